@@ -60,9 +60,9 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 class KernelBase
 {
  public:
-  KernelBase(const AlgorithmBase* algo, int t)
+  KernelBase(const AlgorithmBase* algo, int t, double openingAngle = 0.0, int order = 6)
       : algo_(algo), numprocessors_(Parallel::NumCores()),
-        barrier_("BSV KernelBase Barrier", numprocessors_), typeOut_(t)
+        barrier_("BSV KernelBase Barrier", numprocessors_), typeOut_(t), openingAngle_(openingAngle), order_(order)
   {}
 
   virtual ~KernelBase() = default;
@@ -93,6 +93,10 @@ class KernelBase
   int typeOut_;
   DenseMatrixHandle matOut_;
 
+  //! treecode opening angle, 0 selects the direct sum, and expansion order
+  double openingAngle_;
+  int order_;
+
   bool preIntegration(FieldHandle& mesh, FieldHandle& coil)
   {
     vmesh_ = mesh->vmesh();
@@ -134,6 +138,53 @@ class KernelBase
     outdata = matOut_;
     return true;
   }
+
+  //! Fills the output with scale times the curl (B field) or the potential (A field) of the sources
+  void evaluateTreecode(const BiotSavartTreecode& tree, double scale)
+  {
+    algo_->remark("Treecode evaluation with opening angle " + std::to_string(openingAngle_) +
+        " and order " + std::to_string(order_) + " over " + std::to_string(tree.size()) + " sources");
+
+    Parallel::RunTasks([&](int proc_num)
+    {
+      const index_type begins = (modelSize_ * proc_num) / numprocessors_;
+      const index_type ends = (modelSize_ * (proc_num + 1)) / numprocessors_;
+      int cnt = 0;
+
+      try
+      {
+        for (index_type iM = begins; iM < ends; iM++)
+        {
+          Point modelNode;
+          vmesh_->get_node(modelNode, iM);
+
+          Vector F;
+          if (typeOut_ == 1)
+            tree.evaluate(Vector(modelNode), nullptr, &F);
+          else if (typeOut_ == 2)
+            tree.evaluate(Vector(modelNode), &F, nullptr);
+          F *= scale;
+
+          matOut_->put(iM, 0, F[0]);
+          matOut_->put(iM, 1, F[1]);
+          matOut_->put(iM, 2, F[2]);
+
+          //! progress reporter
+          if (proc_num == 0 && ++cnt == 200)
+          {
+            cnt = 0;
+            algo_->update_progress_max(iM, ends - begins);
+          }
+        }
+        success_[proc_num] = true;
+      }
+      catch (...)
+      {
+        algo_->error("Treecode evaluation crashed");
+        success_[proc_num] = false;
+      }
+    }, numprocessors_);
+  }
 };
 
 namespace {
@@ -150,7 +201,7 @@ std::string formatWithCommas(const T& value)
 class PieceWiseKernel : public KernelBase
 {
  public:
-  PieceWiseKernel(const AlgorithmBase* algo, int t) : KernelBase(algo, t)
+  PieceWiseKernel(const AlgorithmBase* algo, int t, double openingAngle, int order) : KernelBase(algo, t, openingAngle, order)
   {
     // we keep last calculated step
     // however if segments lenght varies,
@@ -190,6 +241,14 @@ class PieceWiseKernel : public KernelBase
       coilNodes_.emplace_back(enode2);
     }
 
+    if (openingAngle_ > 0.0)
+    {
+      std::vector<Vector> positions, weights;
+      discretizeCoil(positions, weights);
+      evaluateTreecode(BiotSavartTreecode(positions, weights, openingAngle_, order_), 1.0e-7);
+      return postIntegration(outdata);
+    }
+
     //! Start the multi threaded
     Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 
@@ -212,6 +271,44 @@ class PieceWiseKernel : public KernelBase
   //! keep nodes on the coil cached
   std::vector<Vector> coilNodes_;
 
+  //! Midpoints and current weighted lengths of the curve elements used by ParallelKernel
+  void discretizeCoil(std::vector<Vector>& positions, std::vector<Vector>& weights)
+  {
+    double prevSegLen = 123456789.12345678;
+    int nips = 0;
+
+    for (size_t iC0 = 0, iC1 = 1, iCV = 0; iC0 < coilNodes_.size(); iC0 += 2, iC1 += 2, iCV++)
+    {
+      double currentFromField;
+      vcoilField_->get_value(currentFromField, iCV);
+
+      const double current = currentFromField == 0.0 ? 1.0 : currentFromField;
+      const auto absCurrent = std::fabs(current);
+
+      const Vector& coilNodeThis = current >= 0.0 ? coilNodes_[iC0] : coilNodes_[iC1];
+      const Vector& coilNodeNext = current >= 0.0 ? coilNodes_[iC1] : coilNodes_[iC0];
+
+      const double newSegLen = (coilNodeNext - coilNodeThis).length();
+
+      if (extstep_ > 0) { nips = newSegLen / extstep_; }
+      else if (fabs(prevSegLen - newSegLen) > 0.00000001)
+      {
+        prevSegLen = newSegLen;
+        nips = adjustNumberOfIntegrationPoints(newSegLen);
+      }
+
+      if (nips < 3) { algo_->warning("integration step too big"); }
+
+      for (int iip = 0; iip < nips - 1; iip++)
+      {
+        const auto piip = Interpolate(coilNodeThis, coilNodeNext, static_cast<double>(iip) / nips);
+        const auto piip1 = Interpolate(coilNodeThis, coilNodeNext, static_cast<double>(iip + 1) / nips);
+        positions.push_back((piip + piip1) / 2);
+        weights.push_back((piip1 - piip) * absCurrent);
+      }
+    }
+  }
+
   //! execute in parallel
   void ParallelKernel(int proc_num)
   {
@@ -417,6 +514,25 @@ class VolumetricKernel : public KernelBase
 
     vmesh_->synchronize(Mesh::NODES_E | Mesh::EDGES_E);
 
+    //! only the vector potential has the 1/r form the treecode expands
+    if (openingAngle_ > 0.0 && typeOut_ == 2)
+    {
+      std::vector<Vector> positions(coilSize_), weights(coilSize_);
+      for (VMesh::Elem::index_type iC = 0; iC < coilSize_; iC++)
+      {
+        Point coilCenter;
+        Vector current;
+        vcoilField_->get_value(current, iC);
+        vcoilField_->get_center(coilCenter, iC);
+        positions[iC] = Vector(coilCenter);
+        weights[iC] = current * (vcoil_->get_volume(iC) / (4.0 * M_PI));
+      }
+      evaluateTreecode(BiotSavartTreecode(positions, weights, openingAngle_, order_), 1.0);
+      return postIntegration(outdata);
+    }
+    if (openingAngle_ > 0.0)
+      algo_->remark("Treecode evaluation covers the vector potential only, using direct summation.");
+
     //! Start the multi threaded
     Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 
@@ -631,11 +747,19 @@ bool BiotSavartSolverAlgorithm::run(
     return (false);
   }
 
+  const double openingAngle = get(Parameters::UseTreecode).toBool() ? get(Parameters::TreecodeOpeningAngle).toDouble() : 0.0;
+  const int order = get(Parameters::TreecodeOrder).toInt();
+  if (openingAngle < 0.0 || order < 0)
+  {
+    error("Treecode opening angle and order must not be negative.");
+    return (false);
+  }
+
   if (coil->vmesh()->is_curvemesh())
   {
     if (coil->vfield()->is_constantdata() && coil->vfield()->is_scalar())
     {
-      PieceWiseKernel pwk(this, outtype);
+      PieceWiseKernel pwk(this, outtype, openingAngle, order);
       if (!pwk.integrate(mesh, coil, outdata))
       {
         error("Aborted during integration");
@@ -653,6 +777,8 @@ bool BiotSavartSolverAlgorithm::run(
     if ((coil->vfield()->is_lineardata() || coil->vfield()->is_constantdata()) &&
         coil->vfield()->is_vector())
     {
+      if (openingAngle > 0.0)
+        remark("Treecode evaluation is not available for dipole coils, using direct summation.");
       DipolesKernel dp(this, outtype);
       if (!dp.integrate(mesh, coil, outdata))
       {
@@ -670,7 +796,7 @@ bool BiotSavartSolverAlgorithm::run(
   {
     if (coil->vfield()->is_constantdata() && coil->vfield()->is_vector())
     {
-      VolumetricKernel vp(this, outtype);
+      VolumetricKernel vp(this, outtype, openingAngle, order);
       if (!vp.integrate(mesh, coil, outdata))
       {
         error("Aborted during integration");
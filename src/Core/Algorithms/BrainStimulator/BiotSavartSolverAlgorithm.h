@@ -34,6 +34,7 @@
 #include <Core/Datatypes/Matrix.h>
 
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/BrainStimulator/BiotSavartTreecode.h>
 #include <Core/Algorithms/BrainStimulator/share.h>
 
 ///@file BiotSavartSolverAlgorithm
@@ -64,6 +65,9 @@ namespace BrainStimulator {
     BiotSavartSolverAlgorithm()
     {
       addParameter(Parameters::OutType, 0);
+      addParameter(Parameters::UseTreecode, false);
+      addParameter(Parameters::TreecodeOpeningAngle, 0.4);
+      addParameter(Parameters::TreecodeOrder, 6);
     }
     AlgorithmOutput run(const AlgorithmInput& input) const override;
     bool run(FieldHandle mesh, FieldHandle coil, Datatypes::DenseMatrixHandle& outdata, int outtype) const;
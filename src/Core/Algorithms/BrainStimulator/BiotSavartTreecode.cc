@@ -0,0 +1,276 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/BrainStimulator/BiotSavartTreecode.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+using namespace SCIRun::Core::Geometry;
+
+ALGORITHM_PARAMETER_DEF(BrainStimulator, UseTreecode);
+ALGORITHM_PARAMETER_DEF(BrainStimulator, TreecodeOpeningAngle);
+ALGORITHM_PARAMETER_DEF(BrainStimulator, TreecodeOrder);
+
+namespace
+{
+  const int maxDepth = 24;
+}
+
+BiotSavartTreecode::BiotSavartTreecode(const std::vector<Vector>& positions,
+  const std::vector<Vector>& weights, double openingAngle, int order, int leafSize) :
+  openingAngle_(openingAngle), order_(std::max(0, order)), leafSize_(std::max(1, leafSize)),
+  positions_(positions), weights_(weights), numMoments_(0)
+{
+  // Enumerate the multi-indices by degree, the order the recurrence needs them in
+  const int maxDegree = order_ + 1;
+  const int side = maxDegree + 1;
+  std::vector<int> lookup(side * side * side, -1);
+  auto index = [&](int i, int j, int k)
+  {
+    return (i < 0 || j < 0 || k < 0 || i + j + k > maxDegree) ? -1 : lookup[(i * side + j) * side + k];
+  };
+  for (int degree = 0; degree <= maxDegree; ++degree)
+  {
+    if (degree == maxDegree)
+      numMoments_ = terms_.size();
+    for (int i = degree; i >= 0; --i)
+      for (int j = degree - i; j >= 0; --j)
+      {
+        Term t;
+        t.power[0] = i;
+        t.power[1] = j;
+        t.power[2] = degree - i - j;
+        t.degree = degree;
+        lookup[(i * side + j) * side + t.power[2]] = static_cast<int>(terms_.size());
+        terms_.push_back(t);
+      }
+  }
+  for (auto& t : terms_)
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      int p[3] = { t.power[0], t.power[1], t.power[2] };
+      p[axis] -= 1;
+      t.lower[axis] = index(p[0], p[1], p[2]);
+      p[axis] -= 1;
+      t.lower2[axis] = index(p[0], p[1], p[2]);
+      p[axis] += 3;
+      t.upper[axis] = index(p[0], p[1], p[2]);
+    }
+  }
+
+  if (positions_.empty())
+    return;
+
+  Vector min = positions_[0], max = positions_[0];
+  for (const auto& p : positions_)
+  {
+    min = Min(min, p);
+    max = Max(max, p);
+  }
+  build(0, positions_.size(), min, max, 0);
+
+  moments_.assign(cells_.size() * 3 * numMoments_, 0.0);
+  for (size_t c = 0; c < cells_.size(); ++c)
+    computeMoments(static_cast<int>(c));
+}
+
+int BiotSavartTreecode::build(size_t begin, size_t end, const Vector& min, const Vector& max, int depth)
+{
+  const int id = static_cast<int>(cells_.size());
+  cells_.push_back(Cell());
+
+  Cell cell;
+  cell.begin = begin;
+  cell.end = end;
+  cell.center = (min + max) * 0.5;
+  cell.radius = 0.0;
+  for (auto i = begin; i < end; ++i)
+    cell.radius = std::max(cell.radius, (positions_[i] - cell.center).length());
+  cell.firstChild = static_cast<int>(children_.size());
+  cell.numChildren = 0;
+
+  if (end - begin > static_cast<size_t>(leafSize_) && depth < maxDepth && cell.radius > 0.0)
+  {
+    // Sort the sources into the eight octants around the center
+    std::vector<size_t> order(end - begin);
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = begin + i;
+    auto octant = [&](size_t i)
+    {
+      const auto& p = positions_[i];
+      return (p.x() > cell.center.x() ? 1 : 0) | (p.y() > cell.center.y() ? 2 : 0) | (p.z() > cell.center.z() ? 4 : 0);
+    };
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return octant(a) < octant(b); });
+
+    std::vector<Vector> sortedPositions(order.size()), sortedWeights(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+      sortedPositions[i] = positions_[order[i]];
+      sortedWeights[i] = weights_[order[i]];
+    }
+    std::copy(sortedPositions.begin(), sortedPositions.end(), positions_.begin() + begin);
+    std::copy(sortedWeights.begin(), sortedWeights.end(), weights_.begin() + begin);
+
+    std::vector<int> children;
+    auto first = begin;
+    while (first < end)
+    {
+      const int o = octant(first);
+      auto last = first + 1;
+      while (last < end && octant(last) == o)
+        ++last;
+      Vector childMin = positions_[first], childMax = positions_[first];
+      for (auto i = first; i < last; ++i)
+      {
+        childMin = Min(childMin, positions_[i]);
+        childMax = Max(childMax, positions_[i]);
+      }
+      children.push_back(build(first, last, childMin, childMax, depth + 1));
+      first = last;
+    }
+
+    cell.firstChild = static_cast<int>(children_.size());
+    cell.numChildren = static_cast<int>(children.size());
+    children_.insert(children_.end(), children.begin(), children.end());
+  }
+
+  cells_[id] = cell;
+  return id;
+}
+
+void BiotSavartTreecode::computeMoments(int c)
+{
+  const auto& cell = cells_[c];
+  double* moments = &moments_[c * 3 * numMoments_];
+  std::vector<double> powers(3 * (order_ + 1));
+
+  for (auto i = cell.begin; i < cell.end; ++i)
+  {
+    const Vector d = positions_[i] - cell.center;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      powers[axis * (order_ + 1)] = 1.0;
+      for (int p = 1; p <= order_; ++p)
+        powers[axis * (order_ + 1) + p] = powers[axis * (order_ + 1) + p - 1] * d[axis];
+    }
+
+    for (size_t t = 0; t < numMoments_; ++t)
+    {
+      const auto& term = terms_[t];
+      const double monomial = powers[term.power[0]] * powers[(order_ + 1) + term.power[1]] * powers[2 * (order_ + 1) + term.power[2]];
+      for (int k = 0; k < 3; ++k)
+        moments[k * numMoments_ + t] += weights_[i][k] * monomial;
+    }
+  }
+}
+
+// Adds the expansion of a cell at r = x - center to the potential and its gradient,
+// grad[j][k] being the derivative of component k along axis j. The Taylor coefficients
+// a_k = D^k (1/|x - y|) / k! at y = center follow from
+//   |k| R^2 a_k - (2|k| - 1) sum_i r_i a_{k-e_i} + (|k| - 1) sum_i a_{k-2e_i} = 0,
+// and the derivative of a_k along x_j is -(k_j + 1) a_{k+e_j}.
+void BiotSavartTreecode::evaluateCell(int c, const Vector& r, std::vector<double>& a, double phi[3], double grad[3][3]) const
+{
+  const double R2 = r.length2();
+  a[0] = 1.0 / std::sqrt(R2);
+  for (size_t t = 1; t < terms_.size(); ++t)
+  {
+    const auto& term = terms_[t];
+    double sum = 0.0;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      if (term.lower[axis] >= 0)
+        sum += (2 * term.degree - 1) * r[axis] * a[term.lower[axis]];
+      if (term.lower2[axis] >= 0)
+        sum -= (term.degree - 1) * a[term.lower2[axis]];
+    }
+    a[t] = sum / (term.degree * R2);
+  }
+
+  const double* moments = &moments_[c * 3 * numMoments_];
+  for (size_t t = 0; t < numMoments_; ++t)
+  {
+    const auto& term = terms_[t];
+    for (int k = 0; k < 3; ++k)
+    {
+      const double m = moments[k * numMoments_ + t];
+      phi[k] += a[t] * m;
+      for (int j = 0; j < 3; ++j)
+        grad[j][k] -= (term.power[j] + 1) * a[term.upper[j]] * m;
+    }
+  }
+}
+
+void BiotSavartTreecode::evaluate(const Vector& x, Vector* potential, Vector* curl) const
+{
+  Vector directPotential, directCurl;
+  double phi[3] = { 0.0, 0.0, 0.0 };
+  double grad[3][3] = { { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+
+  if (!cells_.empty())
+  {
+    std::vector<double> coefficients(terms_.size());
+    std::vector<int> stack(1, 0);
+    while (!stack.empty())
+    {
+      const int c = stack.back();
+      const auto& cell = cells_[c];
+      stack.pop_back();
+
+      const Vector r = x - cell.center;
+      // small cells are cheaper to sum directly than to expand
+      if (cell.radius < openingAngle_ * r.length() && cell.end - cell.begin > numMoments_)
+      {
+        evaluateCell(c, r, coefficients, phi, grad);
+      }
+      else if (cell.numChildren == 0)
+      {
+        for (auto i = cell.begin; i < cell.end; ++i)
+        {
+          const Vector R = positions_[i] - x;
+          const double Rl = R.length();
+          directPotential += weights_[i] / Rl;
+          directCurl += Cross(R, weights_[i]) / (Rl * Rl * Rl);
+        }
+      }
+      else
+      {
+        stack.insert(stack.end(), children_.begin() + cell.firstChild, children_.begin() + cell.firstChild + cell.numChildren);
+      }
+    }
+  }
+
+  if (potential)
+    *potential = directPotential + Vector(phi[0], phi[1], phi[2]);
+  if (curl)
+    *curl = directCurl + Vector(grad[1][2] - grad[2][1], grad[2][0] - grad[0][2], grad[0][1] - grad[1][0]);
+}
@@ -0,0 +1,108 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+///@file BiotSavartTreecode
+///@brief Octree treecode for sums of vector valued sources with a 1/r kernel
+///
+///@details
+/// Evaluates, for sources with positions s and vector weights w,
+///   potential(x) = sum w / |x - s|
+///   curl(x)      = sum (s - x) / |s - x|^3 x w     (the curl of potential)
+/// which covers the magnetic vector potential and the Biot-Savart field of line
+/// segments, current elements and current density cells. Octree cells that look
+/// small from the target, radius < theta * distance, are replaced by a Cartesian
+/// Taylor expansion of the kernel about the cell center (Lindsay and Krasny,
+/// J. Comput. Phys. 172, 2001); the others are split or summed directly. The error
+/// falls off roughly as theta^(order+1), and theta = 0 gives the direct sum.
+
+#ifndef CORE_ALGORITHMS_BRAINSTIMULATOR_BIOTSAVARTTREECODE_H
+#define CORE_ALGORITHMS_BRAINSTIMULATOR_BIOTSAVARTTREECODE_H
+
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <vector>
+#include <Core/Algorithms/BrainStimulator/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace BrainStimulator {
+
+  ALGORITHM_PARAMETER_DECL(UseTreecode);
+  ALGORITHM_PARAMETER_DECL(TreecodeOpeningAngle);
+  ALGORITHM_PARAMETER_DECL(TreecodeOrder);
+
+  class SCISHARE BiotSavartTreecode
+  {
+  public:
+    BiotSavartTreecode(const std::vector<Geometry::Vector>& positions,
+      const std::vector<Geometry::Vector>& weights, double openingAngle, int order = 6, int leafSize = 16);
+
+    //! Either output may be null. Safe to call from several threads.
+    void evaluate(const Geometry::Vector& x, Geometry::Vector* potential, Geometry::Vector* curl) const;
+
+    size_t size() const { return positions_.size(); }
+
+  private:
+    struct Cell
+    {
+      Geometry::Vector center;
+      double radius;
+      size_t begin, end;
+      int firstChild, numChildren;
+    };
+
+    //! multi-index k of a Taylor term and the terms the recurrence refers to, -1 if absent
+    struct Term
+    {
+      int power[3];
+      int degree;
+      int lower[3], lower2[3], upper[3];
+    };
+
+    int build(size_t begin, size_t end, const Geometry::Vector& min, const Geometry::Vector& max, int depth);
+    void computeMoments(int cell);
+    void evaluateCell(int cell, const Geometry::Vector& r, std::vector<double>& coefficients, double phi[3], double grad[3][3]) const;
+
+    double openingAngle_;
+    int order_;
+    int leafSize_;
+    std::vector<Geometry::Vector> positions_, weights_;
+    std::vector<Cell> cells_;
+    std::vector<int> children_;
+    //! terms up to order_ + 1, sorted by degree; the first numMoments_ carry moments
+    std::vector<Term> terms_;
+    size_t numMoments_;
+    //! per cell, the moments sum w_c (s - center)^k of the three weight components
+    std::vector<double> moments_;
+  };
+
+}}}}
+
+#endif
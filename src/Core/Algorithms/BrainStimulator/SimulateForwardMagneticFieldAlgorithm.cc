@@ -41,6 +41,7 @@
 #include <Core/Logging/ScopedTimeRemarker.h>
 #include <Core/Logging/Log.h>
 #include <Core/Algorithms/BrainStimulator/SimulateForwardMagneticFieldAlgorithm.h>
+#include <memory>
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -60,11 +61,18 @@ AlgorithmInputName SimulateForwardMagneticFieldAlgo::DetectorLocations("Detector
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticField("MagneticField");
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticFieldMagnitudes("MagneticFieldMagnitudes");
 
+SimulateForwardMagneticFieldAlgo::SimulateForwardMagneticFieldAlgo()
+{
+  addParameter(Parameters::UseTreecode, false);
+  addParameter(Parameters::TreecodeOpeningAngle, 0.4);
+  addParameter(Parameters::TreecodeOrder, 6);
+}
+
 class CalcFMField
 {
   public:
 
-    CalcFMField(const AlgorithmBase* algo) : algo_(algo),
+    CalcFMField(const AlgorithmBase* algo, double openingAngle, int order) : algo_(algo), openingAngle_(openingAngle), order_(order),
       np_(-1),efld_(nullptr),ctfld_(nullptr),dipfld_(nullptr),detfld_(nullptr),emsh_(nullptr),ctmsh_(nullptr),dipmsh_(nullptr),detmsh_(nullptr),magfld_(nullptr),magmagfld_(nullptr)
     {
     }
@@ -78,8 +86,13 @@ class CalcFMField
     void interpolate(int proc, Point p);
     void set_up_cell_cache();
     void calc_parallel(int proc);
+    void set_up_treecode();
+    Vector treecode_field(const Point& p) const;
 
     const AlgorithmBase* algo_;
+    double openingAngle_; // 0 for direct summation
+    int order_;
+    std::unique_ptr<BiotSavartTreecode> tree_;
     int np_;
     std::vector<Vector> interp_value_;
     std::vector<std::pair<std::string, Tensor> > tens_;
@@ -211,26 +224,33 @@ void CalcFMField::calc_parallel(int proc)
 
     detmsh_->get_center(pt, idx);
 
-    // init the interp val to 0
-    interp_value_[proc] = Vector(0,0,0);
-    interpolate(proc, pt);
-
-    mag_field = interp_value_[proc];
-
     Vector normal;
     detfld_->get_value(normal,idx);
 
-    // iterate over the dipoles.
-    for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+    if (tree_)
     {
-      dipmsh_->get_center(pt2, dip_idx);
-      dipfld_->value(P,dip_idx);
+      mag_field = treecode_field(pt);
+    }
+    else
+    {
+      // init the interp val to 0
+      interp_value_[proc] = Vector(0,0,0);
+      interpolate(proc, pt);
 
-      Vector radius = pt - pt2; // detector - source
-      Vector valuePXR = Cross(P, radius);
-      double length = radius.length();
+      mag_field = interp_value_[proc];
+
+      // iterate over the dipoles.
+      for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+      {
+        dipmsh_->get_center(pt2, dip_idx);
+        dipfld_->value(P,dip_idx);
 
-      mag_field += valuePXR / (length * length * length);
+        Vector radius = pt - pt2; // detector - source
+        Vector valuePXR = Cross(P, radius);
+        double length = radius.length();
+
+        mag_field += valuePXR / (length * length * length);
+      }
     }
 
     mag_field *= one_over_4_pi;
@@ -250,6 +270,51 @@ void CalcFMField::calc_parallel(int proc)
 
 }
 
+// The cells and the dipoles both contribute source x radius / |radius|^3, which is the
+// curl the treecode evaluates.
+void CalcFMField::set_up_treecode()
+{
+  VMesh::size_type num_dipoles = dipmsh_->num_nodes();
+  std::vector<Vector> positions, weights;
+  positions.reserve(cell_cache_.size() + num_dipoles);
+  weights.reserve(cell_cache_.size() + num_dipoles);
+
+  for (const auto& c : cell_cache_)
+  {
+    positions.push_back(Vector(c.center_));
+    weights.push_back(c.cur_density_ * c.volume_);
+  }
+
+  Point pt;
+  Vector P;
+  for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+  {
+    dipmsh_->get_center(pt, dip_idx);
+    dipfld_->value(P, dip_idx);
+    positions.push_back(Vector(pt));
+    weights.push_back(P);
+  }
+
+  tree_.reset(new BiotSavartTreecode(positions, weights, openingAngle_, order_));
+}
+
+Vector CalcFMField::treecode_field(const Point& p) const
+{
+  Vector field;
+  tree_->evaluate(Vector(p), nullptr, &field);
+
+  // interpolate() leaves out the cell holding the detector
+  VMesh::Elem::index_type inside_cell = 0;
+  if (emsh_->locate(inside_cell, p))
+  {
+    const per_cell_cache& c = cell_cache_[inside_cell];
+    Vector radius = p - c.center_;
+    double length = radius.length();
+    field -= (Cross(c.cur_density_, radius) / (length * length * length)) * c.volume_;
+  }
+  return field;
+}
+
 boost::tuple<FieldHandle,FieldHandle> CalcFMField::calc_forward_magnetic_field(FieldHandle efield, FieldHandle ctfield, FieldHandle dipoles, FieldHandle detectors)
 {
   efld_ = efield->vfield();
@@ -303,6 +368,12 @@ boost::tuple<FieldHandle,FieldHandle> CalcFMField::calc_forward_magnetic_field(F
   // cache per cell calculations that are used over and over again.
   set_up_cell_cache();
 
+  if (openingAngle_ > 0.0)
+  {
+    emsh_->synchronize(Mesh::ELEM_LOCATE_E);
+    set_up_treecode();
+  }
+
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // do the parallel work.
   Thread::parallel(this, &CalcFMField::calc_parallel, np_, mod);
@@ -336,7 +407,14 @@ boost::tuple<FieldHandle, FieldHandle> SimulateForwardMagneticFieldAlgo::run(Fie
     THROW_ALGORITHM_INPUT_ERROR("Must have Vector field as Detector Locations input");
   }
 
-  CalcFMField algo(this);
+  const double openingAngle = get(Parameters::UseTreecode).toBool() ? get(Parameters::TreecodeOpeningAngle).toDouble() : 0.0;
+  const int order = get(Parameters::TreecodeOrder).toInt();
+  if (openingAngle < 0.0 || order < 0)
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Treecode opening angle and order must not be negative.");
+  }
+
+  CalcFMField algo(this, openingAngle, order);
   FieldHandle MField, MFieldMagnitudes;
 
   boost::tie(MField,MFieldMagnitudes) = algo.calc_forward_magnetic_field(ElectricField, ConductivityTensors, DipoleSources, DetectorLocations);
@@ -42,6 +42,7 @@
 
 #include <Core/Datatypes/MatrixFwd.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/BrainStimulator/BiotSavartTreecode.h>
 #include <vector>
 #include <Core/Algorithms/BrainStimulator/share.h>
 
@@ -53,6 +54,7 @@ namespace SCIRun {
 class SCISHARE SimulateForwardMagneticFieldAlgo : public AlgorithmBase
 {
   public:
+    SimulateForwardMagneticFieldAlgo();
 
     static AlgorithmInputName ElectricField;
     static AlgorithmInputName ConductivityTensor;
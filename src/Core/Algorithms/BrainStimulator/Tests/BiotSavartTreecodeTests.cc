@@ -0,0 +1,181 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/BrainStimulator/BiotSavartTreecode.h>
+#include <Core/Algorithms/BrainStimulator/BiotSavartSolverAlgorithm.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <random>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+namespace
+{
+  void directSum(const std::vector<Vector>& positions, const std::vector<Vector>& weights,
+    const Vector& x, Vector& potential, Vector& curl)
+  {
+    potential = curl = Vector(0, 0, 0);
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+      const Vector R = positions[i] - x;
+      const double Rl = R.length();
+      potential += weights[i] / Rl;
+      curl += Cross(R, weights[i]) / (Rl * Rl * Rl);
+    }
+  }
+
+  // Largest error over the targets relative to the largest value
+  double treecodeError(double openingAngle, bool curl)
+  {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::vector<Vector> positions, weights, targets;
+    for (int i = 0; i < 4000; ++i)
+    {
+      positions.push_back(Vector(unit(rng), unit(rng), 0.2 * unit(rng) + 2.0));
+      weights.push_back(Vector(unit(rng), unit(rng), unit(rng)));
+    }
+    for (int i = 0; i < 200; ++i)
+      targets.push_back(Vector(unit(rng), unit(rng), unit(rng)));
+
+    BiotSavartTreecode tree(positions, weights, openingAngle, 8);
+    double maxError = 0, maxValue = 0;
+    for (const auto& x : targets)
+    {
+      Vector expectedPotential, expectedCurl, value;
+      directSum(positions, weights, x, expectedPotential, expectedCurl);
+      if (curl)
+        tree.evaluate(x, nullptr, &value);
+      else
+        tree.evaluate(x, &value, nullptr);
+      const auto& expected = curl ? expectedCurl : expectedPotential;
+      maxError = std::max(maxError, (value - expected).length());
+      maxValue = std::max(maxValue, expected.length());
+    }
+    return maxError / maxValue;
+  }
+
+  FieldHandle circularCoil(int segments, double radius, double height)
+  {
+    FieldInformation fi("CurveMesh", static_cast<int>(databasis_info_type::CONSTANTDATA_E), "double");
+    auto coil = CreateField(fi);
+    auto vmesh = coil->vmesh();
+    for (int i = 0; i < segments; ++i)
+    {
+      const double angle = 2.0 * M_PI * i / segments;
+      vmesh->add_point(Point(radius * cos(angle), radius * sin(angle), height));
+    }
+    VMesh::Node::array_type edge(2);
+    for (int i = 0; i < segments; ++i)
+    {
+      edge[0] = i;
+      edge[1] = (i + 1) % segments;
+      vmesh->add_elem(edge);
+    }
+    coil->vfield()->resize_values();
+    for (VMesh::index_type i = 0; i < segments; ++i)
+      coil->vfield()->set_value(i % 2 ? 1.0 : 2.0, i);
+    return coil;
+  }
+
+  FieldHandle gridOfNodes(int n)
+  {
+    FieldInformation fi("PointCloudMesh", static_cast<int>(databasis_info_type::LINEARDATA_E), "double");
+    auto model = CreateField(fi);
+    auto vmesh = model->vmesh();
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+        for (int k = 0; k < n; ++k)
+          vmesh->add_point(Point(-0.1 + 0.2 * i / (n - 1), -0.1 + 0.2 * j / (n - 1), -0.1 + 0.08 * k / (n - 1)));
+    model->vfield()->resize_values();
+    return model;
+  }
+
+  double maxRelativeDifference(const DenseMatrix& a, const DenseMatrix& b)
+  {
+    return (a - b).rowwise().norm().maxCoeff() / b.rowwise().norm().maxCoeff();
+  }
+}
+
+TEST(BiotSavartTreecodeTests, ZeroOpeningAngleIsDirectSum)
+{
+  EXPECT_LT(treecodeError(0.0, false), 1e-12);
+  EXPECT_LT(treecodeError(0.0, true), 1e-12);
+}
+
+TEST(BiotSavartTreecodeTests, ErrorShrinksWithOpeningAngle)
+{
+  for (bool curl : { false, true })
+  {
+    const double coarse = treecodeError(0.8, curl);
+    const double medium = treecodeError(0.5, curl);
+    const double fine = treecodeError(0.25, curl);
+    EXPECT_LT(fine, medium);
+    EXPECT_LT(medium, coarse);
+    EXPECT_LT(coarse, 5e-2);
+    EXPECT_LT(fine, 1e-6);
+  }
+}
+
+TEST(BiotSavartTreecodeTests, SolverMatchesDirectKernelAtSeveralTolerances)
+{
+  auto coil = circularCoil(120, 0.05, 0.1);
+  auto model = gridOfNodes(10);
+
+  BiotSavartSolverAlgorithm direct;
+  DenseMatrixHandle directB, directA;
+  ASSERT_TRUE(direct.run(model, coil, directB, 1));
+  ASSERT_TRUE(direct.run(model, coil, directA, 2));
+
+  double previousError = 1.0;
+  for (double openingAngle : { 0.5, 0.3, 0.2 })
+  {
+    BiotSavartSolverAlgorithm treecode;
+    treecode.set(Parameters::UseTreecode, true);
+    treecode.set(Parameters::TreecodeOpeningAngle, openingAngle);
+    DenseMatrixHandle B, A;
+    ASSERT_TRUE(treecode.run(model, coil, B, 1));
+    ASSERT_TRUE(treecode.run(model, coil, A, 2));
+
+    const double error = std::max(maxRelativeDifference(*B, *directB), maxRelativeDifference(*A, *directA));
+    EXPECT_LT(error, 2e-2) << openingAngle;
+    EXPECT_LT(error, previousError) << openingAngle;
+    previousError = error;
+  }
+  EXPECT_LT(previousError, 1e-5);
+}
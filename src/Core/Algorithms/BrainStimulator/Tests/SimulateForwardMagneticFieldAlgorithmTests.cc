@@ -127,3 +127,30 @@ TEST(SimulateForwardMagneticFieldAlgoTest, TestOnLatVol)
   EXPECT_MATRIX_EQ_TOLERANCE(*MField_matrix, *MField_expected_matrix, 1e-16);
   EXPECT_MATRIX_EQ_TOLERANCE(*MFieldMagnitudes_matrix, *MFieldMagnitudes_expected_matrix, 1e-16);
 }
+
+TEST(SimulateForwardMagneticFieldAlgoTest, TreecodeMatchesDirectSumOnLatVol)
+{
+  FieldHandle first = LoadFieldFirstModuleInput();
+  FieldHandle second = LoadFieldSecondModuleInput();
+  FieldHandle third = LoadFieldThirdModuleInput();
+  FieldHandle fourth = LoadFieldFourthModuleInput();
+
+  SimulateForwardMagneticFieldAlgo direct;
+  FieldHandle directField, directMagnitudes;
+  boost::tie(directField, directMagnitudes) = direct.run(first, second, third, fourth);
+
+  GetFieldDataAlgo getData;
+  DenseMatrixHandle expected = getData.runMatrix(directField);
+
+  for (double openingAngle : { 0.5, 0.2 })
+  {
+    SimulateForwardMagneticFieldAlgo treecode;
+    treecode.set(Algorithms::BrainStimulator::Parameters::UseTreecode, true);
+    treecode.set(Algorithms::BrainStimulator::Parameters::TreecodeOpeningAngle, openingAngle);
+    FieldHandle field, magnitudes;
+    boost::tie(field, magnitudes) = treecode.run(first, second, third, fourth);
+
+    DenseMatrixHandle actual = getData.runMatrix(field);
+    EXPECT_LT((*actual - *expected).norm(), 1e-3 * expected->norm()) << openingAngle;
+  }
+}
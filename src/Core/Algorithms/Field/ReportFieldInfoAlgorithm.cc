@@ -123,12 +123,15 @@ ReportFieldInfoAlgorithm::Outputs ReportFieldInfoAlgorithm::update_input_attribu
       output.geometricSize += vmesh->get_size(idx);
     }
 
+    vmesh->get_adjacency_memory(output.adjacencyMemory_, output.nestedAdjacencyMemory_);
+
   }
   return output;
 }
 
 ReportFieldInfoAlgorithm::Outputs::Outputs()
-  : dataMin(0), dataMax(0), numdata_(0), numnodes_(0), numelements_(0), geometricSize(0)
+  : dataMin(0), dataMax(0), numdata_(0), numnodes_(0), numelements_(0), geometricSize(0),
+    adjacencyMemory_(0), nestedAdjacencyMemory_(0)
 {
 }
 
@@ -163,5 +166,13 @@ std::string ReportFieldInfoAlgorithm::summarize(const Outputs& info)
   ostr << "Data location: " << info.dataLocation << std::endl;
   ostr << "Dims (x,y,z): " << info.dims << std::endl;
   ostr << "Geometric size: " << info.geometricSize << std::endl;
+  if (info.adjacencyMemory_ > 0)
+  {
+    ostr << "Node adjacency memory: " << info.adjacencyMemory_ << " bytes";
+    if (info.nestedAdjacencyMemory_ > info.adjacencyMemory_)
+      ostr << " (" << info.nestedAdjacencyMemory_ - info.adjacencyMemory_
+           << " bytes saved over nested vectors)";
+    ostr << std::endl;
+  }
   return ostr.str();
 }
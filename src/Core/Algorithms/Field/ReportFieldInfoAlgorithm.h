@@ -54,6 +54,9 @@ namespace Fields {
       size_t numdata_, numnodes_, numelements_;
       std::string dataLocation;
       double geometricSize;
+      /// Bytes of the mesh's node adjacency table, if it has been built,
+      /// and the bytes the same table would take as nested vectors.
+      size_t adjacencyMemory_, nestedAdjacencyMemory_;
     };
 
     Outputs run(const Inputs& input) const;
@@ -35,11 +35,13 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Algorithms/Legacy/Fields/MeshDerivatives/ExtractSimpleIsosurfaceAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -101,3 +103,54 @@ TEST(ExtractSimpleIsoSurfaceAlgoTest, ExtractSimpleIsoSurf_LatVol_DataOnNodes)
   EXPECT_EQ(output->vmesh()->num_elems(),3);
   EXPECT_EQ(output->vfield()->num_values(),5);
 }
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, ThreadedExtractionMatchesSingleThread)
+{
+  auto latvol = CreateEmptyLatVol(40, 40, 40);
+  auto imesh = latvol->vmesh();
+  auto ifield = latvol->vfield();
+  for (VMesh::Node::index_type i = 0; i < imesh->num_nodes(); ++i)
+  {
+    Point p;
+    imesh->get_center(p, i);
+    ifield->set_value(Vector(p).length(), i);
+  }
+
+  std::vector<double> isovalues { 0.4, 0.8 };
+  // The number of cell ranges, not of cores, decides whether outputs are stitched, so this
+  // covers the stitching even on a single core.
+  auto extract = [&](int ranges)
+  {
+    ExtractSimpleIsosurfaceAlgo algo;
+    algo.set(Parameters::num_threads, ranges);
+    FieldHandle output;
+    algo.run(latvol, isovalues, output);
+    return output;
+  };
+
+  auto serial = extract(1);
+  auto threaded = extract(4);
+  ASSERT_TRUE(serial != nullptr);
+  ASSERT_TRUE(threaded != nullptr);
+
+  auto smesh = serial->vmesh();
+  auto tmesh = threaded->vmesh();
+  ASSERT_EQ(smesh->num_nodes(), tmesh->num_nodes());
+  ASSERT_EQ(smesh->num_elems(), tmesh->num_elems());
+
+  // Vertices on edges shared by two ranges are merged, in single threaded order
+  for (VMesh::Node::index_type i = 0; i < smesh->num_nodes(); ++i)
+  {
+    Point ps, pt;
+    smesh->get_center(ps, i);
+    tmesh->get_center(pt, i);
+    EXPECT_EQ(ps, pt);
+  }
+  for (VMesh::Elem::index_type i = 0; i < smesh->num_elems(); ++i)
+  {
+    VMesh::Node::array_type ns, nt;
+    smesh->get_nodes(ns, i);
+    tmesh->get_nodes(nt, i);
+    EXPECT_EQ(ns, nt);
+  }
+}
@@ -37,6 +37,8 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -53,3 +55,146 @@ TEST(MapFieldDataFromSourceToDestinationAlgoTests, ThrowsOnNullInput)
   AlgorithmInput empty;
   EXPECT_THROW(algo.run(empty), AlgorithmProcessingException);
 }
+
+namespace
+{
+  // Lattice with a linear function of the position as node data
+  FieldHandle linearLatVol(int size, const Point& minb, const Point& maxb)
+  {
+    FieldInformation fi("LatVolMesh", 1, "double");
+    MeshHandle mesh = CreateMesh(fi, size, size, size, minb, maxb);
+    FieldHandle field = CreateField(fi, mesh);
+    VMesh* vmesh = field->vmesh();
+    VField* vfield = field->vfield();
+    vfield->resize_values();
+    for (VMesh::Node::index_type idx = 0; idx < vmesh->num_nodes(); ++idx)
+    {
+      Point p;
+      vmesh->get_center(p, idx);
+      vfield->set_value(p.x() + 2.0*p.y() + 3.0*p.z(), idx);
+    }
+    return field;
+  }
+
+  VMesh::Node::index_type bruteForceClosestNode(VMesh* mesh, const Point& p)
+  {
+    VMesh::Node::index_type best = 0;
+    double bestdist = DBL_MAX;
+    for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); ++idx)
+    {
+      Point q;
+      mesh->get_center(q, idx);
+      if ((q - p).length() < bestdist) { bestdist = (q - p).length(); best = idx; }
+    }
+    return best;
+  }
+
+  FieldHandle mapField(FieldHandle source, FieldHandle destination, const std::string& method, double maxdist = -1.0)
+  {
+    MapFieldDataFromSourceToDestinationAlgo algo;
+    algo.setOption(Parameters::MappingMethod, method);
+    algo.set(Parameters::MaxDistance, maxdist);
+    algo.set(Parameters::DefaultValue, -100.0);
+    FieldHandle output;
+    EXPECT_TRUE(algo.runImpl(source, destination, output));
+    return output;
+  }
+}
+
+TEST(MapFieldDataFromSourceToDestinationAlgoTests, InterpolatedDataReproducesLinearField)
+{
+  auto source = linearLatVol(9, Point(0, 0, 0), Point(1, 1, 1));
+  auto destination = linearLatVol(7, Point(0.05, 0.11, 0.17), Point(0.93, 0.89, 0.81));
+
+  auto output = mapField(source, destination, "interpolateddata");
+  ASSERT_TRUE(output != nullptr);
+
+  VMesh* omesh = output->vmesh();
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); ++idx)
+  {
+    Point p;
+    omesh->get_center(p, idx);
+    double val;
+    output->vfield()->get_value(val, idx);
+    EXPECT_NEAR(p.x() + 2.0*p.y() + 3.0*p.z(), val, 1e-10);
+  }
+}
+
+TEST(MapFieldDataFromSourceToDestinationAlgoTests, ClosestDataMatchesBruteForceSearch)
+{
+  auto source = linearLatVol(6, Point(0, 0, 0), Point(1, 1, 1));
+  auto destination = linearLatVol(7, Point(-0.23, 0.07, 0.13), Point(1.17, 0.97, 0.89));
+
+  auto output = mapField(source, destination, "closestdata");
+  ASSERT_TRUE(output != nullptr);
+
+  VMesh* smesh = source->vmesh();
+  VMesh* omesh = output->vmesh();
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); ++idx)
+  {
+    Point p;
+    omesh->get_center(p, idx);
+    double expected, val;
+    source->vfield()->get_value(expected, bruteForceClosestNode(smesh, p));
+    output->vfield()->get_value(val, idx);
+    EXPECT_DOUBLE_EQ(expected, val);
+  }
+}
+
+TEST(MapFieldDataFromSourceToDestinationAlgoTests, SingleDestinationMatchesSerialReference)
+{
+  auto source = linearLatVol(8, Point(0.03, 0.02, 0.01), Point(0.97, 0.95, 0.99));
+  auto destination = linearLatVol(5, Point(0.11, 0.07, 0.13), Point(0.91, 0.83, 0.89));
+
+  auto output = mapField(source, destination, "singledestination");
+  ASSERT_TRUE(output != nullptr);
+
+  // Every source goes to its closest destination; the last source wins
+  VMesh* smesh = source->vmesh();
+  VMesh* dmesh = destination->vmesh();
+  std::vector<double> expected(dmesh->num_nodes(), -100.0);
+  for (VMesh::Node::index_type idx = 0; idx < smesh->num_nodes(); ++idx)
+  {
+    Point p;
+    smesh->get_center(p, idx);
+    source->vfield()->get_value(expected[bruteForceClosestNode(dmesh, p)], idx);
+  }
+
+  for (VMesh::Node::index_type idx = 0; idx < dmesh->num_nodes(); ++idx)
+  {
+    double val;
+    output->vfield()->get_value(val, idx);
+    EXPECT_DOUBLE_EQ(expected[idx], val);
+  }
+}
+
+TEST(MapFieldDataFromSourceToDestinationAlgoTests, MaxDistanceLeavesFarDestinationsAtDefault)
+{
+  auto source = linearLatVol(5, Point(0, 0, 0), Point(1, 1, 1));
+  auto destination = linearLatVol(5, Point(0.5, 0.5, 0.5), Point(2.5, 2.5, 2.5));
+
+  auto output = mapField(source, destination, "closestdata", 0.3);
+  ASSERT_TRUE(output != nullptr);
+
+  VMesh* smesh = source->vmesh();
+  VMesh* omesh = output->vmesh();
+  int mapped = 0;
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); ++idx)
+  {
+    Point p, q;
+    omesh->get_center(p, idx);
+    smesh->get_center(q, bruteForceClosestNode(smesh, p));
+    double val;
+    output->vfield()->get_value(val, idx);
+    if ((q - p).length() < 0.3)
+    {
+      EXPECT_NEAR(q.x() + 2.0*q.y() + 3.0*q.z(), val, 1e-12);
+      mapped++;
+    }
+    else
+    {
+      EXPECT_EQ(-100.0, val);
+    }
+  }
+  EXPECT_GT(mapped, 0);
+}
@@ -63,6 +63,7 @@ void runTest(int basis, const std::string& expectedBasisTypeTemplate, const std:
   EXPECT_EQ(sizex * sizey * sizez, info.numnodes_);
   EXPECT_EQ((sizex-1) * (sizey-1) * (sizez-1), info.numelements_);
   EXPECT_EQ(expectedBasisString, info.dataLocation);
+  EXPECT_EQ(0, info.adjacencyMemory_);
 }
 
 TEST(ReportFieldInfoTest, CanDescribeLatVol)
@@ -72,6 +73,35 @@ TEST(ReportFieldInfoTest, CanDescribeLatVol)
   runTest(1, "HexTrilinearLgn", "Nodes (linear basis)", 60);
 }
 
+TEST(ReportFieldInfoTest, ReportsNodeAdjacencyMemory)
+{
+  FieldInformation fi("TetVolMesh", 1, "double");
+  MeshHandle mesh = CreateMesh(fi);
+  auto vmesh = mesh->vmesh();
+  const int n = 20;
+  for (int k = 0; k <= n; ++k)
+    for (int j = 0; j <= 1; ++j)
+      for (int i = 0; i <= 1; ++i)
+        vmesh->add_point(Point(i, j, k));
+  VMesh::Node::array_type tet(4);
+  for (int k = 0; k < n; ++k)
+  {
+    tet[0] = 4*k; tet[1] = 4*k + 1; tet[2] = 4*k + 2; tet[3] = 4*k + 4;
+    vmesh->add_elem(tet);
+  }
+  FieldHandle ofh = CreateField(fi, mesh);
+
+  ReportFieldInfoAlgorithm algo;
+  auto info = algo.run(ofh);
+  EXPECT_EQ(0, info.adjacencyMemory_);
+
+  vmesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+  info = algo.run(ofh);
+  EXPECT_GT(info.adjacencyMemory_, 0);
+  EXPECT_GT(info.nestedAdjacencyMemory_, 0);
+  EXPECT_NE(std::string::npos, ReportFieldInfoAlgorithm::summarize(info).find("Node adjacency memory"));
+}
+
 TEST(TensorDoubleCastTest, MinMaxQuestion)
 {
   Tensor t1(1,1,1,2,2,3);
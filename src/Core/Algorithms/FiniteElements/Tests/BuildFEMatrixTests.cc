@@ -34,6 +34,10 @@
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Legacy/FiniteElements/BuildMatrix/BuildFEMatrix.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Thread/Parallel.h>
+#include <chrono>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 
@@ -42,6 +46,7 @@ using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Algorithms::FiniteElements;
 using namespace SCIRun::Core::Algorithms::DataIO;
+using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::TestUtils;
 using ::testing::NotNull;
@@ -161,6 +166,40 @@ TEST(BuildFEMatrixAlgorithmTests, TestMeshSize1e4)
   EXPECT_TRUE(expectedOutput("1e4.mat")->isApprox(*output));
 }
 
+TEST(BuildFEMatrixAlgorithmTests, RerunReusesSparsityPatternOfSameMesh)
+{
+  using namespace FEInputData;
+  auto mesh = loadTestMesh("fem_1e3_elements.fld");
+  auto otherMesh = loadTestMesh("fem_1e1_elements.fld");
+  ASSERT_THAT(mesh, NotNull());
+  ASSERT_THAT(otherMesh, NotNull());
+
+  BuildFEMatrixAlgo algo;
+  auto build = [&algo](FieldHandle field)
+  {
+    auto out = algo.run(withInputData((Variables::InputField, field)));
+    return out.get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  };
+
+  auto first = build(mesh);
+  auto second = build(mesh);
+  ASSERT_THAT(first, NotNull());
+  ASSERT_THAT(second, NotNull());
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first->nonZeros(), second->nonZeros());
+  EXPECT_TRUE(expectedOutput("1e3.mat")->isApprox(*second));
+
+  // A different mesh must not pick up the cached structure
+  auto other = build(otherMesh);
+  ASSERT_THAT(other, NotNull());
+  EXPECT_EQ(7, other->nrows());
+  EXPECT_TRUE(expectedOutput("1e1.mat")->isApprox(*other));
+
+  auto third = build(mesh);
+  ASSERT_THAT(third, NotNull());
+  EXPECT_TRUE(expectedOutput("1e3.mat")->isApprox(*third));
+}
+
 // move to nightly: file too big for github unit test repo
 TEST(BuildFEMatrixAlgorithmTests, DISABLED_TestMeshSize1e5)
 {
@@ -214,3 +253,41 @@ TEST(BuildFEMatrixAlgorithmTests, DISABLED_TestMeshSize1e6)
 
   EXPECT_TRUE(compare_with_tolerance(*expectedOutput("1e6.mat"), *output));
 }
+
+// Benchmark rather than a correctness test: prints CG iterations per second on a
+// BuildFEMatrix stiffness matrix for increasing thread counts.
+TEST(BuildFEMatrixAlgorithmTests, DISABLED_CGIterationsPerSecondByThreadCount)
+{
+  using namespace FEInputData;
+  auto mesh = loadTestMesh("fem_1e4_elements.fld");
+  ASSERT_THAT(mesh, NotNull());
+
+  BuildFEMatrixAlgo build;
+  auto A = build.run(withInputData((Variables::InputField, mesh))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  ASSERT_THAT(A, NotNull());
+
+  DenseColumnMatrixHandle b(makeShared<DenseColumnMatrix>(*A * DenseColumnMatrix::Ones(A->ncols())));
+  DenseColumnMatrixHandle x0(makeShared<DenseColumnMatrix>(DenseColumnMatrix::Zero(A->ncols())));
+  const int iterations = 500;
+
+  const auto maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+  {
+    SCIRun::Core::Thread::Parallel::SetMaximumCores(threads);
+
+    SolveLinearSystemAlgo solver;
+    solver.set(Variables::MaxIterations, iterations);
+    solver.set(Variables::TargetError, 1e-300);
+    solver.setOption(Variables::Method, "cg");
+    solver.setUpdaterFunc([](double) {});
+
+    DenseColumnMatrixHandle x;
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(solver.run(A, b, x0, x));
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << A->nrows() << " unknowns, " << threads << " threads: "
+      << iterations / elapsed.count() << " CG iterations/sec" << std::endl;
+  }
+  SCIRun::Core::Thread::Parallel::SetMaximumCores(0);
+}
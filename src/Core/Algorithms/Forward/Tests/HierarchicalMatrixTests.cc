@@ -0,0 +1,288 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Forward/HierarchicalMatrix.h>
+#include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <array>
+#include <map>
+#include <numeric>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Forward;
+
+namespace
+{
+  std::vector<Point> spherePoints(int n, double radius, const Vector& center)
+  {
+    std::vector<Point> points;
+    const double golden = M_PI * (3.0 - sqrt(5.0));
+    for (int i = 0; i < n; ++i)
+    {
+      const double z = 1.0 - 2.0 * (i + 0.5) / n;
+      const double r = sqrt(1.0 - z * z);
+      points.push_back(Point(radius * r * cos(golden * i), radius * r * sin(golden * i), radius * z) + center);
+    }
+    return points;
+  }
+
+  HierarchicalMatrix::BlockGenerator laplaceKernel(const std::vector<Point>& rowPoints, const std::vector<Point>& colPoints)
+  {
+    return [&rowPoints, &colPoints](const std::vector<index_type>& rows, const std::vector<index_type>& cols)
+    {
+      return HierarchicalMatrix::BlockEntries([&rowPoints, &colPoints, rows, cols](const std::vector<index_type>& rowPositions,
+        const std::vector<index_type>& colPositions, Eigen::MatrixXd& block)
+      {
+        block.resize(rowPositions.size(), colPositions.size());
+        for (size_t j = 0; j < colPositions.size(); ++j)
+          for (size_t i = 0; i < rowPositions.size(); ++i)
+            block(i, j) = 1.0 / ((rowPoints[rows[rowPositions[i]]] - colPoints[cols[colPositions[j]]]).length() + 0.05);
+      });
+    };
+  }
+
+  DenseMatrix denseFrom(const std::vector<Point>& rowPoints, const std::vector<Point>& colPoints)
+  {
+    std::vector<index_type> rows(rowPoints.size()), cols(colPoints.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    std::iota(cols.begin(), cols.end(), 0);
+    Eigen::MatrixXd block;
+    laplaceKernel(rowPoints, colPoints)(rows, cols)(rows, cols, block);
+    return block;
+  }
+
+  double relativeError(const HierarchicalMatrix& H, const DenseMatrix& dense)
+  {
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(H.cols(), -1.0, 2.0);
+    Eigen::VectorXd y;
+    H.multiply(x, y);
+    return (y - dense * x).norm() / (dense * x).norm();
+  }
+
+  // Sphere made by subdividing an octahedron, projected back on the sphere
+  MeshHandle sphereMesh(int levels, double radius)
+  {
+    std::vector<Vector> points = { Vector(1,0,0), Vector(-1,0,0), Vector(0,1,0), Vector(0,-1,0), Vector(0,0,1), Vector(0,0,-1) };
+    std::vector<std::array<index_type, 3>> faces = { {{0,2,4}}, {{2,1,4}}, {{1,3,4}}, {{3,0,4}}, {{2,0,5}}, {{1,2,5}}, {{3,1,5}}, {{0,3,5}} };
+
+    for (int level = 0; level < levels; ++level)
+    {
+      std::map<std::pair<index_type, index_type>, index_type> midpoints;
+      auto midpoint = [&](index_type a, index_type b)
+      {
+        auto key = std::make_pair(std::min(a, b), std::max(a, b));
+        auto found = midpoints.find(key);
+        if (found != midpoints.end())
+          return found->second;
+        Vector m = points[a] + points[b];
+        m.normalize();
+        points.push_back(m);
+        return midpoints[key] = static_cast<index_type>(points.size() - 1);
+      };
+
+      std::vector<std::array<index_type, 3>> refined;
+      for (const auto& f : faces)
+      {
+        const auto a = midpoint(f[0], f[1]), b = midpoint(f[1], f[2]), c = midpoint(f[2], f[0]);
+        refined.push_back({{f[0], a, c}});
+        refined.push_back({{a, f[1], b}});
+        refined.push_back({{c, b, f[2]}});
+        refined.push_back({{a, b, c}});
+      }
+      faces.swap(refined);
+    }
+
+    FieldInformation fi("TriSurfMesh", static_cast<int>(databasis_info_type::LINEARDATA_E), "double");
+    auto mesh = CreateMesh(fi);
+    auto vmesh = mesh->vmesh();
+    for (const auto& p : points)
+      vmesh->add_point(Point(p * radius));
+    for (const auto& f : faces)
+    {
+      VMesh::Node::array_type nodes(3);
+      for (int k = 0; k < 3; ++k)
+        nodes[k] = f[k];
+      vmesh->add_elem(nodes);
+    }
+    return mesh;
+  }
+
+  double relativeError(const HierarchicalMatrix& H, const DenseMatrixHandle& dense)
+  {
+    return relativeError(H, *dense);
+  }
+}
+
+TEST(HierarchicalMatrixTests, CompressesSmoothKernelToRequestedAccuracy)
+{
+  const auto points = spherePoints(3000, 1.0, Vector(0, 0, 0));
+  HierarchicalMatrix::Options options;
+  options.tolerance = 1e-4;
+  HierarchicalMatrix H(points, points, laplaceKernel(points, points), options);
+
+  EXPECT_GT(H.numLowRankBlocks(), 0u);
+  EXPECT_GT(H.numDenseBlocks(), 0u);
+  EXPECT_LT(H.compressionRatio(), 0.4);
+  EXPECT_LT(relativeError(H, denseFrom(points, points)), 1e-3);
+}
+
+TEST(HierarchicalMatrixTests, ToDenseMatchesKernel)
+{
+  const auto points = spherePoints(500, 1.0, Vector(0, 0, 0));
+  HierarchicalMatrix H(points, points, laplaceKernel(points, points));
+
+  auto dense = denseFrom(points, points);
+  EXPECT_LT((*H.toDense() - dense).norm() / dense.norm(), 1e-5);
+}
+
+TEST(HierarchicalMatrixTests, TighterToleranceIsMoreAccurate)
+{
+  const auto points = spherePoints(2000, 1.0, Vector(0, 0, 0));
+  const auto dense = denseFrom(points, points);
+  HierarchicalMatrix::Options loose, tight;
+  loose.tolerance = 1e-3;
+  tight.tolerance = 1e-8;
+  HierarchicalMatrix looseH(points, points, laplaceKernel(points, points), loose);
+  HierarchicalMatrix tightH(points, points, laplaceKernel(points, points), tight);
+
+  EXPECT_LT(relativeError(tightH, dense), relativeError(looseH, dense));
+  EXPECT_LT(looseH.compressionRatio(), tightH.compressionRatio());
+  EXPECT_LT(relativeError(tightH, dense), 1e-7);
+}
+
+TEST(HierarchicalMatrixTests, RectangularOperatorBetweenSurfaces)
+{
+  const auto rows = spherePoints(800, 0.5, Vector(0, 0, 0));
+  const auto cols = spherePoints(1500, 1.0, Vector(0.1, 0, 0));
+  HierarchicalMatrix H(rows, cols, laplaceKernel(rows, cols));
+
+  ASSERT_EQ(800, H.rows());
+  ASSERT_EQ(1500, H.cols());
+  EXPECT_LT(relativeError(H, denseFrom(rows, cols)), 1e-5);
+}
+
+TEST(HierarchicalMatrixTests, SetDiagonalOnlyTouchesDiagonal)
+{
+  const auto points = spherePoints(400, 1.0, Vector(0, 0, 0));
+  HierarchicalMatrix H(points, points, laplaceKernel(points, points));
+  Eigen::VectorXd diagonal = Eigen::VectorXd::LinSpaced(400, 1.0, 400.0);
+  H.setDiagonal(diagonal);
+
+  DenseMatrix expected = denseFrom(points, points);
+  expected.diagonal() = diagonal;
+  EXPECT_LT((*H.toDense() - expected).norm() / expected.norm(), 1e-5);
+}
+
+class CompressedBEMOperatorTests : public ::testing::Test, public BuildBEMatrixBase
+{
+protected:
+  void SetUp() override
+  {
+    outer_ = sphereMesh(4, 1.0);
+    inner_ = sphereMesh(3, 0.6);
+    pre_calc_tri_areas(outer_->vmesh(), areas_);
+    options_.leafSize = 16;
+    options_.tolerance = 1e-6;
+  }
+
+  MeshHandle outer_, inner_;
+  std::vector<double> areas_;
+  HierarchicalMatrix::Options options_;
+};
+
+TEST_F(CompressedBEMOperatorTests, AutoPMatchesDense)
+{
+  DenseMatrixHandle dense;
+  make_auto_P(outer_->vmesh(), dense, 1.0, 0.2);
+  auto compressed = make_auto_P_compressed(outer_->vmesh(), 1.0, 0.2, options_);
+
+  EXPECT_LT(compressed->compressionRatio(), 1.0);
+  EXPECT_LT(relativeError(*compressed, dense), 1e-4);
+}
+
+TEST_F(CompressedBEMOperatorTests, CrossPMatchesDense)
+{
+  DenseMatrixHandle dense;
+  make_cross_P(inner_->vmesh(), outer_->vmesh(), dense, 1.0, 0.2);
+  auto compressed = make_cross_P_compressed(inner_->vmesh(), outer_->vmesh(), 1.0, 0.2, options_);
+
+  EXPECT_LT(relativeError(*compressed, dense), 1e-4);
+}
+
+TEST_F(CompressedBEMOperatorTests, AutoGMatchesDense)
+{
+  DenseMatrixHandle dense;
+  make_auto_G(outer_->vmesh(), dense, 1.0, 0.2, areas_);
+  auto compressed = make_auto_G_compressed(outer_->vmesh(), 1.0, 0.2, areas_, options_);
+
+  EXPECT_LT(compressed->compressionRatio(), 1.0);
+  EXPECT_LT(relativeError(*compressed, dense), 1e-4);
+}
+
+TEST_F(CompressedBEMOperatorTests, CrossGMatchesDense)
+{
+  DenseMatrixHandle dense;
+  make_cross_G(inner_->vmesh(), outer_->vmesh(), dense, 1.0, 0.2, areas_);
+  auto compressed = make_cross_G_compressed(inner_->vmesh(), outer_->vmesh(), 1.0, 0.2, areas_, options_);
+
+  EXPECT_LT(relativeError(*compressed, dense), 1e-4);
+}
+
+TEST_F(CompressedBEMOperatorTests, CompressedSurfaceToPointsTransferMatchesDense)
+{
+  FieldInformation surfaceInfo("TriSurfMesh", static_cast<int>(databasis_info_type::LINEARDATA_E), "double");
+  FieldInformation pointsInfo("PointCloudMesh", static_cast<int>(databasis_info_type::LINEARDATA_E), "double");
+  auto points = CreateField(pointsInfo);
+  for (const auto& p : spherePoints(1000, 0.4, Vector(0.05, 0, 0)))
+    points->vmesh()->add_point(p);
+  points->vfield()->resize_values();
+
+  bemfield_vector fields = { bemfield(CreateField(surfaceInfo, inner_)), bemfield(points) };
+  fields[0].surface = true;
+  fields[0].set_source_dirichlet();
+  fields[1].set_measurement_neumann();
+
+  auto dense = castMatrix::toDense(BEMAlgoImplFactory::create(fields)->compute(fields));
+  auto compressed = castMatrix::toDense(BEMAlgoImplFactory::create(fields, true, options_)->compute(fields));
+
+  ASSERT_EQ(1000, compressed->nrows());
+  ASSERT_EQ(dense->ncols(), compressed->ncols());
+  EXPECT_LT((*compressed - *dense).norm() / dense->norm(), 1e-4);
+}
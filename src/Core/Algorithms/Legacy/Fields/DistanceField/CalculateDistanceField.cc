@@ -34,6 +34,7 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Logging/Log.h>
 #include <Core/Thread/Parallel.h>
+#include <atomic>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -71,11 +72,13 @@ class CalculateDistanceFieldP : public Interruptible
     CalculateDistanceFieldP(VMesh* imesh, VMesh* objmesh, VField* objfield, VField*  ofield, VField* vfield, const AlgorithmBase* algo) :
       imesh(imesh), objmesh(objmesh), objfield(objfield), ofield(ofield), vfield(vfield), algo_(algo)  {}
 
-    void parallel(int proc, int nproc)
+    VMesh::size_type size() const
     {
-      VMesh::size_type num_values = ofield->num_values();
-      VMesh::size_type num_evalues = ofield->num_evalues();
+      return ofield->basis_order() > 1 ? ofield->num_evalues() : ofield->num_values();
+    }
 
+    void run(VMesh::index_type start, VMesh::index_type end)
+    {
       double max = DBL_MAX;
       if (algo_->get(Parameters::Truncate).toBool())
       {
@@ -83,13 +86,10 @@ class CalculateDistanceFieldP : public Interruptible
       }
 
       double val = 0.0;
-      int cnt = 0;
 
       if (ofield->basis_order() == 0)
       {
         VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
 
         for (VMesh::Elem::index_type idx=start; idx<end; idx++)
         {
@@ -98,15 +98,11 @@ class CalculateDistanceFieldP : public Interruptible
           imesh->get_center(p,idx);
           if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
           ofield->set_value(val,idx);
-
-          if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
         }
       }
       else if (ofield->basis_order() == 1)
       {
         VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_values);
 
         for (VMesh::Node::index_type idx=start; idx<end; idx++)
         {
@@ -115,15 +111,11 @@ class CalculateDistanceFieldP : public Interruptible
           imesh->get_center(p,idx);
           if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
           ofield->set_value(val,idx);
-
-          if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
         }
       }
       else if (ofield->basis_order() > 1)
       {
         VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
-        range(proc,nproc,start,end,num_evalues);
 
         for (VMesh::ENode::index_type idx=start; idx<end; idx++)
         {
@@ -132,33 +124,19 @@ class CalculateDistanceFieldP : public Interruptible
           imesh->get_center(p,idx);
           if(!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
           ofield->set_value(val,idx);
-
-          if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
         }
       }
     }
 
-    void parallel2(int proc, int nproc)
+    void run2(VMesh::index_type start, VMesh::index_type end)
     {
-      VMesh::size_type num_values = ofield->num_values();
-      VMesh::size_type num_evalues = ofield->num_evalues();
-
-      if (algo_->get(Parameters::Truncate).toBool())
-      {
-        // Cannot do both at the same time
-        if (proc == 0) algo_->warning("Closest value has been requested, disabling truncated distance map.");
-      }
-
       double val = 0.0;
-      int cnt = 0;
 
       if (ofield->basis_order() == 0)
       {
         VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
         VMesh::coords_type coords;
         Point p, p2;
-        range(proc,nproc,start,end,num_values);
 
         if (objfield->is_scalar())
         {
@@ -172,7 +150,6 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(scalar,coords,fidx);
             vfield->set_value(scalar,idx);
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
         else if (objfield->is_vector())
@@ -187,7 +164,6 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(vec,coords,fidx);
             vfield->set_value(vec,idx);
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
         else if (objfield->is_tensor())
@@ -202,16 +178,13 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(tensor,coords,fidx);
             vfield->set_value(tensor,idx);
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
       }
       else if (ofield->basis_order() == 1)
       {
         VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
         VMesh::coords_type coords;
-        range(proc,nproc,start,end,num_values);
         Point p, p2;
 
         if (objfield->is_scalar())
@@ -226,8 +199,6 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(scalar,coords,fidx);
             vfield->set_value(scalar,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
         else if (objfield->is_vector())
@@ -242,8 +213,6 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(vec,coords,fidx);
             vfield->set_value(vec,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
         else if (objfield->is_tensor())
@@ -258,17 +227,13 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(tensor,coords,fidx);
             vfield->set_value(tensor,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
       }
       else if (ofield->basis_order() > 1)
       {
         VMesh::Elem::index_type fidx;
-        VMesh::index_type start, end;
         VMesh::coords_type coords;
-        range(proc,nproc,start,end,num_evalues);
         Point p, p2;
 
         if (objfield->is_scalar())
@@ -282,8 +247,6 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(scalar,coords,fidx);
             vfield->set_value(scalar,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
         else if (objfield->is_vector())
@@ -297,8 +260,6 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(vec,coords,fidx);
             vfield->set_value(vec,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
         else if (objfield->is_tensor())
@@ -312,24 +273,11 @@ class CalculateDistanceFieldP : public Interruptible
             ofield->set_value(val,idx);
             objfield->interpolate(tensor,coords,fidx);
             vfield->set_value(tensor,idx);
-
-            if (proc == 0) { cnt++; if (cnt == 100) { algo_->update_progress_max(idx,end); cnt = 0; } }
           }
         }
       }
     }
 
-
-    void range(int proc, int nproc,
-               VMesh::index_type& start, VMesh::index_type& end,
-               VMesh::size_type size)
-    {
-      VMesh::size_type m = size/nproc;
-      start = proc*m;
-      end = (proc+1)*m;
-      if (proc == nproc-1) end = size;
-    }
-
   private:
     VMesh*   imesh;
     VMesh*   objmesh;
@@ -338,6 +286,22 @@ class CalculateDistanceFieldP : public Interruptible
     VField*  vfield;
     const AlgorithmBase* algo_;
 };
+
+  // Hands out chunks of output values dynamically, since closest-element queries vary a lot in cost.
+  template <class Evaluate>
+  void forEachValueChunk(const AlgorithmBase* algo, VMesh::size_type size, Evaluate evaluate)
+  {
+    const auto caller = std::this_thread::get_id();
+    std::atomic<VMesh::size_type> done(0);
+    Parallel::For(0, size, [&](std::int64_t start, std::int64_t end)
+    {
+      evaluate(start, end);
+      const auto total = done += end - start;
+      if (std::this_thread::get_id() == caller)
+        algo->update_progress_max(total, size);
+    });
+  }
+
 }
 
 //TODO refactor duplication
@@ -405,8 +369,7 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
   }
 
   detail::CalculateDistanceFieldP palgo(imesh,objmesh,ofield,this);
-  auto task_i = [&palgo](int i) { palgo.parallel(i, Parallel::NumCores()); };
-  Parallel::RunTasks(task_i, Parallel::NumCores());
+  detail::forEachValueChunk(this, palgo.size(), [&palgo](VMesh::index_type start, VMesh::index_type end) { palgo.run(start, end); });
 
   return (true);
 }
@@ -489,9 +452,14 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (false);
   }
 
+  if (get(Parameters::Truncate).toBool())
+  {
+    // Cannot do both at the same time
+    warning("Closest value has been requested, disabling truncated distance map.");
+  }
+
   detail::CalculateDistanceFieldP palgo(imesh,objmesh,objfield,dfield,vfield,this);
-  auto task_i = [&palgo](int i) { palgo.parallel2(i, Parallel::NumCores()); };
-  Parallel::RunTasks(task_i, Parallel::NumCores());
+  detail::forEachValueChunk(this, palgo.size(), [&palgo](VMesh::index_type start, VMesh::index_type end) { palgo.run2(start, end); });
 
   return (true);
 }
@@ -27,6 +27,7 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/Mapping/BuildMappingMatrixAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/MappingBlocks.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Thread/Parallel.h>
@@ -38,6 +39,7 @@
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/SparseRowMatrixFromMap.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
+#include <algorithm>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -96,94 +98,22 @@ namespace detail
   void BuildMappingMatrixClosestDataPAlgo::parallel(int proc)
   {
     // Determine which ones to run
-    VField::size_type num_values = dfield_->num_values();
-    VField::size_type localsize = num_values/nproc_;
-    VField::index_type start = localsize*proc;
-    VField::index_type end = localsize*(proc+1);
-    if (proc == nproc_-1) end = num_values;
+    VField::index_type start, end;
+    get_range(dfield_->num_values(),proc,nproc_,start,end);
 
     barrier_.wait();
 
-    int cnt = 0;
-
-    if (dfield_->basis_order() == 0 && sfield_->basis_order() == 0)
+    std::vector<Point> points;
+    std::vector<VMesh::index_type> idx;
+    for (VField::index_type bstart=start; bstart<end; bstart+=mapping_block_size)
     {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
+      VField::index_type bend = std::min(bstart+mapping_block_size,end);
 
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-          }
-          else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
-    {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-          }
-          else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
-    {
-      Point p, r;
-      VMesh::Node::index_type didx;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_node(dist,r,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-          }
-          else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
-    {
-      Point p, r;
-      VMesh::Node::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_node(dist,r,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-          }
-          else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+      get_centers(points,dmesh_,dfield_->basis_order(),bstart,bend);
+      find_closest(idx,smesh_,sfield_->basis_order(),points,maxdist_);
+      std::copy(idx.begin(),idx.end(),cc_+bstart);
+
+      if (proc == 0) algo_->update_progress_max(bend,end);
     }
 
     barrier_.wait();
@@ -228,111 +158,39 @@ namespace detail
   {
     // Determine which ones to run
     VField::size_type num_values = sfield_->num_values();
-    VField::size_type localsize = num_values/nproc_;
-    VField::index_type start = localsize*proc;
-    VField::index_type end = localsize*(proc+1);
-    if (proc == nproc_-1) end = num_values;
+    VField::index_type start, end;
+    get_range(num_values,proc,nproc_,start,end);
 
     if (proc == 0)
     {
-      tcc_.resize(dfield_->num_values());
+      tcc_.assign(dfield_->num_values(),-1);
     }
 
     barrier_.wait();
 
-    int cnt = 0;
-
-    if (sfield_->basis_order() == 0 && dfield_->basis_order() == 0)
-    {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        smesh_->get_center(p,idx);
-        double dist;
-        if(dmesh_->find_closest_elem(dist,r,coords,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-          }
-          else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (sfield_->basis_order() == 1 && dfield_->basis_order() == 0)
-    {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        smesh_->get_center(p,idx);
-        double dist;
-        if(dmesh_->find_closest_elem(dist,r,coords,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-          }
-          else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (sfield_->basis_order() == 0 && dfield_->basis_order() == 1)
-    {
-      Point p, r;
-      VMesh::Node::index_type didx;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        smesh_->get_center(p,idx);
-        double dist;
-        if(dmesh_->find_closest_node(dist,r,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-          }
-          else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (sfield_->basis_order() == 1 && dfield_->basis_order() == 1)
+    std::vector<Point> points;
+    std::vector<VMesh::index_type> idx;
+    for (VField::index_type bstart=start; bstart<end; bstart+=mapping_block_size)
     {
-      Point p, r;
-      VMesh::Node::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        smesh_->get_center(p,idx);
-        double dist;
-        if(dmesh_->find_closest_node(dist,r,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-          }
-          else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+      VField::index_type bend = std::min(bstart+mapping_block_size,end);
+
+      get_centers(points,smesh_,sfield_->basis_order(),bstart,bend);
+      find_closest(idx,dmesh_,dfield_->basis_order(),points,maxdist_);
+      std::copy(idx.begin(),idx.end(),cc_+bstart);
+
+      if (proc == 0) algo_->update_progress_max(bend,end);
     }
 
     barrier_.wait();
 
+    // The source with the highest index wins if several map onto the
+    // same destination
     if (proc == 0)
     {
       VField::size_type num_dvalues = dfield_->num_values();
-      for (VMesh::index_type idx=0; idx<num_dvalues;idx++)
-      {
-        tcc_[idx] = -1;
-      }
       for (VMesh::index_type idx=0; idx<num_values;idx++)
       {
-        tcc_[cc_[idx]] = idx;
+        if (cc_[idx] >= 0) tcc_[cc_[idx]] = idx;
       }
 
       rr_[0] = 0;
@@ -370,131 +228,52 @@ namespace detail
   void BuildMappingMatrixInterpolatedDataPAlgo::parallel(int proc)
   {
     // Determine which ones to run
-    VField::size_type num_values = dfield_->num_values();
-    VField::size_type localsize = num_values/nproc_;
-    VField::index_type start = localsize*proc;
-    VField::index_type end = localsize*(proc+1);
-    if (proc == nproc_-1) end = num_values;
+    VField::index_type start, end;
+    get_range(dfield_->num_values(),proc,nproc_,start,end);
 
     barrier_.wait();
 
-    int cnt = 0;
+    std::vector<Point> points;
+    std::vector<Point> result;
+    std::vector<double> dist;
+    std::vector<VMesh::coords_type> coords;
+    std::vector<VMesh::Elem::index_type> sidx;
+    VMesh::ElemInterpolate interp;
 
-    if (dfield_->basis_order() == 0 && sfield_->basis_order() == 0)
+    for (VField::index_type bstart=start; bstart<end; bstart+=mapping_block_size)
     {
-      Point p, r;
-      VMesh::Elem::index_type didx;
+      VField::index_type bend = std::min(bstart+mapping_block_size,end);
 
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
+      get_centers(points,dmesh_,dfield_->basis_order(),bstart,bend);
+      smesh_->mfind_closest_elem(dist,result,coords,sidx,points,maxdist_);
 
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-            vv_[idx] = 1.0;
-          }
-          else
-          {
-            cc_[idx] = -1;
-            vv_[idx] = 1.0;
-          }
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
-    {
-      Point p, r;
-      VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      for (VField::index_type idx=bstart; idx<bend; idx++)
       {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,didx,p))
+        const size_t j = idx-bstart;
+        if (sidx[j] < 0 || (maxdist_ >= 0.0 && dist[j] >= maxdist_))
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-            vv_[idx] = 1.0;
-          }
-          else
+          for (index_type i=0;i<e_;i++)
           {
-            cc_[idx] = -1;
-            vv_[idx] = 1.0;
+            cc_[idx*e_+i] = -1;
+            vv_[idx*e_+i] = 0.0;
           }
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
-    {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-      VMesh::ElemInterpolate interp;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+        else if (sfield_->basis_order() == 0)
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            smesh_->get_interpolate_weights(coords,didx,interp,1);
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = interp.node_index[j];
-              vv_[idx*e_+j] = interp.weights[j];
-            }
-          }
-          else
-          {
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = -1;
-              vv_[idx*e_+j] = 0.0;
-            }
-          }
+          cc_[idx] = sidx[j];
+          vv_[idx] = 1.0;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
-    {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-      VMesh::ElemInterpolate interp;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+        else
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            smesh_->get_interpolate_weights(coords,didx,interp,1);
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = interp.node_index[j];
-              vv_[idx*e_+j] = interp.weights[j];
-            }
-          }
-          else
+          smesh_->get_interpolate_weights(coords[j],sidx[j],interp,1);
+          for (index_type i=0;i<e_;i++)
           {
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = -1;
-              vv_[idx*e_+j] = 0.0;
-            }
+            cc_[idx*e_+i] = interp.node_index[i];
+            vv_[idx*e_+i] = interp.weights[i];
           }
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
       }
+      if (proc == 0) algo_->update_progress_max(bend,end);
     }
 
     barrier_.wait();
@@ -27,6 +27,7 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/Mapping/MapFieldDataFromSourceToDestination.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/MappingBlocks.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Thread/Parallel.h>
@@ -40,6 +41,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 
 #include <boost/scoped_ptr.hpp>
+#include <algorithm>
 
 using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Core::Geometry;
@@ -105,88 +107,26 @@ void
 MapFieldDataFromSourceToDestinationClosestDataPAlgo::parallel(int proc)
 {
   // Determine which ones to run
-  VField::size_type num_values = dfield_->num_values();
-  VField::size_type localsize = num_values/nproc_;
-  VField::index_type start = localsize*proc;
-  VField::index_type end = localsize*(proc+1);
-  if (proc == nproc_-1) end = num_values;
+  VField::index_type start, end;
+  get_range(dfield_->num_values(),proc,nproc_,start,end);
 
   barrier_.wait();
 
-  int cnt = 0;
+  std::vector<Point> points;
+  std::vector<VMesh::index_type> sidx;
 
-  if (dfield_->basis_order() == 0 && sfield_->basis_order() == 0)
+  for (VField::index_type bstart=start; bstart<end; bstart+=mapping_block_size)
   {
-    Point p, r;
-    VMesh::Elem::index_type didx;
+    VField::index_type bend = std::min(bstart+mapping_block_size,end);
 
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-    {
-      dmesh_->get_center(p,idx);
-      double dist;
-      if(smesh_->find_closest_elem(dist,r,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          dfield_->copy_value(sfield_,didx,idx);
-        }
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
-  {
-    Point p, r;
-    VMesh::Elem::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
-    {
-      dmesh_->get_center(p,idx);
-      double dist;
-      if(smesh_->find_closest_elem(dist,r,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          dfield_->copy_value(sfield_,didx,idx);
-        }
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
-  {
-    Point p, r;
-    VMesh::Node::index_type didx;
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-    {
-      dmesh_->get_center(p,idx);
-      double dist;
-      if(smesh_->find_closest_node(dist,r,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          dfield_->copy_value(sfield_,didx,idx);
-        }
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
-  {
-    Point p, r;
-    VMesh::Node::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
+    get_centers(points,dmesh_,dfield_->basis_order(),bstart,bend);
+    find_closest(sidx,smesh_,sfield_->basis_order(),points,maxdist_);
+
+    for (VField::index_type idx=bstart; idx<bend; idx++)
     {
-      dmesh_->get_center(p,idx);
-      double dist;
-      if(smesh_->find_closest_node(dist,r,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          dfield_->copy_value(sfield_,didx,idx);
-        }
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (sidx[idx-bstart] >= 0) dfield_->copy_value(sfield_,sidx[idx-bstart],idx);
     }
+    if (proc == 0) algo_->update_progress_max(bend,end);
   }
 
   barrier_.wait();
@@ -214,119 +154,57 @@ MapFieldDataFromSourceToDestinationSingleDestinationPAlgo::parallel(int proc)
 {
   // Determine which ones to run
   VField::size_type num_values = sfield_->num_values();
-  VField::size_type localsize = num_values/nproc_;
-  VField::index_type start = localsize*proc;
-  VField::index_type end = localsize*(proc+1);
-  if (proc == nproc_-1) end = num_values;
+  VField::index_type start, end;
+  get_range(num_values,proc,nproc_,start,end);
 
   if (proc == 0)
   {
-    tcc_.resize(dfield_->num_values(),-1);
-    cc_.resize(sfield_->num_values(),-1);
+    tcc_.assign(dfield_->num_values(),-1);
+    cc_.assign(num_values,-1);
   }
 
   barrier_.wait();
-  int cnt = 0;
 
-  if (sfield_->basis_order() == 0 && dfield_->basis_order() == 0)
-  {
-    Point p, r;
-    VMesh::coords_type coords;
-    VMesh::Elem::index_type didx;
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-    {
-      smesh_->get_center(p,idx);
-      double dist;
-      if(dmesh_->find_closest_elem(dist,r,coords,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          cc_[idx] = didx;
-        }
-        else cc_[idx] = -1;
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (sfield_->basis_order() == 1 && dfield_->basis_order() == 0)
-  {
-    Point p, r;
-    VMesh::coords_type coords;
-    VMesh::Elem::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
-    {
-      smesh_->get_center(p,idx);
-      double dist;
-      if(dmesh_->find_closest_elem(dist,r,coords,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          cc_[idx] = didx;
-        }
-        else cc_[idx] = -1;
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (sfield_->basis_order() == 0 && dfield_->basis_order() == 1)
-  {
-    Point p, r;
-    VMesh::Node::index_type didx;
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-    {
-      smesh_->get_center(p,idx);
-      double dist;
-      if(dmesh_->find_closest_node(dist,r,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          cc_[idx] = didx;
-        }
-        else cc_[idx] = -1;
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (sfield_->basis_order() == 1 && dfield_->basis_order() == 1)
+  // Every thread finds the destinations of its own range of sources
+  std::vector<Point> points;
+  std::vector<VMesh::index_type> didx;
+
+  for (VField::index_type bstart=start; bstart<end; bstart+=mapping_block_size)
   {
-    Point p, r;
-    VMesh::Node::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
-    {
-      smesh_->get_center(p,idx);
-      double dist;
-      if(dmesh_->find_closest_node(dist,r,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          cc_[idx] = didx;
-        }
-        else cc_[idx] = -1;
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
+    VField::index_type bend = std::min(bstart+mapping_block_size,end);
+
+    get_centers(points,smesh_,sfield_->basis_order(),bstart,bend);
+    find_closest(didx,dmesh_,dfield_->basis_order(),points,maxdist_);
+    std::copy(didx.begin(),didx.end(),cc_.begin()+bstart);
+
+    if (proc == 0) algo_->update_progress_max(bend,end);
   }
 
   barrier_.wait();
 
-  // Copy the data thread safe
+  // Several sources can map onto the same destination; the one with the
+  // highest index wins. Inverting the map is a cheap serial pass, so it is
+  // done by one thread to keep the outcome independent of the thread count.
   if (proc == 0)
   {
-    VField::size_type num_dvalues = dfield_->num_values();
-
-    for (VMesh::index_type idx=0; idx<num_values;idx++)
+    for (VMesh::index_type idx=0; idx<num_values; idx++)
     {
       if (cc_[idx] >= 0) tcc_[cc_[idx]] = idx;
     }
+  }
 
-    for (VMesh::index_type idx=0; idx<num_dvalues;idx++)
-    {
-      if (tcc_[idx] >= 0)
-      {
-        dfield_->copy_value(sfield_,tcc_[idx],idx);
-      }
-    }
+  barrier_.wait();
+
+  // Each thread owns a range of destinations, so the writes do not overlap
+  VField::index_type dstart, dend;
+  get_range(dfield_->num_values(),proc,nproc_,dstart,dend);
+
+  for (VMesh::index_type idx=dstart; idx<dend; idx++)
+  {
+    if (tcc_[idx] >= 0) dfield_->copy_value(sfield_,tcc_[idx],idx);
   }
+
+  barrier_.wait();
 }
 
 
@@ -347,96 +225,42 @@ void
 MapFieldDataFromSourceToDestinationInterpolatedDataPAlgo::parallel(int proc)
 {
   // Determine which ones to run
-  VField::size_type num_values = dfield_->num_values();
-  VField::size_type localsize = num_values/nproc_;
-  VField::index_type start = localsize*proc;
-  VField::index_type end = localsize*(proc+1);
-  if (proc == nproc_-1) end = num_values;
+  VField::index_type start, end;
+  get_range(dfield_->num_values(),proc,nproc_,start,end);
 
   barrier_.wait();
 
-  int cnt = 0;
-  if (dfield_->basis_order() == 0 && sfield_->basis_order() == 0)
+  std::vector<Point> points;
+  std::vector<Point> result;
+  std::vector<double> dist;
+  std::vector<VMesh::coords_type> coords;
+  std::vector<VMesh::Elem::index_type> sidx;
+  VMesh::ElemInterpolate interp;
+
+  for (VField::index_type bstart=start; bstart<end; bstart+=mapping_block_size)
   {
-    Point p, r;
-    VMesh::Elem::index_type didx;
+    VField::index_type bend = std::min(bstart+mapping_block_size,end);
 
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-    {
-      dmesh_->get_center(p,idx);
+    get_centers(points,dmesh_,dfield_->basis_order(),bstart,bend);
+    smesh_->mfind_closest_elem(dist,result,coords,sidx,points,maxdist_);
 
-      double dist;
-      if(smesh_->find_closest_elem(dist,r,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          dfield_->copy_value(sfield_,didx,idx);
-        }
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
-  {
-    Point p, r;
-    VMesh::Elem::index_type didx;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
+    for (VField::index_type idx=bstart; idx<bend; idx++)
     {
-      dmesh_->get_center(p,idx);
-      double dist;
-      if(smesh_->find_closest_elem(dist,r,didx,p))
-      {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          dfield_->copy_value(sfield_,didx,idx);
-        }
-      }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
-  {
-    Point p, r;
-    VMesh::coords_type coords;
-    VMesh::Elem::index_type didx;
-    VMesh::ElemInterpolate interp;
-    for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-    {
-      dmesh_->get_center(p,idx);
-      double dist;
-      if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+      const size_t j = idx-bstart;
+      if (sidx[j] < 0 || (maxdist_ >= 0.0 && dist[j] >= maxdist_)) continue;
+
+      if (sfield_->basis_order() == 0)
       {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          smesh_->get_interpolate_weights(coords,didx,interp,1);
-          dfield_->copy_weighted_value(sfield_,&(interp.node_index[0]),
-              &(interp.weights[0]),interp.node_index.size(),idx);
-        }
+        dfield_->copy_value(sfield_,sidx[j],idx);
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
-  }
-  else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
-  {
-    Point p, r;
-    VMesh::coords_type coords;
-    VMesh::Elem::index_type didx;
-    VMesh::ElemInterpolate interp;
-    for (VMesh::Node::index_type idx=start; idx<end;idx++)
-    {
-      dmesh_->get_center(p,idx);
-      double dist;
-      if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+      else
       {
-        if (maxdist_ < 0.0 || dist < maxdist_)
-        {
-          smesh_->get_interpolate_weights(coords,didx,interp,1);
-          dfield_->copy_weighted_value(sfield_,&(interp.node_index[0]),
-              &(interp.weights[0]),interp.node_index.size(),idx);
-        }
+        smesh_->get_interpolate_weights(coords[j],sidx[j],interp,1);
+        dfield_->copy_weighted_value(sfield_,&(interp.node_index[0]),
+            &(interp.weights[0]),interp.node_index.size(),idx);
       }
-      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
     }
+    if (proc == 0) algo_->update_progress_max(bend,end);
   }
 
   barrier_.wait();
@@ -542,7 +366,6 @@ MapFieldDataFromSourceToDestinationAlgo::runImpl(FieldHandle source, FieldHandle
   }
   else if(method == "singledestination")
   {
-    np = 1; //TODO: ???
     algoP.reset(new detail::MapFieldDataFromSourceToDestinationSingleDestinationPAlgo(np));
   }
   else if (method == "interpolateddata")
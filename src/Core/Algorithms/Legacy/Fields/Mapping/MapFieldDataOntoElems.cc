@@ -154,6 +154,16 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
   VField::index_type      end = localsize*(proc+1);
   if (proc == nproc-1) end = num_elems;
 
+  // Visit the elements in Morton order: the data source passes the element
+  // it found for the previous point on as the first guess for the next one,
+  // which pays off when consecutive points are close together.
+  std::vector<Point> centers(end-start);
+  for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+    omesh->get_center(centers[idx-start],idx);
+  std::vector<VMesh::index_type> order;
+  VMesh::morton_order(order,centers);
+  const VMesh::size_type num_local = order.size();
+
   std::vector<VMesh::coords_type> coords;
   std::vector<double> weights;
   std::vector<Point> points;
@@ -215,9 +225,9 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
       values.resize(coords.size());
       if (sample_method== "average")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -226,14 +236,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += values[j]; num++; }
           if (num > 0) val /= num; else val = def_value_;
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "integrate")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           vol = omesh->get_size(idx);
           omesh->get_normals(norms,coords,idx);
@@ -243,14 +253,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += values[j]*weights[j]; num++; }
           if (num > 0) val *= vol; else val = def_value_;
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "min")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -259,14 +269,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           for (size_t j=0; j<values.size(); j++) if (exist(values[j])) if (values[j] < val) val = values[j];
           if (val == std::numeric_limits<double>::max()) val = def_value_;
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "max")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -275,14 +285,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           for (size_t j=0; j<values.size(); j++) if (exist(values[j])) if (values[j] > val) val = values[j];
           if (val == -std::numeric_limits<double>::max()) val = def_value_;
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "sum")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -291,15 +301,15 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           for (size_t j=0; j<values.size(); j++) if(exist(val)) { val += values[j]; num++; }
           if (num == 0) val = def_value_;
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "mostcommon")
       {
         std::vector<double> common;
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -325,15 +335,15 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             rval = def_value_;
           }
           ofield->set_value(rval,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "median")
       {
         std::vector<double> median;
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -352,7 +362,7 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             val = def_value_;
           }
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else
@@ -372,23 +382,23 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
         double val; double rval; double vol;
         if (sample_method== "average")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = 0.0; size_t num = 0;
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += values[j]; num++; }
             if (num > 0) val = val/num; else val = def_value_;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "integrate")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             vol = omesh->get_size(idx);
             datasource->get_data(values,points);
@@ -396,57 +406,57 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             for (size_t j=0; j<values.size(); j++) if (exist(val)) { val += values[j]*weights[j]; num++; }
             if (num > 0) val *= vol;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "min")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = std::numeric_limits<double>::max();
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { if (values[j] < val) val = values[j]; }
             if (val == std::numeric_limits<double>::max()) val = def_value_;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "max")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = -std::numeric_limits<double>::max();
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { if (values[j] > val) val = values[j]; }
             if (val == -std::numeric_limits<double>::max()) val = def_value_;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "sum")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = 0.0; size_t num = 0;
             for (size_t j=0; j<values.size(); j++) { if (exist(values[j])) { val += values[j]; num++;} }
             if (num == 0) val = def_value_;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "mostcommon")
         {
           std::vector<double> common;
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             common.clear();
@@ -470,15 +480,15 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
               rval = def_value_;
             }
             ofield->set_value(rval,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "median")
         {
           std::vector<double> median;
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             median.clear();
@@ -495,7 +505,7 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
               val = def_value_;
             }
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else
@@ -512,23 +522,23 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
         Vector val; double vol;
         if (sample_method== "average")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = Vector(0,0,0); size_t num = 0;
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += values[j]; num++; }
             if (num > 0) val = val*(1.0/num); else val = def_value_;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "integrate")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             vol = omesh->get_size(idx);
             datasource->get_data(values,points);
@@ -536,20 +546,20 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += values[j]*weights[j]; }
             val *= vol;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "sum")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = Vector(0,0,0);
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += values[j]; }
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else
@@ -566,23 +576,23 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
         Tensor val; double vol;
         if (sample_method== "average")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = Tensor(0); size_t num = 0;
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += values[j]; num++; }
             if (num > 0) val = val*(1.0/num);
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "integrate")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             vol = omesh->get_size(idx);
             datasource->get_data(values,points);
@@ -590,20 +600,20 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += weights[j]*values[j]; }
             val = val*vol;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "sum")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = Tensor(0);
             for (size_t j=0; j<values.size(); j++) if (exist(values[j])) { val += values[j]; }
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else
@@ -629,9 +639,9 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
       values.resize(coords.size());
       if (sample_method== "average")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -640,14 +650,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           for (size_t j=1; j<values.size(); j++) val += values[j];
           val *= scale;
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "integrate")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           vol = omesh->get_size(idx);
           omesh->get_normals(norms,coords,idx);
@@ -657,14 +667,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           for (size_t j=1; j<values.size(); j++) val += values[j]*weights[j];
           val *= vol;
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "min")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -672,14 +682,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           val = values[0];
           for (size_t j=1; j<values.size(); j++) if (values[j] < val) val = values[j];
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "max")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -687,14 +697,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           val = values[0];
           for (size_t j=1; j<values.size(); j++) if (values[j] > val) val = values[j];
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "sum")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -702,14 +712,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           val = values[0];
           for (size_t j=1; j<values.size(); j++) val += values[j];
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "mostcommon")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -727,14 +737,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           }
 
           ofield->set_value(rval,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else if (sample_method== "median")
       {
-        for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+        for (VMesh::index_type k=0; k<num_local; k++)
         {
-
+          VMesh::Elem::index_type idx(start+order[k]);
           omesh->minterpolate(points,coords,idx);
           omesh->get_normals(norms,coords,idx);
           datasource->get_data(grads,points);
@@ -744,7 +754,7 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
           if (values.size()%2) val = (values[x]+values[x+1])*0.5;
           else val = values[x];
           ofield->set_value(val,idx);
-          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+          if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
         }
       }
       else
@@ -765,23 +775,23 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
         double scale = 1.0/coords.size();
         if (sample_method== "average")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = values[0];
             for (size_t j=1; j<values.size(); j++) val += values[j];
             val *= scale;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "integrate")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             vol = omesh->get_size(idx);
             datasource->get_data(values,points);
@@ -789,53 +799,53 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             for (size_t j=1; j<values.size(); j++) val += values[j]*weights[j];
             val *= vol;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "min")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = values[0];
             for (size_t j=1; j<values.size(); j++) if (values[j] < val) val = values[j];
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "max")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = values[0];
             for (size_t j=1; j<values.size(); j++) if (values[j] > val) val = values[j];
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "sum")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = values[0];
             for (size_t j=1; j<values.size(); j++) val += values[j];
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "mostcommon")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             std::sort(values.begin(),values.end());
@@ -851,14 +861,14 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             }
 
             ofield->set_value(rval,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "median")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             std::sort(values.begin(),values.end());
@@ -866,7 +876,7 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             if (values.size()%2) val = (values[x]+values[x+1])*0.5;
             else val = values[x];
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else
@@ -884,23 +894,23 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
         double scale = 1.0/coords.size();
         if (sample_method== "average")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = values[0];
             for (size_t j=1; j<values.size(); j++) val += values[j];
             val *= scale;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "integrate")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             vol = omesh->get_size(idx);
             datasource->get_data(values,points);
@@ -908,20 +918,20 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             for (size_t j=1; j<values.size(); j++) val += values[j]*weights[j];
             val *= vol;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "sum")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = values[0];
             for (size_t j=1; j<values.size(); j++) val += values[j];
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else
@@ -939,23 +949,23 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
         double scale = 1.0/coords.size();
         if (sample_method== "average")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = values[0];
             for (size_t j=1; j<values.size(); j++) val += values[j];
             val = val* scale;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "integrate")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             vol = omesh->get_size(idx);
             datasource->get_data(values,points);
@@ -963,20 +973,20 @@ MapFieldDataOntoElemsPAlgo::parallel(int proc)
             for (size_t j=1; j<values.size(); j++) val += values[j]*weights[j];
             val = val*vol;
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else if (sample_method== "sum")
         {
-          for (VMesh::Elem::index_type idx=start; idx<end; idx++)
+          for (VMesh::index_type k=0; k<num_local; k++)
           {
-
+            VMesh::Elem::index_type idx(start+order[k]);
             omesh->minterpolate(points,coords,idx);
             datasource->get_data(values,points);
             val = values[0];
             for (size_t j=1; j<values.size(); j++) val += values[j];
             ofield->set_value(val,idx);
-            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+            if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(k,num_local); } }
           }
         }
         else
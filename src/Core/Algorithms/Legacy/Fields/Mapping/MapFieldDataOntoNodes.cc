@@ -116,18 +116,29 @@ MapFieldDataOntoNodesPAlgo::parallel(int proc)
   VField::index_type      end = localsize*(proc+1);
   if (proc == nproc-1) end = num_nodes;
 
+  // Visit the nodes in Morton order: the data source passes the element it
+  // found for the previous point on as the first guess for the next one,
+  // which pays off when consecutive points are close together.
+  std::vector<Point> centers(end-start);
+  for (VMesh::Node::index_type idx=start; idx<end; idx++)
+    omesh->get_center(centers[idx-start],idx);
+  std::vector<VMesh::index_type> order;
+  VMesh::morton_order(order,centers);
+  const VMesh::size_type num_local = order.size();
+
   int cnt = 0;
   if (is_flux_)
   {
     // To compute flux through a surface
     Point p; Vector val; Vector norm;
-    for (VMesh::Node::index_type idx=start; idx<end; idx++)
+    for (VMesh::index_type j=0; j<num_local; j++)
     {
-      omesh->get_center(p,idx);
+      VMesh::Node::index_type idx(start+order[j]);
+      p = centers[order[j]];
       omesh->get_normal(norm,idx);
       datasource->get_data(val,p);
       ofield->set_value(Dot(val,norm),idx);
-      if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(j,num_local); } }
     }
   }
   else
@@ -136,34 +147,37 @@ MapFieldDataOntoNodesPAlgo::parallel(int proc)
     if (datasource->is_scalar())
     {
       Point p; double val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
+      for (VMesh::index_type j=0; j<num_local; j++)
       {
-        omesh->get_center(p,idx);
+        VMesh::Node::index_type idx(start+order[j]);
+        p = centers[order[j]];
         datasource->get_data(val,p);
         ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(j,num_local); } }
       }
     }
     else if (datasource->is_vector())
     {
       Point p; Vector val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
+      for (VMesh::index_type j=0; j<num_local; j++)
       {
-        omesh->get_center(p,idx);
+        VMesh::Node::index_type idx(start+order[j]);
+        p = centers[order[j]];
         datasource->get_data(val,p);
         ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(j,num_local); } }
       }
     }
     else
     {
       Point p; Tensor val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
+      for (VMesh::index_type j=0; j<num_local; j++)
       {
-        omesh->get_center(p,idx);
+        VMesh::Node::index_type idx(start+order[j]);
+        p = centers[order[j]];
         datasource->get_data(val,p);
         ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(j,num_local); } }
       }
     }
   }
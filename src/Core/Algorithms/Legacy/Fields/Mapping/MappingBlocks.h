@@ -0,0 +1,105 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_MAPPING_MAPPINGBLOCKS_H
+#define CORE_ALGORITHMS_FIELDS_MAPPING_MAPPINGBLOCKS_H 1
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <vector>
+
+// Helpers shared by the threaded mapping algorithms, which split the values of a
+// field over the threads and locate the positions of each thread in blocks.
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+  // Points are located in blocks, so the batched searches work on a
+  // coherent set of points and progress can still be reported
+  const VMesh::size_type mapping_block_size = 4096;
+
+  // Values [start,end) handled by thread proc out of nproc
+  inline void get_range(VField::size_type num_values, int proc, int nproc,
+                        VField::index_type& start, VField::index_type& end)
+  {
+    VField::size_type localsize = num_values/nproc;
+    start = localsize*proc;
+    end = localsize*(proc+1);
+    if (proc == nproc-1) end = num_values;
+  }
+
+  // Positions of the values [start,end) of a field with this basis order
+  inline void get_centers(std::vector<Geometry::Point>& points, const VMesh* mesh,
+                          int basis_order, VMesh::index_type start, VMesh::index_type end)
+  {
+    points.resize(end-start);
+    if (basis_order == 0)
+    {
+      for (VMesh::index_type idx=start; idx<end; idx++)
+        mesh->get_center(points[idx-start],VMesh::Elem::index_type(idx));
+    }
+    else
+    {
+      for (VMesh::index_type idx=start; idx<end; idx++)
+        mesh->get_center(points[idx-start],VMesh::Node::index_type(idx));
+    }
+  }
+
+  // Closest value of a field with this basis order for each point, set to -1
+  // if nothing is found within maxdist (a negative maxdist means no limit)
+  inline void find_closest(std::vector<VMesh::index_type>& idx, const VMesh* mesh,
+                           int basis_order, const std::vector<Geometry::Point>& points, double maxdist)
+  {
+    std::vector<double> dist;
+    std::vector<Geometry::Point> result;
+    if (basis_order == 0)
+    {
+      std::vector<VMesh::coords_type> coords;
+      std::vector<VMesh::Elem::index_type> elems;
+      mesh->mfind_closest_elem(dist,result,coords,elems,points,maxdist);
+      idx.assign(elems.begin(),elems.end());
+    }
+    else
+    {
+      std::vector<VMesh::Node::index_type> nodes;
+      mesh->mfind_closest_node(dist,result,nodes,points,maxdist);
+      idx.assign(nodes.begin(),nodes.end());
+    }
+
+    for (size_t j=0; j<idx.size(); j++)
+    {
+      if (maxdist >= 0.0 && dist[j] >= maxdist) idx[j] = -1;
+    }
+  }
+
+}}}}
+
+#endif
@@ -31,6 +31,42 @@
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 
+std::vector<BaseMC::edgepair_t> BaseMC::node_keys() const
+{
+  std::vector<edgepair_t> keys;
+  if (basis_order_ == 0)
+  {
+    keys.resize(node_map_.size());
+    for (const auto& node : node_map_)
+      keys[node.second] = { -1, node.first, 1.0 };
+  }
+  else
+  {
+    keys.resize(edge_map_.size());
+    for (const auto& edge : edge_map_)
+      keys[edge.second] = edge.first;
+  }
+  return keys;
+}
+
+std::vector<BaseMC::edgepair_t> BaseMC::elem_keys() const
+{
+  std::vector<edgepair_t> keys;
+  if (basis_order_ == 0)
+  {
+    keys.resize(edge_map_.size());
+    for (const auto& face : edge_map_)
+      keys[face.second] = face.first;
+  }
+  else
+  {
+    keys.reserve(cell_map_.size());
+    for (auto cell : cell_map_)
+      keys.push_back({ -1, cell, 1.0 });
+  }
+  return keys;
+}
+
 MatrixHandle BaseMC::get_interpolant()
 {
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
@@ -87,7 +87,7 @@ namespace SCIRun {
       SCIRun::index_type second;
       double dfirst;
     };
-  protected:
+
     struct edgepairhash
     {
       size_t operator()(const edgepair_t &a) const
@@ -99,8 +99,20 @@ namespace SCIRun {
 
     typedef std::unordered_map<edgepair_t, SCIRun::index_type, edgepairhash> edge_hash_type;
 
+    // Source of every output node, indexed by output node: the cut edge of the
+    // input mesh for node data, or the input node itself (first == -1) for cell
+    // data. Tesselators run over different cell ranges return equal keys for a
+    // shared vertex, which is how their outputs are stitched together.
+    std::vector<edgepair_t> node_keys() const;
+
+    // Source of every output element, indexed by output element, in the same
+    // convention: the parent cell for node data, or the pair of cells whose
+    // shared face was extracted for cell data.
+    std::vector<edgepair_t> elem_keys() const;
+
+  protected:
     std::vector<SCIRun::index_type> cell_map_;  // Unique cells when surfacing node data.
-    std::vector<SCIRun::index_type> node_map_;  // Unique nodes when surfacing cell data.
+    std::unordered_map<SCIRun::index_type, SCIRun::index_type> node_map_;  // Unique nodes when surfacing cell data.
 
     SCIRun::size_type nnodes_;
     SCIRun::size_type ncells_;
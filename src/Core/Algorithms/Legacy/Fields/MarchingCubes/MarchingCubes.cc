@@ -35,7 +35,7 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
-#include <Core/Algorithms/Math/AppendMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Algorithms/Legacy/Fields/MergeFields/AppendFieldsAlgo.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
@@ -59,7 +59,6 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithms::Fields;
-using namespace SCIRun::Core::Algorithms::Math;
 
 ALGORITHM_PARAMETER_DEF(Fields, transparency);
 ALGORITHM_PARAMETER_DEF(Fields, build_geometry);
@@ -91,21 +90,21 @@ class MarchingCubesAlgoP {
 
     MarchingCubesAlgoP(FieldHandle input,const std::vector<double>& iso_values) :
      input_(input),
-     iso_values_(iso_values) { }
-
-    ~MarchingCubesAlgoP()
-    {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       delete_all_items(tesselator_);
-      #endif
-    }
+     np_(1),
+     iso_values_(iso_values),
+     algo_(nullptr) { }
 
     FieldHandle    input_;
 
-    std::vector<TESSELATOR*>   tesselator_;
+    // One tesselator per iso value and cell range, at index iso*np_+proc. Every range
+    // is contiguous, and its cells are visited once for all iso values.
+    std::vector<std::unique_ptr<TESSELATOR>> tesselator_;
+    int np_;
+
+    // Per iso value, after the range outputs have been stitched together
     std::vector<FieldHandle>  output_field_;
-    std::vector<MatrixHandle> output_interpolant_matrix_;
-    std::vector<MatrixHandle> output_parent_cell_matrix_;
+    std::vector<std::vector<BaseMC::edgepair_t>> output_node_keys_;
+    std::vector<std::vector<BaseMC::edgepair_t>> output_elem_keys_;
     #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
      std::vector<GeomHandle>   output_geometry_;
     #endif
@@ -122,12 +121,17 @@ class MarchingCubesAlgoP {
     bool run(const AlgorithmBase* algo, FieldHandle& output,
              MatrixHandle& node_interpolant,MatrixHandle& elem_interpolant );
 
-    void parallel(int proc, int nproc, size_t iso);
+    void parallel(int proc);
 
   private:
-    AppendFieldsAlgorithm append_fields_;
-    AppendMatrixAlgorithm append_matrices_;
+    // Below this many cells per range, merging the outputs costs more than the threads save
+    static const VMesh::size_type min_cells_per_range_ = 1000;
 
+    void stitch(size_t iso);
+    MatrixHandle build_interpolant(const std::vector<std::vector<BaseMC::edgepair_t>>& keys,
+                                   size_type ncols) const;
+
+    AppendFieldsAlgorithm append_fields_;
 };
 
 
@@ -150,33 +154,22 @@ template <class TESSELATOR>
 bool
 MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
                         FieldHandle& output,
-                        MatrixHandle&,
-                        MatrixHandle&)
+                        MatrixHandle& node_interpolant,
+                        MatrixHandle& elem_interpolant)
 {
   algo_ = algo;
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  int np = algo->get_int("num_threads");
-  /// By default (-1) choose number of processors
-  if (np < 1) np = Thread::numProcessors();
-  /// Cap the number of threads
-  if (np > 4*Thread::numProcessors()) np = 4*Thread::numProcessors();
-  */
-  /// @todo: FIX MULTI THREADING OF MARCHING CUBES FIELDS ARE NOT PROPORLY LINKED
- #endif
-  int np = Parallel::NumCores();
+  const VMesh::size_type num_elems = input_->vmesh()->num_elems();
 
-  np = 1;
-  size_t num_values = iso_values_.size();
-
-  tesselator_.resize(np);
-  for (size_t j=0; j<tesselator_.size(); j++)
-    tesselator_[j] = new TESSELATOR(input_);
+  /// By default (-1) split the cells into one range per core available to this algorithm; a
+  /// positive num_threads sets the number of ranges, which For spreads over the cores there are.
+  np_ = static_cast<int>(Parallel::NumCores());
+  const int requested = algo->get(Parameters::num_threads).toInt();
+  if (requested > 0)
+    np_ = requested;
+  np_ = static_cast<int>(std::max<VMesh::size_type>(1, std::min<VMesh::size_type>(np_, num_elems / min_cells_per_range_)));
 
-  output_field_.resize(np*num_values);
-  output_interpolant_matrix_.resize(np*num_values);
-  output_parent_cell_matrix_.resize(np*num_values);
-  //output_geometry_.resize(np*num_values);
+  const size_t num_values = iso_values_.size();
 
   build_field_ = algo->get(Parameters::build_field).toBool();
   build_geometry_ = algo->get(Parameters::build_geometry).toBool();
@@ -184,26 +177,54 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
   build_elem_interpolant_ = algo->get(Parameters::build_elem_interpolant).toBool();
   transparency_ = algo->get(Parameters::transparency).toBool();
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  append_fields_.set_progress_reporter(algo->get_progress_reporter());
-  append_matrices_.set_progress_reporter(algo->get_progress_reporter());
-  append_matrices_.setOption("method","append_rows");
- #endif
+  // Resetting synchronizes the input mesh, so it has to happen before the threads start
+  tesselator_.resize(np_*num_values);
+  for (size_t j=0; j<tesselator_.size(); j++)
+  {
+    tesselator_[j].reset(new TESSELATOR(input_));
+    tesselator_[j]->reset(0, build_field_, build_geometry_, transparency_);
+  }
 
-  for (size_t j=0; j<iso_values_.size(); j++)
+  Parallel::For(0, np_, [this](std::int64_t begin, std::int64_t end)
   {
-    if (np == 1)
-    {
-      parallel(0,1,j);
-    }
-    else
+    for (auto proc = begin; proc < end; ++proc)
+      parallel(static_cast<int>(proc));
+  }, 1);
+
+  output_field_.resize(num_values);
+  output_node_keys_.resize(num_values);
+  output_elem_keys_.resize(num_values);
+  if (build_field_)
+  {
+    for (size_t j=0; j<num_values; j++)
+      stitch(j);
+  }
+
+  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
+  if (build_geometry_)
+  {
+    for (size_t j=0; j<tesselator_.size(); j++)
     {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       Thread::parallel(this,&MarchingCubesAlgoP<TESSELATOR>::parallel,np,np,j);
-      #endif
+      MaterialHandle mathandle;
+      ColorMapHandle colormap;
+      colormap = algo_->get_colormap("colormap");
+      if (colormap.get_rep())
+      {
+        mathandle = colormap->lookup(iso_values_[j/np_]);
+      }
+      else
+      {
+        Color color = algo_->get_color("color");
+        mathandle = new Material(color);
+      }
+      if (mathandle.get_rep())
+      {
+        GeomHandle geom = tesselator_[j]->get_geom();
+        output_geometry_.push_back(new GeomMaterial(geom,mathandle));
+      }
     }
   }
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
+
   if (output_geometry_.size() == 0)
   {
     geometry = 0;
@@ -225,21 +246,18 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
   {
    if (!(append_fields_.run(output_field_,output)))
       return (false);
-  }
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if (build_node_interpolant_)
-  {
-    if (!(append_matrices_.run(output_interpolant_matrix_,node_interpolant)))
-      return (false);
-  }
+    // Rows follow the nodes and elements of the appended output field
+    if (build_node_interpolant_)
+    {
+      node_interpolant = build_interpolant(output_node_keys_, input_->vmesh()->num_nodes());
+    }
 
-  if (build_elem_interpolant_)
-  {
-    if (!(append_matrices_.run(output_parent_cell_matrix_,elem_interpolant)))
-      return (false);
+    if (build_elem_interpolant_)
+    {
+      elem_interpolant = build_interpolant(output_elem_keys_, num_elems);
+    }
   }
- #endif
 
   return (true);
 }
@@ -304,82 +322,135 @@ bool MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isoval
 
 
 template<class TESSELATOR>
-void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
+void MarchingCubesAlgoP<TESSELATOR>::parallel(int proc)
 {
-  tesselator_[proc]->reset(0, build_field_, build_geometry_, transparency_);
-
   VMesh*  imesh  = input_->vmesh();
 
-  VMesh::size_type num_elems = imesh->num_elems();
+  const VMesh::size_type num_elems = imesh->num_elems();
+  const size_t num_values = iso_values_.size();
 
-  index_type start = (proc)*(num_elems/nproc);
-  index_type end = (proc < nproc-1) ? (proc+1)*(num_elems/nproc) : num_elems;
+  const index_type start = (num_elems*proc)/np_;
+  const index_type end = (num_elems*(proc+1))/np_;
 
   index_type cnt = 0;
-  size_type total = (num_elems*iso_values_.size()/nproc);
-  index_type offset = (num_elems*iso/nproc);
-  double isoval = iso_values_[iso];
 
   for(VMesh::Elem::index_type idx= start ; idx<end; idx++)
   {
-    tesselator_[proc]->extract(idx, isoval);
+    for (size_t iso=0; iso<num_values; iso++)
+    {
+      tesselator_[iso*np_+proc]->extract(idx, iso_values_[iso]);
+    }
     if (proc == 0)
     {
       cnt++;
       if (cnt == 300)
       {
         cnt = 0;
-        algo_->update_progress(idx+offset/total);
+        algo_->update_progress_max(idx-start, end-start);
       }
     }
   }
+}
 
-  output_field_[iso*nproc+proc] = nullptr;
-  output_interpolant_matrix_[iso*nproc+proc] = nullptr;
-  output_parent_cell_matrix_[iso*nproc+proc] = nullptr;
-
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-   output_geometry_[iso*nproc+proc] = 0;
-  #endif
+// Merges the range outputs of one iso value. Nodes are matched on the edge (or
+// node) of the input mesh they were created from, and ranges are merged in cell
+// order, so the result is the same as a single threaded extraction.
+template<class TESSELATOR>
+void MarchingCubesAlgoP<TESSELATOR>::stitch(size_t iso)
+{
+  const double isoval = iso_values_[iso];
+  auto& node_keys = output_node_keys_[iso];
+  auto& elem_keys = output_elem_keys_[iso];
 
-  if (build_field_)
-  {
-    output_field_[iso*nproc+proc] = tesselator_[proc]->get_field(isoval);
-  }
-  if (build_node_interpolant_)
+  if (np_ == 1)
   {
-    output_interpolant_matrix_[iso*nproc+proc] = tesselator_[proc]->get_interpolant();
-  }
-  if (build_elem_interpolant_)
-  {
-    output_parent_cell_matrix_[iso*nproc+proc] = tesselator_[proc]->get_parent_cells();
+    output_field_[iso] = tesselator_[iso]->get_field(isoval);
+    node_keys = tesselator_[iso]->node_keys();
+    elem_keys = tesselator_[iso]->elem_keys();
+    return;
   }
 
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if (build_geometry_)
+  FieldHandle output;
+  VMesh* omesh = nullptr;
+
+  BaseMC::edge_hash_type merged_nodes;
+  std::vector<index_type> local_to_merged;
+  VMesh::Node::array_type nodes;
+  Core::Geometry::Point p;
+
+  for (int proc=0; proc<np_; proc++)
   {
-    MaterialHandle mathandle;
-    ColorMapHandle colormap;
-    colormap = algo_->get_colormap("colormap");
-    if (colormap.get_rep())
+    const auto& tesselator = *tesselator_[iso*np_+proc];
+    FieldHandle part = tesselator_[iso*np_+proc]->get_field(isoval);
+    VMesh* pmesh = part->vmesh();
+
+    if (!output)
     {
-      mathandle = colormap->lookup(isoval);
+      FieldInformation fi(part);
+      output = CreateField(fi);
+      omesh = output->vmesh();
     }
-    else
+
+    const auto part_keys = tesselator.node_keys();
+    local_to_merged.resize(part_keys.size());
+    for (size_t k=0; k<part_keys.size(); k++)
     {
-      Color color = algo_->get_color("color");
-      mathandle = new Material(color);
+      const auto loc = merged_nodes.find(part_keys[k]);
+      if (loc == merged_nodes.end())
+      {
+        pmesh->get_center(p, VMesh::Node::index_type(k));
+        const VMesh::Node::index_type nodeindex = omesh->add_point(p);
+        merged_nodes[part_keys[k]] = nodeindex;
+        node_keys.push_back(part_keys[k]);
+        local_to_merged[k] = nodeindex;
+      }
+      else
+      {
+        local_to_merged[k] = loc->second;
+      }
     }
-    if (mathandle.get_rep())
+
+    const VMesh::size_type nelems = pmesh->num_elems();
+    for (VMesh::Elem::index_type idx=0; idx<nelems; idx++)
     {
-      GeomHandle geom = tesselator_[proc]->get_geom();
-      output_geometry_[iso*nproc+proc] = new GeomMaterial(geom,mathandle);
+      pmesh->get_nodes(nodes, idx);
+      for (size_t k=0; k<nodes.size(); k++)
+        nodes[k] = local_to_merged[nodes[k]];
+      omesh->add_elem(nodes);
     }
-    else
+
+    const auto part_elem_keys = tesselator.elem_keys();
+    elem_keys.insert(elem_keys.end(), part_elem_keys.begin(), part_elem_keys.end());
+  }
+
+  output->vfield()->resize_values();
+  output->vfield()->set_all_values(isoval);
+  output_field_[iso] = output;
+}
+
+// Rows are the stitched output nodes or elements of all iso values in order;
+// each row interpolates from the one or two input nodes or cells in its key.
+template<class TESSELATOR>
+MatrixHandle MarchingCubesAlgoP<TESSELATOR>::build_interpolant(
+  const std::vector<std::vector<BaseMC::edgepair_t>>& keys, size_type ncols) const
+{
+  typedef SparseRowMatrix::Triplet T;
+  std::vector<T> tripletList;
+
+  index_type row = 0;
+  for (const auto& iso_keys : keys)
+  {
+    for (const auto& key : iso_keys)
     {
-      output_geometry_[iso*nproc+proc] = 0;
+      if (key.first >= 0)
+        tripletList.push_back(T(row, key.first, 1.0 - key.dfirst));
+      if (key.second >= 0)
+        tripletList.push_back(T(row, key.second, key.dfirst));
+      row++;
     }
   }
-  #endif
 
+  SparseRowMatrixHandle mat(new SparseRowMatrix(row, ncols));
+  mat->setFromTriplets(tripletList.begin(), tripletList.end());
+  return mat;
 }
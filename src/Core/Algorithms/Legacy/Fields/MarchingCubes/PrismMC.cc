@@ -62,7 +62,7 @@ void PrismMC::reset( int /*n*/, bool build_field, bool build_geom, bool )
     mesh_->synchronize(Mesh::FACES_E|Mesh::ELEM_NEIGHBORS_E);
     if (build_field_)
     {
-      node_map_ = std::vector<index_type>(nnodes_, -1);
+      node_map_.clear();
     }
   }
   triangles_ = 0;
@@ -117,8 +117,8 @@ void PrismMC::find_or_add_parent(index_type u0, index_type u1, double d0, index_
 VMesh::Node::index_type PrismMC::find_or_add_nodepoint(VMesh::Node::index_type &tet_node_idx)
 {
   VMesh::Node::index_type surf_node_idx;
-  index_type i = node_map_[tet_node_idx];
-  if (i != -1) surf_node_idx = VMesh::Node::index_type(i);
+  const auto loc = node_map_.find(tet_node_idx);
+  if (loc != node_map_.end()) surf_node_idx = VMesh::Node::index_type(loc->second);
   else
   {
     Point p;
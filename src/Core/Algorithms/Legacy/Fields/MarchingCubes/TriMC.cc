@@ -60,7 +60,7 @@ void  TriMC::reset( int /*n*/, bool build_field, bool build_geom, bool )
     mesh_->synchronize(Mesh::EDGES_E|Mesh::ELEM_NEIGHBORS_E);
     if (build_field_)
     {
-      node_map_ = std::vector<SCIRun::index_type>(nsize, -1);
+      node_map_.clear();
     }
   }
 
@@ -88,8 +88,8 @@ void  TriMC::reset( int /*n*/, bool build_field, bool build_geom, bool )
 VMesh::Node::index_type TriMC::find_or_add_nodepoint(VMesh::Node::index_type &tri_node_idx)
 {
   VMesh::Node::index_type curve_node_idx;
-  SCIRun::index_type i = node_map_[tri_node_idx];
-  if (i != -1) curve_node_idx = VMesh::Node::index_type(i);
+  const auto loc = node_map_.find(tri_node_idx);
+  if (loc != node_map_.end()) curve_node_idx = VMesh::Node::index_type(loc->second);
   else
   {
     Point p;
@@ -68,6 +68,7 @@ ExtractSimpleIsosurfaceAlgo::ExtractSimpleIsosurfaceAlgo()
   addParameter(Parameters::ManualMaximumIsovalue, 0.0);
   addParameter(Parameters::ManualMinimumIsovalue, 0.0);
   addOption(Parameters::IsovalueChoice, "Single", "Single|List|Quantity");
+  addParameter(Parameters::num_threads, -1);
 }
 
 bool ExtractSimpleIsosurfaceAlgo::run(FieldHandle input, const std::vector<double>& isovalues, FieldHandle& output) const
@@ -79,6 +80,7 @@ bool ExtractSimpleIsosurfaceAlgo::run(FieldHandle input, const std::vector<doubl
 
   MarchingCubesAlgo marching_;
   marching_.set(Parameters::build_field, true);
+  marching_.set(Parameters::num_threads, get(Parameters::num_threads).toInt());
   marching_.run(input, isovalues, output);
 
   return (true);
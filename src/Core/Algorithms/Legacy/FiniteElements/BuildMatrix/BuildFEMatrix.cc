@@ -66,14 +66,41 @@ namespace SCIRun {
         template <typename T>
         using matrix_pointer_type = SharedPointer<matrix_type<T>>;
 
+/// Compressed row structure of a stiffness matrix together with the mesh it
+/// was derived from. Conductivities only change the values, not the structure.
+struct FEMatrixSparsityPattern
+{
+  Datatype::id_type mesh_id = -1;
+  size_type num_nodes = 0;
+  size_type num_elems = 0;
+  std::vector<index_type> rows;
+  std::vector<index_type> columns;
+
+  void update_key(const Field& field)
+  {
+    auto vmesh = field.vmesh();
+    const auto id = field.mesh()->id();
+    if (id != mesh_id || vmesh->num_nodes() != num_nodes || vmesh->num_elems() != num_elems)
+    {
+      mesh_id = id;
+      num_nodes = vmesh->num_nodes();
+      num_elems = vmesh->num_elems();
+      rows.clear();
+      columns.clear();
+    }
+  }
+};
+
 template <typename T>
 class BuildFEMatrixAlgoImpl
 {
 public:
-  explicit BuildFEMatrixAlgoImpl(const AlgorithmBase* algo) : algo_(algo) {}
+  BuildFEMatrixAlgoImpl(const AlgorithmBase* algo, SharedPointer<FEMatrixSparsityPattern> pattern) :
+    algo_(algo), pattern_(pattern) {}
   bool run(FieldHandle input, Datatypes::DenseMatrixHandle ctable, matrix_pointer_type<T>& output) const;
 private:
   const AlgorithmBase* algo_;
+  SharedPointer<FEMatrixSparsityPattern> pattern_;
   mutable int generation_ = 0;
   mutable std::vector<std::vector<T>> basis_values_;
   mutable matrix_pointer_type<T> basis_fematrix_;
@@ -84,9 +111,10 @@ template <typename T>
 class FEMBuilder
 {
 public:
-  explicit FEMBuilder(const AlgorithmBase* algo) :
+  FEMBuilder(const AlgorithmBase* algo, SharedPointer<FEMatrixSparsityPattern> pattern) :
     algo_(algo), numprocessors_(Parallel::NumCores()),
     barrier_("FEMBuilder Barrier", numprocessors_),
+    pattern_(pattern), reuse_pattern_(false),
     mesh_(nullptr), field_(nullptr),
     domain_dimension(0), local_dimension_nodes(0),
     local_dimension_add_nodes(0),
@@ -108,6 +136,10 @@ private:
   int numprocessors_;
   Barrier barrier_;
 
+  // Structure of a previous matrix on the same mesh; filled in on the first build
+  SharedPointer<FEMatrixSparsityPattern> pattern_;
+  bool reuse_pattern_;
+
   VMesh* mesh_;
   VField *field_;
 
@@ -137,6 +169,8 @@ private:
 
   // Entry point for the parallel version
   void parallel(int proc);
+  // Symbolic pass: maps out the nonzeros of each row and creates fematrix_
+  bool build_pattern(int proc, index_type start_gd, index_type end_gd);
 
   void add_lcl_gbl(index_type row, const std::vector<index_type> &cols, const std::vector<T> &lcl_a)
   {
@@ -669,10 +703,14 @@ FEMBuilder<T>::setup()
     algo_->error("Mesh size < 0");
     success_[0] = false;
   }
-  LOG_DEBUG("Allocating buffer for nonzero row indices of size: {}", global_dimension+1);
-  rows_.reset(new index_type[global_dimension+1]);
+  reuse_pattern_ = pattern_ && pattern_->rows.size() == static_cast<size_t>(global_dimension+1);
+  if (!reuse_pattern_)
+  {
+    LOG_DEBUG("Allocating buffer for nonzero row indices of size: {}", global_dimension+1);
+    rows_.reset(new index_type[global_dimension+1]);
 
-  colidx_.resize(numprocessors_+1);
+    colidx_.resize(numprocessors_+1);
+  }
   return true;
 }
 
@@ -714,6 +752,207 @@ FEMBuilder<T>::parallel(int proc_num)
   const index_type start_gd = (global_dimension * proc_num)/numprocessors_;
   const index_type end_gd  = (global_dimension * (proc_num+1))/numprocessors_;
 
+  if (reuse_pattern_)
+  {
+    try
+    {
+      /// the main thread lays out the matrix from the cached structure
+      if (proc_num == 0)
+      {
+        fematrix_ = makeShared<matrix_type<T>>(global_dimension, global_dimension);
+        fematrix_->resizeNonZeros(pattern_->columns.size());
+        std::copy(pattern_->rows.begin(), pattern_->rows.end(), fematrix_->outerIndexPtr());
+        std::copy(pattern_->columns.begin(), pattern_->columns.end(), fematrix_->innerIndexPtr());
+      }
+      success_[proc_num] = true;
+    }
+    catch (...)
+    {
+      algo_->error("BuildFEMatrix crashed while creating final stiffness matrix");
+      success_[proc_num] = false;
+    }
+
+    /// check point
+    barrier_.wait();
+
+    // Bail out if one of the processes failed
+    for (auto q=0; q<numprocessors_;q++)
+    {
+      if (!success_[q])
+        return;
+    }
+  }
+  else if (!build_pattern(proc_num, start_gd, end_gd))
+  {
+    return;
+  }
+
+  VMesh::Elem::array_type ca;
+  VMesh::Node::array_type na;
+  VMesh::Edge::array_type ea;
+  std::vector<index_type> neib_dofs;
+  std::vector<std::vector<T>> precompute;
+
+  int cnt = 0;
+  const size_type size_gd = end_gd-start_gd;
+  const auto updateFrequency = 2*size_gd / 100;
+
+  try
+  {
+    /// zeroing in parallel
+    const auto ns = fematrix_->outerIndexPtr()[start_gd];
+    const auto ne = fematrix_->outerIndexPtr()[end_gd];
+    auto a = &(fematrix_->valuePtr()[ns]), ae=&(fematrix_->valuePtr()[ne]);
+    while (a<ae) *a++=0.0;
+
+    std::vector<VMesh::coords_type> ni_points;
+    std::vector<double> ni_weights;
+    std::vector<std::vector<double>> ni_derivatives;
+
+    create_numerical_integration(ni_points, ni_weights, ni_derivatives);
+
+    std::vector<T> lsml; ///< line of local stiffnes matrix
+    lsml.resize(local_dimension);
+
+    /// loop over system dofs for this thread
+    for (VMesh::Node::index_type i = start_gd; i<end_gd; ++i)
+    {
+      if (i < global_dimension_nodes)
+      {
+        /// check for nodes
+        /// get neighboring cells for node
+        mesh_->get_elems(ca,i);
+      }
+      else if (i < global_dimension_nodes + global_dimension_add_nodes)
+      {
+        /// check for additional nodes at edges
+        /// get neighboring cells for additional nodes
+        VMesh::Edge::index_type ii(i-global_dimension_nodes);
+        mesh_->get_elems(ca,ii);
+      }
+      else
+      {
+        // There is some functionality implemented for higher order basis functions,
+        // but it seems not to be accessible, entirely implemented nor validated.
+        algo_->warning("BuildFEMatrix only supports linear basis functions.");
+      }
+
+      /// loop over elements attributed elements
+
+      if (mesh_->is_regularmesh())
+      {
+        for (size_t j = 0; j < ca.size(); j++)
+        {
+          mesh_->get_nodes(na, ca[j]); ///< get neighboring nodes
+          neib_dofs.resize(na.size());
+          for(size_t k = 0; k < na.size(); k++)
+          {
+            neib_dofs[k] = na[k]; // Must cast to (int) for SGI compiler :-(
+          }
+
+          for(size_t k = 0; k < na.size(); k++)
+          {
+            if (na[k] == i)
+            {
+              auto successLocal = build_local_matrix_regular(ca[j], k , lsml, ni_points, ni_weights, ni_derivatives,precompute);
+							if (!successLocal)
+							{
+								success_[proc_num] = false;
+								return;
+							}
+              add_lcl_gbl(i, neib_dofs, lsml);
+            }
+          }
+        }
+      }
+      else
+      {
+        for (size_t j = 0; j < ca.size(); j++)
+        {
+          neib_dofs.clear();
+          mesh_->get_nodes(na, ca[j]); ///< get neighboring nodes
+          for(size_t k = 0; k < na.size(); k++)
+          {
+            neib_dofs.push_back(na[k]); // Must cast to (int) for SGI compiler :-(
+          }
+          /// check for additional nodes at edges
+          if (global_dimension_add_nodes)
+          {
+            mesh_->get_edges(ea, ca[j]); ///< get neighboring edges
+            for(size_t k = 0; k < ea.size(); k++)
+            {
+              neib_dofs.push_back(global_dimension + ea[k]);
+            }
+          }
+
+          ASSERT(static_cast<int>(neib_dofs.size()) == local_dimension);
+
+          for(size_t k = 0; k < na.size(); k++)
+          {
+            if (na[k] == i)
+            {
+              auto successLocal = build_local_matrix(ca[j], k , lsml, ni_points, ni_weights, ni_derivatives);
+							if (!successLocal)
+							{
+								success_[proc_num] = false;
+								return;
+							}
+              add_lcl_gbl(i, neib_dofs, lsml);
+            }
+          }
+
+          if (global_dimension_add_nodes)
+          {
+            for (size_t k = 0; k < ea.size(); k++)
+            {
+              if (global_dimension + static_cast<int>(ea[k]) == i)
+              {
+                auto successLocal = build_local_matrix(ca[j], k+na.size(), lsml, ni_points, ni_weights, ni_derivatives);
+								if (!successLocal)
+								{
+									success_[proc_num] = false;
+									return;
+								}
+                add_lcl_gbl(i, neib_dofs, lsml);
+              }
+            }
+          }
+        }
+      }
+
+      if (proc_num == 0)
+      {
+        cnt++;
+        if (cnt == updateFrequency)
+        {
+          cnt = 0;
+          algo_->update_progress_max(i+size_gd,2*size_gd);
+        }
+      }
+    }
+    success_[proc_num] = true;
+  }
+  catch (...)
+  {
+    algo_->error("BuildFEMatrix crashed while filling out stiffness matrix");
+    success_[proc_num] = false;
+  }
+
+  barrier_.wait();
+
+  // Bail out if one of the processes failed
+  for (int q=0; q<numprocessors_; q++)
+  {
+    if (!success_[q])
+      return;
+  }
+}
+
+// -- symbolic pass, skipped when the pattern of this mesh is cached
+template <typename T>
+bool
+FEMBuilder<T>::build_pattern(int proc_num, index_type start_gd, index_type end_gd)
+{
   /// creating sparse matrix structure
   std::vector<index_type> mycols;
 
@@ -813,11 +1052,10 @@ FEMBuilder<T>::parallel(int proc_num)
   {
     if (!success_[q])
     {
-      return;
+      return false;
     }
   }
 
-  std::vector<std::vector<T>> precompute;
   index_type st = 0;
 
   if (proc_num == 0)
@@ -855,7 +1093,7 @@ FEMBuilder<T>::parallel(int proc_num)
   for (int q=0; q<numprocessors_;q++)
   {
     if (! success_[q])
-      return;
+      return false;
   }
 
   try
@@ -885,7 +1123,7 @@ FEMBuilder<T>::parallel(int proc_num)
   for (auto q=0; q<numprocessors_; q++)
   {
     if (!success_[q])
-      return;
+      return false;
   }
 
   try
@@ -896,6 +1134,11 @@ FEMBuilder<T>::parallel(int proc_num)
       rows_[global_dimension] = st;
       algo_->remark("Creating fematrix on main thread.");
       fematrix_ = makeShared<matrix_type<T>>(global_dimension, global_dimension, rows_.get(), allcols_.get(), st);
+      if (pattern_)
+      {
+        pattern_->rows.assign(fematrix_->outerIndexPtr(), fematrix_->outerIndexPtr() + global_dimension + 1);
+        pattern_->columns.assign(fematrix_->innerIndexPtr(), fematrix_->innerIndexPtr() + fematrix_->nonZeros());
+      }
       rows_.reset();
       allcols_.reset();
     }
@@ -914,160 +1157,9 @@ FEMBuilder<T>::parallel(int proc_num)
   for (auto q=0; q<numprocessors_;q++)
   {
     if (!success_[q])
-      return;
-  }
-
-  try
-  {
-    /// zeroing in parallel
-    const auto ns = colidx_[proc_num];
-    const auto ne = colidx_[proc_num+1];
-    auto a = &(fematrix_->valuePtr()[ns]), ae=&(fematrix_->valuePtr()[ne]);
-    while (a<ae) *a++=0.0;
-
-    std::vector<VMesh::coords_type> ni_points;
-    std::vector<double> ni_weights;
-    std::vector<std::vector<double>> ni_derivatives;
-
-    create_numerical_integration(ni_points, ni_weights, ni_derivatives);
-
-    std::vector<T> lsml; ///< line of local stiffnes matrix
-    lsml.resize(local_dimension);
-
-    /// loop over system dofs for this thread
-    cnt = 0;
-    size_gd = end_gd-start_gd;
-    for (VMesh::Node::index_type i = start_gd; i<end_gd; ++i)
-    {
-      if (i < global_dimension_nodes)
-      {
-        /// check for nodes
-        /// get neighboring cells for node
-        mesh_->get_elems(ca,i);
-      }
-      else if (i < global_dimension_nodes + global_dimension_add_nodes)
-      {
-        /// check for additional nodes at edges
-        /// get neighboring cells for additional nodes
-        VMesh::Edge::index_type ii(i-global_dimension_nodes);
-        mesh_->get_elems(ca,ii);
-      }
-      else
-      {
-        // There is some functionality implemented for higher order basis functions,
-        // but it seems not to be accessible, entirely implemented nor validated.
-        algo_->warning("BuildFEMatrix only supports linear basis functions.");
-      }
-
-      /// loop over elements attributed elements
-
-      if (mesh_->is_regularmesh())
-      {
-        for (size_t j = 0; j < ca.size(); j++)
-        {
-          mesh_->get_nodes(na, ca[j]); ///< get neighboring nodes
-          neib_dofs.resize(na.size());
-          for(size_t k = 0; k < na.size(); k++)
-          {
-            neib_dofs[k] = na[k]; // Must cast to (int) for SGI compiler :-(
-          }
-
-          for(size_t k = 0; k < na.size(); k++)
-          {
-            if (na[k] == i)
-            {
-              auto successLocal = build_local_matrix_regular(ca[j], k , lsml, ni_points, ni_weights, ni_derivatives,precompute);
-							if (!successLocal)
-							{
-								success_[proc_num] = false;
-								return;
-							}
-              add_lcl_gbl(i, neib_dofs, lsml);
-            }
-          }
-        }
-      }
-      else
-      {
-        for (size_t j = 0; j < ca.size(); j++)
-        {
-          neib_dofs.clear();
-          mesh_->get_nodes(na, ca[j]); ///< get neighboring nodes
-          for(size_t k = 0; k < na.size(); k++)
-          {
-            neib_dofs.push_back(na[k]); // Must cast to (int) for SGI compiler :-(
-          }
-          /// check for additional nodes at edges
-          if (global_dimension_add_nodes)
-          {
-            mesh_->get_edges(ea, ca[j]); ///< get neighboring edges
-            for(size_t k = 0; k < ea.size(); k++)
-            {
-              neib_dofs.push_back(global_dimension + ea[k]);
-            }
-          }
-
-          ASSERT(static_cast<int>(neib_dofs.size()) == local_dimension);
-
-          for(size_t k = 0; k < na.size(); k++)
-          {
-            if (na[k] == i)
-            {
-              auto successLocal = build_local_matrix(ca[j], k , lsml, ni_points, ni_weights, ni_derivatives);
-							if (!successLocal)
-							{
-								success_[proc_num] = false;
-								return;
-							}
-              add_lcl_gbl(i, neib_dofs, lsml);
-            }
-          }
-
-          if (global_dimension_add_nodes)
-          {
-            for (size_t k = 0; k < ea.size(); k++)
-            {
-              if (global_dimension + static_cast<int>(ea[k]) == i)
-              {
-                auto successLocal = build_local_matrix(ca[j], k+na.size(), lsml, ni_points, ni_weights, ni_derivatives);
-								if (!successLocal)
-								{
-									success_[proc_num] = false;
-									return;
-								}
-                add_lcl_gbl(i, neib_dofs, lsml);
-              }
-            }
-          }
-        }
-      }
-
-      if (proc_num == 0)
-      {
-        cnt++;
-        if (cnt == updateFrequency)
-        {
-          cnt = 0;
-          algo_->update_progress_max(i+size_gd,2*size_gd);
-        }
-      }
-    }
-    success_[proc_num] = true;
-  }
-  catch (...)
-  {
-    algo_->error("BuildFEMatrix crashed while filling out stiffness matrix");
-    success_[proc_num] = false;
-  }
-
-  barrier_.wait();
-
-  // Bail out if one of the processes failed
-  for (int q=0; q<numprocessors_; q++)
-  {
-    if (!success_[q])
-      return;
+      return false;
   }
+  return true;
 }
 
 const AlgorithmParameterName BuildFEMatrixAlgo::ForceSymmetry("ForceSymmetry");
@@ -1111,7 +1203,10 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     }
   }
 
-  FEMBuilder<T> builder(algo_);
+  if (pattern_)
+    pattern_->update_key(*input);
+
+  FEMBuilder<T> builder(algo_, pattern_);
 
   if (algo_->get(BuildFEMatrixAlgo::GenerateBasis).toBool())
   {
@@ -1237,11 +1332,14 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
   auto field = input.get<Field>(Variables::InputField);
   auto ctable = input.get<DenseMatrix>(Conductivity_Table);
 
+  if (!pattern_)
+    pattern_ = makeShared<FEMatrixSparsityPattern>();
+
 	AlgorithmOutput output;
   if (field && field->vfield() && field->vfield()->is_complex_double())
 	{
 		matrix_pointer_type<complex> stiffness;
-	  BuildFEMatrixAlgoImpl<complex> impl(this);
+	  BuildFEMatrixAlgoImpl<complex> impl(this, pattern_);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.--complex detected	");
 		output[Stiffness_Matrix_Complex] = stiffness;
@@ -1249,7 +1347,7 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
 	else
 	{
 		matrix_pointer_type<double> stiffness;
-	  BuildFEMatrixAlgoImpl<double> impl(this);
+	  BuildFEMatrixAlgoImpl<double> impl(this, pattern_);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
 		output[Stiffness_Matrix] = stiffness;
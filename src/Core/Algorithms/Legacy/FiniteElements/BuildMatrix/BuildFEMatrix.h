@@ -38,6 +38,8 @@ namespace SCIRun {
 		namespace Algorithms {
 			namespace FiniteElements {
 
+struct FEMatrixSparsityPattern;
+
 class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
 {
   public:
@@ -61,6 +63,12 @@ class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
     }
 
     AlgorithmOutput run(const AlgorithmInput &) const override;
+
+  private:
+    // Row/column structure of the last stiffness matrix. It only depends on the
+    // mesh, so rerunning with new conductivities or tensors skips the symbolic
+    // pass and only redoes the numerical integration.
+    mutable SharedPointer<FEMatrixSparsityPattern> pattern_;
 };
 
 }}}}
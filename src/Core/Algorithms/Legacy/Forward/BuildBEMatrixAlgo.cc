@@ -38,11 +38,13 @@
 #include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <iostream>
 #include <string>
 #include <fstream>
 #include <numeric>
+#include <unordered_map>
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm/copy.hpp>
 
@@ -54,17 +56,21 @@
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Forward;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 ALGORITHM_PARAMETER_DEF(Forward, FieldNameList);
 ALGORITHM_PARAMETER_DEF(Forward, FieldTypeList);
 ALGORITHM_PARAMETER_DEF(Forward, BoundaryConditionList);
 ALGORITHM_PARAMETER_DEF(Forward, InsideConductivityList);
 ALGORITHM_PARAMETER_DEF(Forward, OutsideConductivityList);
+ALGORITHM_PARAMETER_DEF(Forward, CompressPointOperators);
+ALGORITHM_PARAMETER_DEF(Forward, CompressionTolerance);
 
 void BuildBEMatrixBase::getOmega(
   const Vector& y1,
@@ -491,6 +497,156 @@ double BuildBEMatrixBase::do_radon_g(
   return g2 * aV.length();
 }
 
+namespace
+{
+  // Plain copy of a surface, so the assembly threads only read shared arrays
+  struct SurfaceGeometry
+  {
+    explicit SurfaceGeometry(VMesh* mesh)
+    {
+      VMesh::Node::size_type nnodes;
+      VMesh::Face::size_type nfaces;
+      mesh->size(nnodes);
+      mesh->size(nfaces);
+      points.resize(nnodes);
+      faces.resize(nfaces);
+      for (VMesh::index_type i = 0; i < nnodes; ++i)
+        points[i] = Vector(mesh->get_point(VMesh::Node::index_type(i)));
+
+      VMesh::Node::array_type nodes;
+      for (VMesh::index_type f = 0; f < nfaces; ++f)
+      {
+        mesh->get_nodes(nodes, VMesh::Face::index_type(f));
+        for (int k = 0; k < 3; ++k)
+          faces[f][k] = nodes[k];
+      }
+    }
+
+    // Faces touching each node, in face order
+    void buildNodeFaces()
+    {
+      nodeFaces.assign(points.size(), std::vector<index_type>());
+      for (size_t f = 0; f < faces.size(); ++f)
+        for (auto n : faces[f])
+          nodeFaces[n].push_back(f);
+    }
+
+    int corner(size_t face, index_type node) const
+    {
+      for (int k = 0; k < 3; ++k)
+        if (faces[face][k] == node)
+          return k;
+      return -1;
+    }
+
+    std::vector<Vector> points;
+    std::vector<std::array<index_type, 3>> faces;
+    std::vector<std::vector<index_type>> nodeFaces;
+  };
+
+  // Radon's 7 point quadrature rule for triangles
+  struct RadonRule
+  {
+    RadonRule() : weights(1, 7)
+    {
+      const double sqrt15 = sqrt(15.0);
+      weights(0,0) = 9.0/40.0;
+      weights(0,1) = (155 + sqrt15) / 1200;
+      weights(0,2) = weights(0,1);
+      weights(0,3) = weights(0,1);
+      weights(0,4) = (155 - sqrt15) / 1200;
+      weights(0,5) = weights(0,4);
+      weights(0,6) = weights(0,4);
+      s = (1 - sqrt15) / 7;
+      r = (1 + sqrt15) / 7;
+    }
+
+    DenseMatrix weights;
+    double s, r;
+  };
+
+  // Faces touching any of the given nodes, each once and in face order
+  std::vector<index_type> facesTouching(const SurfaceGeometry& surf, const std::vector<index_type>& nodes)
+  {
+    std::vector<index_type> result;
+    for (auto n : nodes)
+      result.insert(result.end(), surf.nodeFaces[n].begin(), surf.nodeFaces[n].end());
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+  }
+
+  // Faces touching the columns of one compressed block, set up once per block: the
+  // position in the block of every corner (-1 outside it), and the faces and corners
+  // touching every column.
+  struct BlockFaces
+  {
+    BlockFaces(const SurfaceGeometry& surf, const std::vector<index_type>& cols) :
+      faces(facesTouching(surf, cols)), corners(faces.size()), incidence(cols.size())
+    {
+      std::unordered_map<index_type, index_type> position;
+      for (size_t j = 0; j < cols.size(); ++j)
+        position[cols[j]] = j;
+
+      for (size_t k = 0; k < faces.size(); ++k)
+      {
+        for (int i = 0; i < 3; ++i)
+        {
+          auto p = position.find(surf.faces[faces[k]][i]);
+          corners[k][i] = p != position.end() ? p->second : -1;
+          if (p != position.end())
+            incidence[p->second].emplace_back(k, i);
+        }
+      }
+    }
+
+    // Sums values(face, row position, corner values) of the faces touching the requested
+    // columns; values returns false for faces that do not contribute to that row.
+    template <class FaceValues>
+    void sum(const std::vector<index_type>& rowPositions, const std::vector<index_type>& colPositions,
+      Eigen::MatrixXd& block, FaceValues values) const
+    {
+      block.setZero(rowPositions.size(), colPositions.size());
+      std::array<double, 3> v;
+
+      // A single column, as cross approximation asks for, only needs its own faces
+      if (colPositions.size() == 1)
+      {
+        for (const auto& fc : incidence[colPositions[0]])
+          for (size_t r = 0; r < rowPositions.size(); ++r)
+            if (values(faces[fc.first], rowPositions[r], v))
+              block(r, 0) += v[fc.second];
+        return;
+      }
+
+      std::vector<index_type> slot(incidence.size(), -1);
+      for (size_t c = 0; c < colPositions.size(); ++c)
+        slot[colPositions[c]] = c;
+
+      for (size_t k = 0; k < faces.size(); ++k)
+      {
+        std::array<index_type, 3> column;
+        for (int i = 0; i < 3; ++i)
+          column[i] = corners[k][i] >= 0 ? slot[corners[k][i]] : -1;
+        if (column[0] < 0 && column[1] < 0 && column[2] < 0)
+          continue;
+        for (size_t r = 0; r < rowPositions.size(); ++r)
+        {
+          if (!values(faces[k], rowPositions[r], v))
+            continue;
+          for (int i = 0; i < 3; ++i)
+            if (column[i] >= 0)
+              block(r, column[i]) += v[i];
+        }
+      }
+    }
+
+    std::vector<index_type> faces;
+    std::vector<std::array<index_type, 3>> corners;
+    std::vector<std::vector<std::pair<size_t, int>>> incidence;
+  };
+}
+
 class BuildBEMatrixBaseCompute : public BuildBEMatrixBase
 {
 public:
@@ -510,8 +666,70 @@ public:
   double,
   double,
   const std::vector<double>& );
+
+  static HierarchicalMatrixHandle make_P_compressed(VMesh* hsurf1, VMesh* hsurf2, bool self,
+    double in_cond, double out_cond, const HierarchicalMatrix::Options& options);
+
+  static HierarchicalMatrixHandle make_G_compressed(VMesh* hsurf1, VMesh* hsurf2, bool self,
+    double in_cond, double out_cond, const std::vector<double>& avInn, const HierarchicalMatrix::Options& options);
+
+private:
+  struct FaceWeights
+  {
+    DenseMatrix cruse_weights;
+    Vector centroid;
+    double area;
+  };
+
+  static std::vector<FaceWeights> face_weights(const SurfaceGeometry& surf, const RadonRule& rule, const std::vector<double>& avInn);
+
+  //! G values of one triangle seen from op; corner is the vertex op sits on, or -1
+  static void face_g_values(const SurfaceGeometry& surf, size_t face, const FaceWeights& weights,
+    const RadonRule& rule, const Vector& op, int corner, DenseMatrix& g_coef, DenseMatrix& temp, DenseMatrix& g_values);
 };
 
+std::vector<BuildBEMatrixBaseCompute::FaceWeights> BuildBEMatrixBaseCompute::face_weights(
+  const SurfaceGeometry& surf, const RadonRule& rule, const std::vector<double>& avInn)
+{
+  std::vector<FaceWeights> result(surf.faces.size());
+  Parallel::For(0, static_cast<std::int64_t>(surf.faces.size()), [&](std::int64_t begin, std::int64_t end)
+  {
+    for (auto f = begin; f < end; ++f)
+    {
+      const auto& face = surf.faces[f];
+      const auto& p1 = surf.points[face[0]];
+      const auto& p2 = surf.points[face[1]];
+      const auto& p3 = surf.points[face[2]];
+      result[f].area = avInn[f];
+      result[f].cruse_weights.resize(3, 7);
+      get_cruse_weights(p1, p2, p3, rule.s, rule.r, result[f].area, result[f].cruse_weights);
+      result[f].centroid = (p1 + p2 + p3) / 3.0;
+    }
+  });
+  return result;
+}
+
+void BuildBEMatrixBaseCompute::face_g_values(const SurfaceGeometry& surf, size_t face, const FaceWeights& weights,
+  const RadonRule& rule, const Vector& op, int corner, DenseMatrix& g_coef, DenseMatrix& temp, DenseMatrix& g_values)
+{
+  const auto& p1 = surf.points[surf.faces[face][0]];
+  const auto& p2 = surf.points[surf.faces[face][1]];
+  const auto& p3 = surf.points[surf.faces[face][2]];
+
+  if (corner >= 0)
+  {
+    bem_sing(p1, p2, p3, corner, g_values);
+  }
+  else
+  {
+    get_g_coef(p1, p2, p3, op, rule.s, rule.r, weights.centroid, g_coef);
+
+    for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*rule.weights(0,i);
+
+    g_values = weights.area * (weights.cruse_weights * temp.transpose());
+  }
+}
+
 void BuildBEMatrixBase::make_auto_G_allocate(VMesh* hsurf, DenseMatrixHandle &h_GG_)
 {
   auto nnodes = numNodes(hsurf);
@@ -532,66 +750,29 @@ void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& aut
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
+  const SurfaceGeometry surf(hsurf);
+  const RadonRule rule;
+  const auto weights = face_weights(surf, rule, avInn);
 
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-
-  hsurf->begin(fi); hsurf->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf->get_nodes(nodes, *fi);
-    Vector p1(hsurf->get_point(nodes[0]));
-    Vector p2(hsurf->get_point(nodes[1]));
-    Vector p3(hsurf->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-    hsurf->begin(ni); hsurf->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf->get_point(ppi));
-
-      if (ppi == nodes[0])       bem_sing(p1, p2, p3, 0, g_values);
-      else if (ppi == nodes[1])       bem_sing(p1, p2, p3, 1, g_values);
-      else if (ppi == nodes[2])       bem_sing(p1, p2, p3, 2, g_values);
-      else
-      {
-        get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
-
-        for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
+  //! every thread owns a range of rows; faces are visited in mesh order so the sums match the serial code
+  Parallel::For(0, static_cast<std::int64_t>(surf.points.size()), [&](std::int64_t begin, std::int64_t end)
+  {
+    DenseMatrix g_coef(1, 7);
+    DenseMatrix temp(1,7);
+    DenseMatrix g_values(3, 1);
 
-        g_values = area * (cruse_weights * temp.transpose());
-      } // else
+    for (size_t f = 0; f < surf.faces.size(); ++f)
+    { //! find contributions from every triangle
+      const auto& nodes = surf.faces[f];
+      for (auto ppi = begin; ppi < end; ++ppi)
+      { //! for every node
+        face_g_values(surf, f, weights[f], rule, surf.points[ppi], surf.corner(f, ppi), g_coef, temp, g_values);
 
-      for (int i=0; i<3; ++i)
-        auto_G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))+=g_values(i,0)*mult;
+        for (int i=0; i<3; ++i)
+          auto_G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))+=g_values(i,0)*mult;
+      }
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_G_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_)
@@ -613,60 +794,29 @@ void BuildBEMatrixBaseCompute::make_cross_G_compute(VMesh* hsurf1, VMesh* hsurf2
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-  hsurf2->begin(fi); hsurf2->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf2->get_nodes(nodes, *fi);
-    Vector p1(hsurf2->get_point(nodes[0]));
-    Vector p2(hsurf2->get_point(nodes[1]));
-    Vector p3(hsurf2->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-
-    hsurf1->begin(ni); hsurf1->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf1->get_point(ppi));
-      get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
+  const SurfaceGeometry target(hsurf1);
+  const SurfaceGeometry surf(hsurf2);
+  const RadonRule rule;
+  const auto weights = face_weights(surf, rule, avInn);
 
-      for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
+  Parallel::For(0, static_cast<std::int64_t>(target.points.size()), [&](std::int64_t begin, std::int64_t end)
+  {
+    DenseMatrix g_coef(1, 7);
+    DenseMatrix temp(1,7);
+    DenseMatrix g_values(3, 1);
 
-      g_values = area * (cruse_weights * temp.transpose());
+    for (size_t f = 0; f < surf.faces.size(); ++f)
+    { //! find contributions from every triangle
+      const auto& nodes = surf.faces[f];
+      for (auto ppi = begin; ppi < end; ++ppi)
+      { //! for every node
+        face_g_values(surf, f, weights[f], rule, target.points[ppi], -1, g_coef, temp, g_values);
 
-      for (int i=0; i<3; ++i)
-        cross_G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))+=g_values(i,0)*mult;
+        for (int i=0; i<3; ++i)
+          cross_G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))+=g_values(i,0)*mult;
+      }
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_P_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_PP_)
@@ -686,32 +836,29 @@ void BuildBEMatrixBaseCompute::make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2
 {
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-  int i;
+  const SurfaceGeometry target(hsurf1);
+  const SurfaceGeometry surf(hsurf2);
 
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  hsurf1->begin(ni); hsurf1->end(nie);
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf1->get_point(ppi);
-
-    hsurf2->begin(fi); hsurf2->end(fie);
-    for (; fi != fie; ++fi){ //! find contributions from every triangle
+  Parallel::For(0, static_cast<std::int64_t>(target.points.size()), [&](std::int64_t begin, std::int64_t end)
+  {
+    DenseMatrix coef(1, 3);
+    for (auto ppi = begin; ppi < end; ++ppi)
+    { //! for every node
+      const auto& pp = target.points[ppi];
 
-      hsurf2->get_nodes(nodes, *fi);
-      Vector v1 = hsurf2->get_point(nodes[0]) - pp;
-      Vector v2 = hsurf2->get_point(nodes[1]) - pp;
-      Vector v3 = hsurf2->get_point(nodes[2]) - pp;
+      for (const auto& nodes : surf.faces)
+      { //! find contributions from every triangle
+        Vector v1 = surf.points[nodes[0]] - pp;
+        Vector v2 = surf.points[nodes[1]] - pp;
+        Vector v3 = surf.points[nodes[2]] - pp;
 
-      getOmega(v1, v2, v3, coef);
+        getOmega(v1, v2, v3, coef);
 
-      for (i=0; i<3; ++i)
-        cross_P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))-=coef(0,i)*mult;
+        for (int i=0; i<3; ++i)
+          cross_P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))-=coef(0,i)*mult;
+      }
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_auto_P_allocate(VMesh* hsurf, DenseMatrixHandle &h_PP_)
@@ -737,44 +884,35 @@ void BuildBEMatrixBaseCompute::make_auto_P_compute(VMesh* hsurf, MatrixType& aut
 {
   auto nnodes = auto_P.rows();
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+  const SurfaceGeometry surf(hsurf);
 
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-
-  unsigned int i;
-
-  hsurf->begin(ni); hsurf->end(nie);
-
-  for (; ni != nie; ++ni)
-  { //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf->get_point(ppi);
-
-    hsurf->begin(fi); hsurf->end(fie);
+  Parallel::For(0, static_cast<std::int64_t>(surf.points.size()), [&](std::int64_t begin, std::int64_t end)
+  {
+    DenseMatrix coef(1, 3);
+    for (auto ppi = begin; ppi < end; ++ppi)
+    { //! for every node
+      const auto& pp = surf.points[ppi];
 
-    for (; fi != fie; ++fi)
-    { //! find contributions from every triangle
-      hsurf->get_nodes(nodes, *fi);
-      if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2])
-      {
-        Vector v1 = hsurf->get_point(nodes[0]) - pp;
-        Vector v2 = hsurf->get_point(nodes[1]) - pp;
-        Vector v3 = hsurf->get_point(nodes[2]) - pp;
+      for (const auto& nodes : surf.faces)
+      { //! find contributions from every triangle
+        if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2])
+        {
+          Vector v1 = surf.points[nodes[0]] - pp;
+          Vector v2 = surf.points[nodes[1]] - pp;
+          Vector v3 = surf.points[nodes[2]] - pp;
 
-        getOmega(v1, v2, v3, coef);
+          getOmega(v1, v2, v3, coef);
 
-        for (i=0; i<3; ++i)
-          auto_P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))-=coef(0,i)*mult;
+          for (int i=0; i<3; ++i)
+            auto_P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))-=coef(0,i)*mult;
+        }
       }
     }
-  }
+  });
 
   //! accounting for autosolid angle
   auto sumOfRows = auto_P.rowwise().sum().eval();
-  for (i=0; i<nnodes; ++i)
+  for (int i=0; i<nnodes; ++i)
   {
     auto_P(i,i) = out_cond - sumOfRows(i);
   }
@@ -787,6 +925,110 @@ void BuildBEMatrixBase::make_auto_P(VMesh* hsurf, DenseMatrixHandle &h_PP_,
   BuildBEMatrixBaseCompute::make_auto_P_compute(hsurf, *h_PP_, in_cond, out_cond);
 }
 
+//! The compressed operators evaluate the same integrals as the dense ones, but only for the
+//! blocks the hierarchical matrix asks for: each block visits the faces touching its columns.
+HierarchicalMatrixHandle BuildBEMatrixBaseCompute::make_P_compressed(VMesh* hsurf1, VMesh* hsurf2, bool self,
+  double in_cond, double out_cond, const HierarchicalMatrix::Options& options)
+{
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+  const SurfaceGeometry target(hsurf1);
+  SurfaceGeometry surf(hsurf2);
+  surf.buildNodeFaces();
+
+  auto generator = [&](const std::vector<index_type>& rows, const std::vector<index_type>& cols)
+  {
+    auto faces = std::make_shared<const BlockFaces>(surf, cols);
+    return HierarchicalMatrix::BlockEntries([&, rows, faces](const std::vector<index_type>& rowPositions,
+      const std::vector<index_type>& colPositions, Eigen::MatrixXd& block)
+    {
+      DenseMatrix coef(1, 3);
+      faces->sum(rowPositions, colPositions, block, [&](index_type f, index_type r, std::array<double, 3>& v)
+      {
+        if (self && surf.corner(f, rows[r]) >= 0)
+          return false;
+        const auto& nodes = surf.faces[f];
+        const auto& pp = target.points[rows[r]];
+        getOmega(surf.points[nodes[0]] - pp, surf.points[nodes[1]] - pp, surf.points[nodes[2]] - pp, coef);
+        for (int i=0; i<3; ++i)
+          v[i] = -coef(0,i)*mult;
+        return true;
+      });
+    });
+  };
+
+  std::vector<Point> rowPoints(target.points.begin(), target.points.end());
+  std::vector<Point> colPoints(surf.points.begin(), surf.points.end());
+  auto P = makeShared<HierarchicalMatrix>(rowPoints, colPoints, generator, options);
+
+  if (self)
+  {
+    //! accounting for autosolid angle
+    Eigen::VectorXd sumOfRows;
+    P->multiply(Eigen::VectorXd::Ones(P->cols()), sumOfRows);
+    P->setDiagonal(Eigen::VectorXd::Constant(P->rows(), out_cond) - sumOfRows);
+  }
+  return P;
+}
+
+HierarchicalMatrixHandle BuildBEMatrixBaseCompute::make_G_compressed(VMesh* hsurf1, VMesh* hsurf2, bool self,
+  double in_cond, double out_cond, const std::vector<double>& avInn, const HierarchicalMatrix::Options& options)
+{
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+  const SurfaceGeometry target(hsurf1);
+  SurfaceGeometry surf(hsurf2);
+  surf.buildNodeFaces();
+  const RadonRule rule;
+  const auto weights = face_weights(surf, rule, avInn);
+
+  auto generator = [&](const std::vector<index_type>& rows, const std::vector<index_type>& cols)
+  {
+    auto faces = std::make_shared<const BlockFaces>(surf, cols);
+    return HierarchicalMatrix::BlockEntries([&, rows, faces](const std::vector<index_type>& rowPositions,
+      const std::vector<index_type>& colPositions, Eigen::MatrixXd& block)
+    {
+      DenseMatrix g_coef(1, 7);
+      DenseMatrix temp(1,7);
+      DenseMatrix g_values(3, 1);
+      faces->sum(rowPositions, colPositions, block, [&](index_type f, index_type r, std::array<double, 3>& v)
+      {
+        const int corner = self ? surf.corner(f, rows[r]) : -1;
+        face_g_values(surf, f, weights[f], rule, target.points[rows[r]], corner, g_coef, temp, g_values);
+        for (int i=0; i<3; ++i)
+          v[i] = g_values(i,0)*mult;
+        return true;
+      });
+    });
+  };
+
+  std::vector<Point> rowPoints(target.points.begin(), target.points.end());
+  std::vector<Point> colPoints(surf.points.begin(), surf.points.end());
+  return makeShared<HierarchicalMatrix>(rowPoints, colPoints, generator, options);
+}
+
+HierarchicalMatrixHandle BuildBEMatrixBase::make_auto_P_compressed(VMesh* hsurf,
+  double in_cond, double out_cond, const HierarchicalMatrix::Options& options)
+{
+  return BuildBEMatrixBaseCompute::make_P_compressed(hsurf, hsurf, true, in_cond, out_cond, options);
+}
+
+HierarchicalMatrixHandle BuildBEMatrixBase::make_cross_P_compressed(VMesh* hsurf1, VMesh* hsurf2,
+  double in_cond, double out_cond, const HierarchicalMatrix::Options& options)
+{
+  return BuildBEMatrixBaseCompute::make_P_compressed(hsurf1, hsurf2, false, in_cond, out_cond, options);
+}
+
+HierarchicalMatrixHandle BuildBEMatrixBase::make_auto_G_compressed(VMesh* hsurf,
+  double in_cond, double out_cond, const std::vector<double>& avInn, const HierarchicalMatrix::Options& options)
+{
+  return BuildBEMatrixBaseCompute::make_G_compressed(hsurf, hsurf, true, in_cond, out_cond, avInn, options);
+}
+
+HierarchicalMatrixHandle BuildBEMatrixBase::make_cross_G_compressed(VMesh* hsurf1, VMesh* hsurf2,
+  double in_cond, double out_cond, const std::vector<double>& avInn, const HierarchicalMatrix::Options& options)
+{
+  return BuildBEMatrixBaseCompute::make_G_compressed(hsurf1, hsurf2, false, in_cond, out_cond, avInn, options);
+}
+
 // precalculate triangles area
 void BuildBEMatrixBase::pre_calc_tri_areas(VMesh* hsurf, std::vector<double>& areaV){
 
@@ -936,7 +1178,12 @@ bool BuildBEMatrixBase::compute_nesting(std::vector<int> &nesting, const std::ve
 class SurfaceAndPoints : public BEMAlgoImpl, public BuildBEMatrixBaseCompute
 {
 public:
+  SurfaceAndPoints(bool compress, const HierarchicalMatrix::Options& compression) :
+    compress_(compress), compression_(compression) {}
   MatrixHandle compute(const bemfield_vector& fields) const override;
+private:
+  bool compress_;
+  HierarchicalMatrix::Options compression_;
 };
 
 class SurfaceToSurface : public BEMAlgoImpl, public BuildBEMatrixBaseCompute
@@ -945,7 +1192,8 @@ public:
   MatrixHandle compute(const bemfield_vector& fields) const override;
 };
 
-BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
+BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields, bool compressPointOperators,
+  const HierarchicalMatrix::Options& compression)
 {
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   // Check for special case where the potentials need to be evaluated at the nodes of a lead
@@ -988,7 +1236,7 @@ BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
     // If all of the checks above don't flag meets_conditions as false,
     // return a value that indicates the algorithm to use is the surface-to-nodes case
     if ( meets_conditions )
-      return makeShared<SurfaceAndPoints>();
+      return makeShared<SurfaceAndPoints>(compressPointOperators, compression);
   }
 
   //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1303,12 +1551,25 @@ MatrixHandle SurfaceAndPoints::compute(const bemfield_vector& fields) const
   DenseMatrixHandle Pns;
   DenseMatrixHandle Gns;
   make_auto_P(surface, Pss, 1.0, 0.0);
-  make_cross_P(nodes, surface, Pns, 1.0, 0.0);
 
   std::vector<double> area;
   pre_calc_tri_areas( surface, area );
 
   make_auto_G( surface, Gss, 1.0, 0.0, area );
+
+  if (compress_)
+  {
+    // With many points the operators to the points dominate; compressed, they cost close
+    // to linear time to build and to apply to the columns of inv(G_surf_surf)*P_surf_surf.
+    auto compressedPns = make_cross_P_compressed(nodes, surface, 1.0, 0.0, compression_);
+    auto compressedGns = make_cross_G_compressed(nodes, surface, 1.0, 0.0, area, compression_);
+    const Eigen::MatrixXd surfaceTransfer = Gss->inverse() * *Pss;
+    Eigen::MatrixXd currentTerm;
+    compressedGns->multiply(surfaceTransfer, currentTerm);
+    return makeShared<DenseMatrix>(*compressedPns->toDense() - currentTerm);
+  }
+
+  make_cross_P(nodes, surface, Pns, 1.0, 0.0);
   make_cross_G( nodes, surface, Gns, 1.0, 0.0, area );
 
   return makeShared<DenseMatrix>(*Pns - (*Gns * Gss->inverse() * *Pss));
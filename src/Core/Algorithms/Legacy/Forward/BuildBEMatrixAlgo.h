@@ -42,6 +42,7 @@
 #include <Core/GeometryPrimitives/GeomFwd.h>
 #include <Core/Datatypes/Legacy/Field/FieldFwd.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/Legacy/Forward/HierarchicalMatrix.h>
 #include <Core/Algorithms/Legacy/Forward/share.h>
 
 namespace SCIRun {
@@ -54,6 +55,8 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(BoundaryConditionList);
         ALGORITHM_PARAMETER_DECL(InsideConductivityList);
         ALGORITHM_PARAMETER_DECL(OutsideConductivityList);
+        ALGORITHM_PARAMETER_DECL(CompressPointOperators);
+        ALGORITHM_PARAMETER_DECL(CompressionTolerance);
 
         typedef std::vector<std::string> FieldTypeListType;
 
@@ -146,6 +149,31 @@ namespace SCIRun {
           static void make_cross_P_allocate( VMesh*,
             VMesh*, Datatypes::DenseMatrixHandle&);
 
+          //! Compressed versions of the operators above, for surfaces too large to store densely.
+          static HierarchicalMatrixHandle make_auto_P_compressed( VMesh*,
+            double,
+            double,
+            const HierarchicalMatrix::Options& options = HierarchicalMatrix::Options() );
+
+          static HierarchicalMatrixHandle make_cross_P_compressed( VMesh*,
+            VMesh*,
+            double,
+            double,
+            const HierarchicalMatrix::Options& options = HierarchicalMatrix::Options() );
+
+          static HierarchicalMatrixHandle make_auto_G_compressed( VMesh*,
+            double,
+            double,
+            const std::vector<double>&,
+            const HierarchicalMatrix::Options& options = HierarchicalMatrix::Options() );
+
+          static HierarchicalMatrixHandle make_cross_G_compressed( VMesh*,
+            VMesh*,
+            double,
+            double,
+            const std::vector<double>&,
+            const HierarchicalMatrix::Options& options = HierarchicalMatrix::Options() );
+
           static void pre_calc_tri_areas(VMesh*, std::vector<double>&);
 
           static int compute_parent(const std::vector<VMesh*> &meshes, int index);
@@ -218,7 +246,10 @@ namespace SCIRun {
         class SCISHARE BEMAlgoImplFactory
         {
         public:
-          static BEMAlgoPtr create(const bemfield_vector& fields);
+          //! With compressPointOperators, a surface and points problem assembles the operators
+          //! from the surface to the points as hierarchical matrices with these options.
+          static BEMAlgoPtr create(const bemfield_vector& fields, bool compressPointOperators = false,
+            const HierarchicalMatrix::Options& compression = HierarchicalMatrix::Options());
         };
 
       }}}}
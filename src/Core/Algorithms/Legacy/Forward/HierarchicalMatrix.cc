@@ -0,0 +1,405 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Forward/HierarchicalMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <numeric>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Forward;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+HierarchicalMatrix::HierarchicalMatrix(const std::vector<Point>& rowPoints, const std::vector<Point>& colPoints,
+  const BlockGenerator& generator, const Options& options) : options_(options)
+{
+  buildTree(rowPoints, options_.leafSize, rowTree_);
+  buildTree(colPoints, options_.leafSize, colTree_);
+  if (rowPoints.empty() || colPoints.empty())
+    return;
+
+  buildBlocks(0, 0);
+
+  // Blocks vary a lot in cost, so they are handed out one at a time
+  Parallel::For(0, static_cast<std::int64_t>(blocks_.size()), [&](std::int64_t begin, std::int64_t end)
+  {
+    for (auto b = begin; b < end; ++b)
+      assemble(blocks_[b], generator);
+  }, 1);
+
+  std::vector<int> leafOfRow(rowPoints.size());
+  for (size_t leaf = 0; leaf < rowTree_.leaves.size(); ++leaf)
+  {
+    const auto& cluster = rowTree_.clusters[rowTree_.leaves[leaf]];
+    std::fill(leafOfRow.begin() + cluster.begin, leafOfRow.begin() + cluster.end, static_cast<int>(leaf));
+  }
+  leafBlocks_.resize(rowTree_.leaves.size());
+  for (size_t b = 0; b < blocks_.size(); ++b)
+  {
+    const auto& cluster = rowTree_.clusters[blocks_[b].rowCluster];
+    for (int leaf = leafOfRow[cluster.begin]; leaf <= leafOfRow[cluster.end - 1]; ++leaf)
+      leafBlocks_[leaf].push_back(static_cast<int>(b));
+  }
+}
+
+void HierarchicalMatrix::buildTree(const std::vector<Point>& points, int leafSize, ClusterTree& tree)
+{
+  const auto n = static_cast<index_type>(points.size());
+  std::vector<Eigen::Vector3d> permuted(n);
+  tree.perm.resize(n);
+  for (index_type i = 0; i < n; ++i)
+    tree.perm[i] = i;
+  for (index_type i = 0; i < n; ++i)
+    permuted[i] = Eigen::Vector3d(points[i].x(), points[i].y(), points[i].z());
+  if (n > 0)
+    split(permuted, 0, n, std::max(1, leafSize), tree);
+}
+
+// Bisects along the longest side of the bounding box at the median, which keeps the
+// tree balanced whatever the point distribution.
+int HierarchicalMatrix::split(std::vector<Eigen::Vector3d>& points, index_type begin, index_type end,
+  int leafSize, ClusterTree& tree)
+{
+  const int id = static_cast<int>(tree.clusters.size());
+  tree.clusters.push_back(Cluster());
+  Cluster cluster;
+  cluster.begin = begin;
+  cluster.end = end;
+  cluster.min = cluster.max = points[begin];
+  for (auto i = begin + 1; i < end; ++i)
+  {
+    cluster.min = cluster.min.cwiseMin(points[i]);
+    cluster.max = cluster.max.cwiseMax(points[i]);
+  }
+  cluster.child[0] = cluster.child[1] = -1;
+
+  if (end - begin > leafSize)
+  {
+    int axis;
+    (cluster.max - cluster.min).maxCoeff(&axis);
+
+    std::vector<index_type> order(end - begin);
+    for (index_type i = 0; i < end - begin; ++i)
+      order[i] = begin + i;
+    const auto mid = order.begin() + order.size() / 2;
+    std::nth_element(order.begin(), mid, order.end(), [&](index_type a, index_type b)
+    {
+      return points[a][axis] < points[b][axis] || (points[a][axis] == points[b][axis] && tree.perm[a] < tree.perm[b]);
+    });
+
+    std::vector<Eigen::Vector3d> sortedPoints(order.size());
+    std::vector<index_type> sortedPerm(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+      sortedPoints[i] = points[order[i]];
+      sortedPerm[i] = tree.perm[order[i]];
+    }
+    std::copy(sortedPoints.begin(), sortedPoints.end(), points.begin() + begin);
+    std::copy(sortedPerm.begin(), sortedPerm.end(), tree.perm.begin() + begin);
+
+    const auto middle = begin + static_cast<index_type>(order.size() / 2);
+    cluster.child[0] = split(points, begin, middle, leafSize, tree);
+    cluster.child[1] = split(points, middle, end, leafSize, tree);
+  }
+  else
+  {
+    tree.leaves.push_back(id);
+  }
+
+  tree.clusters[id] = cluster;
+  return id;
+}
+
+bool HierarchicalMatrix::admissible(const Cluster& row, const Cluster& col) const
+{
+  const double rowDiameter = (row.max - row.min).norm();
+  const double colDiameter = (col.max - col.min).norm();
+  const Eigen::Vector3d gap = (row.min - col.max).cwiseMax(col.min - row.max).cwiseMax(Eigen::Vector3d::Zero());
+  const double distance = gap.norm();
+  return distance > 0 && std::min(rowDiameter, colDiameter) <= options_.eta * distance;
+}
+
+void HierarchicalMatrix::buildBlocks(int rowCluster, int colCluster)
+{
+  const auto& row = rowTree_.clusters[rowCluster];
+  const auto& col = colTree_.clusters[colCluster];
+  const bool rowLeaf = row.child[0] < 0;
+  const bool colLeaf = col.child[0] < 0;
+
+  const bool farField = admissible(row, col);
+  if (farField || (rowLeaf && colLeaf))
+  {
+    Block block;
+    block.rowCluster = rowCluster;
+    block.colCluster = colCluster;
+    block.lowRank = farField;
+    blocks_.push_back(block);
+    return;
+  }
+
+  if (colLeaf || (!rowLeaf && row.end - row.begin >= col.end - col.begin))
+  {
+    buildBlocks(row.child[0], colCluster);
+    buildBlocks(row.child[1], colCluster);
+  }
+  else
+  {
+    buildBlocks(rowCluster, col.child[0]);
+    buildBlocks(rowCluster, col.child[1]);
+  }
+}
+
+void HierarchicalMatrix::assemble(Block& block, const BlockGenerator& generator) const
+{
+  const auto& row = rowTree_.clusters[block.rowCluster];
+  const auto& col = colTree_.clusters[block.colCluster];
+  const std::vector<index_type> rows(rowTree_.perm.begin() + row.begin, rowTree_.perm.begin() + row.end);
+  const std::vector<index_type> cols(colTree_.perm.begin() + col.begin, colTree_.perm.begin() + col.end);
+  const auto entries = generator(rows, cols);
+
+  std::vector<index_type> rowPositions(rows.size()), colPositions(cols.size());
+  std::iota(rowPositions.begin(), rowPositions.end(), 0);
+  std::iota(colPositions.begin(), colPositions.end(), 0);
+
+  if (block.lowRank && crossApproximation(block, rowPositions, colPositions, entries))
+    return;
+
+  block.lowRank = false;
+  block.U.resize(0, 0);
+  block.V.resize(0, 0);
+  block.dense.resize(rows.size(), cols.size());
+  entries(rowPositions, colPositions, block.dense);
+}
+
+// Adaptive cross approximation with partial pivoting: every step takes the largest
+// entry of one residual row as pivot, and the next row where the new column is largest.
+bool HierarchicalMatrix::crossApproximation(Block& block, const std::vector<index_type>& rowPositions,
+  const std::vector<index_type>& colPositions, const BlockEntries& entries) const
+{
+  const auto m = static_cast<index_type>(rowPositions.size());
+  const auto n = static_cast<index_type>(colPositions.size());
+  // Beyond this rank the factors take more room than the dense block
+  const auto maxRank = std::min<index_type>(options_.maxRank, (m * n) / (m + n));
+
+  std::vector<Eigen::VectorXd> us, vs;
+  std::vector<bool> usedRow(m, false);
+  std::vector<index_type> single(1);
+  Eigen::MatrixXd sample;
+  double normSquared = 0.0;
+  index_type pivotRow = 0;
+
+  while (static_cast<index_type>(us.size()) < maxRank)
+  {
+    usedRow[pivotRow] = true;
+    single[0] = pivotRow;
+    entries(single, colPositions, sample);
+    Eigen::VectorXd v = sample.row(0).transpose();
+    for (size_t k = 0; k < us.size(); ++k)
+      v -= us[k][pivotRow] * vs[k];
+
+    index_type pivotCol;
+    const double pivot = v.cwiseAbs().maxCoeff(&pivotCol);
+    if (pivot == 0.0)
+    {
+      // This row is already reproduced exactly; try another one
+      const auto next = std::find(usedRow.begin(), usedRow.end(), false);
+      if (next == usedRow.end())
+        break;
+      pivotRow = next - usedRow.begin();
+      continue;
+    }
+    v /= v[pivotCol];
+
+    single[0] = pivotCol;
+    entries(rowPositions, single, sample);
+    Eigen::VectorXd u = sample.col(0);
+    for (size_t k = 0; k < us.size(); ++k)
+      u -= vs[k][pivotCol] * us[k];
+
+    const double uNorm = u.norm();
+    const double vNorm = v.norm();
+    double cross = 0.0;
+    for (size_t k = 0; k < us.size(); ++k)
+      cross += u.dot(us[k]) * v.dot(vs[k]);
+    normSquared += 2.0 * cross + uNorm * uNorm * vNorm * vNorm;
+
+    us.push_back(u);
+    vs.push_back(v);
+
+    if (uNorm * vNorm <= options_.tolerance * std::sqrt(std::abs(normSquared)))
+    {
+      block.U.resize(m, us.size());
+      block.V.resize(n, vs.size());
+      for (size_t k = 0; k < us.size(); ++k)
+      {
+        block.U.col(k) = us[k];
+        block.V.col(k) = vs[k];
+      }
+      return true;
+    }
+
+    index_type next = -1;
+    double largest = -1.0;
+    for (index_type i = 0; i < m; ++i)
+    {
+      if (!usedRow[i] && std::abs(u[i]) > largest)
+      {
+        largest = std::abs(u[i]);
+        next = i;
+      }
+    }
+    if (next < 0)
+      break;
+    pivotRow = next;
+  }
+
+  // A block of zeros needs no factors
+  if (us.empty() && std::find(usedRow.begin(), usedRow.end(), false) == usedRow.end())
+  {
+    block.U.resize(m, 0);
+    block.V.resize(n, 0);
+    return true;
+  }
+  return false;
+}
+
+void HierarchicalMatrix::multiply(const Eigen::VectorXd& x, Eigen::VectorXd& y) const
+{
+  Eigen::MatrixXd Y;
+  multiply(Eigen::MatrixXd(x), Y);
+  y = Y.col(0);
+}
+
+void HierarchicalMatrix::multiply(const Eigen::MatrixXd& X, Eigen::MatrixXd& Y) const
+{
+  Eigen::MatrixXd Xp(cols(), X.cols());
+  for (index_type j = 0; j < cols(); ++j)
+    Xp.row(j) = X.row(colTree_.perm[j]);
+
+  // V^T*X of the low rank blocks, shared by all the row leaves a block covers
+  std::vector<Eigen::MatrixXd> coefficients(blocks_.size());
+  Parallel::For(0, static_cast<std::int64_t>(blocks_.size()), [&](std::int64_t begin, std::int64_t end)
+  {
+    for (auto b = begin; b < end; ++b)
+    {
+      const auto& block = blocks_[b];
+      if (block.lowRank)
+      {
+        const auto& col = colTree_.clusters[block.colCluster];
+        coefficients[b] = block.V.transpose() * Xp.middleRows(col.begin, col.end - col.begin);
+      }
+    }
+  });
+
+  // Every row leaf sums its own rows, so no two threads write the same entry
+  Eigen::MatrixXd Yp = Eigen::MatrixXd::Zero(rows(), X.cols());
+  Parallel::For(0, static_cast<std::int64_t>(rowTree_.leaves.size()), [&](std::int64_t begin, std::int64_t end)
+  {
+    for (auto leaf = begin; leaf < end; ++leaf)
+    {
+      const auto& rowLeaf = rowTree_.clusters[rowTree_.leaves[leaf]];
+      const auto length = rowLeaf.end - rowLeaf.begin;
+      for (int b : leafBlocks_[leaf])
+      {
+        const auto& block = blocks_[b];
+        const auto& row = rowTree_.clusters[block.rowCluster];
+        const auto& col = colTree_.clusters[block.colCluster];
+        const auto offset = rowLeaf.begin - row.begin;
+        if (block.lowRank)
+          Yp.middleRows(rowLeaf.begin, length) += block.U.middleRows(offset, length) * coefficients[b];
+        else
+          Yp.middleRows(rowLeaf.begin, length) += block.dense.middleRows(offset, length) * Xp.middleRows(col.begin, col.end - col.begin);
+      }
+    }
+  });
+
+  Y.resize(rows(), X.cols());
+  for (index_type i = 0; i < rows(); ++i)
+    Y.row(rowTree_.perm[i]) = Yp.row(i);
+}
+
+DenseMatrixHandle HierarchicalMatrix::toDense() const
+{
+  auto dense = makeShared<DenseMatrix>(DenseMatrix::Zero(rows(), cols()));
+  for (const auto& block : blocks_)
+  {
+    const auto& row = rowTree_.clusters[block.rowCluster];
+    const auto& col = colTree_.clusters[block.colCluster];
+    const Eigen::MatrixXd values = block.lowRank ? Eigen::MatrixXd(block.U * block.V.transpose()) : block.dense;
+    for (index_type j = 0; j < col.end - col.begin; ++j)
+      for (index_type i = 0; i < row.end - row.begin; ++i)
+        (*dense)(rowTree_.perm[row.begin + i], colTree_.perm[col.begin + j]) = values(i, j);
+  }
+  return dense;
+}
+
+void HierarchicalMatrix::setDiagonal(const Eigen::VectorXd& diagonal)
+{
+  std::vector<index_type> colPosition(cols());
+  for (index_type j = 0; j < cols(); ++j)
+    colPosition[colTree_.perm[j]] = j;
+
+  // The diagonal never lies in a well separated block
+  for (auto& block : blocks_)
+  {
+    if (block.lowRank)
+      continue;
+    const auto& row = rowTree_.clusters[block.rowCluster];
+    const auto& col = colTree_.clusters[block.colCluster];
+    for (auto i = row.begin; i < row.end; ++i)
+    {
+      const auto node = rowTree_.perm[i];
+      const auto j = colPosition[node];
+      if (j >= col.begin && j < col.end)
+        block.dense(i - row.begin, j - col.begin) = diagonal[node];
+    }
+  }
+}
+
+size_t HierarchicalMatrix::numLowRankBlocks() const
+{
+  return std::count_if(blocks_.begin(), blocks_.end(), [](const Block& b) { return b.lowRank; });
+}
+
+size_t HierarchicalMatrix::numDenseBlocks() const
+{
+  return blocks_.size() - numLowRankBlocks();
+}
+
+double HierarchicalMatrix::compressionRatio() const
+{
+  double stored = 0.0;
+  for (const auto& block : blocks_)
+    stored += block.lowRank ? static_cast<double>(block.U.size() + block.V.size()) : static_cast<double>(block.dense.size());
+  return stored / (static_cast<double>(rows()) * static_cast<double>(cols()));
+}
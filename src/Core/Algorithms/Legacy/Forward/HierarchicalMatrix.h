@@ -0,0 +1,146 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_LEGACY_FORWARD_HIERARCHICALMATRIX_H
+#define CORE_ALGORITHMS_LEGACY_FORWARD_HIERARCHICALMATRIX_H
+
+#include <functional>
+#include <vector>
+#include <Eigen/Dense>
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/GeometryPrimitives/GeomFwd.h>
+#include <Core/Algorithms/Legacy/Forward/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Forward {
+
+        // Hierarchical matrix for the node-to-node operators of the boundary element method.
+        // Rows and columns are ordered by cluster trees over the node positions. Blocks
+        // coupling well separated clusters are stored as low rank products U*V^T, found
+        // by adaptive cross approximation from a few of their rows and columns; all other
+        // blocks are stored dense. Storage and the cost of a product are then close to
+        // O(N log N) instead of O(N^2).
+
+        class SCISHARE HierarchicalMatrix
+        {
+        public:
+          struct Options
+          {
+            Options() : leafSize(32), eta(1.0), tolerance(1e-6), maxRank(64) {}
+
+            // Clusters up to this many points are not split further
+            int leafSize;
+            // Two clusters are well separated if min(diam) <= eta * distance
+            double eta;
+            // Relative accuracy of the low rank blocks in the Frobenius norm
+            double tolerance;
+            // Blocks needing a higher rank are stored dense
+            int maxRank;
+          };
+
+          // Fills values with the entries of one block at the given row and column
+          // positions within the block.
+          typedef std::function<void(const std::vector<index_type>& rowPositions,
+            const std::vector<index_type>& colPositions, Eigen::MatrixXd& values)> BlockEntries;
+
+          // Returns the entries of the block coupling rows and cols of the matrix. Cross
+          // approximation samples one row or column of a block at a time, so anything the
+          // block needs is best set up here, once. Called concurrently for different blocks.
+          typedef std::function<BlockEntries(const std::vector<index_type>& rows,
+            const std::vector<index_type>& cols)> BlockGenerator;
+
+          HierarchicalMatrix(const std::vector<Geometry::Point>& rowPoints,
+            const std::vector<Geometry::Point>& colPoints,
+            const BlockGenerator& generator, const Options& options = Options());
+
+          index_type rows() const { return static_cast<index_type>(rowTree_.perm.size()); }
+          index_type cols() const { return static_cast<index_type>(colTree_.perm.size()); }
+
+          // y = H*x
+          void multiply(const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+          // Y = H*X, all columns at once
+          void multiply(const Eigen::MatrixXd& X, Eigen::MatrixXd& Y) const;
+
+          Datatypes::DenseMatrixHandle toDense() const;
+
+          // Overwrites the diagonal of a square matrix built with the same row and column points
+          void setDiagonal(const Eigen::VectorXd& diagonal);
+
+          size_t numLowRankBlocks() const;
+          size_t numDenseBlocks() const;
+          // Stored entries relative to rows()*cols()
+          double compressionRatio() const;
+
+        private:
+          struct Cluster
+          {
+            index_type begin, end;  // range in the permuted order
+            Eigen::Vector3d min, max;
+            int child[2];
+          };
+
+          struct ClusterTree
+          {
+            std::vector<Cluster> clusters;  // clusters[0] is the root
+            std::vector<index_type> perm;   // original index of every permuted position
+            std::vector<int> leaves;        // leaf clusters in order
+          };
+
+          struct Block
+          {
+            int rowCluster, colCluster;
+            bool lowRank;
+            Eigen::MatrixXd dense;
+            Eigen::MatrixXd U, V;
+          };
+
+          static void buildTree(const std::vector<Geometry::Point>& points, int leafSize, ClusterTree& tree);
+          static int split(std::vector<Eigen::Vector3d>& points, index_type begin, index_type end,
+            int leafSize, ClusterTree& tree);
+          bool admissible(const Cluster& row, const Cluster& col) const;
+          void buildBlocks(int rowCluster, int colCluster);
+          void assemble(Block& block, const BlockGenerator& generator) const;
+          bool crossApproximation(Block& block, const std::vector<index_type>& rowPositions,
+            const std::vector<index_type>& colPositions, const BlockEntries& entries) const;
+
+          Options options_;
+          ClusterTree rowTree_, colTree_;
+          std::vector<Block> blocks_;
+          // blocks overlapping the rows of every row leaf, for the product
+          std::vector<std::vector<int>> leafBlocks_;
+        };
+
+        typedef SharedPointer<HierarchicalMatrix> HierarchicalMatrixHandle;
+
+      }}}}
+
+#endif
@@ -0,0 +1,432 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Math/LinearSystem/AlgebraicMultigrid.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Logging/Log.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  using SparseMatrix = AlgebraicMultigrid::SparseMatrix;
+  using Vector = AlgebraicMultigrid::Vector;
+  using Entries = std::vector<std::pair<index_type, double>>;
+
+  const index_type rowsPerChunk = 2048;
+
+  // Builds a compressed matrix whose rows are generated independently on the thread
+  // pool. rowEntries(i, entries) appends the entries of row i in any order; repeated
+  // columns are summed.
+  template <class RowEntries>
+  SparseMatrix buildRows(index_type nrows, index_type ncols, RowEntries rowEntries)
+  {
+    const auto numChunks = (nrows + rowsPerChunk - 1) / rowsPerChunk;
+    std::vector<std::vector<index_type>> chunkColumns(numChunks);
+    std::vector<std::vector<double>> chunkValues(numChunks);
+    std::vector<index_type> outer(nrows + 1, 0);
+
+    Parallel::For(0, numChunks, [&](std::int64_t chunkBegin, std::int64_t chunkEnd)
+    {
+      Entries entries;
+      for (auto chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+      {
+        auto& columns = chunkColumns[chunk];
+        auto& values = chunkValues[chunk];
+        const index_type rowEnd = std::min(nrows, (chunk + 1) * rowsPerChunk);
+        for (index_type i = chunk * rowsPerChunk; i < rowEnd; ++i)
+        {
+          entries.clear();
+          rowEntries(i, entries);
+          std::sort(entries.begin(), entries.end(),
+            [](const std::pair<index_type, double>& a, const std::pair<index_type, double>& b) { return a.first < b.first; });
+
+          const auto rowStart = columns.size();
+          for (const auto& entry : entries)
+          {
+            if (columns.size() > rowStart && columns.back() == entry.first)
+              values.back() += entry.second;
+            else
+            {
+              columns.push_back(entry.first);
+              values.push_back(entry.second);
+            }
+          }
+          outer[i + 1] = static_cast<index_type>(columns.size() - rowStart);
+        }
+      }
+    }, 1);
+
+    for (index_type i = 0; i < nrows; ++i)
+      outer[i + 1] += outer[i];
+
+    SparseMatrix M(nrows, ncols);
+    M.resizeNonZeros(outer[nrows]);
+    std::copy(outer.begin(), outer.end(), M.outerIndexPtr());
+    Parallel::For(0, numChunks, [&](std::int64_t chunkBegin, std::int64_t chunkEnd)
+    {
+      for (auto chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+      {
+        const auto offset = outer[chunk * rowsPerChunk];
+        std::copy(chunkColumns[chunk].begin(), chunkColumns[chunk].end(), M.innerIndexPtr() + offset);
+        std::copy(chunkValues[chunk].begin(), chunkValues[chunk].end(), M.valuePtr() + offset);
+      }
+    }, 1);
+    return M;
+  }
+
+  Vector diagonal(const SparseMatrix& A)
+  {
+    Vector d(A.rows());
+    Parallel::For(0, A.rows(), [&](std::int64_t begin, std::int64_t end)
+    {
+      for (auto i = begin; i < end; ++i)
+      {
+        double value = 0.0;
+        for (SparseMatrix::InnerIterator it(A, i); it; ++it)
+        {
+          if (it.col() == i)
+            value = it.value();
+        }
+        d[i] = value;
+      }
+    });
+    return d;
+  }
+
+  Vector invertDiagonal(const Vector& d)
+  {
+    const double tiny = 1e-300;
+    return d.unaryExpr([tiny](double v) { return std::abs(v) > tiny ? 1.0 / v : 0.0; });
+  }
+
+  // Largest eigenvalue of D^-1 A by power iteration, for the damping factors
+  double spectralRadius(const SparseMatrix& A, const Vector& invDiag)
+  {
+    const auto n = A.rows();
+    Vector x(n), y(n);
+    for (index_type i = 0; i < n; ++i)
+      x[i] = 1.0 + static_cast<double>(i % 7) / 7.0;
+    x.normalize();
+
+    double rho = 0.0;
+    for (int iter = 0; iter < 15; ++iter)
+    {
+      AlgebraicMultigrid::multiply(A, x, y);
+      y = y.cwiseProduct(invDiag);
+      rho = y.norm();
+      if (rho == 0.0)
+        break;
+      x = y / rho;
+    }
+    return rho;
+  }
+
+  // Strong connections of every row, stored as the pattern of a matrix
+  SparseMatrix strengthOfConnection(const SparseMatrix& A, const Vector& d, double threshold)
+  {
+    const double threshold2 = threshold * threshold;
+    return buildRows(A.rows(), A.cols(), [&](index_type i, Entries& entries)
+    {
+      for (SparseMatrix::InnerIterator it(A, i); it; ++it)
+      {
+        const auto j = it.col();
+        if (j != i && it.value() * it.value() >= threshold2 * std::abs(d[i] * d[j]))
+          entries.emplace_back(j, 1.0);
+      }
+    });
+  }
+
+  // Greedy aggregation: whole free neighbourhoods first, then leftovers join a
+  // neighbouring aggregate, then whatever remains is grouped with its free neighbours.
+  // Serial, so the hierarchy does not depend on the number of threads.
+  index_type aggregate(const SparseMatrix& S, std::vector<index_type>& agg)
+  {
+    const auto n = S.rows();
+    agg.assign(n, -1);
+    index_type numAggregates = 0;
+
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] != -1 || S.outerIndexPtr()[i] == S.outerIndexPtr()[i + 1])
+        continue;
+      bool free = true;
+      for (SparseMatrix::InnerIterator it(S, i); it && free; ++it)
+        free = agg[it.col()] == -1;
+      if (!free)
+        continue;
+      agg[i] = numAggregates;
+      for (SparseMatrix::InnerIterator it(S, i); it; ++it)
+        agg[it.col()] = numAggregates;
+      numAggregates++;
+    }
+
+    const auto roots = agg;
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] != -1)
+        continue;
+      for (SparseMatrix::InnerIterator it(S, i); it; ++it)
+      {
+        if (roots[it.col()] != -1)
+        {
+          agg[i] = roots[it.col()];
+          break;
+        }
+      }
+    }
+
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] != -1)
+        continue;
+      agg[i] = numAggregates;
+      for (SparseMatrix::InnerIterator it(S, i); it; ++it)
+      {
+        if (agg[it.col()] == -1)
+          agg[it.col()] = numAggregates;
+      }
+      numAggregates++;
+    }
+    return numAggregates;
+  }
+
+  SparseMatrix multiplySparse(const SparseMatrix& A, const SparseMatrix& B)
+  {
+    return buildRows(A.rows(), B.cols(), [&](index_type i, Entries& entries)
+    {
+      for (SparseMatrix::InnerIterator a(A, i); a; ++a)
+      {
+        for (SparseMatrix::InnerIterator b(B, a.col()); b; ++b)
+          entries.emplace_back(b.col(), a.value() * b.value());
+      }
+    });
+  }
+}
+
+void AlgebraicMultigrid::multiply(const SparseMatrix& A, const Vector& x, Vector& y)
+{
+  y.resize(A.rows());
+  const auto outer = A.outerIndexPtr();
+  const auto inner = A.innerIndexPtr();
+  const auto values = A.valuePtr();
+  Parallel::For(0, A.rows(), [&](std::int64_t begin, std::int64_t end)
+  {
+    for (auto i = begin; i < end; ++i)
+    {
+      double sum = 0.0;
+      for (auto k = outer[i]; k < outer[i + 1]; ++k)
+        sum += values[k] * x[inner[k]];
+      y[i] = sum;
+    }
+  });
+}
+
+AlgebraicMultigrid::AlgebraicMultigrid(SparseRowMatrixHandle A, const Options& options) :
+  options_(options), directCoarseSolve_(false)
+{
+  if (!A || A->rows() != A->cols())
+    THROW_INVALID_ARGUMENT("Algebraic multigrid needs a square matrix");
+
+  SharedPointer<const SparseMatrix> current;
+  if (A->isCompressed())
+    current = A;
+  else
+  {
+    auto compressed = makeShared<SparseMatrix>(*A);
+    compressed->makeCompressed();
+    current = compressed;
+  }
+
+  std::vector<index_type> agg;
+  while (true)
+  {
+    Level level;
+    level.A = current;
+    const auto n = current->rows();
+    const auto d = diagonal(*current);
+    const auto invDiag = invertDiagonal(d);
+    const auto rho = spectralRadius(*current, invDiag);
+    const auto omega = rho > 0.0 ? 4.0 / (3.0 * rho) : 0.0;
+    level.smootherDiag = omega * invDiag;
+
+    const bool last = n <= options_.coarsestSize || static_cast<int>(levels_.size()) + 1 >= options_.maxLevels;
+    if (!last)
+    {
+      const auto S = strengthOfConnection(*current, d, options_.strengthThreshold);
+      const auto numAggregates = aggregate(S, agg);
+
+      // Stop once coarsening stalls, e.g. on a matrix without strong connections
+      if (numAggregates > 0 && numAggregates < n * 9 / 10)
+      {
+        std::vector<double> weight(numAggregates, 0.0);
+        for (index_type i = 0; i < n; ++i)
+          weight[agg[i]] += 1.0;
+        for (auto& w : weight)
+          w = 1.0 / std::sqrt(w);
+
+        // P = (I - omega D^-1 A) T, with T the normalized piecewise constant aggregates
+        const auto& Ac = *current;
+        level.P = buildRows(n, numAggregates, [&](index_type i, Entries& entries)
+        {
+          entries.emplace_back(agg[i], weight[agg[i]]);
+          const auto scale = -omega * invDiag[i];
+          for (SparseMatrix::InnerIterator it(Ac, i); it; ++it)
+            entries.emplace_back(agg[it.col()], scale * it.value() * weight[agg[it.col()]]);
+        });
+        level.R = level.P.transpose();
+        level.R.makeCompressed();
+
+        const auto coarse = makeShared<SparseMatrix>(multiplySparse(level.R, multiplySparse(Ac, level.P)));
+        levels_.push_back(level);
+        current = coarse;
+        continue;
+      }
+    }
+
+    levels_.push_back(level);
+    break;
+  }
+
+  const auto& coarsest = *levels_.back().A;
+  if (coarsest.rows() <= 4 * options_.coarsestSize)
+  {
+    coarseSolver_.compute(Eigen::MatrixXd(coarsest));
+    directCoarseSolve_ = true;
+  }
+
+  LOG_DEBUG("Algebraic multigrid with {} levels, coarsest {} unknowns, operator complexity {}",
+    levels_.size(), coarsest.rows(), operatorComplexity());
+}
+
+double AlgebraicMultigrid::operatorComplexity() const
+{
+  double total = 0.0;
+  for (const auto& level : levels_)
+    total += static_cast<double>(level.A->nonZeros());
+  return total / static_cast<double>(levels_.front().A->nonZeros());
+}
+
+AlgebraicMultigrid::Workspace AlgebraicMultigrid::makeWorkspace() const
+{
+  Workspace work;
+  work.levels.resize(levels_.size());
+  for (size_t l = 0; l < levels_.size(); ++l)
+  {
+    const auto n = levels_[l].A->rows();
+    work.levels[l].x.resize(n);
+    work.levels[l].b.resize(n);
+    work.levels[l].r.resize(n);
+  }
+  return work;
+}
+
+void AlgebraicMultigrid::apply(const Vector& r, Vector& z, Workspace& work) const
+{
+  if (work.levels.size() != levels_.size())
+    work = makeWorkspace();
+  work.levels.front().b = r;
+  cycle(0, work);
+  z = work.levels.front().x;
+}
+
+void AlgebraicMultigrid::apply(const Vector& r, Vector& z) const
+{
+  auto work = makeWorkspace();
+  apply(r, z, work);
+}
+
+// x = level.A^-1 b approximately, from a zero initial guess
+void AlgebraicMultigrid::cycle(size_t l, Workspace& work) const
+{
+  const auto& level = levels_[l];
+  if (l + 1 == levels_.size())
+  {
+    solveCoarsest(work);
+    return;
+  }
+
+  auto& v = work.levels[l];
+  v.x = level.smootherDiag.cwiseProduct(v.b);
+  smooth(level, v, options_.smoothingSweeps - 1);
+
+  multiply(*level.A, v.x, v.r);
+  v.r = v.b - v.r;
+  auto& next = work.levels[l + 1];
+  multiply(level.R, v.r, next.b);
+  cycle(l + 1, work);
+  multiply(level.P, next.x, v.r);
+  v.x += v.r;
+
+  smooth(level, v, options_.smoothingSweeps);
+}
+
+void AlgebraicMultigrid::smooth(const Level& level, Workspace::LevelVectors& v, int sweeps) const
+{
+  for (int sweep = 0; sweep < sweeps; ++sweep)
+  {
+    multiply(*level.A, v.x, v.r);
+    v.x += level.smootherDiag.cwiseProduct(v.b - v.r);
+  }
+}
+
+void AlgebraicMultigrid::solveCoarsest(Workspace& work) const
+{
+  const auto& level = levels_.back();
+  auto& v = work.levels.back();
+  if (directCoarseSolve_)
+  {
+    v.x = coarseSolver_.solve(v.b);
+  }
+  else
+  {
+    // Coarsening stalled on a large level; fall back to a fixed number of sweeps
+    v.x = level.smootherDiag.cwiseProduct(v.b);
+    smooth(level, v, 20);
+  }
+}
+
+SharedPointer<const AlgebraicMultigrid> AlgebraicMultigridCache::get(SparseRowMatrixHandle A,
+  const AlgebraicMultigrid::Options& options)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  if (!hierarchy_ || !A || A->id() != matrixId_)
+  {
+    hierarchy_.reset();
+    hierarchy_ = makeShared<AlgebraicMultigrid>(A, options);
+    matrixId_ = A->id();
+  }
+  return hierarchy_;
+}
@@ -0,0 +1,134 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_MATH_LINEARSYSTEM_ALGEBRAICMULTIGRID_H
+#define CORE_ALGORITHMS_MATH_LINEARSYSTEM_ALGEBRAICMULTIGRID_H
+
+#include <mutex>
+#include <vector>
+#include <Eigen/Dense>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+// Smoothed aggregation algebraic multigrid for symmetric positive (semi-)definite
+// sparse matrices such as the stiffness matrices from BuildFEMatrix. The hierarchy
+// is built once per matrix and applied as a preconditioner, one V-cycle per call.
+
+class SCISHARE AlgebraicMultigrid
+{
+  public:
+    using SparseMatrix = Datatypes::SparseRowMatrix::EigenBase;
+    using Vector = Eigen::VectorXd;
+
+    struct Options
+    {
+      Options() : strengthThreshold(0.08), smoothingSweeps(1), maxLevels(25), coarsestSize(500) {}
+
+      // j is a strong neighbour of i if |a_ij| >= threshold * sqrt(|a_ii * a_jj|)
+      double strengthThreshold;
+      // Damped Jacobi sweeps before and after each coarse grid correction
+      int smoothingSweeps;
+      int maxLevels;
+      // Levels up to this size are solved directly
+      index_type coarsestSize;
+    };
+
+    // Per-level vectors of one V-cycle. The hierarchy itself is never written while
+    // applying it, so it can be shared by threads that each use their own workspace.
+    struct Workspace
+    {
+      struct LevelVectors
+      {
+        Vector x, b, r;
+      };
+      std::vector<LevelVectors> levels;
+    };
+
+    explicit AlgebraicMultigrid(Datatypes::SparseRowMatrixHandle A, const Options& options = Options());
+
+    Workspace makeWorkspace() const;
+
+    // z ~= A^-1 r by one V-cycle from a zero initial guess. The cycle is symmetric,
+    // so it is a valid preconditioner for CG.
+    void apply(const Vector& r, Vector& z, Workspace& work) const;
+    // As above, with work vectors allocated for this call only
+    void apply(const Vector& r, Vector& z) const;
+
+    size_t numLevels() const { return levels_.size(); }
+    index_type levelSize(size_t level) const { return levels_[level].A->rows(); }
+    // Nonzeros of all level operators relative to the nonzeros of A
+    double operatorComplexity() const;
+
+    // y = A*x, with the rows split over the thread pool
+    static void multiply(const SparseMatrix& A, const Vector& x, Vector& y);
+
+  private:
+    struct Level
+    {
+      SharedPointer<const SparseMatrix> A;
+      Vector smootherDiag;  // omega / a_ii
+      SparseMatrix P;       // interpolates the next coarser level onto this one
+      SparseMatrix R;       // P^T
+    };
+
+    void cycle(size_t level, Workspace& work) const;
+    void smooth(const Level& level, Workspace::LevelVectors& v, int sweeps) const;
+    void solveCoarsest(Workspace& work) const;
+
+    Options options_;
+    std::vector<Level> levels_;
+    Eigen::LDLT<Eigen::MatrixXd> coarseSolver_;
+    bool directCoarseSolve_;
+};
+
+// Keeps the hierarchy of the last matrix, so that repeated solves with the same
+// matrix, e.g. one per electrode for a lead field, only pay for the setup once.
+// Matrices are identified by their Datatype id, as they are not modified after
+// they have been sent downstream.
+
+class SCISHARE AlgebraicMultigridCache
+{
+  public:
+    SharedPointer<const AlgebraicMultigrid> get(Datatypes::SparseRowMatrixHandle A,
+      const AlgebraicMultigrid::Options& options = AlgebraicMultigrid::Options());
+
+  private:
+    std::mutex lock_;
+    Datatypes::Datatype::id_type matrixId_ = -1;
+    SharedPointer<const AlgebraicMultigrid> hierarchy_;
+};
+
+}}}}
+
+#endif
@@ -33,6 +33,7 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/LinearSystem/AlgebraicMultigrid.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
@@ -40,15 +41,16 @@
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 
+using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Datatypes;
 
-SolveLinearSystemAlgo::SolveLinearSystemAlgo()
+SolveLinearSystemAlgo::SolveLinearSystemAlgo() : amgCache_(makeShared<AlgebraicMultigridCache>())
 {
   // For solver
   addOption(Variables::Method,"cg","jacobi|cg|bicg|minres");
-  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi");
+  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi|AMG");
 
   addParameter(Variables::TargetError, 1e-5);
   addParameter(Variables::MaxIterations, 500);
@@ -138,7 +140,7 @@ class SolveLinearSystemCGAlgo : public SolveLinearSystemParallelAlgo
 bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 {
   ParallelLinearAlgebra::ParallelMatrix A;
-  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, Z, P;
+  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, U, W, P, S;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
   int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
@@ -169,8 +171,10 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
   if ( !PLA.new_vector(X) ||
        !PLA.new_vector(DIAG) ||
        !PLA.new_vector(R) ||
-       !PLA.new_vector(Z) ||
-       !PLA.new_vector(P))
+       !PLA.new_vector(U) ||
+       !PLA.new_vector(W) ||
+       !PLA.new_vector(P) ||
+       !PLA.new_vector(S))
   {
     if (PLA.first())
     {
@@ -227,7 +231,14 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
     return (true);
   }
 
-  double bkden = 0.0;
+  // Chronopoulos/Gear CG: the search direction P and its product S = A*P are updated
+  // from U = M*R and W = A*U, so each iteration reduces all its dot products at once.
+  PLA.zeros(P);
+  PLA.zeros(S);
+  double gamma = PLA.mult_dot(R,DIAG,U);
+  double delta = PLA.mult_dot(A,U,W);
+  double alpha = gamma/delta;
+  double beta = 0.0;
 
   int cnt = 0;
   double log_target = log(tolerance);
@@ -256,28 +267,14 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       return true;
     }
 
-    PLA.mult(R,DIAG,Z);
-    double bknum = PLA.dot(Z,R);
+    double gammaNext, rnorm;
+    PLA.cg_step(alpha,beta,A,DIAG,X,R,U,W,P,S,gammaNext,delta,rnorm);
 
-    if (niter == 0)
-    {
-      PLA.copy(Z,P);
-    }
-    else
-    {
-      double bk = bknum/bkden;
-      PLA.scale_add(bk,P,Z,P);
-    }
-    PLA.mult(A,P,Z);
-    bkden = bknum;
-
-    double akden = PLA.dot(Z,P);
-    double ak=bknum/akden;
+    beta = gammaNext/gamma;
+    alpha = gammaNext/(delta - beta*gammaNext/alpha);
+    gamma = gammaNext;
 
-    PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
-
-    error = PLA.norm(R)/bnorm;
+    error = rnorm/bnorm;
     if (error < xmin)
     {
       PLA.copy(X,XMIN);
@@ -499,10 +496,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     double ak=bknum/akden;
 
     PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
-
     PLA.scale_add(-ak,Z1,R1,R1);
-    error = PLA.norm(R)/bnorm;
+    error = PLA.scale_add_norm(-ak,Z,R,R)/bnorm;
 
     if (error < xmin) { PLA.copy(X,XMIN); xmin = error; }
     if (PLA.first()) (*convergence_)[niter] = xmin;
@@ -1015,8 +1010,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     PLA.mult(DIAG,Z,Z);
     PLA.sub(Z,X,X);
     PLA.mult(A,X,Z);
-    PLA.sub(Z,B,Z);
-    error = PLA.norm(Z) / bnorm;
+    error = PLA.scale_add_norm(-1.0,B,Z,Z) / bnorm;
     if (error < xmin) { PLA.copy(X,XMIN); xmin = error; }
     if (PLA.first()) (*convergence_)[niter] = xmin;
 
@@ -1067,6 +1061,276 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   return (true);
 }
 
+//------------------------------------------------------------------
+// Simultaneous CG for several right-hand sides, e.g. one per electrode of
+// a lead field. Every column runs its own Jacobi preconditioned CG, but the
+// columns share one pass over the matrix per iteration, so the matrix is
+// read once for all of them. Converged columns are frozen.
+
+class SolveLinearSystemBlockCGAlgo : public ParallelLinearAlgebraBase
+{
+  public:
+    explicit SolveLinearSystemBlockCGAlgo(const AlgorithmBase* base) : algo_(base),
+      pre_conditioner_(base->getOption(Variables::Preconditioner)) {}
+
+    bool run(SparseRowMatrixHandle a, DenseMatrixHandle b, DenseMatrixHandle x0, DenseMatrixHandle& x) const;
+    bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override;
+
+  private:
+    const AlgorithmBase* algo_;
+    std::string pre_conditioner_;
+};
+
+bool
+SolveLinearSystemBlockCGAlgo::run(SparseRowMatrixHandle a, DenseMatrixHandle b,
+                                  DenseMatrixHandle x0, DenseMatrixHandle& x) const
+{
+  SolverInputs matrices;
+  matrices.A = a;
+  matrices.B = b;
+  matrices.X0 = x0;
+
+  x = makeShared<DenseMatrix>(b->nrows(), b->ncols());
+  matrices.X = x;
+
+  if(!start_parallel(matrices))
+  {
+    const std::string msg = "Encountered an error while running parallel linear algebra";
+    algo_->error(msg);
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage(msg));
+  }
+
+  return (true);
+}
+
+bool SolveLinearSystemBlockCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelVector DIAG;
+  ParallelLinearAlgebra::ParallelBlock B, X, R, U, W, P, S;
+
+  const double tolerance = algo_->get(Variables::TargetError).toDouble();
+  const int max_iter = algo_->get(Variables::MaxIterations).toInt();
+  const size_t cols = matrices.B->ncols();
+  int niter = 0;
+
+  if (!PLA.add_matrix(matrices.A, A) ||
+      !PLA.new_vector(DIAG) ||
+      !PLA.new_block(cols, B) ||
+      !PLA.new_block(cols, X) ||
+      !PLA.new_block(cols, R) ||
+      !PLA.new_block(cols, U) ||
+      !PLA.new_block(cols, W) ||
+      !PLA.new_block(cols, P) ||
+      !PLA.new_block(cols, S))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  PLA.copy(*matrices.B, B);
+  PLA.copy(*matrices.X0, X);
+
+  if (pre_conditioner_ == "Jacobi")
+  {
+    PLA.absdiag(A,DIAG);
+    double max = PLA.max(DIAG);
+    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
+  }
+  else
+  {
+    PLA.ones(DIAG);
+  }
+
+  PLA.mult(A,X,R);
+  PLA.sub(B,R,R);
+
+  std::vector<double> bnorm(cols), error(cols), alpha(cols), beta(cols, 0.0), gamma(cols), delta(cols);
+  std::vector<double> gammaNext(cols), rnorm(cols);
+  std::vector<bool> active(cols);
+  PLA.norms(B, &bnorm[0]);
+  PLA.norms(R, &rnorm[0]);
+
+  auto update_error = [&]()
+  {
+    double worst = 0.0;
+    for (size_t c = 0; c < cols; c++)
+    {
+      // A zero right-hand side has the zero solution
+      error[c] = bnorm[c] > 0.0 ? rnorm[c]/bnorm[c] : 0.0;
+      active[c] = error[c] > tolerance;
+      worst = std::max(worst, error[c]);
+    }
+    return worst;
+  };
+
+  double error_max = update_error();
+  const double log_orig = log(error_max);
+  const double log_scale = log_orig - log(tolerance);
+
+  PLA.zeros(P);
+  PLA.zeros(S);
+  PLA.mult_dot(DIAG,R,U,&gamma[0]);
+  PLA.mult_dot(A,U,W,&delta[0]);
+  for (size_t c = 0; c < cols; c++)
+    alpha[c] = active[c] ? gamma[c]/delta[c] : 0.0;
+
+  int cnt = 0;
+  while (niter < max_iter && error_max > tolerance)
+  {
+    PLA.cg_step(&alpha[0],&beta[0],A,DIAG,X,R,U,W,P,S,&gammaNext[0],&delta[0],&rnorm[0]);
+    niter++;
+    error_max = update_error();
+
+    for (size_t c = 0; c < cols; c++)
+    {
+      if (active[c])
+      {
+        beta[c] = gammaNext[c]/gamma[c];
+        alpha[c] = gammaNext[c]/(delta[c] - beta[c]*gammaNext[c]/alpha[c]);
+      }
+      else
+      {
+        alpha[c] = beta[c] = 0.0;
+      }
+      gamma[c] = gammaNext[c];
+    }
+
+    cnt++;
+    if (cnt == 20)
+    {
+      cnt = 0;
+      if (PLA.first())
+        algo_->update_progress((log_orig-log(error_max))/log_scale);
+    }
+  }
+
+  PLA.copy(X, *matrices.X);
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    if (error_max <= tolerance)
+      ostr << "Solver converged for " << cols << " right-hand sides after " << niter << " iterations with error " << error_max;
+    else
+      ostr << "Solver stopped after " << niter << " iterations. Largest error of " << cols << " right-hand sides was " << error_max;
+    algo_->remark(ostr.str());
+  }
+
+  PLA.wait();
+  return true;
+}
+
+//------------------------------------------------------------------
+// CG Solver with an algebraic multigrid preconditioner. The V-cycle does
+// not map onto the ParallelLinearAlgebra kernels, so this one runs serially
+// and leaves the parallelism to the sparse products of the hierarchy.
+
+class SolveLinearSystemAMGCGAlgo
+{
+  public:
+    SolveLinearSystemAMGCGAlgo(const AlgorithmBase* base, SharedPointer<const AlgebraicMultigrid> amg) :
+      algo_(base), amg_(amg) {}
+    bool run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
+             DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
+             DenseColumnMatrixHandle& convergence) const;
+
+  private:
+    const AlgorithmBase* algo_;
+    SharedPointer<const AlgebraicMultigrid> amg_;
+};
+
+bool
+SolveLinearSystemAMGCGAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
+                                DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
+                                DenseColumnMatrixHandle& convergence) const
+{
+  using Vector = AlgebraicMultigrid::Vector;
+
+  const double tolerance = algo_->get(Variables::TargetError).toDouble();
+  const int max_iter = algo_->get(Variables::MaxIterations).toInt();
+  int niter = 0;
+
+  convergence = makeShared<DenseColumnMatrix>(max_iter);
+  convergence->setZero();
+
+  Vector X = *x0;
+  Vector XMIN = X;
+  Vector R, Z, P, Q;
+  const Vector& B = *b;
+  // the hierarchy may be shared with other solves, the work vectors are not
+  auto work = amg_->makeWorkspace();
+
+  AlgebraicMultigrid::multiply(*a, X, R);
+  R = B - R;
+
+  const double bnorm = B.norm();
+  double error = R.norm()/bnorm;
+  double xmin = error;
+  const double orig = error;
+
+  if (error <= tolerance)
+  {
+    x = makeShared<DenseColumnMatrix>(XMIN);
+    std::ostringstream ostr;
+    ostr << "Solver found solution with error = " << error;
+    algo_->remark(ostr.str());
+    return true;
+  }
+
+  amg_->apply(R, Z, work);
+  P = Z;
+  double rho = R.dot(Z);
+
+  int cnt = 0;
+  const double log_orig = log(orig);
+  const double log_scale = log_orig - log(tolerance);
+
+  while (niter < max_iter && error > tolerance)
+  {
+    AlgebraicMultigrid::multiply(*a, P, Q);
+    const double alpha = rho/P.dot(Q);
+    X += alpha*P;
+    R -= alpha*Q;
+
+    error = R.norm()/bnorm;
+    if (error < xmin)
+    {
+      XMIN = X;
+      xmin = error;
+    }
+    (*convergence)[niter] = xmin;
+    niter++;
+
+    if (error <= tolerance)
+      break;
+
+    amg_->apply(R, Z, work);
+    const double rhoNext = R.dot(Z);
+    P = Z + (rhoNext/rho)*P;
+    rho = rhoNext;
+
+    cnt++;
+    if (cnt == 20)
+    {
+      cnt = 0;
+      algo_->update_progress((log_orig-log(error))/log_scale);
+    }
+  }
+
+  x = makeShared<DenseColumnMatrix>(XMIN);
+
+  std::ostringstream ostr;
+  if (error <= tolerance)
+    ostr << "Solver converged after " << niter << " iterations with error " << error;
+  else
+    ostr << "Solver stopped after " << niter << " iterations. Error was " << error;
+  algo_->remark(ostr.str());
+  return true;
+}
+
 bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
                            DenseColumnMatrixHandle b,
                            DenseColumnMatrixHandle x0,
@@ -1146,9 +1410,23 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   }
 
   std::string method = getOption(Variables::Method);
+  const bool multigrid = getOption(Variables::Preconditioner) == "AMG";
+
+  if (multigrid && method != "cg")
+  {
+    THROW_ALGORITHM_INPUT_ERROR("The AMG preconditioner is only available with the cg method");
+  }
 
   DenseColumnMatrixHandle conv;
-  if (method == "cg")
+  if (multigrid)
+  {
+    SolveLinearSystemAMGCGAlgo algo(this, amgCache_->get(A));
+    if(!algo.run(A,b,x0,x,conv))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Conjugate Gradient method failed"));
+    }
+  }
+  else if (method == "cg")
   {
     SolveLinearSystemCGAlgo algo(this);
     if(!algo.run(A,b,x0,x,conv))
@@ -1200,9 +1478,84 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   return true;
 }
 
+bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
+                           DenseMatrixHandle b,
+                           DenseMatrixHandle x0,
+                           DenseMatrixHandle& x) const
+{
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(b, "No matrix b is given");
+
+  if (A->nrows() != A->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A is not square");
+  }
+
+  if (A->nrows() != b->nrows())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and b do not have the same number of rows");
+  }
+
+  if (!x0)
+  {
+    x0 = makeShared<DenseMatrix>(DenseMatrix::Zero(b->nrows(), b->ncols()));
+  }
+
+  if (x0->nrows() != b->nrows() || x0->ncols() != b->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix x0 and b need to have the same size");
+  }
+
+  const std::string method = getOption(Variables::Method);
+  const std::string preconditioner = getOption(Variables::Preconditioner);
+
+  if (method == "cg" && preconditioner != "AMG")
+  {
+    ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
+
+    double tolerance = get(Variables::TargetError).toDouble();
+    int maxIterations = get(Variables::MaxIterations).toInt();
+    ENSURE_POSITIVE_DOUBLE(tolerance, "Tolerance out of range!");
+    ENSURE_POSITIVE_INT(maxIterations, "Max iterations out of range!");
+
+    SolveLinearSystemBlockCGAlgo algo(this);
+    if (!algo.run(A,b,x0,x))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Conjugate Gradient method failed"));
+    }
+    return true;
+  }
+
+  // The AMG hierarchy is cached, so only the first column pays for its setup.
+  x = makeShared<DenseMatrix>(b->nrows(), b->ncols());
+  for (size_t col = 0; col < b->ncols(); ++col)
+  {
+    DenseColumnMatrixHandle xcol;
+    if (!run(A, makeShared<DenseColumnMatrix>(b->col(col)), makeShared<DenseColumnMatrix>(x0->col(col)), xcol))
+      return false;
+    x->col(col) = *xcol;
+  }
+  return true;
+}
+
 AlgorithmOutput SolveLinearSystemAlgo::run(const AlgorithmInput& input) const
 {
   auto lhs = input.get<SparseRowMatrix>(Variables::LHS);
+
+  auto rhsBlock = input.get<DenseMatrix>(Variables::RHS);
+  if (rhsBlock)
+  {
+    DenseMatrixHandle solution;
+    if (!run(lhs, rhsBlock, DenseMatrixHandle(), solution))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("SolveLinearSystem Algo returned false--need to improve error conditions so it throws before returning."));
+    }
+
+    AlgorithmOutput output;
+    output[Variables::Solution] = solution;
+    return output;
+  }
+
   auto rhs = input.get<DenseColumnMatrix>(Variables::RHS);
 
   DenseColumnMatrixHandle solution;
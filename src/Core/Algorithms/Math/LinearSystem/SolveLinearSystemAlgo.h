@@ -42,6 +42,8 @@ namespace Core {
 namespace Algorithms {
 namespace Math {
 
+class AlgebraicMultigridCache;
+
 // Solve a linear system in parallel using a standard iterative method
 // Method solves A*x = b, with x0 being the initializer for the solution
 
@@ -61,7 +63,19 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
              Datatypes::DenseColumnMatrixHandle x0,
              Datatypes::DenseColumnMatrixHandle& x) const;
 
+    // One solution column per column of b. Jacobi or unpreconditioned cg solves
+    // all of them simultaneously with one matrix pass per iteration; the other
+    // methods solve them one after another.
+    bool run(Datatypes::SparseRowMatrixHandle A,
+             Datatypes::DenseMatrixHandle b,
+             Datatypes::DenseMatrixHandle x0,
+             Datatypes::DenseMatrixHandle& x) const;
+
     AlgorithmOutput run(const AlgorithmInput& input) const override;
+
+  private:
+    // Multigrid hierarchy of the last matrix solved with the AMG preconditioner
+    SharedPointer<AlgebraicMultigridCache> amgCache_;
 };
 
 
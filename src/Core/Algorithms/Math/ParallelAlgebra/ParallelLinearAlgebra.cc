@@ -650,6 +650,290 @@ void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelVector&
   }
 }
 
+double ParallelLinearAlgebra::mult_dot(const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
+{
+  double* a_ptr = a.data_+start_;
+  double* b_ptr = b.data_+start_;
+  double* r_ptr = r.data_+start_;
+
+  double val = 0.0;
+  for (size_t j=0; j<local_size_; j++)
+  {
+    const double rj = a_ptr[j]*b_ptr[j];
+    val += rj*a_ptr[j];
+    r_ptr[j] = rj;
+  }
+
+  return(reduce_sum(val));
+}
+
+double ParallelLinearAlgebra::mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r)
+{
+  wait();
+
+  double* idata = b.data_;
+  double* odata = r.data_;
+
+  double* data = a.data_;
+  auto rows = a.rows_;
+  auto columns = a.columns_;
+
+  double val = 0.0;
+  for(size_t i=start_;i<end_;i++)
+  {
+    double sum = 0.0;
+    index_type row_idx = rows[i];
+    index_type next_idx = rows[i+1];
+    for(index_type j=row_idx;j<next_idx;j++)
+    {
+      sum+=data[j]*idata[columns[j]];
+    }
+    odata[i]=sum;
+    val += sum*idata[i];
+  }
+
+  return(reduce_sum(val));
+}
+
+double ParallelLinearAlgebra::scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
+{
+  double* a_ptr = a.data_+start_;
+  double* b_ptr = b.data_+start_;
+  double* r_ptr = r.data_+start_;
+
+  double val = 0.0;
+  for (size_t j=0; j<local_size_; j++)
+  {
+    const double rj = s*a_ptr[j]+b_ptr[j];
+    val += rj*rj;
+    r_ptr[j] = rj;
+  }
+
+  return(sqrt(reduce_sum(val)));
+}
+
+void ParallelLinearAlgebra::cg_step(double alpha, double beta, const ParallelMatrix& A, const ParallelVector& diag,
+  ParallelVector& x, ParallelVector& r, ParallelVector& u, ParallelVector& w,
+  ParallelVector& p, ParallelVector& s, double& gamma, double& delta, double& rnorm)
+{
+  double partial[3] = { 0.0, 0.0, 0.0 };
+
+  // Vector updates only touch this thread's rows, so they need no synchronization.
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double pi = u.data_[i] + beta*p.data_[i];
+    const double si = w.data_[i] + beta*s.data_[i];
+    p.data_[i] = pi;
+    s.data_[i] = si;
+    x.data_[i] += alpha*pi;
+    const double ri = r.data_[i] - alpha*si;
+    r.data_[i] = ri;
+    const double ui = diag.data_[i]*ri;
+    u.data_[i] = ui;
+    partial[0] += ri*ui;
+    partial[2] += ri*ri;
+  }
+
+  // The product reads all of u.
+  wait();
+
+  double* data = A.data_;
+  auto rows = A.rows_;
+  auto columns = A.columns_;
+  for (size_t i=start_; i<end_; i++)
+  {
+    double sum = 0.0;
+    for (index_type j=rows[i]; j<rows[i+1]; j++)
+      sum += data[j]*u.data_[columns[j]];
+    w.data_[i] = sum;
+    partial[1] += sum*u.data_[i];
+  }
+
+  // The barrier in the reduction also keeps the next step from overwriting u while
+  // other threads are still reading it.
+  reduce_sum(partial, 3);
+  gamma = partial[0];
+  delta = partial[1];
+  rnorm = sqrt(partial[2]);
+}
+
+bool ParallelLinearAlgebra::new_block(size_t cols, ParallelBlock& B)
+{
+  wait();
+
+  data_.setSuccess(proc_);
+  if (proc_ == 0)
+  {
+    try
+    {
+      DenseColumnMatrixHandle mat(makeShared<DenseColumnMatrix>(data_.getSize()*cols));
+      data_.setCurrentMatrix(mat);
+      data_.addVector(mat);
+    }
+    catch (...)
+    {
+      data_.setFail(0);
+    }
+  }
+
+  wait();
+
+  if (!data_.isSuccess(0))
+    return false;
+
+  auto mat = data_.getCurrentMatrix();
+  wait();
+
+  B.data_ = mat->data();
+  B.size_ = size_;
+  B.cols_ = cols;
+  return true;
+}
+
+void ParallelLinearAlgebra::copy(const DenseMatrix& a, ParallelBlock& r)
+{
+  const size_t cols = r.cols_;
+  for (size_t i=start_; i<end_; i++)
+    for (size_t c=0; c<cols; c++)
+      r.data_[i*cols+c] = a(i,c);
+}
+
+void ParallelLinearAlgebra::copy(const ParallelBlock& a, DenseMatrix& r)
+{
+  const size_t cols = a.cols_;
+  for (size_t i=start_; i<end_; i++)
+    for (size_t c=0; c<cols; c++)
+      r(i,c) = a.data_[i*cols+c];
+}
+
+void ParallelLinearAlgebra::copy(const ParallelBlock& a, ParallelBlock& r)
+{
+  std::copy(a.data_+start_*a.cols_, a.data_+end_*a.cols_, r.data_+start_*r.cols_);
+}
+
+void ParallelLinearAlgebra::zeros(ParallelBlock& r)
+{
+  std::fill(r.data_+start_*r.cols_, r.data_+end_*r.cols_, 0.0);
+}
+
+void ParallelLinearAlgebra::sub(const ParallelBlock& a, const ParallelBlock& b, ParallelBlock& r)
+{
+  for (size_t j=start_*r.cols_; j<end_*r.cols_; j++)
+    r.data_[j] = a.data_[j]-b.data_[j];
+}
+
+void ParallelLinearAlgebra::norms(const ParallelBlock& a, double* norms)
+{
+  const size_t cols = a.cols_;
+  partial_.assign(cols, 0.0);
+  for (size_t j=start_*cols; j<end_*cols; j++)
+    partial_[j%cols] += a.data_[j]*a.data_[j];
+
+  reduce_sum(&partial_[0], static_cast<int>(cols));
+  for (size_t c=0; c<cols; c++)
+    norms[c] = sqrt(partial_[c]);
+}
+
+void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelBlock& b, ParallelBlock& r)
+{
+  wait();
+
+  const size_t cols = b.cols_;
+  double* data = a.data_;
+  auto rows = a.rows_;
+  auto columns = a.columns_;
+
+  for (size_t i=start_; i<end_; i++)
+  {
+    double* out = r.data_+i*cols;
+    for (size_t c=0; c<cols; c++) out[c] = 0.0;
+    for (index_type j=rows[i]; j<rows[i+1]; j++)
+    {
+      const double aij = data[j];
+      const double* in = b.data_+columns[j]*cols;
+      for (size_t c=0; c<cols; c++) out[c] += aij*in[c];
+    }
+  }
+}
+
+void ParallelLinearAlgebra::mult_dot(const ParallelVector& a, const ParallelBlock& b, ParallelBlock& r, double* dots)
+{
+  const size_t cols = b.cols_;
+  partial_.assign(cols, 0.0);
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double ai = a.data_[i];
+    for (size_t c=0, k=i*cols; c<cols; c++, k++)
+    {
+      const double rk = ai*b.data_[k];
+      r.data_[k] = rk;
+      partial_[c] += rk*b.data_[k];
+    }
+  }
+
+  reduce_sum(&partial_[0], static_cast<int>(cols));
+  std::copy(partial_.begin(), partial_.end(), dots);
+}
+
+void ParallelLinearAlgebra::mult_dot(const ParallelMatrix& a, const ParallelBlock& b, ParallelBlock& r, double* dots)
+{
+  mult(a, b, r);
+
+  const size_t cols = b.cols_;
+  partial_.assign(cols, 0.0);
+  for (size_t j=start_*cols; j<end_*cols; j++)
+    partial_[j%cols] += r.data_[j]*b.data_[j];
+
+  reduce_sum(&partial_[0], static_cast<int>(cols));
+  std::copy(partial_.begin(), partial_.end(), dots);
+}
+
+void ParallelLinearAlgebra::cg_step(const double* alpha, const double* beta, const ParallelMatrix& A,
+  const ParallelVector& diag, ParallelBlock& x, ParallelBlock& r, ParallelBlock& u, ParallelBlock& w,
+  ParallelBlock& p, ParallelBlock& s, double* gamma, double* delta, double* rnorm)
+{
+  const size_t cols = x.cols_;
+  partial_.assign(3*cols, 0.0);
+  double* gammaPartial = &partial_[0];
+  double* deltaPartial = gammaPartial+cols;
+  double* rnormPartial = deltaPartial+cols;
+
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double di = diag.data_[i];
+    for (size_t c=0, k=i*cols; c<cols; c++, k++)
+    {
+      const double pk = u.data_[k] + beta[c]*p.data_[k];
+      const double sk = w.data_[k] + beta[c]*s.data_[k];
+      p.data_[k] = pk;
+      s.data_[k] = sk;
+      x.data_[k] += alpha[c]*pk;
+      const double rk = r.data_[k] - alpha[c]*sk;
+      r.data_[k] = rk;
+      const double uk = di*rk;
+      u.data_[k] = uk;
+      gammaPartial[c] += rk*uk;
+      rnormPartial[c] += rk*rk;
+    }
+  }
+
+  // The product reads all of u.
+  mult(A, u, w);
+
+  for (size_t j=start_*cols; j<end_*cols; j++)
+    deltaPartial[j%cols] += w.data_[j]*u.data_[j];
+
+  // As in the single vector step, the barrier in the reduction keeps the next step
+  // from overwriting u while other threads are still reading it.
+  reduce_sum(&partial_[0], static_cast<int>(3*cols));
+  for (size_t c=0; c<cols; c++)
+  {
+    gamma[c] = gammaPartial[c];
+    delta[c] = deltaPartial[c];
+    rnorm[c] = sqrt(rnormPartial[c]);
+  }
+}
+
 void ParallelLinearAlgebra::mult_trans(ParallelMatrix& a, ParallelVector& b, ParallelVector& r)
 {
   wait();
@@ -723,30 +1007,42 @@ void ParallelLinearAlgebra::absdiag(const ParallelMatrix& a, ParallelVector& r)
 
 double ParallelLinearAlgebra::reduce_sum(double val)
 {
+  reduce_sum(&val, 1);
+  return (val);
+}
+
+void ParallelLinearAlgebra::reduce_sum(double* values, int count)
+{
+  const int width = data_.reductionWidth();
   int buffer = reduce_buffer_;
-  reduce_[buffer][proc_] = val;
+  for (int k=0; k<count; k++) reduce_[buffer][proc_*width+k] = values[k];
   if (reduce_buffer_)
     reduce_buffer_ = 0;
   else
     reduce_buffer_ = 1;
   wait();
 
-  double ret = 0.0; for (int j=0; j<nproc_;j++) ret += reduce_[buffer][j];
-  return (ret);
+  // Sum in thread order so every thread gets bit-identical results.
+  for (int k=0; k<count; k++)
+  {
+    double ret = 0.0; for (int j=0; j<nproc_;j++) ret += reduce_[buffer][j*width+k];
+    values[k] = ret;
+  }
 }
 
 /// @todo: std::max_element
 double ParallelLinearAlgebra::reduce_max(double val)
 {
   int buffer = reduce_buffer_;
-  reduce_[buffer][proc_] = val;
+  reduce_[buffer][proc_*data_.reductionWidth()] = val;
   if (reduce_buffer_)
     reduce_buffer_ = 0;
   else
     reduce_buffer_ = 1;
   wait();
 
-  double ret = -(DBL_MAX); for (int j=0; j<nproc_;j++) if (reduce_[buffer][j] > ret) ret = reduce_[buffer][j];
+  const int width = data_.reductionWidth();
+  double ret = -(DBL_MAX); for (int j=0; j<nproc_;j++) if (reduce_[buffer][j*width] > ret) ret = reduce_[buffer][j*width];
   return (ret);
 }
 
@@ -754,36 +1050,53 @@ double ParallelLinearAlgebra::reduce_max(double val)
 double ParallelLinearAlgebra::reduce_min(double val)
 {
   int buffer = reduce_buffer_;
-  reduce_[buffer][proc_] = val;
+  reduce_[buffer][proc_*data_.reductionWidth()] = val;
   if (reduce_buffer_)
     reduce_buffer_ = 0;
   else
     reduce_buffer_ = 1;
   wait();
 
-  double ret = DBL_MAX; for (int j=0; j<nproc_;j++) if (reduce_[buffer][j] < ret) ret = reduce_[buffer][j];
+  const int width = data_.reductionWidth();
+  double ret = DBL_MAX; for (int j=0; j<nproc_;j++) if (reduce_[buffer][j*width] < ret) ret = reduce_[buffer][j*width];
   return (ret);
 }
 
 
 
+size_t SolverInputs::numRightHandSides() const
+{
+  return B ? B->ncols() : 1;
+}
+
+bool SolverInputs::sizesMatch() const
+{
+  const auto size = A->nrows();
+  if (B)
+    return B->nrows() == size && X->nrows() == size && X0->nrows() == size
+      && X->ncols() == B->ncols() && X0->ncols() == B->ncols();
+  return b->nrows() == size && x->nrows() == size && x0->nrows() == size;
+}
+
 bool ParallelLinearAlgebraBase::start_parallel(SolverInputs& matrices, int nproc) const
 {
   size_t size = matrices.A->nrows();
-  if (matrices.b->nrows() != size
-    || matrices.x->nrows() != size
-    || matrices.x0->nrows() != size)
+  if (!matrices.sizesMatch())
     return false;
 
+  // RunTasks never starts more threads than the core limit allows, and the shared
+  // barrier must be sized for exactly the threads that will arrive at it.
+  const int numCores = static_cast<int>(Parallel::NumCores());
+  if (nproc < 1 || nproc > numCores)
+  {
+    nproc = numCores;
+  }
+
   /// Require a minimum of 50 variables per processor
   /// Below that parallelism is overhead
   if (nproc*50 > static_cast<int>(size))
   {
-    nproc = static_cast<int>(size) / 50;
-  }
-  if (nproc < 1)
-  {
-    nproc = Parallel::NumCores();
+    nproc = std::max(1, static_cast<int>(size) / 50);
   }
 
   ParallelLinearAlgebraSharedData sharedData(matrices, nproc);
@@ -806,11 +1119,10 @@ ParallelLinearAlgebraSharedData::ParallelLinearAlgebraSharedData(const SolverInp
   imatrices_(inputs),
   barrier_("Parallel Linear Algebra", numProcs),
   numProcs_(numProcs),
-  reduce1_(numProcs),
-  reduce2_(numProcs)
+  reductionWidth_(std::max(4, 3*static_cast<int>(inputs.numRightHandSides()))),
+  reduce1_(numProcs*reductionWidth_),
+  reduce2_(numProcs*reductionWidth_)
 {
-  if (inputs.b->nrows() != size_
-    || inputs.x->nrows() != size_
-    || inputs.x0->nrows() != size_)
+  if (!inputs.sizesMatch())
     BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Dimension mismatch")); /// @todo: use new DimensionMismatch exception type
 }
@@ -55,12 +55,24 @@ namespace Math {
     Datatypes::DenseColumnMatrixHandle x0;
     Datatypes::DenseColumnMatrixHandle x;
 
+    // Several right-hand sides, one per column, for the multi-RHS solvers. When B is
+    // set, b, x0 and x are not used.
+    Datatypes::DenseMatrixHandle B;
+    Datatypes::DenseMatrixHandle X0;
+    Datatypes::DenseMatrixHandle X;
+
+    size_t numRightHandSides() const;
+    bool sizesMatch() const;
+
     void clear()
     {
       A.reset();
       b.reset();
       x0.reset();
       x.reset();
+      B.reset();
+      X0.reset();
+      X.reset();
     }
   };
 
@@ -93,6 +105,11 @@ namespace Math {
 
     SolverInputs& inputs() { return imatrices_; }
 
+    /// Each thread owns this many consecutive slots of a reduction buffer, so several
+    /// values can be reduced behind a single barrier. The multi-RHS kernels reduce
+    /// three values per right-hand side.
+    int reductionWidth() const { return reductionWidth_; }
+
     double* reduceBuffer1() { return &reduce1_[0]; }
     double* reduceBuffer2() { return &reduce2_[0]; }
 
@@ -104,6 +121,7 @@ namespace Math {
     SolverInputs imatrices_;
     SCIRun::Core::Thread::Barrier barrier_;
     int numProcs_;
+    int reductionWidth_;
     /// classes for communication
     std::vector<double> reduce1_;
     std::vector<double> reduce2_;
@@ -147,6 +165,15 @@ public:
       size_t   nnz_;
   };
 
+  // Several vectors stored row by row, so that a sparse matrix-block product reads
+  // every row of the matrix once for all of them.
+  class ParallelBlock {
+    public:
+      double* data_;  // entry (i,c) is data_[i*cols_+c]
+      size_t size_;
+      size_t cols_;
+  };
+
   // Constructor
   ParallelLinearAlgebra(ParallelLinearAlgebraSharedData& base, int proc);
 
@@ -185,8 +212,45 @@ public:
 
   void mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
 
+  // Fused kernels: one pass over the local rows and one reduction instead of two.
+  // r = a.*b; returns dot(r,a) (preconditioner apply + dot)
+  double mult_dot(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
+  // r = a*b; returns dot(r,b) (SpMV + dot). r must not alias b.
+  double mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
+  // r = s*a + b; returns norm(r) (axpy + norm)
+  double scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
+
+  // One iteration of the Chronopoulos/Gear formulation of Jacobi-preconditioned CG,
+  // which needs two synchronizations instead of the four of the textbook loop:
+  //   p = u + beta*p,  s = w + beta*s,  x += alpha*p,  r -= alpha*s,  u = diag.*r,
+  //   w = A*u,  gamma = dot(r,u),  delta = dot(w,u),  rnorm = norm(r)
+  // where s tracks A*p and w tracks A*u. p and s must be zero before the first step.
+  void cg_step(double alpha, double beta, const ParallelMatrix& A, const ParallelVector& diag,
+    ParallelVector& x, ParallelVector& r, ParallelVector& u, ParallelVector& w,
+    ParallelVector& p, ParallelVector& s, double& gamma, double& delta, double& rnorm);
+
   void absdiag(const ParallelMatrix& a, ParallelVector& r);
 
+  // Multi-RHS kernels. Per column results are written to arrays of length cols_.
+  bool new_block(size_t cols, ParallelBlock& B);
+  void copy(const Datatypes::DenseMatrix& a, ParallelBlock& r);
+  void copy(const ParallelBlock& a, Datatypes::DenseMatrix& r);
+  void copy(const ParallelBlock& a, ParallelBlock& r);
+  void zeros(ParallelBlock& r);
+  void sub(const ParallelBlock& a, const ParallelBlock& b, ParallelBlock& r);
+  void norms(const ParallelBlock& a, double* norms);
+  // r = a*b (sparse matrix times block)
+  void mult(const ParallelMatrix& a, const ParallelBlock& b, ParallelBlock& r);
+  // r = a.*b for every column; dots = column dots of r and b
+  void mult_dot(const ParallelVector& a, const ParallelBlock& b, ParallelBlock& r, double* dots);
+  // r = a*b; dots = column dots of r and b. r must not alias b.
+  void mult_dot(const ParallelMatrix& a, const ParallelBlock& b, ParallelBlock& r, double* dots);
+  // cg_step for every column, with one matrix pass and one reduction for all of them.
+  // A column with alpha = beta = 0 is left unchanged.
+  void cg_step(const double* alpha, const double* beta, const ParallelMatrix& A, const ParallelVector& diag,
+    ParallelBlock& x, ParallelBlock& r, ParallelBlock& u, ParallelBlock& w,
+    ParallelBlock& p, ParallelBlock& s, double* gamma, double* delta, double* rnorm);
+
   void ones(ParallelVector& r);
 
   int  proc() { return proc_; }
@@ -197,6 +261,7 @@ public:
 
 private:
   double reduce_sum(double val);
+  void reduce_sum(double* values, int count);
   double reduce_min(double val);
   double reduce_max(double val);
 
@@ -213,6 +278,7 @@ private:
 
   double* reduce_[2];
   int     reduce_buffer_;
+  std::vector<double> partial_;
 
 
 };
@@ -0,0 +1,189 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Math/LinearSystem/AlgebraicMultigrid.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <thread>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
+
+namespace
+{
+  // 7-point finite difference Laplacian on an n^3 grid with Dirichlet boundaries
+  SparseRowMatrixHandle poisson3D(int n)
+  {
+    typedef SparseRowMatrix::Triplet T;
+    std::vector<T> triplets;
+    auto index = [n](int i, int j, int k) { return (k * n + j) * n + i; };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const auto row = index(i, j, k);
+          triplets.emplace_back(row, row, 6.0);
+          if (i > 0) triplets.emplace_back(row, index(i - 1, j, k), -1.0);
+          if (i < n - 1) triplets.emplace_back(row, index(i + 1, j, k), -1.0);
+          if (j > 0) triplets.emplace_back(row, index(i, j - 1, k), -1.0);
+          if (j < n - 1) triplets.emplace_back(row, index(i, j + 1, k), -1.0);
+          if (k > 0) triplets.emplace_back(row, index(i, j, k - 1), -1.0);
+          if (k < n - 1) triplets.emplace_back(row, index(i, j, k + 1), -1.0);
+        }
+    const auto size = n * n * n;
+    SparseRowMatrixHandle A(new SparseRowMatrix(size, size));
+    A->setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+  }
+
+  DenseColumnMatrixHandle onesRhs(index_type size)
+  {
+    auto b = makeShared<DenseColumnMatrix>(size);
+    b->setOnes();
+    return b;
+  }
+
+  double relativeResidual(SparseRowMatrixHandle A, DenseColumnMatrixHandle x, DenseColumnMatrixHandle b)
+  {
+    return (*A * *x - *b).norm() / b->norm();
+  }
+}
+
+TEST(AlgebraicMultigridTests, BuildsCoarseningHierarchy)
+{
+  auto A = poisson3D(30);
+  AlgebraicMultigrid amg(A);
+
+  EXPECT_GT(amg.numLevels(), 2u);
+  EXPECT_EQ(A->nrows(), amg.levelSize(0));
+  for (size_t level = 1; level < amg.numLevels(); ++level)
+    EXPECT_LT(amg.levelSize(level), amg.levelSize(level - 1) / 2);
+  EXPECT_LE(amg.levelSize(amg.numLevels() - 1), 500);
+  EXPECT_LT(amg.operatorComplexity(), 3.0);
+}
+
+TEST(AlgebraicMultigridTests, VCycleIsSymmetric)
+{
+  auto A = poisson3D(12);
+  AlgebraicMultigrid amg(A, [] { AlgebraicMultigrid::Options o; o.coarsestSize = 50; return o; }());
+  ASSERT_GT(amg.numLevels(), 1u);
+
+  AlgebraicMultigrid::Vector u = AlgebraicMultigrid::Vector::Random(A->nrows());
+  AlgebraicMultigrid::Vector v = AlgebraicMultigrid::Vector::Random(A->nrows());
+  AlgebraicMultigrid::Vector Mu, Mv;
+  amg.apply(u, Mu);
+  amg.apply(v, Mv);
+
+  EXPECT_NEAR(v.dot(Mu), u.dot(Mv), 1e-10 * std::abs(v.dot(Mu)));
+  EXPECT_GT(u.dot(Mu), 0.0);
+}
+
+TEST(AlgebraicMultigridTests, SharedHierarchyCanBeAppliedFromSeveralThreads)
+{
+  auto A = poisson3D(12);
+  const AlgebraicMultigrid amg(A, [] { AlgebraicMultigrid::Options o; o.coarsestSize = 50; return o; }());
+  ASSERT_GT(amg.numLevels(), 1u);
+
+  const int numThreads = 4;
+  std::vector<AlgebraicMultigrid::Vector> r, expected(numThreads), z(numThreads);
+  for (int t = 0; t < numThreads; ++t)
+  {
+    r.push_back(AlgebraicMultigrid::Vector::Random(A->nrows()));
+    amg.apply(r[t], expected[t]);
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t)
+    threads.emplace_back([&, t]
+    {
+      auto work = amg.makeWorkspace();
+      for (int i = 0; i < 20; ++i)
+        amg.apply(r[t], z[t], work);
+    });
+  for (auto& thread : threads)
+    thread.join();
+
+  for (int t = 0; t < numThreads; ++t)
+    EXPECT_EQ(expected[t], z[t]) << t;
+}
+
+TEST(AlgebraicMultigridTests, PreconditionedCGNeedsFarFewerIterationsThanJacobi)
+{
+  auto A = poisson3D(30);
+  auto b = onesRhs(A->nrows());
+
+  SolveLinearSystemAlgo algo;
+  algo.set(Variables::TargetError, 1e-8);
+  algo.set(Variables::MaxIterations, 25);
+  algo.setOption(Variables::Method, "cg");
+
+  DenseColumnMatrixHandle x;
+  algo.setOption(Variables::Preconditioner, "Jacobi");
+  ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+  EXPECT_GT(relativeResidual(A, x, b), 1e-4);
+
+  algo.setOption(Variables::Preconditioner, "AMG");
+  ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+  EXPECT_LT(relativeResidual(A, x, b), 1e-7);
+}
+
+TEST(AlgebraicMultigridTests, SolveLinearSystemAlgoRejectsAMGForOtherMethods)
+{
+  auto A = poisson3D(5);
+  auto b = onesRhs(A->nrows());
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "minres");
+  algo.setOption(Variables::Preconditioner, "AMG");
+
+  DenseColumnMatrixHandle x;
+  EXPECT_THROW(algo.run(A, b, DenseColumnMatrixHandle(), x), AlgorithmInputException);
+}
+
+TEST(AlgebraicMultigridTests, CacheReusesHierarchyOfSameMatrix)
+{
+  auto A = poisson3D(10);
+  AlgebraicMultigridCache cache;
+
+  auto first = cache.get(A);
+  auto second = cache.get(A);
+  EXPECT_EQ(first, second);
+
+  SparseRowMatrixHandle copy(A->clone());
+  auto third = cache.get(copy);
+  EXPECT_NE(first, third);
+  EXPECT_EQ(third, cache.get(copy));
+}
@@ -976,3 +976,240 @@ TEST(ParallelArithmeticTests, CanComputeDotProductMulti)
   EXPECT_EQ(-9 , v23);
   EXPECT_EQ(9 , v13);
 }
+
+TEST(ParallelArithmeticTests, CanMultiplyVectorsComponentWiseAndDot)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1, v2, vR;
+  auto vec1 = vector1();
+  auto vec2 = vector2();
+  auto vecR = vector3();
+  pla.add_vector(vec1,v1);
+  pla.add_vector(vec2,v2);
+  pla.add_vector(vecR,vR);
+
+  EXPECT_EQ(-72, pla.mult_dot(v1,v2,vR));
+  EXPECT_EQ(-1, vR.data_[0]);
+  EXPECT_EQ(-16, vR.data_[2]);
+  EXPECT_EQ(0, vR.data_[300]);
+  EXPECT_EQ(-1, vR.data_[size-1]);
+}
+
+TEST(ParallelArithmeticTests, CanMultiplyMatrixByVectorAndDot)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1, vR;
+  auto vec1 = vector1();
+  auto vecR = vector2();
+  pla.add_vector(vec1,v1);
+  pla.add_vector(vecR,vR);
+
+  ParallelLinearAlgebra::ParallelMatrix m1;
+  auto mat1 = matrix1();
+  pla.add_matrix(mat1,m1);
+
+  EXPECT_EQ(-5, pla.mult_dot(m1,v1,vR));
+  EXPECT_EQ(1, vR.data_[0]);
+  EXPECT_EQ(-4, vR.data_[1]);
+  EXPECT_EQ(0, vR.data_[300]);
+  EXPECT_EQ(-2, vR.data_[size-1]);
+}
+
+TEST(ParallelArithmeticTests, CanScaleAddAndCompute2Norm)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1, v3, vR;
+  auto vec1 = vector1();
+  auto vec3 = vector3();
+  auto vecR = vector2();
+  pla.add_vector(vec1,v1);
+  pla.add_vector(vec3,v3);
+  pla.add_vector(vecR,vR);
+
+  EXPECT_NEAR(13.1909, pla.scale_add_norm(2,v1,v3,vR), 0.0001);
+  EXPECT_EQ(2, vR.data_[0]);
+  EXPECT_EQ(5, vR.data_[1]);
+  EXPECT_EQ(0, vR.data_[300]);
+  EXPECT_EQ(-9, vR.data_[size-1]);
+}
+
+namespace
+{
+  SolverInputs tridiagonalSystem()
+  {
+    SolverInputs system;
+    std::vector<Eigen::Triplet<double>> entries;
+    for (int i = 0; i < size; ++i)
+    {
+      entries.emplace_back(i, i, 3.0);
+      if (i > 0)
+        entries.emplace_back(i, i - 1, -1.0);
+      if (i < size - 1)
+        entries.emplace_back(i, i + 1, -1.0);
+    }
+    system.A = makeShared<SparseRowMatrix>(size, size);
+    system.A->setFromTriplets(entries.begin(), entries.end());
+    system.b = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Ones(size));
+    system.x0 = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Zero(size));
+    system.x = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Zero(size));
+    return system;
+  }
+
+  int solveWithFusedCG(ParallelLinearAlgebraSharedData& data, int proc)
+  {
+    ParallelLinearAlgebra pla(data, proc);
+    ParallelLinearAlgebra::ParallelMatrix A;
+    ParallelLinearAlgebra::ParallelVector B, X, DIAG, R, U, W, P, S;
+    pla.add_matrix(data.inputs().A, A);
+    pla.add_vector(data.inputs().b, B);
+    pla.add_vector(data.inputs().x, X);
+    pla.new_vector(DIAG);
+    pla.new_vector(R);
+    pla.new_vector(U);
+    pla.new_vector(W);
+    pla.new_vector(P);
+    pla.new_vector(S);
+
+    pla.absdiag(A, DIAG);
+    pla.absthreshold_invert(DIAG, DIAG, 1e-18);
+    pla.copy(B, R);
+    pla.zeros(P);
+    pla.zeros(S);
+    const double bnorm = pla.norm(B);
+    double gamma = pla.mult_dot(R, DIAG, U);
+    double delta = pla.mult_dot(A, U, W);
+    double alpha = gamma / delta, beta = 0, rnorm = bnorm;
+
+    int niter = 0;
+    while (rnorm / bnorm > 1e-12 && niter < size)
+    {
+      double gammaNext;
+      pla.cg_step(alpha, beta, A, DIAG, X, R, U, W, P, S, gammaNext, delta, rnorm);
+      beta = gammaNext / gamma;
+      alpha = gammaNext / (delta - beta * gammaNext / alpha);
+      gamma = gammaNext;
+      ++niter;
+    }
+    return niter;
+  }
+}
+
+TEST(ParallelArithmeticTests, FusedCGStepSolvesSPDSystemMulti)
+{
+  for (int numProcs : { 1, 4 })
+  {
+    auto system = tridiagonalSystem();
+    ParallelLinearAlgebraSharedData data(system, numProcs);
+
+    std::vector<int> iterations(numProcs);
+    std::vector<std::thread> threads;
+    for (int proc = 0; proc < numProcs; ++proc)
+      threads.emplace_back([&data, &iterations, proc]() { iterations[proc] = solveWithFusedCG(data, proc); });
+    for (auto& t : threads)
+      t.join();
+
+    // every thread follows the same scalar recurrence
+    for (int proc = 1; proc < numProcs; ++proc)
+      EXPECT_EQ(iterations[0], iterations[proc]);
+    EXPECT_LT(iterations[0], 50);
+
+    DenseColumnMatrix residual = *system.b - *system.A * *system.x;
+    EXPECT_LT(residual.norm(), 1e-9);
+  }
+}
+
+namespace
+{
+  int solveWithBlockCG(ParallelLinearAlgebraSharedData& data, int proc)
+  {
+    ParallelLinearAlgebra pla(data, proc);
+    const size_t cols = data.inputs().B->ncols();
+    ParallelLinearAlgebra::ParallelMatrix A;
+    ParallelLinearAlgebra::ParallelVector DIAG;
+    ParallelLinearAlgebra::ParallelBlock B, X, R, U, W, P, S;
+    pla.add_matrix(data.inputs().A, A);
+    pla.new_vector(DIAG);
+    pla.new_block(cols, B);
+    pla.new_block(cols, X);
+    pla.new_block(cols, R);
+    pla.new_block(cols, U);
+    pla.new_block(cols, W);
+    pla.new_block(cols, P);
+    pla.new_block(cols, S);
+
+    pla.absdiag(A, DIAG);
+    pla.absthreshold_invert(DIAG, DIAG, 1e-18);
+    pla.copy(*data.inputs().B, B);
+    pla.copy(*data.inputs().X0, X);
+    pla.copy(B, R);
+    pla.zeros(P);
+    pla.zeros(S);
+
+    std::vector<double> bnorm(cols), rnorm(cols), gamma(cols), gammaNext(cols), delta(cols), alpha(cols), beta(cols, 0.0);
+    pla.norms(B, &bnorm[0]);
+    pla.mult_dot(DIAG, R, U, &gamma[0]);
+    pla.mult_dot(A, U, W, &delta[0]);
+    std::vector<bool> active(cols);
+    for (size_t c = 0; c < cols; ++c)
+    {
+      active[c] = bnorm[c] > 0;
+      alpha[c] = active[c] ? gamma[c] / delta[c] : 0.0;
+    }
+
+    int niter = 0;
+    while (std::find(active.begin(), active.end(), true) != active.end() && niter < size)
+    {
+      pla.cg_step(&alpha[0], &beta[0], A, DIAG, X, R, U, W, P, S, &gammaNext[0], &delta[0], &rnorm[0]);
+      for (size_t c = 0; c < cols; ++c)
+      {
+        active[c] = active[c] && rnorm[c] / bnorm[c] > 1e-12;
+        beta[c] = active[c] ? gammaNext[c] / gamma[c] : 0.0;
+        alpha[c] = active[c] ? gammaNext[c] / (delta[c] - beta[c] * gammaNext[c] / alpha[c]) : 0.0;
+        gamma[c] = gammaNext[c];
+      }
+      ++niter;
+    }
+    pla.copy(X, *data.inputs().X);
+    return niter;
+  }
+}
+
+TEST(ParallelArithmeticTests, BlockCGStepSolvesSeveralRightHandSidesMulti)
+{
+  for (int numProcs : { 1, 4 })
+  {
+    auto system = tridiagonalSystem();
+    system.B = makeShared<DenseMatrix>(DenseMatrix::Zero(size, 3));
+    for (int i = 0; i < size; ++i)
+    {
+      (*system.B)(i, 0) = 1;
+      (*system.B)(i, 1) = i % 7 - 3;
+      // column 2 stays zero and must not produce NaNs
+    }
+    system.X0 = makeShared<DenseMatrix>(DenseMatrix::Zero(size, 3));
+    system.X = makeShared<DenseMatrix>(DenseMatrix::Zero(size, 3));
+    ParallelLinearAlgebraSharedData data(system, numProcs);
+
+    std::vector<int> iterations(numProcs);
+    std::vector<std::thread> threads;
+    for (int proc = 0; proc < numProcs; ++proc)
+      threads.emplace_back([&data, &iterations, proc]() { iterations[proc] = solveWithBlockCG(data, proc); });
+    for (auto& t : threads)
+      t.join();
+
+    for (int proc = 1; proc < numProcs; ++proc)
+      EXPECT_EQ(iterations[0], iterations[proc]);
+    EXPECT_LT(iterations[0], 50);
+
+    DenseMatrix residual = *system.B - *system.A * *system.X;
+    for (int c = 0; c < 3; ++c)
+      EXPECT_LT(residual.col(c).norm(), 1e-9) << c;
+    EXPECT_EQ(0, system.X->col(2).norm());
+  }
+}
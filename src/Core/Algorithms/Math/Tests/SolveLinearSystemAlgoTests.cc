@@ -147,3 +147,60 @@ TEST(SolveLinearSystemTests, DISABLED_CanSolveDarrell_MINRES)
   double solutionError = 2.4;
   CanSolveDarrellWithMethod("minres", solutionError);
 }
+
+namespace
+{
+  SparseRowMatrixHandle laplacian2D(int n)
+  {
+    typedef SparseRowMatrix::Triplet T;
+    std::vector<T> triplets;
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+      {
+        const int row = j * n + i;
+        triplets.emplace_back(row, row, 4.0);
+        if (i > 0) triplets.emplace_back(row, row - 1, -1.0);
+        if (i < n - 1) triplets.emplace_back(row, row + 1, -1.0);
+        if (j > 0) triplets.emplace_back(row, row - n, -1.0);
+        if (j < n - 1) triplets.emplace_back(row, row + n, -1.0);
+      }
+    SparseRowMatrixHandle A(new SparseRowMatrix(n * n, n * n));
+    A->setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+  }
+}
+
+TEST(SolveLinearSystemTests, SolvesSeveralRightHandSidesLikeOneAtATime)
+{
+  auto A = laplacian2D(40);
+  DenseMatrixHandle rhs(new DenseMatrix(A->nrows(), 4));
+  for (size_t i = 0; i < rhs->nrows(); ++i)
+  {
+    (*rhs)(i, 0) = 1;
+    (*rhs)(i, 1) = i % 11 - 5;
+    (*rhs)(i, 2) = i == 17 ? 1 : 0;
+    (*rhs)(i, 3) = -(*rhs)(i, 1);
+  }
+
+  for (const std::string method : { "cg", "bicg" })
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, 1000);
+    algo.set(Variables::TargetError, 1e-10);
+    algo.setOption(Variables::Method, method);
+
+    DenseMatrixHandle solution;
+    ASSERT_TRUE(algo.run(A, rhs, DenseMatrixHandle(), solution));
+    ASSERT_TRUE(solution != nullptr);
+    EXPECT_EQ(rhs->nrows(), solution->nrows());
+    EXPECT_EQ(rhs->ncols(), solution->ncols());
+
+    for (size_t col = 0; col < rhs->ncols(); ++col)
+    {
+      DenseColumnMatrixHandle single;
+      ASSERT_TRUE(algo.run(A, makeShared<DenseColumnMatrix>(rhs->col(col)), DenseColumnMatrixHandle(), single));
+      EXPECT_LT((solution->col(col) - *single).norm(), 1e-8 * single->norm()) << method << " " << col;
+      EXPECT_LT((*A * solution->col(col) - rhs->col(col)).norm(), 1e-9 * rhs->col(col).norm()) << method << " " << col;
+    }
+  }
+}
@@ -35,7 +35,11 @@
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Dataflow/State/SimpleMapModuleState.h>
 #include <Dataflow/Network/ModuleReexecutionStrategies.h>
+#include <Dataflow/Network/PortDataCache.h>
+#include <Dataflow/Network/ModuleResultStore.h>
+#include <Dataflow/Network/ExecutionProfiler.h>
 #include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
+#include <Dataflow/Engine/Scheduler/ModuleConcurrency.h>
 #include <Core/Command/GlobalCommandBuilderFromCommandLine.h>
 #include <Core/Logging/Log.h>
 #include <Core/Logging/ApplicationHelper.h>
@@ -159,6 +163,21 @@ void Application::readCommandLine(int argc, const char* argv[])
     auto maxCoresOption = private_->parameters_->developerParameters()->maxCores();
     if (maxCoresOption)
       Thread::Parallel::SetMaximumCores(*maxCoresOption);
+    auto maxModulesOption = private_->parameters_->developerParameters()->maxConcurrentModules();
+    if (maxModulesOption)
+      ModuleConcurrency::SetMaximumConcurrentModules(*maxModulesOption);
+    auto portCacheMegabytes = private_->parameters_->developerParameters()->portCacheMegabytes();
+    if (portCacheMegabytes)
+      PortDataCache::instance().setMemoryBudget(static_cast<size_t>(*portCacheMegabytes) * 1024 * 1024);
+    auto portCacheDirectory = private_->parameters_->developerParameters()->portCacheDirectory();
+    if (portCacheDirectory)
+      PortDataCache::instance().setSpillDirectory(*portCacheDirectory);
+    auto memoizeDirectory = private_->parameters_->developerParameters()->memoizeDirectory();
+    if (memoizeDirectory)
+      ModuleResultStore::instance().setDirectory(*memoizeDirectory);
+    auto profileFile = private_->parameters_->developerParameters()->profileFile();
+    if (profileFile)
+      ExecutionProfiler::instance().setTraceFile(*profileFile);
 
     LogSettings::Instance().setVerbose(parameters()->verboseMode());
   }
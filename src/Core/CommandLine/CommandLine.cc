@@ -70,6 +70,11 @@ public:
       //("frameInitLimit", po::value<int>(), "ViewScene frame init limit--increase if renderer fails")
       ("guiExpandFactor", po::value<double>(), "Expansion factor for high resolution displays")
       ("max-cores", po::value<unsigned int>(), "Limit the number of cores used by multithreaded algorithms")
+      ("max-modules", po::value<unsigned int>(), "Limit the number of modules executed at once")
+      ("port-cache-mb", po::value<unsigned int>(), "Memory budget in MB for data cached on output ports")
+      ("port-cache-dir", po::value<std::string>(), "Directory to spill evicted port data to")
+      ("memoize-dir", po::value<std::string>(), "Reuse module results stored in this directory")
+      ("profile", po::value<std::string>(), "Write a Chrome trace of each network execution to this file")
       ("list-modules", "print list of available modules")
       ;
 
@@ -119,9 +124,16 @@ public:
     const std::optional<int>& frameInitLimit,
     const std::optional<int>& regressionTimeout,
     const std::optional<unsigned int>& maxCores,
-    const std::optional<double>& guiExpandFactor
+    const std::optional<unsigned int>& maxConcurrentModules,
+    const std::optional<double>& guiExpandFactor,
+    const std::optional<unsigned int>& portCacheMegabytes,
+    const std::optional<std::string>& portCacheDirectory,
+    const std::optional<std::string>& memoizeDirectory,
+    const std::optional<std::string>& profileFile
     ) : threadMode_(threadMode), reexecuteMode_(reexecuteMode), frameInitLimit_(frameInitLimit),
-    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor)
+    regressionTimeout_(regressionTimeout), maxCores_(maxCores), maxConcurrentModules_(maxConcurrentModules),
+    guiExpandFactor_(guiExpandFactor), portCacheMegabytes_(portCacheMegabytes), portCacheDirectory_(portCacheDirectory),
+    memoizeDirectory_(memoizeDirectory), profileFile_(profileFile)
   {}
   std::optional<int> regressionTimeoutSeconds() const override
   {
@@ -143,15 +155,39 @@ public:
   {
     return maxCores_;
   }
+  std::optional<unsigned int> maxConcurrentModules() const override
+  {
+    return maxConcurrentModules_;
+  }
   std::optional<double> guiExpandFactor() const override
   {
     return guiExpandFactor_;
   }
+  std::optional<unsigned int> portCacheMegabytes() const override
+  {
+    return portCacheMegabytes_;
+  }
+  std::optional<std::string> portCacheDirectory() const override
+  {
+    return portCacheDirectory_;
+  }
+  std::optional<std::string> memoizeDirectory() const override
+  {
+    return memoizeDirectory_;
+  }
+  std::optional<std::string> profileFile() const override
+  {
+    return profileFile_;
+  }
 private:
   std::optional<std::string> threadMode_, reexecuteMode_;
   std::optional<int> frameInitLimit_, regressionTimeout_;
-  std::optional<unsigned int> maxCores_;
+  std::optional<unsigned int> maxCores_, maxConcurrentModules_;
   std::optional<double> guiExpandFactor_;
+  std::optional<unsigned int> portCacheMegabytes_;
+  std::optional<std::string> portCacheDirectory_;
+  std::optional<std::string> memoizeDirectory_;
+  std::optional<std::string> profileFile_;
 };
 
 class ApplicationParametersImpl : public ApplicationParameters
@@ -365,7 +401,12 @@ ApplicationParametersHandle CommandLineParser::parse(int argc, const char* argv[
         parseOptionalArg<int>(parsed, "frameInitLimit"),
         parseOptionalArg<int>(parsed, "regression"),
         parseOptionalArg<unsigned int>(parsed, "max-cores"),
-        parseOptionalArg<double>(parsed, "guiExpandFactor")
+        parseOptionalArg<unsigned int>(parsed, "max-modules"),
+        parseOptionalArg<double>(parsed, "guiExpandFactor"),
+        parseOptionalArg<unsigned int>(parsed, "port-cache-mb"),
+        parseOptionalArg<std::string>(parsed, "port-cache-dir"),
+        parseOptionalArg<std::string>(parsed, "memoize-dir"),
+        parseOptionalArg<std::string>(parsed, "profile")
       ),
       ApplicationParametersImpl::Flags(
         parsed.count("help") != 0,
@@ -77,7 +77,12 @@ namespace SCIRun {
         virtual std::optional<std::string> reexecuteMode() const = 0;
         virtual std::optional<int> frameInitLimit() const = 0;
         virtual std::optional<unsigned int> maxCores() const = 0;
+        virtual std::optional<unsigned int> maxConcurrentModules() const = 0;
         virtual std::optional<double> guiExpandFactor() const = 0;
+        virtual std::optional<unsigned int> portCacheMegabytes() const = 0;
+        virtual std::optional<std::string> portCacheDirectory() const = 0;
+        virtual std::optional<std::string> memoizeDirectory() const = 0;
+        virtual std::optional<std::string> profileFile() const = 0;
       };
 
       typedef SharedPointer<ApplicationParameters> ApplicationParametersHandle;
@@ -59,6 +59,12 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     "  --guiExpandFactor arg   Expansion factor for high resolution displays\n"
     "  --max-cores arg         Limit the number of cores used by multithreaded \n"
     "                          algorithms\n"
+    "  --max-modules arg       Limit the number of modules executed at once\n"
+    "  --port-cache-mb arg     Memory budget in MB for data cached on output ports\n"
+    "  --port-cache-dir arg    Directory to spill evicted port data to\n"
+    "  --memoize-dir arg       Reuse module results stored in this directory\n"
+    "  --profile arg           Write a Chrome trace of each network execution to \n"
+    "                          this file\n"
     "  --list-modules          print list of available modules\n";
 
   EXPECT_EQ(expectedHelp, parser.describe());
@@ -0,0 +1,260 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+
+///
+///@file   CompressedAdjacency.h
+///@brief  Adjacency lists (e.g. node to element) stored in one flat array.
+///
+
+#ifndef SCI_Containers_CompressedAdjacency_h
+#define SCI_Containers_CompressedAdjacency_h 1
+
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace SCIRun {
+
+/// Replacement for std::vector<std::vector<T> > when every row is a short
+/// list, as in the node to element tables of the unstructured meshes. The
+/// rows are stored back to back in one array (compressed sparse row
+/// layout), with an offset per row, so a table costs two allocations
+/// instead of one per row and 8 bytes per row instead of a 24 byte vector
+/// header plus allocator overhead.
+///
+/// operator[] returns a light Row view with begin(), end(), size() and
+/// operator[], so code that reads rows like vectors keeps working. Views
+/// are invalidated by any edit, as vector iterators are.
+///
+/// The table is meant to be filled in one go by build(). Rows edited
+/// afterwards by push_back() and erase(), for meshes modified in place,
+/// are moved to a hash table on the side; reading a row costs one extra
+/// lookup only while such edited rows exist.
+
+template <class T>
+class CompressedAdjacency
+{
+  public:
+    typedef T      value_type;
+    typedef size_t size_type;
+
+    class Row
+    {
+      public:
+        typedef T        value_type;
+        typedef const T* iterator;
+        typedef const T* const_iterator;
+
+        Row() : begin_(nullptr), end_(nullptr) {}
+        Row(const T* b, const T* e) : begin_(b), end_(e) {}
+
+        const T* begin() const { return (begin_); }
+        const T* end() const { return (end_); }
+        size_type size() const { return (static_cast<size_type>(end_ - begin_)); }
+        bool empty() const { return (begin_ == end_); }
+        const T& operator[](size_type i) const { return (begin_[i]); }
+        const T& front() const { return (*begin_); }
+        const T& back() const { return (*(end_ - 1)); }
+
+      private:
+        const T* begin_;
+        const T* end_;
+    };
+
+    typedef Row const_reference;
+
+    CompressedAdjacency() : num_rows_(0) {}
+
+    /// Fill the table from num_entries (row, value) pairs: entry i goes to
+    /// row row_of(i) with value value_of(i). Entries whose row is not in
+    /// [0, num_rows) are dropped. Both functions are called from several
+    /// threads. Each row is sorted, which for values increasing with i
+    /// gives the same rows as pushing the entries back in order.
+    template <class ROWOF, class VALUEOF>
+    void build(size_type num_rows, size_type num_entries,
+               const ROWOF& row_of, const VALUEOF& value_of);
+
+    /// Number of rows
+    size_type size() const { return (num_rows_); }
+    bool empty() const { return (num_rows_ == 0); }
+
+    Row operator[](size_type row) const
+    {
+      if (!edited_.empty())
+      {
+        typename edited_type::const_iterator it = edited_.find(row);
+        if (it != edited_.end())
+          return (Row(it->second.data(), it->second.data() + it->second.size()));
+      }
+      if (row + 1 >= offsets_.size()) return (Row());
+      return (Row(values_.data() + offsets_[row], values_.data() + offsets_[row+1]));
+    }
+
+    /// Add an empty row at the end.
+    void add_row() { num_rows_++; }
+
+    /// Append a value to an existing row.
+    void push_back(size_type row, const T& value)
+    {
+      edit(row).push_back(value);
+    }
+
+    /// Remove the first occurrence of value from a row, returns false if
+    /// the row does not contain it.
+    bool erase(size_type row, const T& value)
+    {
+      std::vector<T>& r = edit(row);
+      typename std::vector<T>::iterator it = std::find(r.begin(), r.end(), value);
+      if (it == r.end()) return (false);
+      r.erase(it);
+      return (true);
+    }
+
+    void clear()
+    {
+      std::vector<size_t>().swap(offsets_);
+      std::vector<T>().swap(values_);
+      edited_.clear();
+      num_rows_ = 0;
+    }
+
+    /// Bytes allocated by this table.
+    size_t memory_size() const
+    {
+      size_t mem = sizeof(*this) + offsets_.capacity() * sizeof(size_t) +
+                   values_.capacity() * sizeof(T);
+      for (typename edited_type::const_iterator it = edited_.begin(); it != edited_.end(); ++it)
+        mem += sizeof(*it) + sizeof(void*) + it->second.capacity() * sizeof(T);
+      return (mem);
+    }
+
+    /// Bytes the same rows would take at least as a
+    /// std::vector<std::vector<T> > with tight capacities. Used to report
+    /// what the compressed layout saves.
+    size_t nested_memory_size() const
+    {
+      size_t entries = values_.size();
+      for (typename edited_type::const_iterator it = edited_.begin(); it != edited_.end(); ++it)
+      {
+        entries += it->second.size();
+        if (it->first + 1 < offsets_.size())
+          entries -= offsets_[it->first+1] - offsets_[it->first];
+      }
+      return (sizeof(std::vector<std::vector<T> >) +
+              num_rows_ * sizeof(std::vector<T>) + entries * sizeof(T));
+    }
+
+  private:
+    typedef std::unordered_map<size_type, std::vector<T> > edited_type;
+
+    std::vector<T>& edit(size_type row)
+    {
+      typename edited_type::iterator it = edited_.find(row);
+      if (it != edited_.end()) return (it->second);
+      Row r = (*this)[row];
+      return (edited_.emplace(row, std::vector<T>(r.begin(), r.end())).first->second);
+    }
+
+    /// Start of each row in values_, plus the end of the last one.
+    std::vector<size_t> offsets_;
+    std::vector<T>      values_;
+    /// Rows changed after the build, these shadow the ones in values_.
+    edited_type         edited_;
+    size_type           num_rows_;
+};
+
+
+template <class T>
+template <class ROWOF, class VALUEOF>
+void
+CompressedAdjacency<T>::build(size_type num_rows, size_type num_entries,
+                              const ROWOF& row_of, const VALUEOF& value_of)
+{
+  using Core::Thread::Parallel;
+
+  clear();
+  num_rows_ = num_rows;
+
+  std::unique_ptr<std::atomic<size_t>[]> count(new std::atomic<size_t>[num_rows+1]);
+  Parallel::For(0, num_rows + 1, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (std::int64_t r = begin; r < end; r++) count[r].store(0, std::memory_order_relaxed);
+  });
+
+  Parallel::For(0, num_entries, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (std::int64_t i = begin; i < end; i++)
+    {
+      const std::int64_t r = static_cast<std::int64_t>(row_of(i));
+      if (r < 0 || r >= static_cast<std::int64_t>(num_rows)) continue;
+      count[r].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  offsets_.resize(num_rows + 1);
+  size_t total = 0;
+  for (size_type r = 0; r < num_rows; r++)
+  {
+    offsets_[r] = total;
+    total += count[r].load(std::memory_order_relaxed);
+    count[r].store(offsets_[r], std::memory_order_relaxed);
+  }
+  offsets_[num_rows] = total;
+
+  // The order in which the threads scatter the entries is arbitrary, the
+  // sort per row below makes the result deterministic.
+  values_.resize(total);
+  Parallel::For(0, num_entries, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (std::int64_t i = begin; i < end; i++)
+    {
+      const std::int64_t r = static_cast<std::int64_t>(row_of(i));
+      if (r < 0 || r >= static_cast<std::int64_t>(num_rows)) continue;
+      values_[count[r].fetch_add(1, std::memory_order_relaxed)] = value_of(i);
+    }
+  });
+  count.reset();
+
+  Parallel::For(0, num_rows, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (std::int64_t r = begin; r < end; r++)
+      std::sort(values_.begin() + offsets_[r], values_.begin() + offsets_[r+1]);
+  });
+}
+
+} // End namespace SCIRun
+
+#endif /* SCI_Containers_CompressedAdjacency_h */
@@ -0,0 +1,169 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <gtest/gtest.h>
+#include <Core/Containers/CompressedAdjacency.h>
+#include <Core/Logging/ScopedTimeRemarker.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace SCIRun;
+
+namespace
+{
+  // Node to element table of a strip of triangles, built the old way.
+  std::vector<std::vector<int> > nestedTable(const std::vector<int>& elems, size_t numNodes)
+  {
+    std::vector<std::vector<int> > table(numNodes);
+    for (size_t i = 0; i < elems.size(); ++i)
+      table[elems[i]].push_back(static_cast<int>(i));
+    return table;
+  }
+
+  std::vector<int> triangleStrip(int n)
+  {
+    std::vector<int> elems;
+    for (int i = 0; i < n; ++i)
+    {
+      elems.push_back(i);
+      elems.push_back(i + 1);
+      elems.push_back(i + 2);
+    }
+    return elems;
+  }
+
+  void expectSameRows(const std::vector<std::vector<int> >& expected, const CompressedAdjacency<int>& table)
+  {
+    ASSERT_EQ(expected.size(), table.size());
+    for (size_t r = 0; r < expected.size(); ++r)
+    {
+      auto row = table[r];
+      ASSERT_EQ(expected[r].size(), row.size()) << "row " << r;
+      EXPECT_TRUE(std::equal(row.begin(), row.end(), expected[r].begin())) << "row " << r;
+    }
+  }
+}
+
+TEST(CompressedAdjacencyTest, BuildsTheSameRowsAsNestedVectors)
+{
+  const int n = 1000;
+  auto elems = triangleStrip(n);
+  CompressedAdjacency<int> table;
+  table.build(n + 2, elems.size(),
+    [&](std::int64_t i) { return elems[i]; },
+    [](std::int64_t i) { return static_cast<int>(i); });
+
+  expectSameRows(nestedTable(elems, n + 2), table);
+  EXPECT_EQ(1, table[0].size());
+  EXPECT_EQ(3, table[5].size());
+  EXPECT_EQ(3 * 3 + 2, table[5].front());
+  EXPECT_EQ(3 * 5, table[5].back());
+}
+
+TEST(CompressedAdjacencyTest, DropsEntriesOutsideTheRows)
+{
+  CompressedAdjacency<int> table;
+  std::vector<int> rows = { 0, -1, 2, 7, 2 };
+  table.build(3, rows.size(),
+    [&](std::int64_t i) { return rows[i]; },
+    [](std::int64_t i) { return static_cast<int>(i); });
+
+  ASSERT_EQ(3, table.size());
+  EXPECT_EQ(1, table[0].size());
+  EXPECT_TRUE(table[1].empty());
+  ASSERT_EQ(2, table[2].size());
+  EXPECT_EQ(2, table[2][0]);
+  EXPECT_EQ(4, table[2][1]);
+}
+
+TEST(CompressedAdjacencyTest, KeepsEditsAfterTheBuild)
+{
+  auto elems = triangleStrip(10);
+  CompressedAdjacency<int> table;
+  table.build(12, elems.size(),
+    [&](std::int64_t i) { return elems[i]; },
+    [](std::int64_t i) { return static_cast<int>(i); });
+  auto expected = nestedTable(elems, 12);
+
+  table.push_back(3, 100);
+  expected[3].push_back(100);
+  EXPECT_TRUE(table.erase(4, expected[4][1]));
+  expected[4].erase(expected[4].begin() + 1);
+  EXPECT_FALSE(table.erase(4, 12345));
+
+  table.add_row();
+  table.push_back(12, 7);
+  expected.push_back(std::vector<int>(1, 7));
+  table.add_row();
+  expected.push_back(std::vector<int>());
+
+  expectSameRows(expected, table);
+
+  table.clear();
+  EXPECT_EQ(0, table.size());
+  EXPECT_TRUE(table[3].empty());
+}
+
+TEST(CompressedAdjacencyTest, UsesLessMemoryThanNestedVectors)
+{
+  const int n = 100000;
+  auto elems = triangleStrip(n);
+  CompressedAdjacency<int> table;
+  table.build(n + 2, elems.size(),
+    [&](std::int64_t i) { return elems[i]; },
+    [](std::int64_t i) { return static_cast<int>(i); });
+
+  const size_t used = table.memory_size();
+  const size_t nested = table.nested_memory_size();
+  EXPECT_EQ(sizeof(std::vector<std::vector<int> >) + (n + 2) * sizeof(std::vector<int>) + elems.size() * sizeof(int), nested);
+  EXPECT_LT(used, nested);
+}
+
+TEST(CompressedAdjacencyTest, DISABLED_BuildTiming)
+{
+  using Core::Logging::SimpleScopedTimer;
+  const int n = 5000000;
+  auto elems = triangleStrip(n);
+  {
+    SimpleScopedTimer t;
+    auto table = nestedTable(elems, n + 2);
+    std::cout << "nested vectors built in " << t.elapsedSeconds() << " s" << std::endl;
+  }
+  {
+    SimpleScopedTimer t;
+    CompressedAdjacency<int> table;
+    table.build(n + 2, elems.size(),
+      [&](std::int64_t i) { return elems[i]; },
+      [](std::int64_t i) { return static_cast<int>(i); });
+    std::cout << "compressed table built in " << t.elapsedSeconds() << " s, "
+      << table.memory_size() << " instead of " << table.nested_memory_size() << " bytes" << std::endl;
+  }
+}
@@ -30,6 +30,7 @@
 
 #include <sstream>
 #include <Core/Datatypes/Datatype.h>
+#include <atomic>
 
 using namespace SCIRun::Core::Datatypes;
 
@@ -45,3 +46,36 @@ Datatype& Datatype::operator=(const Datatype&)
 {
   return *this;
 }
+
+size_t Datatype::sizeInBytes() const
+{
+  return 0;
+}
+
+namespace
+{
+  std::atomic<size_t> numClones_(0);
+  std::atomic<size_t> bytesCloned_(0);
+}
+
+void CloneStatistics::recordClone(size_t bytes)
+{
+  ++numClones_;
+  bytesCloned_ += bytes;
+}
+
+size_t CloneStatistics::numClones()
+{
+  return numClones_;
+}
+
+size_t CloneStatistics::bytesCloned()
+{
+  return bytesCloned_;
+}
+
+void CloneStatistics::reset()
+{
+  numClones_ = 0;
+  bytesCloned_ = 0;
+}
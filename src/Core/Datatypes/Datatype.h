@@ -60,6 +60,20 @@ namespace Datatypes {
     virtual Datatype* clone() const = 0;
 
     virtual std::string dynamic_type_name() const = 0;
+
+    /// Estimated memory held by this object, for cache budgets; 0 when unknown.
+    virtual size_t sizeInBytes() const;
+  };
+
+  /// Running totals of deep copies made by the large datatypes' clone(), so a network execution
+  /// can report how much memory it spent on copies.
+  class SCISHARE CloneStatistics
+  {
+  public:
+    static void recordClone(size_t bytes);
+    static size_t numClones();
+    static size_t bytesCloned();
+    static void reset();
   };
 
 }}}
@@ -64,9 +64,12 @@ namespace Datatypes {
 
     DenseColumnMatrixGeneric* clone() const override
     {
+      CloneStatistics::recordClone(sizeInBytes());
       return new DenseColumnMatrixGeneric(*this);
     }
 
+    size_t sizeInBytes() const override { return this->size() * sizeof(T); }
+
     void accept(MatrixVisitorGeneric<T>& visitor) override
     {
       visitor.visit(*this);
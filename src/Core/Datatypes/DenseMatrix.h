@@ -82,9 +82,12 @@ namespace Datatypes {
 
     DenseMatrixGeneric* clone() const override
     {
+      CloneStatistics::recordClone(sizeInBytes());
       return new DenseMatrixGeneric(*this);
     }
 
+    size_t sizeInBytes() const override { return this->size() * sizeof(T); }
+
     size_t nrows() const override { return this->rows(); }
     size_t ncols() const override { return this->cols(); }
 
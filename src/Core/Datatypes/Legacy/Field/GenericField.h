@@ -80,6 +80,9 @@ public:
   /// Clone everything, field data and mesh.
   GenericField<Mesh, Basis, FData> *deep_clone() const override;
 
+  /// Field values plus the mesh's explicit nodes and connectivity.
+  size_t sizeInBytes() const override;
+
   /// Obtain a Handle to the Mesh
   MeshHandle mesh() const override;
   VMesh*  vmesh() const override;
@@ -340,6 +343,7 @@ template <class Mesh, class Basis, class FData>
 GenericField<Mesh, Basis, FData> *
 GenericField<Mesh, Basis, FData>::clone() const
 {
+  Core::Datatypes::CloneStatistics::recordClone(fdata_.size() * sizeof(value_type));
   return new GenericField<Mesh, Basis, FData>(*this);
 }
 
@@ -348,11 +352,27 @@ GenericField<Mesh, Basis, FData> *
   GenericField<Mesh, Basis, FData>::deep_clone() const
 {
   auto copy = new GenericField<Mesh, Basis, FData>(*this);
+  Core::Datatypes::CloneStatistics::recordClone(fdata_.size() * sizeof(value_type));
   copy->mesh_.reset(mesh_->clone());
   copy->vfield_->update_mesh_pointer(copy->mesh_.get());
   return copy;
 }
 
+template <class Mesh, class Basis, class FData>
+size_t
+GenericField<Mesh, Basis, FData>::sizeInBytes() const
+{
+  size_t bytes = fdata_.size() * sizeof(value_type);
+  if (auto mesh = vmesh())
+  {
+    if (!mesh->is_regularmesh())
+      bytes += mesh->num_nodes() * sizeof(Core::Geometry::Point);
+    if (mesh->is_unstructuredmesh())
+      bytes += mesh->num_elems() * mesh->num_nodes_per_elem() * sizeof(index_type);
+  }
+  return bytes;
+}
+
 template <class Mesh, class Basis, class FData>
 MeshHandle
 GenericField<Mesh, Basis, FData>::mesh() const
@@ -33,6 +33,7 @@
 /// Need to fix this and couple it sci-defs
 #include <Core/Datatypes/Legacy/Field/MeshSupport.h>
 
+#include <Core/Containers/CompressedAdjacency.h>
 #include <Core/Containers/StackVector.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
@@ -51,6 +52,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologyTable.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -473,6 +475,14 @@ public:
   bool unsynchronize(mask_type sync) override;
   bool clear_synchronization();
 
+  /// Bytes used by the node neighbor table, and the bytes the same table
+  /// would take as a vector of vectors.
+  void get_adjacency_memory(size_t& used, size_t& nested) const
+  {
+    used = node_neighbors_.memory_size();
+    nested = node_neighbors_.nested_memory_size();
+  }
+
   /// Get the basis class.
   Basis& get_basis() { return basis_; }
 
@@ -1793,10 +1803,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
             "HexVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(
-                                                  (node_neighbors_[idx][i])>>3);
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[idx];
+    array.resize(neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>((neighbors[i])>>3);
   }
 
   template<class ARRAY, class INDEX>
@@ -1808,7 +1818,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1890,7 +1900,7 @@ protected:
       "HexVolMesh: Must call synchronize FACES_E first");
 
     array.clear();
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[idx];
 
     // Iterate through all those edges
     for (size_t n = 0; n < neighbors.size(); n++)
@@ -2090,12 +2100,13 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on HexVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[node];
+    size_t sz = neighbors.size();
 
     std::set<index_type> inserted;
     for (size_t i = 0; i < sz; i++)
     {
-      const index_type base = ((node_neighbors_[node][i])&(~0x7));
+      const index_type base = ((neighbors[i])&(~0x7));
       for (index_type c = base; c < base+8; ++c)
       {
         if (cells_[c] != node) inserted.insert(cells_[c]);
@@ -2756,10 +2767,8 @@ protected:
     }
   };
 
-  using face_ht = std::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using face_nt = std::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = std::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
-  using edge_nt = std::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
+  using face_nt = MeshTopologyTable<PFaceNode, FaceHash>;
+  using edge_nt = MeshTopologyTable<PEdgeNode, EdgeHash>;
 
   typedef std::vector<PFaceCell> face_ct;
   typedef std::vector<PEdgeCell> edge_ct;
@@ -2774,15 +2783,6 @@ protected:
   edge_ct edges_;
   edge_nt edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 index_type combind_index, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2852,7 +2852,9 @@ protected:
     typename Node::array_type   nodes_;
   };
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  /// For each node the cell slots (cell*8 + node in cell) that use it.
+  typedef CompressedAdjacency<typename Cell::index_type> node_neighbor_table;
+  node_neighbor_table node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -3212,107 +3214,50 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-HexVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             typename Node::index_type n4,
-                             index_type combined_index,
-                             face_ht &table) const
+HexVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
-
-
-  typename face_ht::iterator iter = table.find(f);
+  // 6 faces -- each is entered CCW from outside looking in
+  static const int face_nodes[6][4] = { {0,1,2,3}, {7,6,5,4}, {0,4,5,1},
+                                        {2,6,7,3}, {3,7,4,0}, {1,5,6,2} };
+
+  // Degenerate faces are skipped by order_face_nodes (e.g. nodes on
+  // opposite corners are equal, or more than two nodes are equal)
+  std::vector<index_type> offsets, slots;
+  face_table_.build(static_cast<index_type>(points_.size()),
+    static_cast<index_type>(cells_.size() >> 3), 6, 3,
+    [this](index_type cell, int face, PFaceNode& key)
+    {
+      const index_type off = cell << 3;
+      const int* fn = face_nodes[face];
+      index_type n1 = cells_[off+fn[0]], n2 = cells_[off+fn[1]];
+      index_type n3 = cells_[off+fn[2]], n4 = cells_[off+fn[3]];
+      if (!(order_face_nodes(n1,n2,n3,n4))) return (false);
+      key = PFaceNode(n1, n2, n3, n4);
+      return (true);
+    }, offsets, slots);
+
+  const index_type num_faces = static_cast<index_type>(offsets.size()) - 1;
+  faces_.clear();
+  faces_.resize(num_faces);
 
-  if (iter == table.end())
+  Core::Thread::Parallel::For(0, num_faces, [&](std::int64_t begin, std::int64_t end)
   {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
+    for (std::int64_t f = begin; f < end; f++)
     {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      face_nt::first_two_slots(offsets, slots, f, 3,
+                               faces_[f].cells_[0], faces_[f].cells_[1]);
     }
-  }
-}
-
-template <class Basis>
-void
-HexVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
-
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(8);
-
-  face_ht table;
+  });
 
-  while (ci != cie)
+  boundary_faces_.assign(cells_.size() >> 3, 0);
+  for (index_type f = 0; f < num_faces; f++)
   {
-    get_nodes(arr, *ci);
-    // 6 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], arr[3], cell_index, table);
-    hash_face(arr[7], arr[6], arr[5], arr[4], cell_index + 1, table);
-    hash_face(arr[0], arr[4], arr[5], arr[1], cell_index + 2, table);
-    hash_face(arr[2], arr[6], arr[7], arr[3], cell_index + 3, table);
-    hash_face(arr[3], arr[7], arr[4], arr[0], cell_index + 4, table);
-    hash_face(arr[1], arr[5], arr[6], arr[2], cell_index + 5, table);
-
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-  boundary_faces_.resize(cells_.size()>>3);
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2],pface.nodes_[3])] = uidx;
-
-    if (pface.cells_[1] == -1)
+    if (faces_[f].cells_[1] == MESH_NO_NEIGHBOR)
     {
-      index_type cell = (pface.cells_[0]) >> 3;
-      index_type face = (pface.cells_[0]) & 0x7;
+      index_type cell = (faces_[f].cells_[0]) >> 3;
+      index_type face = (faces_[f].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
@@ -3320,74 +3265,39 @@ HexVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<4;
-    hash_edge(arr[0], arr[1], cell_index  , table);
-    hash_edge(arr[1], arr[2], cell_index+1, table);
-    hash_edge(arr[2], arr[3], cell_index+2, table);
-    hash_edge(arr[3], arr[0], cell_index+3, table);
-
-    hash_edge(arr[4], arr[5], cell_index+4, table);
-    hash_edge(arr[5], arr[6], cell_index+5, table);
-    hash_edge(arr[6], arr[7], cell_index+6, table);
-    hash_edge(arr[7], arr[4], cell_index+7, table);
-
-    hash_edge(arr[0], arr[4], cell_index+8, table);
-    hash_edge(arr[5], arr[1], cell_index+9, table);
-    hash_edge(arr[2], arr[6], cell_index+10,table);
-    hash_edge(arr[7], arr[3], cell_index+11,table);
-    ++ci;
-  }
+  static const int edge_nodes[12][2] = { {0,1}, {1,2}, {2,3}, {3,0},
+                                         {4,5}, {5,6}, {6,7}, {7,4},
+                                         {0,4}, {5,1}, {2,6}, {7,3} };
+
+  std::vector<index_type> offsets, slots;
+  edge_table_.build(static_cast<index_type>(points_.size()),
+    static_cast<index_type>(cells_.size() >> 3), 12, 4,
+    [this](index_type cell, int edge, PEdgeNode& key)
+    {
+      const index_type off = cell << 3;
+      const index_type n1 = cells_[off+edge_nodes[edge][0]];
+      const index_type n2 = cells_[off+edge_nodes[edge][1]];
+      if (n1 == n2) return (false);
+      key = PEdgeNode(n1, n2);
+      return (true);
+    }, offsets, slots);
 
   // dump edges into the edges_ container.
+  const index_type num_edges = static_cast<index_type>(offsets.size()) - 1;
+  edges_.clear();
+  edges_.resize(num_edges);
 
-  edges_.resize(table.size());
-
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  Core::Thread::Parallel::For(0, num_edges, [&](std::int64_t begin, std::int64_t end)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+    for (std::int64_t e = begin; e < end; e++)
+    {
+      edges_[e].cells_.assign(slots.begin() + offsets[e], slots.begin() + offsets[e+1]);
+    }
+  });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3677,13 +3587,9 @@ template <class Basis>
 void
 HexVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  node_neighbors_.build(points_.size(), cells_.size(),
+    [this](std::int64_t i) { return (cells_[i]); },
+    [](std::int64_t i) { return (static_cast<typename Cell::index_type>(i)); });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3923,7 +3829,7 @@ HexVolMesh<Basis>::io(Piostream &stream)
   const int version = stream.begin_class(type_name(-1), HEXVOLMESH_VERSION);
   Mesh::io(stream);
 
-  SCIRun::Pio(stream, points_);
+  Pio(stream, points_);
   SCIRun::Pio_index(stream, cells_);
   if (version == 1)
   {
@@ -0,0 +1,380 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+
+#ifndef CORE_DATATYPES_MESHTOPOLOGYTABLE_H
+#define CORE_DATATYPES_MESHTOPOLOGYTABLE_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace SCIRun {
+
+/// Lookup table from the nodes of an edge or face to its index.
+///
+/// The table is filled in one pass over all elements by build(): every
+/// element slot (e.g. the 4 faces of a tet) yields a canonical key, the
+/// (key, slot) pairs are counting sorted on the first (lowest) node of the
+/// key, each of these small buckets is sorted and equal keys are merged. The
+/// unique keys end up in one flat array, grouped per node, and the slots
+/// sharing a key are returned in a compressed (CSR) layout. All passes run
+/// in parallel and nothing is allocated per key.
+///
+/// Keys added or erased afterwards, when a mesh is edited in place, are kept
+/// in a hash table on the side. The interface (find, end, erase and
+/// operator[]) is the subset of std::unordered_map the meshes use.
+///
+/// KEY needs operator== and operator<, and keys that compare equal must
+/// have the same nodes_[0], usually their lowest node.
+
+template <class KEY, class HASH>
+class MeshTopologyTable
+{
+  public:
+    typedef KEY key_type;
+    typedef SCIRun::index_type mapped_type;
+
+  private:
+    typedef std::unordered_map<KEY, index_type, HASH> overlay_type;
+
+  public:
+    template <bool CONST>
+    class iterator_base
+    {
+      public:
+        typedef typename std::conditional<CONST, const MeshTopologyTable,
+                                          MeshTopologyTable>::type table_type;
+        typedef typename std::conditional<CONST, typename overlay_type::const_iterator,
+                                          typename overlay_type::iterator>::type overlay_iterator;
+        typedef typename std::conditional<CONST, const index_type, index_type>::type value_type;
+
+        /// What dereferencing yields, it mimics the pair of a std::map.
+        struct reference
+        {
+          const KEY& first;
+          value_type& second;
+          reference* operator->() { return this; }
+        };
+
+        iterator_base() : table_(nullptr), pos_(-1) {}
+        iterator_base(table_type* table, index_type pos, overlay_iterator it) :
+          table_(table), pos_(pos), it_(it) {}
+
+        /// Mutable iterators convert to const ones.
+        template <bool C = CONST, typename = typename std::enable_if<C>::type>
+        iterator_base(const iterator_base<false>& it) :
+          table_(it.table_), pos_(it.pos_), it_(it.it_) {}
+
+        reference operator*() const
+        {
+          if (pos_ >= 0) return reference{table_->keys_[pos_], table_->values_[pos_]};
+          return reference{it_->first, it_->second};
+        }
+        reference operator->() const { return **this; }
+
+        template <bool C>
+        bool operator==(const iterator_base<C>& it) const
+        {
+          return (pos_ == it.pos_ && (pos_ >= 0 || it_ == it.it_));
+        }
+        template <bool C>
+        bool operator!=(const iterator_base<C>& it) const { return !(*this == it); }
+
+      private:
+        template <bool> friend class iterator_base;
+        friend class MeshTopologyTable;
+
+        table_type*      table_;
+        index_type       pos_;
+        overlay_iterator it_;
+    };
+
+    typedef iterator_base<false> iterator;
+    typedef iterator_base<true>  const_iterator;
+
+    /// Build the table from scratch. For every element elem in
+    /// [0, num_elems) and every slot in [0, num_slots), make_key(elem, slot,
+    /// key) fills in the key of that slot and returns false to skip it
+    /// (degenerate edges or faces). A slot is identified by its combined
+    /// index (elem << slot_shift) + slot.
+    ///
+    /// Key i of the table gets index i, and on return the combined indices
+    /// of the slots that share it are slots[offsets[i]] ..
+    /// slots[offsets[i+1]-1], in increasing order. Slots whose first node
+    /// is not in [0, num_nodes) are ignored.
+    template <class MAKEKEY>
+    void build(index_type num_nodes, index_type num_elems,
+               int num_slots, int slot_shift, const MAKEKEY& make_key,
+               std::vector<index_type>& offsets,
+               std::vector<index_type>& slots);
+
+    /// The first slot and the first slot of another element sharing key i,
+    /// the latter is -1 if there is none. This is the adjacency of a face.
+    static void first_two_slots(const std::vector<index_type>& offsets,
+                                const std::vector<index_type>& slots,
+                                index_type i, int slot_shift,
+                                index_type& slot0, index_type& slot1)
+    {
+      slot0 = slots[offsets[i]];
+      slot1 = -1;
+      for (index_type k = offsets[i]+1; k < offsets[i+1]; k++)
+      {
+        if ((slots[k] >> slot_shift) != (slot0 >> slot_shift))
+        {
+          slot1 = slots[k];
+          break;
+        }
+      }
+    }
+
+    /// Key i of the last build, before any edits.
+    const KEY& key(index_type i) const { return (keys_[i]); }
+
+    iterator find(const KEY& key)
+    {
+      index_type pos = find_sorted(key);
+      if (pos >= 0)
+      {
+        if (values_[pos] < 0) return (end());
+        return (iterator(this, pos, overlay_.end()));
+      }
+      return (iterator(this, -1, overlay_.find(key)));
+    }
+
+    const_iterator find(const KEY& key) const
+    {
+      index_type pos = find_sorted(key);
+      if (pos >= 0)
+      {
+        if (values_[pos] < 0) return (end());
+        return (const_iterator(this, pos, overlay_.end()));
+      }
+      return (const_iterator(this, -1, overlay_.find(key)));
+    }
+
+    iterator end() { return (iterator(this, -1, overlay_.end())); }
+    const_iterator end() const { return (const_iterator(this, -1, overlay_.end())); }
+
+    index_type& operator[](const KEY& key)
+    {
+      index_type pos = find_sorted(key);
+      if (pos >= 0) return (values_[pos]);
+      return (overlay_[key]);
+    }
+
+    void erase(iterator it)
+    {
+      if (it.pos_ >= 0) values_[it.pos_] = -1;
+      else overlay_.erase(it.it_);
+    }
+
+    void clear()
+    {
+      std::vector<index_type>().swap(buckets_);
+      std::vector<KEY>().swap(keys_);
+      std::vector<index_type>().swap(values_);
+      overlay_.clear();
+    }
+
+    /// Approximate memory used by the table in bytes.
+    size_t memory_size() const
+    {
+      return (buckets_.capacity()*sizeof(index_type) +
+              keys_.capacity()*sizeof(KEY) +
+              values_.capacity()*sizeof(index_type) +
+              overlay_.size()*(sizeof(KEY)+2*sizeof(index_type)));
+    }
+
+  private:
+    index_type find_sorted(const KEY& key) const
+    {
+      const index_type n = key.nodes_[0];
+      if (n < 0 || n + 1 >= static_cast<index_type>(buckets_.size())) return (-1);
+      for (index_type k = buckets_[n]; k < buckets_[n+1]; k++)
+      {
+        if (keys_[k] == key) return (k);
+      }
+      return (-1);
+    }
+
+    /// keys_[buckets_[n]] .. keys_[buckets_[n+1]-1] start with node n.
+    std::vector<index_type> buckets_;
+    std::vector<KEY>        keys_;
+    /// Index of each key, -1 once erased.
+    std::vector<index_type> values_;
+    /// Keys inserted after the build.
+    overlay_type            overlay_;
+};
+
+
+template <class KEY, class HASH>
+template <class MAKEKEY>
+void
+MeshTopologyTable<KEY, HASH>::build(index_type num_nodes, index_type num_elems,
+                                    int num_slots, int slot_shift,
+                                    const MAKEKEY& make_key,
+                                    std::vector<index_type>& offsets,
+                                    std::vector<index_type>& slots)
+{
+  using Core::Thread::Parallel;
+
+  clear();
+  if (num_nodes < 0) num_nodes = 0;
+
+  // Count the slots per first node. Keys are generated twice, once here
+  // and once when scattering them, which is cheaper than storing them.
+  std::unique_ptr<std::atomic<index_type>[]> count(new std::atomic<index_type>[num_nodes+1]);
+  Parallel::For(0, num_nodes + 1, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (std::int64_t n = begin; n < end; n++) count[n].store(0, std::memory_order_relaxed);
+  });
+
+  Parallel::For(0, num_elems, [&](std::int64_t begin, std::int64_t end)
+  {
+    KEY key;
+    for (std::int64_t e = begin; e < end; e++)
+    {
+      for (int s = 0; s < num_slots; s++)
+      {
+        if (!make_key(e, s, key)) continue;
+        const index_type n = key.nodes_[0];
+        if (n < 0 || n >= num_nodes) continue;
+        count[n].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  std::vector<index_type> start(num_nodes + 1);
+  index_type total = 0;
+  for (index_type n = 0; n < num_nodes; n++)
+  {
+    start[n] = total;
+    total += count[n].load(std::memory_order_relaxed);
+    count[n].store(start[n], std::memory_order_relaxed);
+  }
+  start[num_nodes] = total;
+
+  // Scatter the (key, slot) pairs into their buckets. The order within a
+  // bucket depends on the threads, the sort below makes it deterministic.
+  struct Record
+  {
+    KEY        key_;
+    index_type slot_;
+  };
+  std::vector<Record> records(total);
+
+  Parallel::For(0, num_elems, [&](std::int64_t begin, std::int64_t end)
+  {
+    KEY key;
+    for (std::int64_t e = begin; e < end; e++)
+    {
+      for (int s = 0; s < num_slots; s++)
+      {
+        if (!make_key(e, s, key)) continue;
+        const index_type n = key.nodes_[0];
+        if (n < 0 || n >= num_nodes) continue;
+        Record& r = records[count[n].fetch_add(1, std::memory_order_relaxed)];
+        r.key_ = key;
+        r.slot_ = (static_cast<index_type>(e) << slot_shift) + s;
+      }
+    }
+  });
+  count.reset();
+
+  // Sort each bucket on key and slot and count the unique keys in it.
+  buckets_.resize(num_nodes + 1);
+  Parallel::For(0, num_nodes, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (std::int64_t n = begin; n < end; n++)
+    {
+      Record* first = records.data() + start[n];
+      Record* last = records.data() + start[n+1];
+      std::sort(first, last, [](const Record& a, const Record& b)
+      {
+        if (a.key_ < b.key_) return (true);
+        if (b.key_ < a.key_) return (false);
+        return (a.slot_ < b.slot_);
+      });
+
+      index_type unique = 0;
+      for (Record* r = first; r != last; ++r)
+      {
+        if (r == first || (r-1)->key_ < r->key_) unique++;
+      }
+      buckets_[n] = unique;
+    }
+  });
+
+  index_type num_keys = 0;
+  for (index_type n = 0; n < num_nodes; n++)
+  {
+    const index_type unique = buckets_[n];
+    buckets_[n] = num_keys;
+    num_keys += unique;
+  }
+  buckets_[num_nodes] = num_keys;
+
+  keys_.resize(num_keys);
+  values_.resize(num_keys);
+  offsets.resize(num_keys + 1);
+  slots.resize(total);
+
+  Parallel::For(0, num_nodes, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (std::int64_t n = begin; n < end; n++)
+    {
+      index_type k = buckets_[n] - 1;
+      for (index_type j = start[n]; j < start[n+1]; j++)
+      {
+        const Record& r = records[j];
+        if (j == start[n] || records[j-1].key_ < r.key_)
+        {
+          k++;
+          keys_[k] = r.key_;
+          values_[k] = k;
+          offsets[k] = j;
+        }
+        slots[j] = r.slot_;
+      }
+    }
+  });
+  offsets[num_keys] = total;
+}
+
+} // end namespace SCIRun
+
+#endif
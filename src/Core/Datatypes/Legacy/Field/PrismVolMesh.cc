@@ -135,6 +135,9 @@ public:
 
 
   VMesh::index_type* get_elems_pointer() const override;
+
+  void get_adjacency_memory(size_t& used, size_t& nested) const override
+    { this->mesh_->get_adjacency_memory(used, nested); }
 };
 
 /// Functions for creating the virtual interface for specific mesh types
@@ -33,6 +33,7 @@
 /// Need to fix this and couple it sci-defs
 #include <Core/Datatypes/Legacy/Field/MeshSupport.h>
 
+#include <Core/Containers/CompressedAdjacency.h>
 #include <Core/Containers/StackVector.h>
 #include <Core/Persistent/PersistentSTL.h>
 
@@ -51,6 +52,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologyTable.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <Core/Utils/Legacy/CheckSum.h>
@@ -58,6 +60,7 @@
 #include <unordered_map>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
+#include <Core/Thread/Parallel.h>
 
 #include <set>
 
@@ -405,6 +408,14 @@ public:
   bool unsynchronize(mask_type mask) override;
   bool clear_synchronization();
 
+  /// Bytes used by the node neighbor table, and the bytes the same table
+  /// would take as a vector of vectors.
+  void get_adjacency_memory(size_t& used, size_t& nested) const
+  {
+    used = node_neighbors_.memory_size();
+    nested = node_neighbors_.nested_memory_size();
+  }
+
   /// Get the basis class.
   Basis& get_basis() { return basis_; }
 
@@ -1710,16 +1721,17 @@ protected:
     for (size_t n = 0; n < neighbors.size(); n++)
     {
       // Get the edge information for the current edge
-      typename edge_ht::const_iterator iter =
+      typename edge_nt::const_iterator iter =
                   edge_table_.find(PEdge(
                     static_cast<typename Node::index_type>(idx),neighbors[n]));
       ASSERTMSG(iter != edge_table_.end(),
                 "Edge not found in PrismVolMesh::edge_table_");
       // Insert all cells that share this edge into
       // the unique set of cell indices
-      for (size_t c = 0; c < (iter->first).cells_.size(); c++)
+      const PEdge& e = edges_[iter->second];
+      for (size_t c = 0; c < e.cells_.size(); c++)
         unique_cells.insert(static_cast<typename ARRAY::value_type>(
-                                                    (iter->first).cells_[c]));
+                                                    e.cells_[c]));
     }
 
     // Copy the unique set of cells to our Cells array return argument
@@ -1832,11 +1844,12 @@ protected:
   {
     ASSERTMSG(synchronized_ & NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on PrismVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[node];
+    size_t sz = neighbors.size();
     array.resize(sz);
     for (size_t i=0; i< sz; i++)
     {
-      array[i] = static_cast<typename ARRAY::value_type>(node_neighbors_[node][i]);
+      array[i] = static_cast<typename ARRAY::value_type>(neighbors[i]);
     }
   }
 
@@ -2216,35 +2229,27 @@ protected:
   std::vector<under_type>   cells_;
 
   /// Face information.
-  struct PFace {
+  struct PFaceNode {
     typename Node::index_type         nodes_[4];   /// 4 nodes makes a face.
-    typename Cell::index_type         cells_[2];   /// 2 cells may have this face is in common.
 
-    PFace() {
+    PFaceNode() {
       nodes_[0] = MESH_NO_NEIGHBOR;
       nodes_[1] = MESH_NO_NEIGHBOR;
       nodes_[2] = MESH_NO_NEIGHBOR;
       nodes_[3] = MESH_NO_NEIGHBOR;
-      cells_[0] = MESH_NO_NEIGHBOR;
-      cells_[1] = MESH_NO_NEIGHBOR;
     }
 
     // snodes_ must be sorted. See Hash Function below.
-    PFace(typename Node::index_type n1, typename Node::index_type n2,
-          typename Node::index_type n3, typename Node::index_type n4) {
-      cells_[0] = MESH_NO_NEIGHBOR;
-      cells_[1] = MESH_NO_NEIGHBOR;
+    PFaceNode(typename Node::index_type n1, typename Node::index_type n2,
+              typename Node::index_type n3, typename Node::index_type n4) {
       nodes_[0] = n1;
       nodes_[1] = n2;
       nodes_[2] = n3;
       nodes_[3] = n4;
     }
 
-    bool shared() const { return ((cells_[0] != MESH_NO_NEIGHBOR) &&
-                                  (cells_[1] != MESH_NO_NEIGHBOR)); }
-
     /// true if both have the same nodes (order does not matter)
-    bool operator==(const PFace &f) const {
+    bool operator==(const PFaceNode &f) const {
       if (nodes_[2] == nodes_[3])
       {
         return ((nodes_[0] == f.nodes_[0]) &&
@@ -2261,7 +2266,7 @@ protected:
 
     /// Compares each node.  When a non equal node is found the <
     /// operator is applied.
-    bool operator<(const PFace &f) const {
+    bool operator<(const PFaceNode &f) const {
       if (nodes_[2] == nodes_[3])
       {
         if ((nodes_[1] < nodes_[2]) && (f.nodes_[1] < f.nodes_[2]))
@@ -2364,20 +2369,37 @@ protected:
 
   };
 
+  struct PFace : public PFaceNode {
+    typename Cell::index_type         cells_[2];   /// 2 cells may have this face is in common.
+
+    PFace() {
+      cells_[0] = MESH_NO_NEIGHBOR;
+      cells_[1] = MESH_NO_NEIGHBOR;
+    }
+
+    PFace(typename Node::index_type n1, typename Node::index_type n2,
+          typename Node::index_type n3, typename Node::index_type n4) :
+      PFaceNode(n1, n2, n3, n4) {
+      cells_[0] = MESH_NO_NEIGHBOR;
+      cells_[1] = MESH_NO_NEIGHBOR;
+    }
+
+    bool shared() const { return ((cells_[0] != MESH_NO_NEIGHBOR) &&
+                                  (cells_[1] != MESH_NO_NEIGHBOR)); }
+  };
+
   /// Edge information.
-  struct PEdge
+  struct PEdgeNode
   {
     typename Node::index_type         nodes_[2];   /// 2 nodes makes an edge.
-    /// list of all the cells this edge is in.
-    std::vector<typename Cell::index_type> cells_;
 
-    PEdge() : cells_(0) {
+    PEdgeNode() {
       nodes_[0] = MESH_NO_NEIGHBOR;
       nodes_[1] = MESH_NO_NEIGHBOR;
     }
     // node_[0] must be smaller than node_[1]. See Hash Function below.
-    PEdge(typename Node::index_type n1,
-          typename Node::index_type n2) : cells_(0)
+    PEdgeNode(typename Node::index_type n1,
+              typename Node::index_type n2)
     {
       if (n1 < n2)
       {
@@ -2391,17 +2413,15 @@ protected:
       }
     }
 
-    bool shared() const { return cells_.size() > 1; }
-
     /// true if both have the same nodes (order does not matter)
-    bool operator==(const PEdge &e) const
+    bool operator==(const PEdgeNode &e) const
     {
       return ((nodes_[0] == e.nodes_[0]) && (nodes_[1] == e.nodes_[1]));
     }
 
     /// Compares each node.  When a non equal node is found the <
     /// operator is applied.
-    bool operator<(const PEdge &e) const
+    bool operator<(const PEdgeNode &e) const
     {
       if (nodes_[0] == e.nodes_[0])
         return (nodes_[1] < e.nodes_[1]);
@@ -2410,6 +2430,18 @@ protected:
     }
   };
 
+  struct PEdge : public PEdgeNode
+  {
+    /// list of all the cells this edge is in.
+    std::vector<typename Cell::index_type> cells_;
+
+    PEdge() {}
+    PEdge(typename Node::index_type n1,
+          typename Node::index_type n2) : PEdgeNode(n1, n2) {}
+
+    bool shared() const { return cells_.size() > 1; }
+  };
+
   /// hash the egde's node_indecies such that edges with the same nodes
   ///  hash to the same value. nodes are sorted on edge construction.
   static const int sz_int = sizeof(int) * 8; // in bits
@@ -2430,7 +2462,7 @@ protected:
     static const int low4_mask = ~(top4_mask | mid4_mask);
 
     /// This is the hash function
-    size_t operator()(const PFace &f) const {
+    size_t operator()(const PFaceNode &f) const {
       if (f.nodes_[1] < f.nodes_[3] )
       {
         return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
@@ -2447,7 +2479,7 @@ protected:
       }
     }
     /// This should return less than rather than equal to.
-    bool operator()(const PFace &f1, const PFace& f2) const {
+    bool operator()(const PFaceNode &f1, const PFaceNode& f2) const {
       return f1 < f2;
     }
   };
@@ -2471,39 +2503,30 @@ protected:
     static const int low_mask = (~((int)0) ^ up_mask);
 
     /// This is the hash function
-    size_t operator()(const PEdge &e) const
+    size_t operator()(const PEdgeNode &e) const
     {
       return (e.nodes_[0] << sz_half_int) |
 	(low_mask & e.nodes_[1]);
     }
 
     ///  This should return less than rather than equal to.
-    bool operator()(const PEdge &e1, const PEdge& e2) const
+    bool operator()(const PEdgeNode &e1, const PEdgeNode& e2) const
     {
       return e1 < e2;
     }
   };
 
-  using face_ht = std::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using edge_ht = std::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
+  using face_nt = MeshTopologyTable<PFaceNode, FaceHash>;
+  using edge_nt = MeshTopologyTable<PEdgeNode, EdgeHash>;
 
   /// container for face storage. Must be computed each time
   ///  nodes or cells change.
   std::vector<PFace>            faces_;
-  face_ht                  face_table_;
+  face_nt                  face_table_;
   /// container for edge storage. Must be computed each time
   ///  nodes or cells change.
   std::vector<PEdge>            edges_;
-  edge_ht                  edge_table_;
-
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Cell::index_type ci, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
+  edge_nt                  edge_table_;
 
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
@@ -2557,32 +2580,15 @@ protected:
     return (true);
   }
 
-  /// useful functors
-  struct FillNodeNeighbors {
-    FillNodeNeighbors(std::vector<std::vector<typename Node::index_type> > &n,
-                      const PrismVolMesh &m) :
-      nbor_vec_(n),
-      mesh_(m)
-    {}
-
-    void operator()(typename Edge::index_type e) {
-      mesh_.get_nodes(nodes_, e);
-      nbor_vec_[nodes_[0]].push_back(nodes_[1]);
-      nbor_vec_[nodes_[1]].push_back(nodes_[0]);
-    }
-
-    std::vector<std::vector<typename Node::index_type> > &nbor_vec_;
-    const PrismVolMesh            &mesh_;
-    typename Node::array_type   nodes_;
-  };
+  /// For each node the nodes it shares an edge with.
+  typedef CompressedAdjacency<typename Node::index_type> node_neighbor_table;
+  node_neighbor_table node_neighbors_;
 
   /// This grid is used as an acceleration structure to expedite calls
   ///  to locate.  For each cell in the grid, we store a list of which
   ///  tets overlap that grid cell -- to find the tet which contains a
   ///  point, we simply find which grid cell contains that point, and
   ///  then search just those tets that overlap that grid cell.
-  std::vector<std::vector<typename Node::index_type> > node_neighbors_;
-
   std::vector<unsigned char> boundary_faces_;
   SharedPointer<SearchGridT<index_type> >  node_grid_;
   SharedPointer<SearchGridT<index_type> >  elem_grid_;
@@ -2886,99 +2892,58 @@ PrismVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-PrismVolMesh<Basis>::hash_face(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Node::index_type n3,
-			       typename Node::index_type n4,
-			       index_type combined_index,
-			       face_ht &table) const
+PrismVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
+  // 5 faces -- each is entered CCW from outside looking in, the
+  // triangles get a dummy fourth node
+  static const int face_nodes[5][4] = { {0,1,2,-1}, {5,4,3,-1}, {1,4,5,2},
+                                        {2,5,3,0}, {0,3,4,1} };
+
+  // Reorder nodes while maintaining CCW or CW orientation. Degenerate
+  // faces are skipped (e.g. nodes on opposite corners are equal, or more
+  // than two nodes are equal)
+  std::vector<index_type> offsets, slots;
+  face_table_.build(static_cast<index_type>(points_.size()),
+    static_cast<index_type>(cells_.size() / 6), 5, 3,
+    [this](index_type cell, int face, PFaceNode& key)
+    {
+      const index_type off = cell * 6;
+      const int* fn = face_nodes[face];
+      typename Node::index_type n1 = cells_[off+fn[0]], n2 = cells_[off+fn[1]];
+      typename Node::index_type n3 = cells_[off+fn[2]], n4 = PRISM_DUMMY_NODE_INDEX;
+      if (fn[3] >= 0) n4 = cells_[off+fn[3]];
+      if (!(order_face_nodes(n1,n2,n3,n4))) return (false);
+      key = PFaceNode(n1, n2, n3, n4);
+      return (true);
+    }, offsets, slots);
 
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
+  // dump faces into the faces_ container.
+  const index_type num_faces = static_cast<index_type>(offsets.size()) - 1;
+  faces_.clear();
+  faces_.resize(num_faces);
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
+  Core::Thread::Parallel::For(0, num_faces, [&](std::int64_t begin, std::int64_t end)
   {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
+    for (std::int64_t f = begin; f < end; f++)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index >> 3)
-           << " are illegally adjacent." << std::endl;*/
+      PFace& face = faces_[f];
+      static_cast<PFaceNode&>(face) = face_table_.key(f);
+      index_type c0, c1;
+      face_nt::first_two_slots(offsets, slots, f, 3, c0, c1);
+      face.cells_[0] = c0;
+      face.cells_[1] = c1;
     }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << " and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
-
-template <class Basis>
-void
-PrismVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
-
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(6);
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    // 5 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], PRISM_DUMMY_NODE_INDEX, cell_index, face_table_);
-    hash_face(arr[5], arr[4], arr[3], PRISM_DUMMY_NODE_INDEX, cell_index + 1, face_table_);
-    hash_face(arr[1], arr[4], arr[5], arr[2], cell_index + 2, face_table_);
-    hash_face(arr[2], arr[5], arr[3], arr[0], cell_index + 3, face_table_);
-    hash_face(arr[0], arr[3], arr[4], arr[1], cell_index + 4, face_table_);
-
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
-  faces_.resize(face_table_.size());
-  typename std::vector<PFace>::iterator f_iter = faces_.begin();
-  typename face_ht::iterator ht_iter = face_table_.begin();
-
-  boundary_faces_.resize(cells_.size() /6);
+  });
 
-  index_type i = 0;
-  while (ht_iter != face_table_.end())
+  boundary_faces_.assign(cells_.size() / 6, 0);
+  for (index_type f = 0; f < num_faces; f++)
   {
-    *f_iter = (*ht_iter).first;
-    (*ht_iter).second = i;
-
-    if ((*f_iter).cells_[1] == -1)
+    if (faces_[f].cells_[1] == MESH_NO_NEIGHBOR)
     {
-      index_type cell = ((*f_iter).cells_[0]) >> 3;
-      index_type face = ((*f_iter).cells_[0]) & 0x7;
+      index_type cell = (faces_[f].cells_[0]) >> 3;
+      index_type face = (faces_[f].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++f_iter; ++ht_iter; i++;
   }
 
   synchronize_lock_.lock();
@@ -2986,66 +2951,45 @@ PrismVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Cell::index_type ci,
-			       edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(ci); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(ci); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    hash_edge(arr[0], arr[1], *ci, edge_table_);
-    hash_edge(arr[1], arr[2], *ci, edge_table_);
-    hash_edge(arr[2], arr[0], *ci, edge_table_);
-
-    hash_edge(arr[3], arr[4], *ci, edge_table_);
-    hash_edge(arr[4], arr[5], *ci, edge_table_);
-    hash_edge(arr[5], arr[3], *ci, edge_table_);
-
-    hash_edge(arr[0], arr[3], *ci, edge_table_);
-    hash_edge(arr[4], arr[1], *ci, edge_table_);
-    hash_edge(arr[2], arr[5], *ci, edge_table_);
-    ++ci;
-  }
+  static const int edge_nodes[9][2] = { {0,1}, {1,2}, {2,0},
+                                        {3,4}, {4,5}, {5,3},
+                                        {0,3}, {4,1}, {2,5} };
+
+  std::vector<index_type> offsets, slots;
+  edge_table_.build(static_cast<index_type>(points_.size()),
+    static_cast<index_type>(cells_.size() / 6), 9, 4,
+    [this](index_type cell, int edge, PEdgeNode& key)
+    {
+      const index_type off = cell * 6;
+      const index_type n1 = cells_[off+edge_nodes[edge][0]];
+      const index_type n2 = cells_[off+edge_nodes[edge][1]];
+      if (n1 == n2) return (false);
+      key = PEdgeNode(n1, n2);
+      return (true);
+    }, offsets, slots);
 
   // dump edges into the edges_ container.
+  const index_type num_edges = static_cast<index_type>(offsets.size()) - 1;
+  edges_.clear();
+  edges_.resize(num_edges);
 
-  edges_.resize(edge_table_.size());
-
-  typename std::vector<PEdge>::iterator e_iter = edges_.begin();
-  typename edge_ht::iterator ht_iter = edge_table_.begin();
-  while (ht_iter != edge_table_.end()) {
-    *e_iter = (*ht_iter).first;
-    (*ht_iter).second = static_cast<typename Edge::index_type>(
-                                                      e_iter - edges_.begin());
-    ++e_iter; ++ht_iter;
-  }
+  Core::Thread::Parallel::For(0, num_edges, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (std::int64_t e = begin; e < end; e++)
+    {
+      PEdge& edge = edges_[e];
+      static_cast<PEdgeNode&>(edge) = edge_table_.key(e);
+      edge.cells_.resize(offsets[e+1] - offsets[e]);
+      for (index_type k = offsets[e]; k < offsets[e+1]; k++)
+      {
+        edge.cells_[k - offsets[e]] = static_cast<typename Cell::index_type>(slots[k] >> 4);
+      }
+    }
+  });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3325,7 +3269,7 @@ PrismVolMesh<Basis>::get_face(typename Face::index_type &face,
             "Must call synchronize FACES_E on PrismVolMesh first");
   if(!(order_face_nodes(n1,n2,n3,n4))) return (false);
   PFace f(n1, n2, n3, n4);
-  typename face_ht::const_iterator fiter = face_table_.find(f);
+  typename face_nt::const_iterator fiter = face_table_.find(f);
   if (fiter == face_table_.end()) {
     return false;
   }
@@ -3337,11 +3281,10 @@ template <class Basis>
 void
 PrismVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  typename Edge::iterator ei, eie;
-  begin(ei); end(eie);
-  std::for_each(ei, eie, FillNodeNeighbors(node_neighbors_, *this));
+  // Every edge adds each of its nodes to the row of the other one.
+  node_neighbors_.build(points_.size(), 2*edges_.size(),
+    [this](std::int64_t i) { return (edges_[i>>1].nodes_[i&1]); },
+    [this](std::int64_t i) { return (edges_[i>>1].nodes_[1-(i&1)]); });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3597,7 +3540,7 @@ PrismVolMesh<Basis>::io(Piostream &stream)
                                          PRISM_VOL_MESH_VERSION);
   Mesh::io(stream);
 
-  SCIRun::Pio(stream, points_);
+  Pio(stream, points_);
   SCIRun::Pio_index(stream, cells_);
   if (version == 1)
   {
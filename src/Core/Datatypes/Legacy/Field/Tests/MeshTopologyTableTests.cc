@@ -0,0 +1,377 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+
+#include <Core/Datatypes/Legacy/Field/MeshTopologyTable.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Logging/ScopedTimeRemarker.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <map>
+#include <functional>
+#include <set>
+#include <unordered_map>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  struct Edge
+  {
+    index_type nodes_[2];
+    Edge() { nodes_[0] = nodes_[1] = -1; }
+    Edge(index_type a, index_type b) { nodes_[0] = std::min(a,b); nodes_[1] = std::max(a,b); }
+    bool operator==(const Edge& e) const { return nodes_[0] == e.nodes_[0] && nodes_[1] == e.nodes_[1]; }
+    bool operator<(const Edge& e) const
+    {
+      return nodes_[0] < e.nodes_[0] || (nodes_[0] == e.nodes_[0] && nodes_[1] < e.nodes_[1]);
+    }
+  };
+
+  struct EdgeHash
+  {
+    size_t operator()(const Edge& e) const { return static_cast<size_t>(e.nodes_[0]*7919 + e.nodes_[1]); }
+  };
+
+  typedef MeshTopologyTable<Edge, EdgeHash> EdgeTable;
+
+  // Two triangles sharing edge 1-2, and a third one with a degenerate edge.
+  const index_type triangles[3][3] = { {0,1,2}, {2,1,3}, {3,4,4} };
+
+  void buildEdges(EdgeTable& table, std::vector<index_type>& offsets, std::vector<index_type>& slots)
+  {
+    table.build(5, 3, 3, 2, [](index_type tri, int edge, Edge& key)
+    {
+      const index_type n1 = triangles[tri][edge], n2 = triangles[tri][(edge+1)%3];
+      if (n1 == n2) return false;
+      key = Edge(n1, n2);
+      return true;
+    }, offsets, slots);
+  }
+}
+
+TEST(MeshTopologyTableTest, BuildsSortedUniqueKeysWithTheirSlots)
+{
+  EdgeTable table;
+  std::vector<index_type> offsets, slots;
+  buildEdges(table, offsets, slots);
+
+  // 0-1, 0-2, 1-2, 1-3, 2-3, 3-4
+  ASSERT_EQ(7u, offsets.size());
+  EXPECT_EQ(8u, slots.size());
+  const Edge expected[6] = { Edge(0,1), Edge(0,2), Edge(1,2), Edge(1,3), Edge(2,3), Edge(3,4) };
+  for (index_type i = 0; i < 6; i++)
+  {
+    EXPECT_TRUE(table.key(i) == expected[i]);
+    auto it = table.find(expected[i]);
+    ASSERT_TRUE(it != table.end());
+    EXPECT_EQ(i, it->second);
+  }
+
+  // Edge 1-2 is the second edge of triangle 0 and the first of triangle 1
+  ASSERT_EQ(2, offsets[3] - offsets[2]);
+  EXPECT_EQ((0 << 2) + 1, slots[offsets[2]]);
+  EXPECT_EQ((1 << 2) + 0, slots[offsets[2] + 1]);
+
+  index_type slot0, slot1;
+  EdgeTable::first_two_slots(offsets, slots, 2, 2, slot0, slot1);
+  EXPECT_EQ(1, slot0);
+  EXPECT_EQ(4, slot1);
+  EdgeTable::first_two_slots(offsets, slots, 0, 2, slot0, slot1);
+  EXPECT_EQ(0, slot0);
+  EXPECT_EQ(-1, slot1);
+
+  EXPECT_TRUE(table.find(Edge(0,3)) == table.end());
+  EXPECT_TRUE(table.find(Edge(7,8)) == table.end());
+}
+
+TEST(MeshTopologyTableTest, KeepsEditsAfterTheBuild)
+{
+  EdgeTable table;
+  std::vector<index_type> offsets, slots;
+  buildEdges(table, offsets, slots);
+
+  table.erase(table.find(Edge(1,2)));
+  EXPECT_TRUE(table.find(Edge(1,2)) == table.end());
+  table[Edge(2,1)] = 10;
+  EXPECT_EQ(10, table.find(Edge(1,2))->second);
+
+  // Keys outside the table, also on nodes added later
+  table[Edge(0,3)] = 11;
+  table[Edge(5,6)] = 12;
+  const EdgeTable& ctable = table;
+  EXPECT_EQ(11, (*ctable.find(Edge(3,0))).second);
+  EXPECT_EQ(12, ctable.find(Edge(6,5))->second);
+  table.erase(table.find(Edge(5,6)));
+  EXPECT_TRUE(ctable.find(Edge(5,6)) == ctable.end());
+
+  table.clear();
+  EXPECT_TRUE(table.find(Edge(0,1)) == table.end());
+}
+
+namespace
+{
+  // Grid of n x n x nz unit cubes, each a hexahedron, two prisms or six tetrahedra.
+  FieldHandle volumeGrid(mesh_info_type type, int n, int nz)
+  {
+    FieldInformation fi(type, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    auto vmesh = field->vmesh();
+
+    auto node = [n](int i, int j, int k) { return i + (n+1)*(j + (n+1)*k); };
+    for (int k = 0; k <= nz; k++)
+      for (int j = 0; j <= n; j++)
+        for (int i = 0; i <= n; i++)
+          vmesh->add_point(Point(i, j, k));
+
+    const int tets[6][4] = { {5,6,0,4}, {0,7,2,3}, {2,6,0,1}, {0,6,5,1}, {0,6,2,7}, {6,7,0,4} };
+    const int prisms[2][6] = { {0,1,2,4,5,6}, {0,2,3,4,6,7} };
+    VMesh::Node::array_type vdata;
+    for (int k = 0; k < nz; k++)
+      for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+        {
+          const int corners[8] = { node(i,j,k), node(i+1,j,k), node(i+1,j+1,k), node(i,j+1,k),
+            node(i,j,k+1), node(i+1,j,k+1), node(i+1,j+1,k+1), node(i,j+1,k+1) };
+          if (type == mesh_info_type::TETVOLMESH_E)
+          {
+            vdata.resize(4);
+            for (const auto& tet : tets)
+            {
+              for (int c = 0; c < 4; c++) vdata[c] = corners[tet[c]];
+              vmesh->add_elem(vdata);
+            }
+          }
+          else if (type == mesh_info_type::PRISMVOLMESH_E)
+          {
+            vdata.resize(6);
+            for (const auto& prism : prisms)
+            {
+              for (int c = 0; c < 6; c++) vdata[c] = corners[prism[c]];
+              vmesh->add_elem(vdata);
+            }
+          }
+          else
+          {
+            vdata.assign(corners, corners + 8);
+            vmesh->add_elem(vdata);
+          }
+        }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  // Checks that the synchronized faces and edges are unique and consistent
+  // with the elements that use them.
+  void checkTopology(VMesh* mesh, size_t expectedBoundaryFaces)
+  {
+    mesh->synchronize(Mesh::FACES_E|Mesh::EDGES_E);
+
+    VMesh::Elem::size_type numElems;
+    VMesh::Face::size_type numFaces;
+    VMesh::Edge::size_type numEdges;
+    mesh->size(numElems);
+    mesh->size(numFaces);
+    mesh->size(numEdges);
+
+    std::set<std::vector<index_type>> faces, edges;
+    VMesh::Node::array_type nodes;
+    for (VMesh::Face::index_type f = 0; f < numFaces; f++)
+    {
+      mesh->get_nodes(nodes, f);
+      std::vector<index_type> key(nodes.begin(), nodes.end());
+      std::sort(key.begin(), key.end());
+      key.erase(std::unique(key.begin(), key.end()), key.end());
+      EXPECT_TRUE(faces.insert(key).second);
+    }
+    for (VMesh::Edge::index_type e = 0; e < numEdges; e++)
+    {
+      mesh->get_nodes(nodes, e);
+      std::vector<index_type> key(nodes.begin(), nodes.end());
+      std::sort(key.begin(), key.end());
+      EXPECT_TRUE(edges.insert(key).second);
+    }
+
+    std::vector<int> faceUses(numFaces, 0);
+    VMesh::Face::array_type elemFaces;
+    VMesh::Elem::array_type elems;
+    for (VMesh::Elem::index_type c = 0; c < numElems; c++)
+    {
+      mesh->get_faces(elemFaces, c);
+      for (auto f : elemFaces)
+      {
+        ASSERT_LT(f, numFaces);
+        faceUses[f]++;
+        mesh->get_elems(elems, f);
+        EXPECT_TRUE(std::find(elems.begin(), elems.end(), c) != elems.end());
+      }
+    }
+
+    size_t boundaryFaces = 0;
+    for (VMesh::Face::index_type f = 0; f < numFaces; f++)
+    {
+      mesh->get_elems(elems, f);
+      EXPECT_EQ(faceUses[f], static_cast<int>(elems.size()));
+      if (elems.size() == 1) boundaryFaces++;
+    }
+    EXPECT_EQ(expectedBoundaryFaces, boundaryFaces);
+    VMesh::Node::array_type elemNodes;
+    for (VMesh::Edge::index_type e = 0; e < numEdges; e++)
+    {
+      mesh->get_nodes(nodes, e);
+      mesh->get_elems(elems, e);
+      EXPECT_FALSE(elems.empty());
+      for (auto c : elems)
+      {
+        mesh->get_nodes(elemNodes, c);
+        EXPECT_TRUE(std::find(elemNodes.begin(), elemNodes.end(), nodes[0]) != elemNodes.end());
+        EXPECT_TRUE(std::find(elemNodes.begin(), elemNodes.end(), nodes[1]) != elemNodes.end());
+      }
+    }
+  }
+}
+
+TEST(MeshTopologyTableTest, TetVolMeshFacesAndEdges)
+{
+  auto field = volumeGrid(mesh_info_type::TETVOLMESH_E, 4, 4);
+  auto mesh = field->vmesh();
+
+  // The diagonals of the cube faces do not match up between all cubes, so
+  // count the faces and edges by brute force.
+  std::map<std::vector<index_type>, int> faces;
+  std::set<std::vector<index_type>> edges;
+  VMesh::Elem::size_type numElems;
+  mesh->size(numElems);
+  VMesh::Node::array_type nodes;
+  for (VMesh::Elem::index_type c = 0; c < numElems; c++)
+  {
+    mesh->get_nodes(nodes, c);
+    for (int i = 0; i < 4; i++)
+    {
+      std::vector<index_type> face;
+      for (int j = 0; j < 4; j++) if (j != i) face.push_back(nodes[j]);
+      std::sort(face.begin(), face.end());
+      faces[face]++;
+      for (int j = i+1; j < 4; j++)
+        edges.insert({ std::min(nodes[i], nodes[j]), std::max(nodes[i], nodes[j]) });
+    }
+  }
+  const size_t boundaryFaces = std::count_if(faces.begin(), faces.end(),
+    [](const std::pair<const std::vector<index_type>, int>& f) { return f.second == 1; });
+
+  checkTopology(mesh, boundaryFaces);
+
+  VMesh::Face::size_type numFaces;
+  VMesh::Edge::size_type numEdges;
+  mesh->size(numFaces);
+  mesh->size(numEdges);
+  EXPECT_EQ(faces.size(), static_cast<size_t>(numFaces));
+  EXPECT_EQ(edges.size(), static_cast<size_t>(numEdges));
+}
+
+TEST(MeshTopologyTableTest, HexVolMeshFacesAndEdges)
+{
+  const int n = 4;
+  auto field = volumeGrid(mesh_info_type::HEXVOLMESH_E, n, n);
+  checkTopology(field->vmesh(), 6*n*n);
+
+  VMesh::Face::size_type numFaces;
+  VMesh::Edge::size_type numEdges;
+  field->vmesh()->size(numFaces);
+  field->vmesh()->size(numEdges);
+  EXPECT_EQ(3*n*n*(n+1), numFaces);
+  EXPECT_EQ(3*n*(n+1)*(n+1), numEdges);
+}
+
+TEST(MeshTopologyTableTest, PrismVolMeshFacesAndEdges)
+{
+  // A single layer: the triangles of stacked prisms are not matched up, as
+  // PrismVolMesh keeps the orientation of triangular faces in their key.
+  const int n = 4;
+  auto field = volumeGrid(mesh_info_type::PRISMVOLMESH_E, n, 1);
+  const int layerEdges = 3*n*n + 2*n;
+  checkTopology(field->vmesh(), 4*n*n + 4*n);
+
+  VMesh::Face::size_type numFaces;
+  VMesh::Edge::size_type numEdges;
+  field->vmesh()->size(numFaces);
+  field->vmesh()->size(numEdges);
+  // Triangles at the bottom and top plus one quad per triangle edge
+  EXPECT_EQ(4*n*n + layerEdges, numFaces);
+  EXPECT_EQ(2*layerEdges + (n+1)*(n+1), numEdges);
+}
+
+TEST(MeshTopologyTableTest, DISABLED_TetVolMeshFaceTableTiming)
+{
+  using Core::Logging::SimpleScopedTimer;
+  const int n = 50;
+  auto field = volumeGrid(mesh_info_type::TETVOLMESH_E, n, n);
+  auto mesh = field->vmesh();
+  VMesh::Elem::size_type numElems;
+  mesh->size(numElems);
+
+  // What the meshes did before: hash every face of every cell
+  {
+    SimpleScopedTimer t;
+    std::unordered_map<std::array<index_type,3>, index_type, std::function<size_t(const std::array<index_type,3>&)>>
+      table(0, [](const std::array<index_type,3>& f) { return static_cast<size_t>((f[0]*73856093) ^ (f[1]*19349663) ^ (f[2]*83492791)); });
+    VMesh::Node::array_type nodes;
+    const int faces[4][3] = { {0,2,1}, {1,2,3}, {0,1,3}, {0,3,2} };
+    for (VMesh::Elem::index_type c = 0; c < numElems; c++)
+    {
+      mesh->get_nodes(nodes, c);
+      for (const auto& face : faces)
+      {
+        std::array<index_type,3> key = {{ nodes[face[0]], nodes[face[1]], nodes[face[2]] }};
+        std::sort(key.begin(), key.end());
+        table.emplace(key, static_cast<index_type>(table.size()));
+      }
+    }
+    std::cout << numElems << " tets, " << table.size() << " faces hashed in " << t.elapsedSeconds() << " s" << std::endl;
+  }
+
+  {
+    SimpleScopedTimer t;
+    mesh->synchronize(Mesh::FACES_E);
+    std::cout << "sorted face table built in " << t.elapsedSeconds() << " s" << std::endl;
+  }
+  {
+    SimpleScopedTimer t;
+    mesh->synchronize(Mesh::EDGES_E);
+    std::cout << "sorted edge table built in " << t.elapsedSeconds() << " s" << std::endl;
+  }
+}
@@ -32,8 +32,13 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/TetVolMesh.h>
+#include <Core/Logging/ScopedTimeRemarker.h>
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -68,3 +73,323 @@ TEST(TetVolMeshTest, CheckMeshIteratorTetVolMesh)
   ASSERT_EQ(c, 6);
 
 }
+
+namespace
+{
+  // Unit cube split into n^3 hexahedra of six tetrahedra each. With grading > 1
+  // the nodes cluster towards the origin, the largest tets being about grading*n^(grading-1)
+  // times the size of the smallest along each axis.
+  FieldHandle tetGrid(int n, double grading = 1.0)
+  {
+    FieldInformation fi(mesh_info_type::TETVOLMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    auto vmesh = field->vmesh();
+
+    auto node = [n](int i, int j, int k) { return i + (n+1)*(j + (n+1)*k); };
+    for (int k = 0; k <= n; k++)
+      for (int j = 0; j <= n; j++)
+        for (int i = 0; i <= n; i++)
+          vmesh->add_point(Point(std::pow(double(i)/n, grading), std::pow(double(j)/n, grading),
+            std::pow(double(k)/n, grading)));
+
+    const int tets[6][4] = { {5,6,0,4}, {0,7,2,3}, {2,6,0,1}, {0,6,5,1}, {0,6,2,7}, {6,7,0,4} };
+    VMesh::Node::array_type vdata(4);
+    for (int k = 0; k < n; k++)
+      for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+        {
+          const int corners[8] = { node(i,j,k), node(i+1,j,k), node(i+1,j+1,k), node(i,j+1,k),
+            node(i,j,k+1), node(i+1,j,k+1), node(i+1,j+1,k+1), node(i,j+1,k+1) };
+          for (const auto& tet : tets)
+          {
+            for (int c = 0; c < 4; c++) vdata[c] = corners[tet[c]];
+            vmesh->add_elem(vdata);
+          }
+        }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  std::vector<Point> scatteredPoints(int num, double lo, double hi)
+  {
+    std::vector<Point> points;
+    unsigned int seed = 12345;
+    auto next = [&seed, lo, hi]()
+    {
+      seed = seed*1103515245u + 12345u;
+      return lo + (hi - lo)*((seed >> 8) & 0xffff)/65535.0;
+    };
+    for (int j = 0; j < num; j++)
+    {
+      const double x = next(), y = next(), z = next();
+      points.emplace_back(x, y, z);
+    }
+    return points;
+  }
+}
+
+TEST(TetVolMeshTest, MortonOrderIsAPermutation)
+{
+  auto points = scatteredPoints(500, -1.0, 2.0);
+  std::vector<VMesh::index_type> order;
+  VMesh::morton_order(order, points);
+
+  ASSERT_EQ(points.size(), order.size());
+  std::vector<bool> seen(points.size(), false);
+  for (auto idx : order)
+  {
+    ASSERT_TRUE(idx >= 0 && idx < static_cast<VMesh::index_type>(points.size()));
+    EXPECT_FALSE(seen[idx]);
+    seen[idx] = true;
+  }
+
+  // Consecutive points along the curve are much closer than in random order
+  double sorted = 0.0, unsorted = 0.0;
+  for (size_t j = 1; j < points.size(); j++)
+  {
+    sorted += (points[order[j]] - points[order[j-1]]).length();
+    unsorted += (points[j] - points[j-1]).length();
+  }
+  EXPECT_LT(sorted, 0.5*unsorted);
+}
+
+TEST(TetVolMeshTest, BatchedClosestNodeMatchesSinglePointSearch)
+{
+  auto field = tetGrid(6);
+  auto mesh = field->vmesh();
+  mesh->synchronize(Mesh::FIND_CLOSEST_NODE_E);
+
+  auto points = scatteredPoints(400, -0.3, 1.3);
+  std::vector<double> dist;
+  std::vector<Point> result;
+  std::vector<VMesh::Node::index_type> nodes;
+  mesh->mfind_closest_node(dist, result, nodes, points);
+
+  ASSERT_EQ(points.size(), nodes.size());
+  for (size_t j = 0; j < points.size(); j++)
+  {
+    double d; Point r; VMesh::Node::index_type node = -1;
+    ASSERT_TRUE(mesh->find_closest_node(d, r, node, points[j]));
+    EXPECT_NEAR(d, dist[j], 1e-12);
+    Point q;
+    mesh->get_center(q, nodes[j]);
+    EXPECT_NEAR(d, (q - points[j]).length(), 1e-12);
+  }
+
+  // Points further than maxdist from every node are not found
+  mesh->mfind_closest_node(dist, result, nodes, points, 0.05);
+  for (size_t j = 0; j < points.size(); j++)
+  {
+    double d; Point r; VMesh::Node::index_type node = -1;
+    mesh->find_closest_node(d, r, node, points[j]);
+    if (d < 0.05 - 1e-12)
+    {
+      EXPECT_NEAR(d, dist[j], 1e-12);
+    }
+    else if (d > 0.05 + 1e-12)
+    {
+      EXPECT_EQ(-1, nodes[j]);
+    }
+  }
+}
+
+TEST(TetVolMeshTest, BatchedClosestElemMatchesSinglePointSearch)
+{
+  auto field = tetGrid(5);
+  auto mesh = field->vmesh();
+  mesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+
+  auto points = scatteredPoints(400, -0.3, 1.3);
+  std::vector<double> dist;
+  std::vector<Point> result;
+  std::vector<VMesh::coords_type> coords;
+  std::vector<VMesh::Elem::index_type> elems;
+  mesh->mfind_closest_elem(dist, result, coords, elems, points);
+
+  ASSERT_EQ(points.size(), elems.size());
+  for (size_t j = 0; j < points.size(); j++)
+  {
+    double d; Point r; VMesh::coords_type c; VMesh::Elem::index_type elem = -1;
+    ASSERT_TRUE(mesh->find_closest_elem(d, r, c, elem, points[j]));
+    EXPECT_NEAR(d, dist[j], 1e-10);
+    EXPECT_NEAR(0.0, (r - result[j]).length(), 1e-10);
+    ASSERT_GE(elems[j], 0);
+    Point p;
+    mesh->interpolate(p, coords[j], elems[j]);
+    EXPECT_NEAR(0.0, (p - result[j]).length(), 1e-10);
+  }
+}
+
+namespace
+{
+  typedef TetVolMesh<Core::Basis::TetLinearLgn<Point> > TVMesh;
+
+  SharedPointer<TVMesh> tetVolMesh(FieldHandle field)
+  {
+    return std::dynamic_pointer_cast<TVMesh>(field->mesh());
+  }
+}
+
+TEST(TetVolMeshTest, SearchTreesMatchSearchGrids)
+{
+  auto treeField = tetGrid(8, 3.0);
+  auto gridField = tetGrid(8, 3.0);
+  auto treeMesh = tetVolMesh(treeField);
+  auto gridMesh = tetVolMesh(gridField);
+  ASSERT_TRUE(treeMesh && gridMesh);
+  EXPECT_TRUE(treeMesh->uses_search_trees());
+  gridMesh->use_search_trees(false);
+
+  const mask_type sync = Mesh::LOCATE_E | Mesh::FIND_CLOSEST_E;
+  treeMesh->synchronize(sync);
+  gridMesh->synchronize(sync);
+
+  auto points = scatteredPoints(500, -0.3, 1.3);
+  // Half of them in the finely meshed corner
+  for (size_t j = 0; j < points.size(); j += 2)
+    points[j] = Point(points[j].x()*0.1, points[j].y()*0.1, points[j].z()*0.1);
+
+  for (const auto& p : points)
+  {
+    TVMesh::Elem::index_type treeElem = -1, gridElem = -1;
+    const bool inside = gridMesh->locate(gridElem, p);
+    EXPECT_EQ(inside, treeMesh->locate(treeElem, p));
+    if (inside)
+    {
+      // Points on shared faces may be found in either tet.
+      VMesh::coords_type coords;
+      treeMesh->get_coords(coords, p, treeElem);
+      for (const auto& c : coords) EXPECT_GT(c, -1e-8);
+      EXPECT_GT(1.0 + 1e-8, coords[0] + coords[1] + coords[2]);
+    }
+
+    double treeDist, gridDist;
+    Point treeResult, gridResult;
+    VMesh::Node::index_type treeNode = -1, gridNode = -1;
+    ASSERT_TRUE(treeMesh->find_closest_node(treeDist, treeResult, treeNode, p));
+    ASSERT_TRUE(gridMesh->find_closest_node(gridDist, gridResult, gridNode, p));
+    EXPECT_NEAR(gridDist, treeDist, 1e-12);
+
+    VMesh::coords_type treeCoords, gridCoords;
+    VMesh::Elem::index_type treeClosest = -1, gridClosest = -1;
+    ASSERT_TRUE(treeMesh->find_closest_elem(treeDist, treeResult, treeCoords, treeClosest, p));
+    ASSERT_TRUE(gridMesh->find_closest_elem(gridDist, gridResult, gridCoords, gridClosest, p));
+    EXPECT_NEAR(gridDist, treeDist, 1e-12);
+    EXPECT_NEAR(0.0, (treeResult - gridResult).length(), 1e-10);
+
+    std::vector<index_type> treeNodes, gridNodes;
+    treeMesh->find_closest_nodes(treeNodes, p, 0.1);
+    gridMesh->find_closest_nodes(gridNodes, p, 0.1);
+    std::sort(treeNodes.begin(), treeNodes.end());
+    std::sort(gridNodes.begin(), gridNodes.end());
+    EXPECT_EQ(gridNodes, treeNodes);
+  }
+
+  // Tets whose boxes overlap a query box
+  VMesh::Elem::array_type elems;
+  const BBox box(Point(0.01, 0.01, 0.01), Point(0.02, 0.03, 0.04));
+  ASSERT_TRUE(treeField->vmesh()->locate(elems, box));
+  VMesh::Elem::array_type expected;
+  for (index_type c = 0; c < 6*8*8*8; c++)
+  {
+    TVMesh::Node::array_type nodes;
+    treeMesh->get_nodes(nodes, TVMesh::Cell::index_type(c));
+    BBox cellBox;
+    for (auto n : nodes) cellBox.extend(treeMesh->get_points()[n]);
+    cellBox.extend(treeMesh->get_epsilon());
+    if (cellBox.overlaps(box)) expected.push_back(c);
+  }
+  std::sort(elems.begin(), elems.end());
+  EXPECT_EQ(expected, elems);
+}
+
+TEST(TetVolMeshTest, SearchTreesFallBackToGridWhenCellsAreEdited)
+{
+  auto field = tetGrid(4);
+  auto mesh = tetVolMesh(field);
+  mesh->synchronize(Mesh::LOCATE_E | Mesh::EDGES_E | Mesh::FACES_E);
+
+  // Splitting a tet in four edits the cells in place, which the element tree
+  // cannot follow.
+  const Point p(0.31, 0.17, 0.07);
+  TVMesh::Elem::index_type elem;
+  ASSERT_TRUE(mesh->locate(elem, p));
+  TVMesh::Elem::array_type tets;
+  TVMesh::Node::index_type node;
+  ASSERT_TRUE(mesh->insert_node_in_elem(tets, node, elem, p));
+  ASSERT_EQ(4u, tets.size());
+
+  for (const auto& q : scatteredPoints(200, 0.0, 1.0))
+  {
+    TVMesh::Elem::index_type found = 0;
+    ASSERT_TRUE(mesh->locate(found, q));
+    VMesh::coords_type coords;
+    mesh->get_coords(coords, q, found);
+    for (const auto& c : coords) EXPECT_GT(c, -1e-8);
+    EXPECT_GT(1.0 + 1e-8, coords[0] + coords[1] + coords[2]);
+  }
+}
+
+namespace
+{
+  void timeSearchStructures(const std::string& label, FieldHandle field, const std::vector<Point>& points)
+  {
+    using Core::Logging::SimpleScopedTimer;
+    for (bool trees : { false, true })
+    {
+      auto mesh = tetVolMesh(field);
+      mesh->clear_synchronization();
+      mesh->use_search_trees(trees);
+      double syncTime, locateTime, nodeTime, elemTime;
+      {
+        SimpleScopedTimer timer;
+        mesh->synchronize(Mesh::LOCATE_E | Mesh::FIND_CLOSEST_E);
+        syncTime = timer.elapsedSeconds();
+      }
+      size_t found = 0;
+      {
+        SimpleScopedTimer timer;
+        for (const auto& p : points)
+        {
+          TVMesh::Elem::index_type elem = -1;
+          if (mesh->locate(elem, p)) ++found;
+        }
+        locateTime = timer.elapsedSeconds();
+      }
+      {
+        SimpleScopedTimer timer;
+        for (const auto& p : points)
+        {
+          double d; Point r; TVMesh::Node::index_type node = -1;
+          mesh->find_closest_node(d, r, node, p);
+        }
+        nodeTime = timer.elapsedSeconds();
+      }
+      {
+        SimpleScopedTimer timer;
+        for (const auto& p : points)
+        {
+          double d; Point r; VMesh::coords_type coords; TVMesh::Elem::index_type elem = -1;
+          mesh->find_closest_elem(d, r, coords, elem, p);
+        }
+        elemTime = timer.elapsedSeconds();
+      }
+      std::cout << label << (trees ? " trees: " : " grids: ")
+                << "synchronize " << syncTime << " s, "
+                << points.size() << " locates " << locateTime << " s (" << found << " inside), "
+                << "closest node " << nodeTime << " s, closest elem " << elemTime << " s" << std::endl;
+    }
+  }
+}
+
+TEST(TetVolMeshTest, DISABLED_SearchTreeVersusGridTiming)
+{
+  const int n = 40;
+  auto points = scatteredPoints(200000, -0.1, 1.1);
+  timeSearchStructures("uniform", tetGrid(n), points);
+
+  // Graded meshes are queried where their elements are, in the refined corner.
+  for (auto& p : points)
+    p = Point(std::pow(std::abs(p.x()), 3.0), std::pow(std::abs(p.y()), 3.0), std::pow(std::abs(p.z()), 3.0));
+  timeSearchStructures("graded", tetGrid(n, 3.0), points);
+}
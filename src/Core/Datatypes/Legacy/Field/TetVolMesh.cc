@@ -147,6 +147,9 @@ public:
 
   VMesh::index_type* get_elems_pointer() const override;
 
+  void get_adjacency_memory(size_t& used, size_t& nested) const override
+    { this->mesh_->get_adjacency_memory(used, nested); }
+
   double inscribed_circumscribed_radius_metric(VMesh::Elem::index_type idx) const override;
 };
 
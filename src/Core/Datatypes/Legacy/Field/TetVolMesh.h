@@ -33,10 +33,13 @@
 /// Need to fix this and couple it sci-defs
 #include <Core/Datatypes/Legacy/Field/MeshSupport.h>
 
+#include <Core/Containers/CompressedAdjacency.h>
 #include <Core/Containers/StackVector.h>
 #include <Core/Persistent/PersistentSTL.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
+#include <Core/GeometryPrimitives/BoundingVolumeHierarchy.h>
+#include <Core/GeometryPrimitives/KDTree.h>
 #include <Core/GeometryPrimitives/BBox.h>
 #include <Core/GeometryPrimitives/CompGeom.h>
 #include <Core/GeometryPrimitives/Point.h>
@@ -51,6 +54,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologyTable.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 #include <Core/Math/MiscMath.h>
@@ -60,6 +64,7 @@
 #include <unordered_map>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
+#include <Core/Thread/Parallel.h>
 
 #include <set>
 
@@ -410,6 +415,19 @@ public:
   bool unsynchronize(mask_type mask) override;
   bool clear_synchronization();
 
+  /// Bytes used by the node neighbor table, and the bytes the same table
+  /// would take as a vector of vectors.
+  void get_adjacency_memory(size_t& used, size_t& nested) const
+  {
+    used = node_neighbors_.memory_size();
+    nested = node_neighbors_.nested_memory_size();
+  }
+
+  /// Choose what synchronize(NODE_LOCATE_E|ELEM_LOCATE_E) builds: search trees
+  /// (the default) or uniform search grids. Changing it drops the current ones.
+  void use_search_trees(bool use);
+  bool uses_search_trees() const { return (use_search_trees_); }
+
   /// Get the basis class.
   Basis& get_basis() { return basis_; }
 
@@ -916,6 +934,17 @@ public:
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
 	      "TetVolMesh::find_closest_node requires synchronize(NODE_LOCATE_E).");
 
+    if (node_tree_)
+    {
+      index_type idx;
+      double dmin = maxdist;
+      if (!node_tree_->find_closest(p, idx, dmin)) return (false);
+      node = INDEX(idx);
+      result = points_[idx];
+      pdist = sqrt(dmin);
+      return (true);
+    }
+
     // get grid sizes
     const size_type ni = node_grid_->get_ni()-1;
     const size_type nj = node_grid_->get_nj()-1;
@@ -1005,6 +1034,15 @@ public:
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
         "TetVolMesh::find_closest_node requires synchronize(NODE_LOCATE_E).")
 
+    if (node_tree_)
+    {
+      node_tree_->visit_within(p, maxdist*maxdist, [&](index_type idx, double)
+      {
+        nodes.push_back(idx);
+      });
+      return (nodes.size() > 0);
+    }
+
     // get grid sizes
     const size_type ni = node_grid_->get_ni()-1;
     const size_type nj = node_grid_->get_nj()-1;
@@ -1077,6 +1115,16 @@ public:
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
         "TetVolMesh::find_closest_node requires synchronize(NODE_LOCATE_E).")
 
+    if (node_tree_)
+    {
+      node_tree_->visit_within(p, maxdist*maxdist, [&](index_type idx, double dist)
+      {
+        nodes.push_back(idx);
+        distances.push_back(dist);
+      });
+      return (nodes.size() > 0);
+    }
+
     // get grid sizes
     const size_type ni = node_grid_->get_ni()-1;
     const size_type nj = node_grid_->get_nj()-1;
@@ -1187,25 +1235,37 @@ public:
               "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
     // First check are we inside an element
-    SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type cidx;
+    if (search_elem(cidx, p))
     {
-      while (it != eit)
-      {
-        if (inside(typename Elem::index_type(*it), p))
-        {
-          pdist = 0.0;
-          result = p;
-          elem = static_cast<INDEX>(*it);
-          ElemData ed(*this, elem);
-          basis_.get_coords(coords, p, ed);
-          return (true);
-        }
-        ++it;
-      }
+      pdist = 0.0;
+      result = p;
+      elem = static_cast<INDEX>(cidx);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
     }
 
     // If not start searching for the closest outer boundary
+    if (elem_tree_)
+    {
+      // Only elements with a boundary face have a finite distance, the tree skips
+      // the others as soon as a boundary face has been found closer than their box.
+      auto boundary_distance = [&](index_type ci, const Core::Geometry::Point& q)
+      {
+        Core::Geometry::Point r;
+        return (closest_boundary_point(r, ci, q));
+      };
+      double dmin = maxdist;
+      if (!elem_tree_->find_closest(p, cidx, dmin, boundary_distance)) return (false);
+      closest_boundary_point(result, cidx, p);
+      elem = INDEX(cidx);
+      ElemData ed(*this,elem);
+      basis_.get_coords(coords,result,ed);
+      pdist = sqrt(dmin);
+      return (true);
+    }
+
     // get grid sizes
     const size_type ni = elem_grid_->get_ni()-1;
     const size_type nj = elem_grid_->get_nj()-1;
@@ -1704,10 +1764,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
             "TetVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(
-                                                  (node_neighbors_[idx][i])>>2);
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[idx];
+    array.resize(neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>((neighbors[i])>>2);
   }
 
   template<class ARRAY, class INDEX>
@@ -1719,7 +1779,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1795,7 +1855,7 @@ protected:
       "TetVolMesh: Must call synchronize FACES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1833,8 +1893,9 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
               "TetVolMesh: Must call synchronize EDGES_E first");
+    array.resize(edges_[idx].cells_.size());
     for (size_t i=0; i< edges_[idx].cells_.size(); i++)
-      array[i] = static_cast<typename ARRAY::value_type>(edges_[idx].cells_[i]);
+      array[i] = static_cast<typename ARRAY::value_type>((edges_[idx].cells_[i])>>3);
   }
 
   template<class ARRAY, class INDEX>
@@ -1931,12 +1992,13 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on TetVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const typename node_neighbor_table::Row neighbors = node_neighbors_[node];
+    size_t sz = neighbors.size();
 
     std::set<index_type> inserted;
     for (size_t i = 0; i < sz; i++)
     {
-      const index_type base = ((node_neighbors_[node][i])&(~0x3));
+      const index_type base = ((neighbors[i])&(~0x3));
       for (index_type c = base; c < base+4; ++c)
       {
         if (cells_[c] != node) inserted.insert(cells_[c]);
@@ -1965,6 +2027,14 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
               "TetVolMesh::locate_node requires synchronize(NODE_LOCATE_E).")
 
+    if (node_tree_)
+    {
+      index_type idx;
+      double dmin = DBL_MAX;
+      if (node_tree_->find_closest(p, idx, dmin)) node = INDEX(idx);
+      return (true);
+    }
+
     // get grid sizes
     const size_type ni = node_grid_->get_ni()-1;
     const size_type nj = node_grid_->get_nj()-1;
@@ -2114,18 +2184,11 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
                 "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type idx;
+    if (search_elem(idx, p))
     {
-      while (it != eit)
-      {
-        if (inside(typename Elem::index_type(*it), p))
-        {
-          elem = static_cast<INDEX>(*it);
-          return (true);
-        }
-        ++it;
-      }
+      elem = static_cast<INDEX>(idx);
+      return (true);
     }
     return (false);
   }
@@ -2139,6 +2202,15 @@ protected:
               "TetVolMesh::locate_elems requires synchronize(ELEM_LOCATE_E).")
 
     array.clear();
+    if (elem_tree_)
+    {
+      elem_tree_->visit_overlapping(b, [&](index_type idx)
+      {
+        array.push_back(typename ARRAY::value_type(idx));
+      });
+      return (array.size() > 0);
+    }
+
     index_type is,js,ks;
     index_type ie,je,ke;
     elem_grid_->locate_clamp(is,js,ks,b.get_min());
@@ -2187,20 +2259,13 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
                 "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
-    typename SearchGridT<index_type>::iterator it, eit;
-    if (elem_grid_->lookup(it, eit, p))
+    index_type idx;
+    if (search_elem(idx, p))
     {
-      while (it != eit)
-      {
-        if (inside(typename Elem::index_type(*it), p))
-        {
-          elem = static_cast<INDEX>(*it);
-          ElemData ed(*this, elem);
-          basis_.get_coords(coords, p, ed);
-          return (true);
-        }
-        ++it;
-      }
+      elem = static_cast<INDEX>(idx);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
     }
 
     return (false);
@@ -2263,6 +2328,11 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  void build_node_grid();
+  void build_elem_grid();
+  void build_node_tree();
+  void build_elem_tree();
+
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
@@ -2270,6 +2340,66 @@ protected:
 
   const Core::Geometry::Point &point(typename Node::index_type i) { return points_[i]; }
 
+  /// Find a tet that contains p using the element tree or grid
+  inline bool search_elem(index_type &elem, const Core::Geometry::Point &p) const
+  {
+    if (elem_tree_)
+    {
+      return (elem_tree_->visit_containing(p, [&](index_type idx)
+      {
+        if (!inside(idx, p)) return (false);
+        elem = idx;
+        return (true);
+      }));
+    }
+
+    typename SearchGridT<index_type>::iterator it, eit;
+    if (elem_grid_->lookup(it, eit, p))
+    {
+      while (it != eit)
+      {
+        if (inside(typename Elem::index_type(*it), p))
+        {
+          elem = *it;
+          return (true);
+        }
+        ++it;
+      }
+    }
+    return (false);
+  }
+
+  /// Closest point to p on the boundary faces of tet ci. Returns the squared
+  /// distance, or DBL_MAX if the tet has no boundary faces.
+  inline double closest_boundary_point(Core::Geometry::Point &result,
+                                       index_type ci,
+                                       const Core::Geometry::Point &p) const
+  {
+    const index_type idx = ci*4;
+    const unsigned char b = boundary_faces_[ci];
+    double dmin = DBL_MAX;
+    if (b == 0) return (dmin);
+
+    // Faces in the same order as compute_faces
+    static const int face_nodes[4][3] = { {0,2,1}, {1,2,3}, {0,1,3}, {0,3,2} };
+    for (int f = 0; f < 4; f++)
+    {
+      if (!(b & (1 << f))) continue;
+      Core::Geometry::Point r;
+      closest_point_on_tri(r, p,
+                           points_[cells_[idx+face_nodes[f][0]]],
+                           points_[cells_[idx+face_nodes[f][1]]],
+                           points_[cells_[idx+face_nodes[f][2]]]);
+      const double dtmp = (p - r).length2();
+      if (dtmp < dmin)
+      {
+        dmin = dtmp;
+        result = r;
+      }
+    }
+    return (dmin);
+  }
+
   template<class INDEX>
   bool inside(INDEX idx, const Core::Geometry::Point &p) const
   {
@@ -2548,10 +2678,8 @@ protected:
     }
   };
 
-  using face_ht = std::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using face_nt = std::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = std::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
-  using edge_nt = std::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
+  using face_nt = MeshTopologyTable<PFaceNode, FaceHash>;
+  using edge_nt = MeshTopologyTable<PEdgeNode, EdgeHash>;
 
   typedef std::vector<PFaceCell> face_ct;
   typedef std::vector<PEdgeCell> edge_ct;
@@ -2572,11 +2700,6 @@ protected:
 			  typename Cell::index_type ci,
 			  bool table_only = false);
 
-  inline void hash_edge(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        index_type combined_index,
-                        edge_ht& table);
-
   inline void add_edge(typename Node::index_type n1,
                         typename Node::index_type n2,
                         index_type combined_index);
@@ -2586,16 +2709,14 @@ protected:
                           typename Node::index_type n3,
                           typename Cell::index_type ci,
                           bool table_only = false);
-  inline void hash_face(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        typename Node::index_type n3,
-                        index_type ci, face_ht& table);
   inline void add_face(typename Node::index_type n1,
                        typename Node::index_type n2,
                        typename Node::index_type n3,
                        index_type combined_index);
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  /// For each node the cell slots (cell*4 + node in cell) that use it.
+  typedef CompressedAdjacency<typename Cell::index_type> node_neighbor_table;
+  node_neighbor_table node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -2606,6 +2727,15 @@ protected:
   SharedPointer<SearchGridT<index_type> >  node_grid_;
   SharedPointer<SearchGridT<index_type> >  elem_grid_;
 
+  /// With use_search_trees_ set, synchronize(NODE_LOCATE_E|ELEM_LOCATE_E) builds
+  ///  a k-d tree over the nodes and a bounding volume hierarchy over the tets
+  ///  instead of the grids. Both adapt to the local element size, so graded
+  ///  meshes do not pile thousands of small tets into a single grid cell. The
+  ///  element tree is replaced by a grid as soon as cells are edited in place.
+  SharedPointer<Core::Geometry::KDTree>                   node_tree_;
+  SharedPointer<Core::Geometry::BoundingVolumeHierarchy>  elem_tree_;
+  bool                                                    use_search_trees_;
+
   // Lock and Condition Variable for hand shaking
   mutable Core::Thread::Mutex                 synchronize_lock_;
   Core::Thread::ConditionVariable             synchronize_cond_;
@@ -2662,6 +2792,7 @@ TetVolMesh<Basis>::TetVolMesh() :
   face_table_(),
   edges_(0),
   edge_table_(),
+  use_search_trees_(true),
   synchronize_lock_("TetVolMesh lock"),
   synchronize_cond_("TetVolMesh condition variable"),
   synchronized_(Mesh::NODES_E | Mesh::CELLS_E),
@@ -2684,6 +2815,7 @@ TetVolMesh<Basis>::TetVolMesh(const TetVolMesh &copy) :
   face_table_(),
   edges_(0),
   edge_table_(),
+  use_search_trees_(true),
   synchronize_lock_("TetVolMesh lock"),
   synchronize_cond_("TetVolMesh condition variable"),
   synchronized_(Mesh::NODES_E | Mesh::CELLS_E),
@@ -2704,6 +2836,7 @@ TetVolMesh<Basis>::TetVolMesh(const TetVolMesh &copy) :
 
   // Epsilon does not require much space, hence copy those
   synchronized_ |= copy.synchronized_ & Mesh::BOUNDING_BOX_E;
+  use_search_trees_ = copy.use_search_trees_;
   bbox_ = copy.bbox_;
   epsilon_ = copy.epsilon_;
   epsilon2_ = copy.epsilon2_;
@@ -2899,6 +3032,9 @@ TetVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
   if (node_grid_) { node_grid_->transform(t); }
   if (elem_grid_) { elem_grid_->transform(t); }
+  // The trees are axis aligned, hence rebuild them for the new points
+  if (node_tree_) build_node_tree();
+  if (elem_tree_) build_elem_tree();
 
   synchronize_lock_.unlock();
 }
@@ -2949,94 +3085,44 @@ TetVolMesh<Basis>::remove_face(typename Node::index_type n1,
 
 template <class Basis>
 void
-TetVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             index_type combined_index,
-                             face_ht& table)
+TetVolMesh<Basis>::compute_faces()
 {
-  PFace f(n1, n2, n3);
+  // 4 faces -- each is entered CCW from outside looking in
+  static const int face_nodes[4][3] = { {0,2,1}, {1,2,3}, {0,1,3}, {0,3,2} };
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << ", #" << (f.cells_[1]>>2) << ", and #"
-           << (combined_index>>2) << " are illegally adjacent." << std::endl;
-           */
-    }
-    else if ((f.cells_[0]>>2) == (combined_index>>2))
+  std::vector<index_type> offsets, slots;
+  face_table_.build(static_cast<index_type>(points_.size()),
+    static_cast<index_type>(cells_.size() >> 2), 4, 2,
+    [this](index_type cell, int face, PFaceNode& key)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << " and #" << (combined_index>>2)
-           << " are the same." << std::endl;*/
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
+      const index_type off = cell << 2;
+      const int* fn = face_nodes[face];
+      key = PFaceNode(cells_[off+fn[0]], cells_[off+fn[1]], cells_[off+fn[2]]);
+      return (true);
+    }, offsets, slots);
 
-template <class Basis>
-void
-TetVolMesh<Basis>::compute_faces()
-{
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(4);
-
-  face_ht table;
+  const index_type num_faces = static_cast<index_type>(offsets.size()) - 1;
+  faces_.clear();
+  faces_.resize(num_faces);
 
-  while (ci != cie)
+  Core::Thread::Parallel::For(0, num_faces, [&](std::int64_t begin, std::int64_t end)
   {
-    get_nodes(arr, *ci);
-    // 4 faces -- each is entered CCW from outside looking in
-
-    index_type cell_index = (*ci)<<2;
-    hash_face(arr[0], arr[2], arr[1], cell_index, table);
-    hash_face(arr[1], arr[2], arr[3], cell_index + 1, table);
-    hash_face(arr[0], arr[1], arr[3], cell_index + 2, table);
-    hash_face(arr[0], arr[3], arr[2], cell_index + 3, table);
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
-
-  boundary_faces_.resize(cells_.size() >> 2);
+    for (std::int64_t f = begin; f < end; f++)
+    {
+      face_nt::first_two_slots(offsets, slots, f, 2,
+                               faces_[f].cells_[0], faces_[f].cells_[1]);
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  boundary_faces_.assign(cells_.size() >> 2, 0);
+  for (index_type f = 0; f < num_faces; f++)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2])] = uidx;
-
-    if (pface.cells_[1] == -1)
+    if (faces_[f].cells_[1] == MESH_NO_NEIGHBOR)
     {
-      index_type cell = (pface.cells_[0]) >> 2;
-      index_type face = (pface.cells_[0]) & 0x3;
+      index_type cell = (faces_[f].cells_[0]) >> 2;
+      index_type face = (faces_[f].cells_[0]) & 0x3;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
@@ -3081,66 +3167,36 @@ TetVolMesh<Basis>::add_face(typename Node::index_type n1,
   }
 }
 
-template <class Basis>
-void
-TetVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht& table)
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
+  static const int edge_nodes[6][2] = { {0,1}, {1,2}, {2,0}, {3,0}, {3,1}, {3,2} };
 
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<3;
-    hash_edge(arr[0], arr[1], cell_index  ,table);
-    hash_edge(arr[1], arr[2], cell_index+1,table);
-    hash_edge(arr[2], arr[0], cell_index+2,table);
-    hash_edge(arr[3], arr[0], cell_index+3,table);
-    hash_edge(arr[3], arr[1], cell_index+4,table);
-    hash_edge(arr[3], arr[2], cell_index+5,table);
-    ++ci;
-  }
-
-  edges_.resize(table.size());
-
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+  std::vector<index_type> offsets, slots;
+  edge_table_.build(static_cast<index_type>(points_.size()),
+    static_cast<index_type>(cells_.size() >> 2), 6, 3,
+    [this](index_type cell, int edge, PEdgeNode& key)
+    {
+      const index_type off = cell << 2;
+      const index_type n1 = cells_[off+edge_nodes[edge][0]];
+      const index_type n2 = cells_[off+edge_nodes[edge][1]];
+      if (n1 == n2) return (false);
+      key = PEdgeNode(n1, n2);
+      return (true);
+    }, offsets, slots);
+
+  const index_type num_edges = static_cast<index_type>(offsets.size()) - 1;
+  edges_.clear();
+  edges_.resize(num_edges);
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  Core::Thread::Parallel::For(0, num_edges, [&](std::int64_t begin, std::int64_t end)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+    for (std::int64_t e = begin; e < end; e++)
+    {
+      edges_[e].cells_.assign(slots.begin() + offsets[e], slots.begin() + offsets[e+1]);
+    }
+  });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3314,6 +3370,8 @@ TetVolMesh<Basis>::clear_synchronization()
 
   node_grid_.reset();
   elem_grid_.reset();
+  node_tree_.reset();
+  elem_tree_.reset();
 
   synchronize_lock_.unlock();
 
@@ -3541,7 +3599,7 @@ TetVolMesh<Basis>::create_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    node_neighbors_[cells_[i]].push_back(i);
+    node_neighbors_.push_back(cells_[i], i);
   }
 }
 
@@ -3552,17 +3610,9 @@ TetVolMesh<Basis>::delete_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    const index_type n = cells_[i];
-    typename std::vector<typename Cell::index_type>::iterator node_cells_end =
-      node_neighbors_[n].end();
-    typename std::vector<typename Cell::index_type>::iterator cell =
-      node_neighbors_[n].begin();
-    while (cell != node_cells_end && (*cell) != i) ++cell;
-
     /// ASSERT that the node_neighbors_ structure contains this cell
-    ASSERT(cell != node_cells_end);
-
-    node_neighbors_[n].erase(cell);
+    if (!node_neighbors_.erase(cells_[i], i))
+      ASSERTFAIL("TetVolMesh: cell is missing from node_neighbors_");
   }
 }
 
@@ -3670,13 +3720,9 @@ template <class Basis>
 void
 TetVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  node_neighbors_.build(points_.size(), cells_.size(),
+    [this](std::int64_t i) { return (cells_[i]); },
+    [](std::int64_t i) { return (static_cast<typename Cell::index_type>(i)); });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3725,6 +3771,15 @@ TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   /// @todo:  This can crash if you insert a new cell outside of the grid.
   // Need to recompute grid at that point.
 
+  // The element tree cannot be updated in place, hence switch to a grid. It is
+  // built from the current cells, which already include this one.
+  if (!elem_grid_)
+  {
+    elem_tree_.reset();
+    build_elem_grid();
+    return;
+  }
+
   const index_type idx = ci*4;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3740,6 +3795,13 @@ template <class Basis>
 void
 TetVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
+  if (!elem_grid_)
+  {
+    elem_tree_.reset();
+    build_elem_grid();
+    if (!elem_grid_) return;
+  }
+
   const index_type idx = ci*4;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3769,6 +3831,47 @@ TetVolMesh<Basis>::remove_node_from_grid(typename Node::index_type ni)
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_elem_grid()
+{
+  if (use_search_trees_)
+  {
+    elem_grid_.reset();
+    build_elem_tree();
+  }
+  else
+  {
+    elem_tree_.reset();
+    build_elem_grid();
+  }
+
+  synchronize_lock_.lock();
+  synchronized_ |= Mesh::ELEM_LOCATE_E;
+  synchronize_lock_.unlock();
+}
+
+template <class Basis>
+void
+TetVolMesh<Basis>::compute_node_grid()
+{
+  ASSERTMSG(bbox_.valid(),"TetVolMesh BBox not valid");
+  if (use_search_trees_)
+  {
+    node_grid_.reset();
+    build_node_tree();
+  }
+  else
+  {
+    node_tree_.reset();
+    build_node_grid();
+  }
+
+  synchronize_lock_.lock();
+  synchronized_ |= Mesh::NODE_LOCATE_E;
+  synchronize_lock_.unlock();
+}
+
+template <class Basis>
+void
+TetVolMesh<Basis>::build_elem_grid()
 {
   if (bbox_.valid())
   {
@@ -3796,17 +3899,12 @@ TetVolMesh<Basis>::compute_elem_grid()
       ++ci;
     }
   }
-
-  synchronize_lock_.lock();
-  synchronized_ |= Mesh::ELEM_LOCATE_E;
-  synchronize_lock_.unlock();
 }
 
 template <class Basis>
 void
-TetVolMesh<Basis>::compute_node_grid()
+TetVolMesh<Basis>::build_node_grid()
 {
-  ASSERTMSG(bbox_.valid(),"TetVolMesh BBox not valid");
   if (bbox_.valid())
   {
     // Cubed root of number of cells to get a subdivision ballpark.
@@ -3833,9 +3931,52 @@ TetVolMesh<Basis>::compute_node_grid()
       ++ni;
     }
   }
+}
 
+template <class Basis>
+void
+TetVolMesh<Basis>::build_elem_tree()
+{
+  // Same boxes as the grid uses, computed in parallel
+  const size_type num_cells = static_cast<size_type>(cells_.size() >> 2);
+  std::vector<Core::Geometry::BBox> boxes(num_cells);
+  Core::Thread::Parallel::For(0, num_cells, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (index_type ci = begin; ci < end; ci++)
+    {
+      const index_type idx = ci*4;
+      Core::Geometry::BBox& box = boxes[ci];
+      box.extend(points_[cells_[idx]]);
+      box.extend(points_[cells_[idx+1]]);
+      box.extend(points_[cells_[idx+2]]);
+      box.extend(points_[cells_[idx+3]]);
+      box.extend(epsilon_);
+    }
+  });
+  elem_tree_.reset(new Core::Geometry::BoundingVolumeHierarchy(boxes));
+}
+
+template <class Basis>
+void
+TetVolMesh<Basis>::build_node_tree()
+{
+  node_tree_.reset(new Core::Geometry::KDTree(points_));
+}
+
+template <class Basis>
+void
+TetVolMesh<Basis>::use_search_trees(bool use)
+{
   synchronize_lock_.lock();
-  synchronized_ |= Mesh::NODE_LOCATE_E;
+  if (use != use_search_trees_)
+  {
+    use_search_trees_ = use;
+    node_grid_.reset();
+    elem_grid_.reset();
+    node_tree_.reset();
+    elem_tree_.reset();
+    synchronized_ &= ~Mesh::LOCATE_E;
+  }
   synchronize_lock_.unlock();
 }
 
@@ -3888,7 +4029,7 @@ TetVolMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double /*err*/
     if (synchronized_ & Mesh::NODE_NEIGHBORS_E)
     {
       synchronize_lock_.lock();
-      node_neighbors_.push_back(std::vector<typename Cell::index_type>());
+      node_neighbors_.add_row();
       synchronize_lock_.unlock();
     }
     return static_cast<typename Node::index_type>(points_.size() - 1);
@@ -4382,7 +4523,7 @@ TetVolMesh<Basis>::io(Piostream &stream)
 					 TETVOLMESH_VERSION);
   Mesh::io(stream);
 
-  SCIRun::Pio(stream, points_);
+  Pio(stream, points_);
   SCIRun::Pio_index(stream, cells_);
   if (version == 1)
   {
@@ -121,6 +121,10 @@ public:
                                      Point& point) override;
 
   VMesh::index_type* get_elems_pointer() const override;
+
+  void get_adjacency_memory(size_t& used, size_t& nested) const override
+    { this->mesh_->get_adjacency_memory(used, nested); }
+
   SharedPointer<SearchGridT<typename SCIRun::index_type> > get_elem_search_grid() override { return this->mesh_->elem_grid_; }
   SharedPointer<SearchGridT<typename SCIRun::index_type> > get_node_search_grid() override { return this->mesh_->node_grid_; }
 
@@ -33,6 +33,7 @@
 /// Need to fix this and couple it sci-defs
 #include <Core/Datatypes/Legacy/Field/MeshSupport.h>
 
+#include <Core/Containers/CompressedAdjacency.h>
 #include <Core/Containers/StackVector.h>
 
 #include <Core/GeometryPrimitives/Transform.h>
@@ -349,6 +350,14 @@ bool synchronize(mask_type mask) override;
 bool unsynchronize(mask_type mask) override;
   bool clear_synchronization();
 
+  /// Bytes used by the node neighbor table, and the bytes the same table
+  /// would take as a vector of vectors.
+  void get_adjacency_memory(size_t& used, size_t& nested) const
+  {
+    used = node_neighbors_.memory_size();
+    nested = node_neighbors_.nested_memory_size();
+  }
+
   /// Get the basis class.
   Basis& get_basis() { return basis_; }
 
@@ -1547,9 +1556,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
 	      "TriSurfMesh: Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(node_neighbors_[idx][i]);
+    const typename node_neighbor_table::Row faces = node_neighbors_[idx];
+    array.resize(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(faces[i]);
   }
 
 
@@ -1582,7 +1592,7 @@ protected:
               "Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
     // Get the table of faces that are connected to the two nodes
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const typename node_neighbor_table::Row faces = node_neighbors_[idx];
     array.clear();
 
     typename ARRAY::value_type edge;
@@ -1710,7 +1720,7 @@ protected:
     array.clear();
 
     // Get all the neighboring elements
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const typename node_neighbor_table::Row faces = node_neighbors_[idx];
     // Make a conservative estimate of the number of node neighbors
     array.reserve(2*faces.size());
 
@@ -2033,7 +2043,8 @@ protected:
   std::vector<index_type>    faces_;               // Connectivity of this mesh
   std::vector<index_type>    edge_neighbors_;      // Neighbor connectivity
   std::vector<Core::Geometry::Vector>        normals_;             // normalized per node normal.
-  std::vector<std::vector<index_type> > node_neighbors_; // Node neighbor connectivity
+  typedef CompressedAdjacency<index_type> node_neighbor_table;
+  node_neighbor_table node_neighbors_;   // Node neighbor connectivity
   std::vector<std::vector<index_type> > edge_on_node_; // Edges emanating from a node
 
   SharedPointer<SearchGridT<index_type> > node_grid_; // Lookup table for nodes
@@ -2109,7 +2120,6 @@ TriSurfMesh<Basis>::TriSurfMesh()
   : points_(0),
     faces_(0),
     edge_neighbors_(0),
-    node_neighbors_(0),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -2133,7 +2143,6 @@ TriSurfMesh<Basis>::TriSurfMesh(const TriSurfMesh &copy)
     faces_(0),
     edge_neighbors_(0),
     normals_(0),
-    node_neighbors_(0),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -3172,13 +3181,9 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  size_type nfaces = static_cast<size_type>(faces_.size());
-  for (index_type f = 0; f < nfaces; ++f)
-  {
-    node_neighbors_[faces_[f]].push_back(f/3);
-  }
+  node_neighbors_.build(points_.size(), faces_.size(),
+    [this](std::int64_t f) { return (faces_[f]); },
+    [](std::int64_t f) { return (static_cast<index_type>(f/3)); });
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
   synchronize_lock_.unlock();
@@ -3296,7 +3301,7 @@ TriSurfMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double err)
   {
     synchronize_lock_.lock();
     points_.push_back(p);
-    node_neighbors_.push_back(std::vector<under_type>());
+    node_neighbors_.add_row();
     synchronize_lock_.unlock();
     return static_cast<typename Node::index_type>(points_.size() - 1);
   }
@@ -34,6 +34,10 @@
 #include <Core/GeometryPrimitives/Transform.h>
 #include <Core/GeometryPrimitives/BBox.h>
 
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
 
@@ -594,6 +598,179 @@ VMesh::find_closest_elems(double&, Point&, VMesh::Elem::array_type&,
   ASSERTFAIL("VMesh interface: find_closest_elems(dist,Point,Elem::array_type,Point) has not been implemented");
 }
 
+namespace
+{
+  // Spread the lower 21 bits of v so there are two zero bits between each
+  uint64_t morton_spread(uint64_t v)
+  {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8)  & 0x100f00f00f00f00fULL;
+    v = (v | v << 4)  & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2)  & 0x1249249249249249ULL;
+    return v;
+  }
+
+  // Search radius for the next query that is guaranteed to contain its
+  // closest node or element: the previous hit lies on the mesh and is at
+  // most prevdist + |p - prevp| away. Pad it a little for round off.
+  double bounded_search_radius(double prevdist, const Point& prevp,
+                               const Point& p, double maxdist)
+  {
+    double radius = (prevdist + (p - prevp).length())*(1.0 + 1e-10) + 1e-300;
+    if (maxdist >= 0.0 && maxdist < radius) radius = maxdist;
+    return radius;
+  }
+}
+
+void
+VMesh::morton_order(std::vector<index_type>& order, const std::vector<Point>& points)
+{
+  const size_t num_points = points.size();
+  order.resize(num_points);
+  for (size_t j=0; j<num_points; j++) order[j] = static_cast<index_type>(j);
+  if (num_points < 3) return;
+
+  Point pmin = points[0];
+  Point pmax = points[0];
+  for (size_t j=1; j<num_points; j++)
+  {
+    pmin = Min(pmin,points[j]);
+    pmax = Max(pmax,points[j]);
+  }
+
+  const double maxcode = static_cast<double>(0x1fffff);
+  Vector scale = pmax - pmin;
+  for (int k=0; k<3; k++) scale[k] = (scale[k] > 0.0) ? maxcode/scale[k] : 0.0;
+
+  std::vector<uint64_t> codes(num_points);
+  for (size_t j=0; j<num_points; j++)
+  {
+    const Vector d = points[j] - pmin;
+    codes[j] = morton_spread(static_cast<uint64_t>(d.x()*scale.x())) |
+               morton_spread(static_cast<uint64_t>(d.y()*scale.y())) << 1 |
+               morton_spread(static_cast<uint64_t>(d.z()*scale.z())) << 2;
+  }
+
+  std::stable_sort(order.begin(), order.end(),
+    [&codes](index_type a, index_type b) { return codes[a] < codes[b]; });
+}
+
+void
+VMesh::mfind_closest_node(std::vector<double>& dist,
+                          std::vector<Point>& result,
+                          std::vector<Node::index_type>& idx,
+                          const std::vector<Point>& points,
+                          double maxdist) const
+{
+  const size_t num_points = points.size();
+  dist.resize(num_points);
+  result.resize(num_points);
+  idx.resize(num_points);
+
+  std::vector<index_type> order;
+  morton_order(order,points);
+
+  bool have_prev = false;
+  double prevdist = 0.0;
+  Point prevp;
+  Node::index_type node = -1;
+
+  for (size_t j=0; j<num_points; j++)
+  {
+    const index_type k = order[j];
+    const Point& p = points[k];
+
+    bool found = false;
+    bool complete = false;
+    if (have_prev)
+    {
+      const double radius = bounded_search_radius(prevdist,prevp,p,maxdist);
+      found = find_closest_node(dist[k],result[k],node,p,radius);
+      complete = found || radius == maxdist;
+    }
+
+    // Full search for the first point, or if round off made the bounded one miss
+    if (!complete)
+    {
+      if (maxdist >= 0.0) found = find_closest_node(dist[k],result[k],node,p,maxdist);
+      else found = find_closest_node(dist[k],result[k],node,p);
+    }
+
+    if (found)
+    {
+      idx[k] = node;
+      have_prev = true;
+      prevdist = dist[k];
+      prevp = p;
+    }
+    else
+    {
+      idx[k] = -1;
+      dist[k] = DBL_MAX;
+    }
+  }
+}
+
+void
+VMesh::mfind_closest_elem(std::vector<double>& dist,
+                          std::vector<Point>& result,
+                          std::vector<coords_type>& coords,
+                          std::vector<Elem::index_type>& idx,
+                          const std::vector<Point>& points,
+                          double maxdist) const
+{
+  const size_t num_points = points.size();
+  dist.resize(num_points);
+  result.resize(num_points);
+  coords.resize(num_points);
+  idx.resize(num_points);
+
+  std::vector<index_type> order;
+  morton_order(order,points);
+
+  bool have_prev = false;
+  double prevdist = 0.0;
+  Point prevp;
+  Elem::index_type elem = -1;
+
+  for (size_t j=0; j<num_points; j++)
+  {
+    const index_type k = order[j];
+    const Point& p = points[k];
+
+    bool found = false;
+    bool complete = false;
+    if (have_prev)
+    {
+      const double radius = bounded_search_radius(prevdist,prevp,p,maxdist);
+      found = find_closest_elem(dist[k],result[k],coords[k],elem,p,radius);
+      complete = found || radius == maxdist;
+    }
+
+    // Full search for the first point, or if round off made the bounded one miss
+    if (!complete)
+    {
+      if (maxdist >= 0.0) found = find_closest_elem(dist[k],result[k],coords[k],elem,p,maxdist);
+      else found = find_closest_elem(dist[k],result[k],coords[k],elem,p);
+    }
+
+    if (found)
+    {
+      idx[k] = elem;
+      have_prev = true;
+      prevdist = dist[k];
+      prevp = p;
+    }
+    else
+    {
+      idx[k] = -1;
+      dist[k] = DBL_MAX;
+    }
+  }
+}
+
 
 bool
 VMesh::get_coords(coords_type&, const Point&, Elem::index_type) const
@@ -831,6 +1008,13 @@ VMesh::clear_synchronization()
   ASSERTFAIL("VMesh interface: clear_synchronization has not yet been implemented");
 }
 
+void
+VMesh::get_adjacency_memory(size_t& used, size_t& nested) const
+{
+  used = 0;
+  nested = 0;
+}
+
 void
 VMesh::transform(const Transform &)
 {
@@ -702,6 +702,33 @@ public:
                                   VMesh::Elem::array_type &i,
                                   const Core::Geometry::Point &point) const;
 
+  /// Batched versions of find_closest_node and find_closest_elem.
+  /// The points are visited in Morton (Z-curve) order so consecutive
+  /// searches touch the same search grid cells, and the result for the
+  /// previous point is handed to the next search: its index is used as the
+  /// first guess and the triangle inequality bounds the search radius.
+  /// Results are stored in the order of the input points; points for which
+  /// nothing was found within maxdist get an index of -1.
+  /// These functions only call the const search functions above and can be
+  /// called from several threads at the same time.
+  void mfind_closest_node(std::vector<double>& dist,
+                          std::vector<Core::Geometry::Point>& result,
+                          std::vector<Node::index_type>& i,
+                          const std::vector<Core::Geometry::Point>& points,
+                          double maxdist = -1.0) const;
+
+  void mfind_closest_elem(std::vector<double>& dist,
+                          std::vector<Core::Geometry::Point>& result,
+                          std::vector<coords_type>& coords,
+                          std::vector<Elem::index_type>& i,
+                          const std::vector<Core::Geometry::Point>& points,
+                          double maxdist = -1.0) const;
+
+  /// Compute the permutation that sorts a set of points along a Morton
+  /// (Z-order) curve through their bounding box.
+  static void morton_order(std::vector<index_type>& order,
+                           const std::vector<Core::Geometry::Point>& points);
+
   /// Find the coordinates of a point in a certain element
   virtual bool get_coords(coords_type& coords,
                                 const Core::Geometry::Point &point, Elem::index_type i) const;
@@ -975,6 +1002,11 @@ public:
   // Only use this function when this is the only code that uses this mesh
   virtual bool clear_synchronization();
 
+  /// Memory of the node to element (or node to node) adjacency table built
+  /// by synchronize(NODE_NEIGHBORS_E), and what the same table would take
+  /// as a vector of vectors. Meshes without such a table report zero.
+  virtual void get_adjacency_memory(size_t& used, size_t& nested) const;
+
   // Transform a full field, this one works on the full field
   virtual void transform(const Core::Geometry::Transform &t);
 
@@ -132,9 +132,15 @@ namespace Datatypes {
 
     SparseRowMatrixGeneric* clone() const override
     {
+      CloneStatistics::recordClone(sizeInBytes());
       return new SparseRowMatrixGeneric(*this);
     }
 
+    size_t sizeInBytes() const override
+    {
+      return this->nonZeros() * (sizeof(T) + sizeof(index_type)) + (this->outerSize() + 1) * sizeof(index_type);
+    }
+
     size_t nrows() const override { return this->rows(); }
     size_t ncols() const override { return this->cols(); }
 
@@ -0,0 +1,72 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+
+using namespace SCIRun::Core::Datatypes;
+
+TEST(CloneStatisticsTests, DenseCloneBytesAreCounted)
+{
+  CloneStatistics::reset();
+  DenseMatrixHandle m(new DenseMatrix(3, 4, 1.0));
+
+  DenseMatrixHandle copy(m->clone());
+  ASSERT_NE(m.get(), copy.get());
+  (*copy)(0, 0) = 5;
+  EXPECT_EQ(1.0, (*m)(0, 0));
+
+  EXPECT_EQ(1, CloneStatistics::numClones());
+  EXPECT_EQ(12 * sizeof(double), CloneStatistics::bytesCloned());
+}
+
+TEST(CloneStatisticsTests, ResetClearsTotals)
+{
+  DenseMatrixHandle m(new DenseMatrix(2, 2, 1.0));
+  DenseMatrixHandle copy(m->clone());
+  CloneStatistics::reset();
+  EXPECT_EQ(0, CloneStatistics::numClones());
+  EXPECT_EQ(0, CloneStatistics::bytesCloned());
+}
+
+TEST(CloneStatisticsTests, SparseCloneBytesAreCounted)
+{
+  SparseRowMatrixHandle s(new SparseRowMatrix(4, 4));
+  s->insert(0, 0) = 1;
+  s->insert(3, 2) = 2;
+  s->makeCompressed();
+
+  CloneStatistics::reset();
+  SparseRowMatrixHandle copy(s->clone());
+  EXPECT_NE(s.get(), copy.get());
+  EXPECT_EQ(1, CloneStatistics::numClones());
+  EXPECT_EQ(2 * (sizeof(double) + sizeof(SCIRun::index_type)) + 5 * sizeof(SCIRun::index_type), CloneStatistics::bytesCloned());
+}
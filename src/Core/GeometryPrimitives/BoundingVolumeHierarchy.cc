@@ -0,0 +1,346 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Core/GeometryPrimitives/BoundingVolumeHierarchy.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+struct BoundingVolumeHierarchy::BuildItem
+{
+  double min_[3];
+  double max_[3];
+  double center_[3];
+  index_type id_;
+};
+
+/// Recursive binned SAH builder. Children are always allocated as adjacent pairs, so a
+/// node only needs to store the index of its first child.
+struct BoundingVolumeHierarchy::Builder
+{
+  static const int num_bins_ = 16;
+  /// Beyond this depth the SAH is abandoned for median splits, which keeps the depth
+  /// logarithmic for degenerate inputs.
+  static const int sah_depth_ = 64;
+
+  Builder(std::vector<BuildItem>& items, size_type max_leaf_size) :
+    items_(items), max_leaf_size_(std::max<size_type>(1, max_leaf_size)) {}
+
+  static double half_area(const double* lo, const double* hi)
+  {
+    const double dx = hi[0] - lo[0], dy = hi[1] - lo[1], dz = hi[2] - lo[2];
+    return dx * dy + dy * dz + dz * dx;
+  }
+
+  /// Fills in the bounds of node for items [lo, hi) and partitions the range. Returns
+  /// the split position, or -1 when the node should be a leaf.
+  index_type split(Node& node, index_type lo, index_type hi, int depth)
+  {
+    double cmin[3], cmax[3];
+    for (int k = 0; k < 3; ++k)
+    {
+      node.min_[k] = cmin[k] = std::numeric_limits<double>::max();
+      node.max_[k] = cmax[k] = -std::numeric_limits<double>::max();
+    }
+    for (index_type j = lo; j < hi; ++j)
+    {
+      const BuildItem& it = items_[j];
+      for (int k = 0; k < 3; ++k)
+      {
+        node.min_[k] = std::min(node.min_[k], it.min_[k]);
+        node.max_[k] = std::max(node.max_[k], it.max_[k]);
+        cmin[k] = std::min(cmin[k], it.center_[k]);
+        cmax[k] = std::max(cmax[k], it.center_[k]);
+      }
+    }
+    node.first_ = lo;
+    node.count_ = hi - lo;
+    if (hi - lo <= max_leaf_size_) return -1;
+
+    int axis = 0;
+    for (int k = 1; k < 3; ++k)
+      if (cmax[k] - cmin[k] > cmax[axis] - cmin[axis]) axis = k;
+    const double extent = cmax[axis] - cmin[axis];
+
+    index_type mid = -1;
+    if (extent > 0.0 && depth < sah_depth_)
+    {
+      size_type count[num_bins_] = {};
+      double bmin[num_bins_][3], bmax[num_bins_][3];
+      for (int b = 0; b < num_bins_; ++b)
+        for (int k = 0; k < 3; ++k)
+        {
+          bmin[b][k] = std::numeric_limits<double>::max();
+          bmax[b][k] = -std::numeric_limits<double>::max();
+        }
+
+      const double scale = num_bins_ / extent;
+      auto bin_of = [&](const BuildItem& it)
+      {
+        return std::min(num_bins_ - 1, static_cast<int>((it.center_[axis] - cmin[axis]) * scale));
+      };
+
+      for (index_type j = lo; j < hi; ++j)
+      {
+        const BuildItem& it = items_[j];
+        const int b = bin_of(it);
+        ++count[b];
+        for (int k = 0; k < 3; ++k)
+        {
+          bmin[b][k] = std::min(bmin[b][k], it.min_[k]);
+          bmax[b][k] = std::max(bmax[b][k], it.max_[k]);
+        }
+      }
+
+      // Sweep from the right to get the cost of every right hand side, then from the
+      // left to pick the cheapest plane.
+      double rightcost[num_bins_];
+      double lo3[3], hi3[3];
+      for (int k = 0; k < 3; ++k)
+      {
+        lo3[k] = std::numeric_limits<double>::max();
+        hi3[k] = -std::numeric_limits<double>::max();
+      }
+      size_type n = 0;
+      for (int b = num_bins_ - 1; b > 0; --b)
+      {
+        n += count[b];
+        for (int k = 0; k < 3; ++k)
+        {
+          lo3[k] = std::min(lo3[k], bmin[b][k]);
+          hi3[k] = std::max(hi3[k], bmax[b][k]);
+        }
+        rightcost[b] = n > 0 ? n * half_area(lo3, hi3) : 0.0;
+      }
+
+      for (int k = 0; k < 3; ++k)
+      {
+        lo3[k] = std::numeric_limits<double>::max();
+        hi3[k] = -std::numeric_limits<double>::max();
+      }
+      n = 0;
+      double bestcost = std::numeric_limits<double>::max();
+      int bestbin = -1;
+      for (int b = 0; b < num_bins_ - 1; ++b)
+      {
+        n += count[b];
+        for (int k = 0; k < 3; ++k)
+        {
+          lo3[k] = std::min(lo3[k], bmin[b][k]);
+          hi3[k] = std::max(hi3[k], bmax[b][k]);
+        }
+        if (n == 0 || n == hi - lo) continue;
+        const double cost = n * half_area(lo3, hi3) + rightcost[b + 1];
+        if (cost < bestcost) { bestcost = cost; bestbin = b; }
+      }
+
+      if (bestbin >= 0)
+      {
+        mid = std::partition(items_.begin() + lo, items_.begin() + hi,
+          [&](const BuildItem& it) { return bin_of(it) <= bestbin; }) - items_.begin();
+        if (mid == lo || mid == hi) mid = -1;
+      }
+    }
+
+    if (mid < 0)
+    {
+      mid = lo + (hi - lo) / 2;
+      std::nth_element(items_.begin() + lo, items_.begin() + mid, items_.begin() + hi,
+        [axis](const BuildItem& a, const BuildItem& b) { return a.center_[axis] < b.center_[axis]; });
+    }
+    node.count_ = 0;
+    return mid;
+  }
+
+  void build(std::vector<Node>& nodes, index_type slot, index_type lo, index_type hi, int depth)
+  {
+    Node node;
+    const index_type mid = split(node, lo, hi, depth);
+    if (mid >= 0)
+    {
+      node.first_ = static_cast<index_type>(nodes.size());
+      nodes.resize(nodes.size() + 2);
+      nodes[slot] = node;
+      build(nodes, node.first_, lo, mid, depth + 1);
+      build(nodes, node.first_ + 1, mid, hi, depth + 1);
+    }
+    else
+    {
+      nodes[slot] = node;
+    }
+  }
+
+  struct Task
+  {
+    index_type slot_, lo_, hi_;
+    int depth_;
+  };
+
+  /// Builds the top of the tree serially and leaves subtrees at depth task_depth as
+  /// tasks to be built in parallel.
+  void build_top(std::vector<Node>& nodes, std::vector<Task>& tasks, index_type slot,
+                 index_type lo, index_type hi, int depth, int task_depth)
+  {
+    if (depth >= task_depth)
+    {
+      Task task = { slot, lo, hi, depth };
+      tasks.push_back(task);
+      return;
+    }
+    Node node;
+    const index_type mid = split(node, lo, hi, depth);
+    if (mid >= 0)
+    {
+      node.first_ = static_cast<index_type>(nodes.size());
+      nodes.resize(nodes.size() + 2);
+      nodes[slot] = node;
+      build_top(nodes, tasks, node.first_, lo, mid, depth + 1, task_depth);
+      build_top(nodes, tasks, node.first_ + 1, mid, hi, depth + 1, task_depth);
+    }
+    else
+    {
+      nodes[slot] = node;
+    }
+  }
+
+  std::vector<BuildItem>& items_;
+  size_type max_leaf_size_;
+};
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const std::vector<BBox>& boxes, size_type max_leaf_size) :
+  max_leaf_size_(max_leaf_size)
+{
+  build(nullptr, boxes);
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const std::vector<index_type>& ids,
+    const std::vector<BBox>& boxes, size_type max_leaf_size) :
+  max_leaf_size_(max_leaf_size)
+{
+  build(&ids, boxes);
+}
+
+BBox
+BoundingVolumeHierarchy::bounding_box() const
+{
+  BBox b;
+  if (!nodes_.empty())
+  {
+    b.extend(Point(nodes_[0].min_[0], nodes_[0].min_[1], nodes_[0].min_[2]));
+    b.extend(Point(nodes_[0].max_[0], nodes_[0].max_[1], nodes_[0].max_[2]));
+  }
+  return b;
+}
+
+void
+BoundingVolumeHierarchy::build(const std::vector<index_type>* ids, const std::vector<BBox>& boxes)
+{
+  std::vector<BuildItem> items;
+  items.reserve(boxes.size());
+  for (size_t j = 0; j < boxes.size(); ++j)
+  {
+    const BBox& b = boxes[j];
+    if (!b.valid()) continue;
+    const Point bmin = b.get_min(), bmax = b.get_max();
+    BuildItem it;
+    it.min_[0] = bmin.x(); it.min_[1] = bmin.y(); it.min_[2] = bmin.z();
+    it.max_[0] = bmax.x(); it.max_[1] = bmax.y(); it.max_[2] = bmax.z();
+    for (int k = 0; k < 3; ++k) it.center_[k] = 0.5 * (it.min_[k] + it.max_[k]);
+    it.id_ = ids ? (*ids)[j] : static_cast<index_type>(j);
+    items.push_back(it);
+  }
+
+  nodes_.clear();
+  items_.clear();
+  if (items.empty()) return;
+
+  Builder builder(items, max_leaf_size_);
+  const index_type n = static_cast<index_type>(items.size());
+  nodes_.reserve(2 * (n / builder.max_leaf_size_) + 1);
+  nodes_.resize(1);
+
+  // Small trees or a single core: no point in splitting the work up.
+  const unsigned int np = Parallel::NumCores();
+  if (np < 2 || n < 8192)
+  {
+    builder.build(nodes_, 0, 0, n, 0);
+  }
+  else
+  {
+    int task_depth = 0;
+    while ((1u << task_depth) < 4 * np) ++task_depth;
+
+    std::vector<Builder::Task> tasks;
+    builder.build_top(nodes_, tasks, 0, 0, n, 0, task_depth);
+
+    // Subtrees are built into their own arrays, with the subtree root at 0.
+    std::vector<std::vector<Node>> subtrees(tasks.size());
+    Parallel::For(0, static_cast<std::int64_t>(tasks.size()), [&](std::int64_t begin, std::int64_t end)
+    {
+      for (auto t = begin; t < end; ++t)
+      {
+        const Builder::Task& task = tasks[t];
+        subtrees[t].resize(1);
+        builder.build(subtrees[t], 0, task.lo_, task.hi_, task.depth_);
+      }
+    }, 1);
+
+    // Splice: the subtree root goes into its slot and the rest is appended, so local
+    // node i > 0 ends up at offset + i - 1.
+    for (size_t t = 0; t < tasks.size(); ++t)
+    {
+      const auto& sub = subtrees[t];
+      const index_type offset = static_cast<index_type>(nodes_.size());
+      for (size_t i = 0; i < sub.size(); ++i)
+      {
+        Node node = sub[i];
+        if (node.count_ == 0) node.first_ += offset - 1;
+        if (i == 0) nodes_[tasks[t].slot_] = node;
+        else nodes_.push_back(node);
+      }
+    }
+  }
+
+  items_.resize(items.size());
+  for (size_t j = 0; j < items.size(); ++j)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      items_[j].min_[k] = items[j].min_[k];
+      items_[j].max_[k] = items[j].max_[k];
+    }
+    items_[j].id_ = items[j].id_;
+  }
+}
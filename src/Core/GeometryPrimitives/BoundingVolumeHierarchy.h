@@ -0,0 +1,233 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#ifndef CORE_GEOMETRY_BOUNDINGVOLUMEHIERARCHY_H
+#define CORE_GEOMETRY_BOUNDINGVOLUMEHIERARCHY_H 1
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+
+#include <vector>
+
+#include <Core/GeometryPrimitives/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Geometry {
+
+/// Bounding volume hierarchy over a set of axis aligned boxes, split with a binned
+/// surface area heuristic. Unlike SearchGridT the tree adapts to the distribution of
+/// the boxes, so meshes with strongly graded element sizes do not end up with
+/// overfull or empty bins. Items are identified by the index they were given at
+/// construction. The top of the tree is split serially and the subtrees are built
+/// in parallel.
+class SCISHARE BoundingVolumeHierarchy
+{
+  public:
+    typedef SCIRun::index_type index_type;
+    typedef SCIRun::size_type  size_type;
+
+    /// Item i is boxes[i]; invalid boxes are left out.
+    explicit BoundingVolumeHierarchy(const std::vector<BBox>& boxes, size_type max_leaf_size = 4);
+    /// Item ids[i] is boxes[i]; invalid boxes are left out.
+    BoundingVolumeHierarchy(const std::vector<index_type>& ids, const std::vector<BBox>& boxes,
+                            size_type max_leaf_size = 4);
+
+    size_type size() const { return static_cast<size_type>(items_.size()); }
+    size_type num_nodes() const { return static_cast<size_type>(nodes_.size()); }
+    BBox bounding_box() const;
+
+    /// Calls visit(id) for every item whose box contains p, until visit returns true.
+    /// Returns whether a visit returned true.
+    template <class Visitor>
+    bool visit_containing(const Point& p, Visitor visit) const
+    {
+      if (nodes_.empty()) return false;
+      const double q[3] = { p.x(), p.y(), p.z() };
+      index_type stack[max_depth_];
+      int top = 0;
+      stack[top++] = 0;
+      while (top > 0)
+      {
+        const Node& n = nodes_[stack[--top]];
+        if (!n.contains(q)) continue;
+        if (n.count_ > 0)
+        {
+          for (index_type j = n.first_; j < n.first_ + n.count_; ++j)
+            if (items_[j].contains(q) && visit(items_[j].id_)) return true;
+        }
+        else
+        {
+          stack[top++] = n.first_ + 1;
+          stack[top++] = n.first_;
+        }
+      }
+      return false;
+    }
+
+    /// Calls visit(id) for every item whose box overlaps b.
+    template <class Visitor>
+    void visit_overlapping(const BBox& b, Visitor visit) const
+    {
+      if (nodes_.empty() || !b.valid()) return;
+      const Point bmin = b.get_min(), bmax = b.get_max();
+      const double lo[3] = { bmin.x(), bmin.y(), bmin.z() };
+      const double hi[3] = { bmax.x(), bmax.y(), bmax.z() };
+      index_type stack[max_depth_];
+      int top = 0;
+      stack[top++] = 0;
+      while (top > 0)
+      {
+        const Node& n = nodes_[stack[--top]];
+        if (!n.overlaps(lo, hi)) continue;
+        if (n.count_ > 0)
+        {
+          for (index_type j = n.first_; j < n.first_ + n.count_; ++j)
+            if (items_[j].overlaps(lo, hi)) visit(items_[j].id_);
+        }
+        else
+        {
+          stack[top++] = n.first_ + 1;
+          stack[top++] = n.first_;
+        }
+      }
+    }
+
+    /// Finds the item closest to p, where distance2(id, p) returns the squared distance
+    /// from p to item id, which must not be less than the distance to its box. Only
+    /// items closer than sqrt(dist2) are considered; on success id and dist2 are
+    /// updated. Boxes are searched nearest first, so the distance function is only
+    /// evaluated for items whose box could still hold a closer one.
+    template <class Distance>
+    bool find_closest(const Point& p, index_type& id, double& dist2, Distance distance2) const
+    {
+      if (nodes_.empty()) return false;
+      const double q[3] = { p.x(), p.y(), p.z() };
+      index_type stack[max_depth_];
+      double     stackdist[max_depth_];
+      int top = 0;
+      stack[top] = 0;
+      stackdist[top++] = nodes_[0].distance2(q);
+      bool found = false;
+      while (top > 0)
+      {
+        --top;
+        if (stackdist[top] >= dist2) continue;
+        const Node& n = nodes_[stack[top]];
+        if (n.count_ > 0)
+        {
+          for (index_type j = n.first_; j < n.first_ + n.count_; ++j)
+          {
+            const Item& item = items_[j];
+            if (item.distance2(q) >= dist2) continue;
+            const double d2 = distance2(item.id_, p);
+            if (d2 < dist2) { dist2 = d2; id = item.id_; found = true; }
+          }
+        }
+        else
+        {
+          const index_type a = n.first_, b = n.first_ + 1;
+          const double da = nodes_[a].distance2(q), db = nodes_[b].distance2(q);
+          if (da <= db)
+          {
+            stack[top] = b; stackdist[top++] = db;
+            stack[top] = a; stackdist[top++] = da;
+          }
+          else
+          {
+            stack[top] = a; stackdist[top++] = da;
+            stack[top] = b; stackdist[top++] = db;
+          }
+        }
+      }
+      return found;
+    }
+
+  private:
+    struct Box
+    {
+      double min_[3];
+      double max_[3];
+
+      inline bool contains(const double* q) const
+      {
+        return (q[0] >= min_[0] && q[0] <= max_[0] && q[1] >= min_[1] &&
+                q[1] <= max_[1] && q[2] >= min_[2] && q[2] <= max_[2]);
+      }
+
+      inline bool overlaps(const double* lo, const double* hi) const
+      {
+        return (lo[0] <= max_[0] && hi[0] >= min_[0] && lo[1] <= max_[1] &&
+                hi[1] >= min_[1] && lo[2] <= max_[2] && hi[2] >= min_[2]);
+      }
+
+      inline double distance2(const double* q) const
+      {
+        double d2 = 0.0;
+        for (int k = 0; k < 3; ++k)
+        {
+          const double d = q[k] < min_[k] ? min_[k] - q[k] : (q[k] > max_[k] ? q[k] - max_[k] : 0.0);
+          d2 += d * d;
+        }
+        return d2;
+      }
+    };
+
+    /// Leaves hold items_[first_, first_+count_); interior nodes have count_ == 0 and
+    /// their children at first_ and first_+1.
+    struct Node : Box
+    {
+      index_type first_;
+      index_type count_;
+    };
+
+    /// Items keep their own box, so leaves can reject items before calling back.
+    struct Item : Box
+    {
+      index_type id_;
+    };
+
+    struct BuildItem;
+    struct Builder;
+
+    void build(const std::vector<index_type>* ids, const std::vector<BBox>& boxes);
+
+    /// Bound on the tree depth; the builder falls back to median splits well before it.
+    static const int max_depth_ = 128;
+
+    size_type max_leaf_size_;
+    std::vector<Node> nodes_;
+    std::vector<Item> items_;
+};
+
+}}}
+
+#endif
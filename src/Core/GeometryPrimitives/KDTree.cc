@@ -0,0 +1,170 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Core/GeometryPrimitives/KDTree.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+KDTree::KDTree(const std::vector<Point>& points, size_type max_leaf_size) :
+  max_leaf_size_(std::max<size_type>(1, max_leaf_size))
+{
+  build(nullptr, points);
+}
+
+KDTree::KDTree(const std::vector<index_type>& ids, const std::vector<Point>& points,
+               size_type max_leaf_size) :
+  max_leaf_size_(std::max<size_type>(1, max_leaf_size))
+{
+  build(&ids, points);
+}
+
+void
+KDTree::build(const std::vector<index_type>* ids, const std::vector<Point>& points)
+{
+  struct Entry
+  {
+    Point p_;
+    index_type id_;
+  };
+
+  const index_type n = static_cast<index_type>(points.size());
+  std::vector<Entry> entries(n);
+  for (index_type j = 0; j < n; ++j)
+  {
+    entries[j].p_ = points[j];
+    entries[j].id_ = ids ? (*ids)[j] : j;
+  }
+
+  // Halving the ranges at every level means the largest node at depth d holds
+  // ceil(n/2^d) points, which fixes the number of levels up front.
+  int depth = 0;
+  for (index_type size = n; size > max_leaf_size_; size = (size + 1) / 2) ++depth;
+  axis_.assign(index_type(1) << depth, 0);
+  split_.assign(index_type(1) << depth, 0.0);
+
+  for (int d = 0; d < depth; ++d)
+  {
+    const index_type first = index_type(1) << d;
+    Parallel::For(first, 2 * first, [&](std::int64_t begin, std::int64_t end)
+    {
+      for (index_type node = begin; node < end; ++node)
+      {
+        // Walk down from the root to find the range of this node.
+        index_type lo = 0, hi = n;
+        for (int bit = d - 1; bit >= 0; --bit)
+        {
+          const index_type mid = lo + (hi - lo) / 2;
+          if ((node >> bit) & 1) lo = mid; else hi = mid;
+        }
+        if (hi - lo <= max_leaf_size_) continue;
+
+        double pmin[3], pmax[3];
+        for (int k = 0; k < 3; ++k)
+        {
+          pmin[k] = std::numeric_limits<double>::max();
+          pmax[k] = -std::numeric_limits<double>::max();
+        }
+        for (index_type j = lo; j < hi; ++j)
+          for (int k = 0; k < 3; ++k)
+          {
+            pmin[k] = std::min(pmin[k], entries[j].p_[k]);
+            pmax[k] = std::max(pmax[k], entries[j].p_[k]);
+          }
+        int axis = 0;
+        for (int k = 1; k < 3; ++k)
+          if (pmax[k] - pmin[k] > pmax[axis] - pmin[axis]) axis = k;
+
+        const index_type mid = lo + (hi - lo) / 2;
+        std::nth_element(entries.begin() + lo, entries.begin() + mid, entries.begin() + hi,
+          [axis](const Entry& a, const Entry& b) { return a.p_[axis] < b.p_[axis]; });
+        axis_[node] = static_cast<unsigned char>(axis);
+        split_[node] = entries[mid].p_[axis];
+      }
+    }, first < 64 ? 1 : 0);
+  }
+
+  points_.resize(n);
+  ids_.resize(n);
+  for (index_type j = 0; j < n; ++j)
+  {
+    points_[j] = entries[j].p_;
+    ids_[j] = entries[j].id_;
+  }
+}
+
+bool
+KDTree::find_closest(const Point& p, index_type& idx, double& dist2) const
+{
+  bool found = false;
+  if (!points_.empty())
+    find_closest(1, 0, size(), p, idx, dist2, found);
+  return found;
+}
+
+void
+KDTree::find_closest(index_type node, index_type lo, index_type hi, const Point& p,
+                     index_type& idx, double& dist2, bool& found) const
+{
+  if (hi - lo <= max_leaf_size_)
+  {
+    for (index_type j = lo; j < hi; ++j)
+    {
+      const double d2 = (points_[j] - p).length2();
+      if (d2 < dist2)
+      {
+        dist2 = d2;
+        idx = ids_[j];
+        found = true;
+      }
+    }
+    return;
+  }
+
+  // Search the side that holds p first; the other side can only hold a closer point
+  // if the splitting plane is closer than the best point so far.
+  const index_type mid = lo + (hi - lo) / 2;
+  const double d = p[axis_[node]] - split_[node];
+  if (d < 0.0)
+  {
+    find_closest(2 * node, lo, mid, p, idx, dist2, found);
+    if (d * d < dist2) find_closest(2 * node + 1, mid, hi, p, idx, dist2, found);
+  }
+  else
+  {
+    find_closest(2 * node + 1, mid, hi, p, idx, dist2, found);
+    if (d * d < dist2) find_closest(2 * node, lo, mid, p, idx, dist2, found);
+  }
+}
@@ -0,0 +1,110 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#ifndef CORE_GEOMETRY_KDTREE_H
+#define CORE_GEOMETRY_KDTREE_H 1
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+
+#include <vector>
+
+#include <Core/GeometryPrimitives/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Geometry {
+
+/// Balanced k-d tree over a point set for closest point and radius queries. The tree
+/// is implicit: every node splits its range of points at the median along the axis
+/// of largest extent, so only the split axis and value are stored per node. The
+/// levels are built one after the other, each in parallel over its nodes.
+class SCISHARE KDTree
+{
+  public:
+    typedef SCIRun::index_type index_type;
+    typedef SCIRun::size_type  size_type;
+
+    /// Point i gets index i.
+    explicit KDTree(const std::vector<Point>& points, size_type max_leaf_size = 8);
+    /// Point j gets index ids[j].
+    KDTree(const std::vector<index_type>& ids, const std::vector<Point>& points,
+           size_type max_leaf_size = 8);
+
+    size_type size() const { return static_cast<size_type>(points_.size()); }
+
+    /// Finds the point closest to p among those closer than sqrt(dist2). On success
+    /// idx and dist2 are updated.
+    bool find_closest(const Point& p, index_type& idx, double& dist2) const;
+
+    /// Calls visit(idx, d2) for every point at squared distance d2 < dist2 from p.
+    template <class Visitor>
+    void visit_within(const Point& p, double dist2, Visitor visit) const
+    {
+      if (!points_.empty())
+        visit_within(1, 0, size(), p, dist2, visit);
+    }
+
+  private:
+    void build(const std::vector<index_type>* ids, const std::vector<Point>& points);
+    void find_closest(index_type node, index_type lo, index_type hi, const Point& p,
+                      index_type& idx, double& dist2, bool& found) const;
+
+    template <class Visitor>
+    void visit_within(index_type node, index_type lo, index_type hi, const Point& p,
+                      double dist2, Visitor& visit) const
+    {
+      if (hi - lo <= max_leaf_size_)
+      {
+        for (index_type j = lo; j < hi; ++j)
+        {
+          const double d2 = (points_[j] - p).length2();
+          if (d2 < dist2) visit(ids_[j], d2);
+        }
+        return;
+      }
+      const index_type mid = lo + (hi - lo) / 2;
+      const double d = p[axis_[node]] - split_[node];
+      if (d < 0.0 || d * d < dist2) visit_within(2 * node, lo, mid, p, dist2, visit);
+      if (d >= 0.0 || d * d < dist2) visit_within(2 * node + 1, mid, hi, p, dist2, visit);
+    }
+
+    size_type max_leaf_size_;
+    /// Points and their indices in tree order
+    std::vector<Point> points_;
+    std::vector<index_type> ids_;
+    /// Split axis and value of every interior node, in heap order with the root at 1
+    std::vector<unsigned char> axis_;
+    std::vector<double> split_;
+};
+
+}}}
+
+#endif
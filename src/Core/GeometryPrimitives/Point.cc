@@ -26,7 +26,7 @@
 */
 
 
-#include <Core/Persistent/Persistent.h>
+#include <Core/Persistent/PersistentSTL.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <iostream>
 #include <sstream>
@@ -168,6 +168,12 @@ SCIRun::Core::Geometry::Pio(Piostream& stream, Point& p)
   stream.end_cheap_delim();
 }
 
+void
+SCIRun::Core::Geometry::Pio(Piostream& stream, std::vector<Point>& data)
+{
+  Pio_packed<double, 3>(stream, data);
+}
+
 
 const std::string&
 SCIRun::Point_get_h_file_path()
@@ -189,6 +189,9 @@ SCISHARE Point AffineCombination(const Point&, double, const Point&, double,
 SCISHARE Point AffineCombination(const Point&, double, const Point&, double);
 
 SCISHARE void Pio( Piostream&, Point& );
+/// Point arrays (mesh nodes) are read and written as one block of doubles
+/// where the stream allows it.
+SCISHARE void Pio( Piostream&, std::vector<Point>& );
 
 inline
 Point operator*(double d, const Point &p) {
@@ -44,7 +44,7 @@
 
 #include <iostream>
 
-#include <Core/Persistent/Persistent.h>
+#include <Core/Persistent/PersistentSTL.h>
 
 #include <teem/ten.h>
 
@@ -436,6 +436,105 @@ void Core::Geometry::Pio(Piostream& stream, Tensor& t)
   stream.end_cheap_delim();
 }
 
+#define STLTENSORVECTOR_VERSION 1
+
+// The record of a single tensor has a variable length, so arrays of them
+// can only be moved in blocks with a layout of their own. Streams without
+// block io, and old files, use the generic vector layout.
+void Core::Geometry::Pio(Piostream& stream, std::vector<Tensor>& data)
+{
+  if (stream.reading() ? stream.peek_class() != "STLTensorVector" : !stream.supports_block_io())
+  {
+    SCIRun::Pio<Tensor>(stream, data);
+    return;
+  }
+
+  stream.begin_class("STLTensorVector", STLTENSORVECTOR_VERSION);
+
+  auto values = [&stream](auto* v, size_t count)
+  {
+    if (count > 0 && !stream.block_io(v, sizeof(*v), count))
+    {
+      for (size_t i = 0; i < count; i++) stream.io(v[i]);
+    }
+  };
+
+  long long size = static_cast<long long>(data.size());
+  stream.io(size);
+  const size_t n = static_cast<size_t>(size);
+
+  std::vector<double> mats(6 * n);
+  std::vector<int> have_eigens(n);
+  if (stream.reading())
+  {
+    data.resize(n);
+  }
+  else
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      const Tensor& t = data[i];
+      double* m = &mats[6 * i];
+      m[0] = t.mat_[0][0]; m[1] = t.mat_[0][1]; m[2] = t.mat_[0][2];
+      m[3] = t.mat_[1][1]; m[4] = t.mat_[1][2]; m[5] = t.mat_[2][2];
+      have_eigens[i] = t.have_eigens_;
+    }
+  }
+
+  values(mats.data(), mats.size());
+  values(have_eigens.data(), have_eigens.size());
+
+  size_t num_eigens = 0;
+  for (size_t i = 0; i < n; i++)
+  {
+    if (have_eigens[i]) num_eigens++;
+  }
+
+  // Eigen systems: three (scaled) eigenvectors and the three eigenvalues.
+  std::vector<double> eigens(12 * num_eigens);
+  if (!stream.reading())
+  {
+    double* e = eigens.data();
+    for (size_t i = 0; i < n; i++)
+    {
+      const Tensor& t = data[i];
+      if (!t.have_eigens_) continue;
+      for (int k = 0; k < 3; k++)
+      {
+        e[k] = t.e1_[k]; e[3+k] = t.e2_[k]; e[6+k] = t.e3_[k];
+      }
+      e[9] = t.l1_; e[10] = t.l2_; e[11] = t.l3_;
+      e += 12;
+    }
+  }
+
+  values(eigens.data(), eigens.size());
+
+  if (stream.reading() && !stream.error())
+  {
+    const double* e = eigens.data();
+    for (size_t i = 0; i < n; i++)
+    {
+      Tensor& t = data[i];
+      const double* m = &mats[6 * i];
+      t.mat_[0][0] = m[0]; t.mat_[0][1] = m[1]; t.mat_[0][2] = m[2];
+      t.mat_[1][1] = m[3]; t.mat_[1][2] = m[4]; t.mat_[2][2] = m[5];
+      t.mat_[1][0] = m[1]; t.mat_[2][0] = m[2]; t.mat_[2][1] = m[4];
+      t.have_eigens_ = have_eigens[i];
+      if (t.have_eigens_)
+      {
+        t.e1_ = Vector(e[0], e[1], e[2]);
+        t.e2_ = Vector(e[3], e[4], e[5]);
+        t.e3_ = Vector(e[6], e[7], e[8]);
+        t.l1_ = e[9]; t.l2_ = e[10]; t.l3_ = e[11];
+        e += 12;
+      }
+    }
+  }
+
+  stream.end_class();
+}
+
 const std::string&
 Tensor::get_h_file_path() {
   static const std::string path(TypeDescription::cc_to_h(__FILE__));
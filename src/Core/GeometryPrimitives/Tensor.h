@@ -113,6 +113,7 @@ public:
   static const std::string& get_h_file_path();
 
   friend SCISHARE void Pio(Piostream&, Tensor&);
+  friend SCISHARE void Pio(Piostream&, std::vector<Tensor>&);
 
   double xx() const { return mat_[0][0]; }
   double xy() const { return mat_[1][0]; }
@@ -140,6 +141,9 @@ private:
 };
 
 SCISHARE void Pio(Piostream&, Tensor&);
+/// Tensor arrays go to block io streams as an STLTensorVector: all the
+/// matrices, then all the eigen flags, then the eigen systems that exist.
+SCISHARE void Pio(Piostream&, std::vector<Tensor>&);
 
 inline bool operator<(const Tensor& t1, const Tensor& t2)
 {
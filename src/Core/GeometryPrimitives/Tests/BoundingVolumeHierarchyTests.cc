@@ -0,0 +1,164 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/GeometryPrimitives/BoundingVolumeHierarchy.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // Boxes clustered around the origin with sizes growing with the distance to it,
+  // like the elements of a mesh that is refined around a point.
+  std::vector<BBox> gradedBoxes(int n, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    std::vector<BBox> boxes;
+    for (int i = 0; i < n; ++i)
+    {
+      Vector d(u(gen), u(gen), u(gen));
+      d *= std::pow(std::abs(u(gen)), 3.0);
+      const Point c = Point(0, 0, 0) + d;
+      const double r = 0.001 + 0.05 * d.length();
+      boxes.push_back(BBox(c - Vector(r, r, r), c + Vector(r, r, r)));
+    }
+    return boxes;
+  }
+
+  double distance2(const BBox& b, const Point& p)
+  {
+    double d2 = 0.0;
+    for (int k = 0; k < 3; ++k)
+    {
+      const double d = std::max({ b.get_min()[k] - p[k], 0.0, p[k] - b.get_max()[k] });
+      d2 += d * d;
+    }
+    return d2;
+  }
+}
+
+TEST(BoundingVolumeHierarchyTests, EmptyTree)
+{
+  BoundingVolumeHierarchy bvh(std::vector<BBox>{});
+  EXPECT_EQ(0, bvh.size());
+  EXPECT_FALSE(bvh.visit_containing(Point(0, 0, 0), [](BoundingVolumeHierarchy::index_type) { return true; }));
+  BoundingVolumeHierarchy::index_type id = -1;
+  double d2 = std::numeric_limits<double>::max();
+  EXPECT_FALSE(bvh.find_closest(Point(0, 0, 0), id, d2, [](BoundingVolumeHierarchy::index_type, const Point&) { return 0.0; }));
+}
+
+TEST(BoundingVolumeHierarchyTests, QueriesMatchBruteForce)
+{
+  // Large enough to take the parallel build path.
+  const auto boxes = gradedBoxes(20000, 3);
+  BoundingVolumeHierarchy bvh(boxes);
+  EXPECT_EQ(20000, bvh.size());
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> u(-1.2, 1.2);
+  for (int q = 0; q < 200; ++q)
+  {
+    // Half of the queries near the dense center.
+    const double s = q % 2 ? 1.0 : 0.05;
+    const Point p(s * u(gen), s * u(gen), s * u(gen));
+
+    std::vector<BoundingVolumeHierarchy::index_type> found, expected;
+    bvh.visit_containing(p, [&](BoundingVolumeHierarchy::index_type i) { found.push_back(i); return false; });
+    for (size_t i = 0; i < boxes.size(); ++i)
+      if (boxes[i].inside(p)) expected.push_back(i);
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(expected, found);
+
+    const BBox query(p - Vector(0.05, 0.05, 0.05), p + Vector(0.05, 0.05, 0.05));
+    found.clear();
+    expected.clear();
+    bvh.visit_overlapping(query, [&](BoundingVolumeHierarchy::index_type i) { found.push_back(i); });
+    for (size_t i = 0; i < boxes.size(); ++i)
+      if (boxes[i].overlaps(query)) expected.push_back(i);
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(expected, found);
+
+    // Distance to the box center, so that the closest item is unique.
+    auto centerDistance = [&](BoundingVolumeHierarchy::index_type i, const Point& x)
+    {
+      EXPECT_LE(distance2(boxes[i], x), (boxes[i].center() - x).length2());
+      return (boxes[i].center() - x).length2();
+    };
+    BoundingVolumeHierarchy::index_type id = -1;
+    double d2 = std::numeric_limits<double>::max();
+    EXPECT_TRUE(bvh.find_closest(p, id, d2, centerDistance));
+    BoundingVolumeHierarchy::index_type best = -1;
+    double bestd2 = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+      const double di = (boxes[i].center() - p).length2();
+      if (di < bestd2) { bestd2 = di; best = i; }
+    }
+    EXPECT_EQ(best, id);
+    EXPECT_DOUBLE_EQ(bestd2, d2);
+  }
+}
+
+TEST(BoundingVolumeHierarchyTests, FindClosestRespectsInitialBound)
+{
+  const auto boxes = gradedBoxes(1000, 5);
+  BoundingVolumeHierarchy bvh(boxes);
+  BoundingVolumeHierarchy::index_type id = 42;
+  double d2 = 1e-12;
+  EXPECT_FALSE(bvh.find_closest(Point(5, 5, 5), id, d2,
+    [&](BoundingVolumeHierarchy::index_type i, const Point& x) { return distance2(boxes[i], x); }));
+  EXPECT_EQ(42, id);
+  EXPECT_EQ(1e-12, d2);
+}
+
+TEST(BoundingVolumeHierarchyTests, IdenticalBoxesAndExplicitIds)
+{
+  // No split plane separates identical boxes; the builder has to fall back to median
+  // splits and still keep every item.
+  std::vector<BBox> boxes(5000, BBox(Point(0, 0, 0), Point(1, 1, 1)));
+  std::vector<BoundingVolumeHierarchy::index_type> ids(boxes.size());
+  for (size_t i = 0; i < ids.size(); ++i) ids[i] = 10 * i;
+  boxes[17] = BBox();
+  BoundingVolumeHierarchy bvh(ids, boxes);
+  EXPECT_EQ(4999, bvh.size());
+
+  std::vector<BoundingVolumeHierarchy::index_type> found;
+  bvh.visit_containing(Point(0.5, 0.5, 0.5), [&](BoundingVolumeHierarchy::index_type i) { found.push_back(i); return false; });
+  EXPECT_EQ(4999u, found.size());
+  EXPECT_TRUE(std::find(found.begin(), found.end(), 170) == found.end());
+  EXPECT_TRUE(std::find(found.begin(), found.end(), 180) != found.end());
+}
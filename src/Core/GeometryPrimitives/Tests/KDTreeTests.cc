@@ -0,0 +1,131 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/GeometryPrimitives/KDTree.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  std::vector<Point> gradedPoints(int n, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    std::vector<Point> points;
+    for (int i = 0; i < n; ++i)
+    {
+      Vector d(u(gen), u(gen), u(gen));
+      d *= std::pow(std::abs(u(gen)), 3.0);
+      points.push_back(Point(0, 0, 0) + d);
+    }
+    return points;
+  }
+}
+
+TEST(KDTreeTests, EmptyTree)
+{
+  KDTree tree(std::vector<Point>{});
+  KDTree::index_type idx = -1;
+  double d2 = std::numeric_limits<double>::max();
+  EXPECT_FALSE(tree.find_closest(Point(0, 0, 0), idx, d2));
+  EXPECT_EQ(-1, idx);
+}
+
+TEST(KDTreeTests, QueriesMatchBruteForce)
+{
+  const auto points = gradedPoints(30000, 11);
+  KDTree tree(points);
+  EXPECT_EQ(30000, tree.size());
+
+  std::mt19937 gen(13);
+  std::uniform_real_distribution<double> u(-1.2, 1.2);
+  for (int q = 0; q < 300; ++q)
+  {
+    const double s = q % 2 ? 1.0 : 0.05;
+    const Point p(s * u(gen), s * u(gen), s * u(gen));
+
+    KDTree::index_type idx = -1;
+    double d2 = std::numeric_limits<double>::max();
+    EXPECT_TRUE(tree.find_closest(p, idx, d2));
+    KDTree::index_type best = -1;
+    double bestd2 = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      const double di = (points[i] - p).length2();
+      if (di < bestd2) { bestd2 = di; best = i; }
+    }
+    EXPECT_EQ(best, idx);
+    EXPECT_EQ(bestd2, d2);
+
+    const double r2 = 0.01 * 0.01;
+    std::vector<KDTree::index_type> found, expected;
+    tree.visit_within(p, r2, [&](KDTree::index_type i, double di)
+    {
+      EXPECT_EQ((points[i] - p).length2(), di);
+      found.push_back(i);
+    });
+    for (size_t i = 0; i < points.size(); ++i)
+      if ((points[i] - p).length2() < r2) expected.push_back(i);
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(expected, found);
+  }
+}
+
+TEST(KDTreeTests, DuplicatePointsAndExplicitIds)
+{
+  std::vector<Point> points(1000, Point(1, 2, 3));
+  points.push_back(Point(0, 0, 0));
+  std::vector<KDTree::index_type> ids(points.size());
+  for (size_t i = 0; i < ids.size(); ++i) ids[i] = 100 + i;
+  KDTree tree(ids, points);
+
+  KDTree::index_type idx = -1;
+  double d2 = std::numeric_limits<double>::max();
+  EXPECT_TRUE(tree.find_closest(Point(0.1, 0, 0), idx, d2));
+  EXPECT_EQ(1100, idx);
+
+  int count = 0;
+  tree.visit_within(Point(1, 2, 3), 1e-6, [&](KDTree::index_type i, double) { EXPECT_LT(i, 1100); ++count; });
+  EXPECT_EQ(1000, count);
+
+  // Nothing closer than the bound: the result is left alone.
+  idx = -1;
+  d2 = 0.001;
+  EXPECT_FALSE(tree.find_closest(Point(0.5, 0.5, 0.5), idx, d2));
+  EXPECT_EQ(-1, idx);
+}
@@ -0,0 +1,547 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Core/IEPlugin/ChunkedField_Plugin.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Persistent/Pstreams.h>
+#include <Core/Logging/LoggerInterface.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <zlib.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  const char CHUNKED_FIELD_MAGIC[8] = { 'S', 'C', 'I', 'R', 'C', 'F', 'L', 'D' };
+  const std::uint32_t CHUNKED_FIELD_BYTE_ORDER = 0x01020304;
+  const std::uint32_t CHUNKED_FIELD_VERSION = 1;
+
+  // Raw bytes per chunk: large enough for zlib to reach its full ratio, small enough to spread
+  // an array over all cores and to keep range reads cheap.
+  const std::uint64_t CHUNK_BYTES = 1 << 20;
+
+  // Longest type name accepted in a header, to reject garbage before allocating for it.
+  const std::uint32_t MAX_TYPE_NAME = 1024;
+
+  static_assert(sizeof(Point) == 3 * sizeof(double), "Points are written as three packed doubles");
+  static_assert(sizeof(Vector) == 3 * sizeof(double), "Vectors are written as three packed doubles");
+
+  struct ArrayToWrite
+  {
+    const unsigned char* data;
+    std::uint32_t scalar_size;
+    std::uint32_t components;
+    std::uint64_t count;
+  };
+
+  template <class T>
+  void put(std::string& header, T value)
+  {
+    header.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void put_string(std::string& header, const std::string& value)
+  {
+    put<std::uint32_t>(header, static_cast<std::uint32_t>(value.size()));
+    header.append(value);
+  }
+
+  std::uint64_t num_chunks_for(std::uint64_t count, std::uint64_t chunkItems)
+  {
+    return (count + chunkItems - 1) / chunkItems;
+  }
+
+  std::uint64_t chunk_items_for(std::uint32_t scalarSize, std::uint32_t components)
+  {
+    return std::max<std::uint64_t>(1, CHUNK_BYTES / (static_cast<std::uint64_t>(scalarSize) * components));
+  }
+
+  // Values are stored as the scalars they are made of, so they can be byte swapped.
+  bool data_layout(const FieldInformation& fi, std::uint32_t& scalarSize, std::uint32_t& components)
+  {
+    components = 1;
+    if (fi.is_double()) scalarSize = sizeof(double);
+    else if (fi.is_float()) scalarSize = sizeof(float);
+    else if (fi.is_longlong()) scalarSize = sizeof(long long);
+    else if (fi.is_unsigned_longlong()) scalarSize = sizeof(unsigned long long);
+    else if (fi.is_long()) scalarSize = sizeof(long);
+    else if (fi.is_unsigned_long()) scalarSize = sizeof(unsigned long);
+    else if (fi.is_int()) scalarSize = sizeof(int);
+    else if (fi.is_unsigned_int()) scalarSize = sizeof(unsigned int);
+    else if (fi.is_short()) scalarSize = sizeof(short);
+    else if (fi.is_unsigned_short()) scalarSize = sizeof(unsigned short);
+    else if (fi.is_char()) scalarSize = sizeof(char);
+    else if (fi.is_unsigned_char()) scalarSize = sizeof(unsigned char);
+    else if (fi.is_vector()) { scalarSize = sizeof(double); components = 3; }
+    else return false;
+    return true;
+  }
+}
+
+bool ChunkedFieldFile::write(FieldHandle field, const std::string& filename, int compressionLevel, std::string& error)
+{
+  if (!field)
+  {
+    error = "No field to write.";
+    return false;
+  }
+
+  VMesh* mesh = field->vmesh();
+  VField* vfield = field->vfield();
+  if (!mesh->is_unstructuredmesh() || mesh->is_nonlinearmesh() || vfield->is_nonlineardata())
+  {
+    error = "The chunked field format only supports unstructured meshes with linear geometry and data.";
+    return false;
+  }
+
+  if (compressionLevel < 0 || compressionLevel > 9)
+    compressionLevel = DEFAULT_COMPRESSION_LEVEL;
+
+  FieldInformation fi(field);
+  ArrayToWrite arrays[NUM_ARRAYS] = {};
+
+  const std::uint64_t numNodes = mesh->num_nodes();
+  arrays[NODES] = { numNodes ? reinterpret_cast<const unsigned char*>(mesh->get_points_pointer()) : nullptr,
+    sizeof(double), 3, numNodes };
+
+  const std::uint64_t numElems = mesh->is_pointcloudmesh() ? 0 : mesh->num_elems();
+  arrays[ELEMS] = { numElems ? reinterpret_cast<const unsigned char*>(mesh->get_elems_pointer()) : nullptr,
+    sizeof(index_type), std::max(1u, mesh->num_nodes_per_elem()), numElems };
+
+  const std::uint64_t numValues = vfield->basis_order() < 0 ? 0 : vfield->num_values();
+  arrays[VALUES] = { nullptr, 1, 1, 0 };
+  if (numValues > 0)
+  {
+    if (!data_layout(fi, arrays[VALUES].scalar_size, arrays[VALUES].components))
+    {
+      error = "The chunked field format does not support data of type " + fi.get_data_type() + ".";
+      return false;
+    }
+    arrays[VALUES].data = static_cast<const unsigned char*>(vfield->fdata_pointer());
+    arrays[VALUES].count = numValues;
+  }
+
+  std::vector<std::vector<unsigned char>> compressed[NUM_ARRAYS];
+  for (int a = 0; a < NUM_ARRAYS; ++a)
+  {
+    const auto& array = arrays[a];
+    const std::uint64_t itemBytes = static_cast<std::uint64_t>(array.scalar_size) * array.components;
+    const auto chunkItems = chunk_items_for(array.scalar_size, array.components);
+    auto& chunks = compressed[a];
+    chunks.resize(num_chunks_for(array.count, chunkItems));
+
+    std::atomic<bool> ok(true);
+    Parallel::For(0, chunks.size(), [&](std::int64_t begin, std::int64_t end)
+    {
+      for (auto c = begin; c < end; ++c)
+      {
+        const std::uint64_t first = c * chunkItems;
+        const uLong rawSize = static_cast<uLong>(std::min(chunkItems, array.count - first) * itemBytes);
+        auto& chunk = chunks[c];
+        uLongf size = compressBound(rawSize);
+        chunk.resize(size);
+        if (compress2(chunk.data(), &size, array.data + first * itemBytes, rawSize, compressionLevel) != Z_OK)
+          ok = false;
+        chunk.resize(size);
+      }
+    }, 1);
+
+    if (!ok)
+    {
+      error = "Could not compress the field data.";
+      return false;
+    }
+  }
+
+  auto makeHeader = [&](std::uint64_t payloadOffset)
+  {
+    std::string header(CHUNKED_FIELD_MAGIC, sizeof(CHUNKED_FIELD_MAGIC));
+    put(header, CHUNKED_FIELD_BYTE_ORDER);
+    put(header, CHUNKED_FIELD_VERSION);
+    put_string(header, fi.get_mesh_type());
+    put_string(header, fi.get_mesh_basis_type());
+    put_string(header, fi.get_basis_type());
+    put_string(header, fi.get_data_type());
+
+    auto offset = payloadOffset;
+    for (int a = 0; a < NUM_ARRAYS; ++a)
+    {
+      const auto& array = arrays[a];
+      const std::uint64_t itemBytes = static_cast<std::uint64_t>(array.scalar_size) * array.components;
+      const auto chunkItems = chunk_items_for(array.scalar_size, array.components);
+      put(header, array.scalar_size);
+      put(header, array.components);
+      put(header, array.count);
+      put(header, chunkItems);
+      put<std::uint64_t>(header, compressed[a].size());
+      for (size_t c = 0; c < compressed[a].size(); ++c)
+      {
+        const std::uint64_t size = compressed[a][c].size();
+        put(header, offset);
+        put(header, size);
+        put<std::uint64_t>(header, std::min(chunkItems, array.count - c * chunkItems) * itemBytes);
+        offset += size;
+      }
+    }
+    return header;
+  };
+
+  // The index holds absolute offsets, so its own length has to be known first.
+  const auto header = makeHeader(makeHeader(0).size());
+
+  std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file)
+  {
+    error = "Could not open file: " + filename;
+    return false;
+  }
+
+  file.write(header.data(), header.size());
+  for (int a = 0; a < NUM_ARRAYS; ++a)
+  {
+    for (const auto& chunk : compressed[a])
+      file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+  }
+
+  if (!file)
+  {
+    error = "Could not write file: " + filename;
+    return false;
+  }
+  return true;
+}
+
+struct ChunkedFieldFile::Mapping
+{
+  boost::interprocess::file_mapping file_;
+  boost::interprocess::mapped_region region_;
+};
+
+ChunkedFieldFile::ChunkedFieldFile(const std::string& filename)
+  : file_(filename.c_str(), std::ios::in | std::ios::binary)
+{
+  if (!file_)
+  {
+    fail("Could not open file: " + filename);
+    return;
+  }
+
+  file_.seekg(0, std::ios::end);
+  file_size_ = static_cast<std::uint64_t>(file_.tellg());
+  file_.seekg(0, std::ios::beg);
+  open_ = read_header();
+  if (!open_ || file_size_ == 0)
+    return;
+
+  try
+  {
+    using namespace boost::interprocess;
+    std::unique_ptr<Mapping> mapping(new Mapping);
+    mapping->file_ = file_mapping(filename.c_str(), read_only);
+    mapping->region_ = mapped_region(mapping->file_, read_only);
+    if (mapping->region_.get_size() == file_size_)
+      mapping_ = std::move(mapping);
+  }
+  catch (const boost::interprocess::interprocess_exception&)
+  {
+    // Fall back to reading the chunks through the stream.
+  }
+}
+
+ChunkedFieldFile::~ChunkedFieldFile()
+{
+}
+
+bool ChunkedFieldFile::fail(const std::string& error)
+{
+  error_ = error;
+  return false;
+}
+
+bool ChunkedFieldFile::read_header()
+{
+  char magic[sizeof(CHUNKED_FIELD_MAGIC)];
+  std::uint32_t byteOrder = 0;
+  file_.read(magic, sizeof(magic));
+  file_.read(reinterpret_cast<char*>(&byteOrder), sizeof(byteOrder));
+  if (!file_ || std::memcmp(magic, CHUNKED_FIELD_MAGIC, sizeof(magic)) != 0)
+    return fail("Not a chunked field file.");
+
+  if (byteOrder != CHUNKED_FIELD_BYTE_ORDER)
+  {
+    swap_bytes(&byteOrder, sizeof(byteOrder), 1);
+    if (byteOrder != CHUNKED_FIELD_BYTE_ORDER)
+      return fail("Not a chunked field file.");
+    swap_ = true;
+  }
+
+  auto get = [this](auto& value)
+  {
+    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
+    if (swap_)
+      swap_bytes(&value, sizeof(value), 1);
+    return static_cast<bool>(file_);
+  };
+
+  auto getString = [this, &get](std::string& value)
+  {
+    std::uint32_t length = 0;
+    if (!get(length) || length > MAX_TYPE_NAME)
+      return false;
+    value.resize(length);
+    file_.read(&value[0], length);
+    return static_cast<bool>(file_);
+  };
+
+  std::uint32_t version = 0;
+  if (!get(version))
+    return fail("Chunked field header is truncated.");
+  if (version > CHUNKED_FIELD_VERSION)
+    return fail("Chunked field file was written by a newer version of SCIRun.");
+
+  if (!getString(mesh_type_) || !getString(mesh_basis_type_) ||
+      !getString(data_basis_type_) || !getString(data_type_))
+    return fail("Chunked field header is truncated.");
+
+  for (int a = 0; a < NUM_ARRAYS; ++a)
+  {
+    auto& array = arrays_[a];
+    std::uint64_t numChunks = 0;
+    if (!get(array.scalar_size) || !get(array.components) || !get(array.count) ||
+        !get(array.chunk_items) || !get(numChunks))
+      return fail("Chunked field header is truncated.");
+
+    const std::uint64_t itemBytes = static_cast<std::uint64_t>(array.scalar_size) * array.components;
+    if (itemBytes == 0 || array.chunk_items == 0 ||
+        numChunks != num_chunks_for(array.count, array.chunk_items) || numChunks > file_size_)
+      return fail("Chunked field index is corrupt.");
+
+    array.chunks.resize(numChunks);
+    for (std::uint64_t c = 0; c < numChunks; ++c)
+    {
+      auto& chunk = array.chunks[c];
+      if (!get(chunk.offset) || !get(chunk.size) || !get(chunk.raw_size))
+        return fail("Chunked field header is truncated.");
+      if (chunk.offset > file_size_ || chunk.size > file_size_ - chunk.offset ||
+          chunk.raw_size != std::min(array.chunk_items, array.count - c * array.chunk_items) * itemBytes)
+        return fail("Chunked field index is corrupt.");
+      // read_items relies on the chunks of an array being stored back to back
+      if (c > 0 && chunk.offset != array.chunks[c - 1].offset + array.chunks[c - 1].size)
+        return fail("Chunked field index is corrupt.");
+    }
+  }
+
+  std::uint32_t scalarSize = 0, components = 0;
+  if (arrays_[NODES].scalar_size != sizeof(double) || arrays_[NODES].components != 3 ||
+      arrays_[ELEMS].scalar_size != sizeof(index_type))
+    return fail("Chunked field index is corrupt.");
+  if (arrays_[VALUES].count > 0 &&
+      (!data_layout(FieldInformation(mesh_type_, mesh_basis_type_, data_basis_type_, data_type_), scalarSize, components) ||
+       scalarSize != arrays_[VALUES].scalar_size || components != arrays_[VALUES].components))
+    return fail("Chunked field data of type " + data_type_ + " cannot be read on this platform.");
+
+  return true;
+}
+
+size_type ChunkedFieldFile::num_chunks() const
+{
+  size_type chunks = 0;
+  for (const auto& array : arrays_)
+    chunks += array.chunks.size();
+  return chunks;
+}
+
+bool ChunkedFieldFile::read_nodes(index_type first, size_type count, Point* nodes)
+{
+  return read_items(arrays_[NODES], first, count, nodes);
+}
+
+bool ChunkedFieldFile::read_elems(index_type first, size_type count, index_type* elems)
+{
+  return read_items(arrays_[ELEMS], first, count, elems);
+}
+
+bool ChunkedFieldFile::read_values(index_type first, size_type count, void* values)
+{
+  return read_items(arrays_[VALUES], first, count, values);
+}
+
+bool ChunkedFieldFile::read_items(const Array& array, index_type first, size_type count, void* items)
+{
+  if (!open_)
+    return false;
+  if (first < 0 || count < 0 || static_cast<std::uint64_t>(first + count) > array.count)
+    return fail("Requested range is outside of the chunked field array.");
+  if (count == 0)
+    return true;
+
+  const std::uint64_t begin = first;
+  const std::uint64_t end = first + count;
+  const std::uint64_t itemBytes = static_cast<std::uint64_t>(array.scalar_size) * array.components;
+  const std::uint64_t firstChunk = begin / array.chunk_items;
+  const std::uint64_t lastChunk = (end - 1) / array.chunk_items;
+
+  // Chunks are stored back to back, so without a mapping the compressed bytes of the range are
+  // one read.
+  const auto base = array.chunks[firstChunk].offset;
+  const unsigned char* compressed = nullptr;
+  std::vector<unsigned char> buffer;
+  if (mapping_)
+  {
+    compressed = static_cast<const unsigned char*>(mapping_->region_.get_address()) + base;
+  }
+  else
+  {
+    buffer.resize(array.chunks[lastChunk].offset + array.chunks[lastChunk].size - base);
+    file_.clear();
+    file_.seekg(base, std::ios::beg);
+    file_.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+    if (!file_)
+      return fail("Chunked field file is truncated.");
+    compressed = buffer.data();
+  }
+
+  auto output = static_cast<unsigned char*>(items);
+  std::atomic<bool> ok(true);
+  Parallel::For(firstChunk, lastChunk + 1, [&](std::int64_t chunkBegin, std::int64_t chunkEnd)
+  {
+    std::vector<unsigned char> partial;
+    for (auto c = chunkBegin; c < chunkEnd; ++c)
+    {
+      const auto& chunk = array.chunks[c];
+      const std::uint64_t chunkFirst = c * array.chunk_items;
+      const std::uint64_t lo = std::max(begin, chunkFirst);
+      const std::uint64_t hi = std::min(end, chunkFirst + chunk.raw_size / itemBytes);
+      unsigned char* destination = output + (lo - begin) * itemBytes;
+      const unsigned char* source = compressed + (chunk.offset - base);
+
+      // Chunks that are entirely in the range are inflated straight into the output.
+      const bool whole = (hi - lo) * itemBytes == chunk.raw_size;
+      if (!whole)
+        partial.resize(chunk.raw_size);
+      uLongf size = static_cast<uLongf>(chunk.raw_size);
+      if (uncompress(whole ? destination : partial.data(), &size, source, static_cast<uLong>(chunk.size)) != Z_OK ||
+          size != chunk.raw_size)
+      {
+        ok = false;
+        continue;
+      }
+      if (!whole)
+        std::memcpy(destination, partial.data() + (lo - chunkFirst) * itemBytes, (hi - lo) * itemBytes);
+      if (swap_)
+        swap_bytes(destination, array.scalar_size, (hi - lo) * array.components);
+    }
+  }, 1);
+
+  if (!ok)
+    return fail("Chunked field data is corrupt.");
+  return true;
+}
+
+FieldHandle ChunkedFieldFile::read_field()
+{
+  if (!open_)
+    return FieldHandle();
+
+  FieldInformation fi(mesh_type_, mesh_basis_type_, data_basis_type_, data_type_);
+  FieldHandle field = CreateField(fi);
+  if (!field)
+  {
+    fail("Could not create a field of type " + fi.get_field_type() + ".");
+    return FieldHandle();
+  }
+
+  VMesh* mesh = field->vmesh();
+  VField* vfield = field->vfield();
+
+  mesh->resize_nodes(num_nodes());
+  if (num_nodes() > 0 && !read_nodes(0, num_nodes(), mesh->get_points_pointer()))
+    return FieldHandle();
+
+  if (!mesh->is_pointcloudmesh())
+  {
+    if (num_elems() > 0 && num_nodes_per_elem() != static_cast<size_type>(mesh->num_nodes_per_elem()))
+    {
+      fail("Chunked field elements do not match the mesh type " + mesh_type_ + ".");
+      return FieldHandle();
+    }
+    mesh->resize_elems(num_elems());
+    if (num_elems() > 0 && !read_elems(0, num_elems(), mesh->get_elems_pointer()))
+      return FieldHandle();
+  }
+
+  vfield->resize_values();
+  if (vfield->basis_order() >= 0 && vfield->num_values() != num_values())
+  {
+    fail("Chunked field values do not match the mesh.");
+    return FieldHandle();
+  }
+  if (num_values() > 0 && !read_values(0, num_values(), vfield->fdata_pointer()))
+    return FieldHandle();
+
+  return field;
+}
+
+FieldHandle SCIRun::ChunkedField_reader(LoggerHandle pr, const char *filename)
+{
+  ChunkedFieldFile file(filename);
+  FieldHandle field = file.read_field();
+  if (!field && pr) pr->error(file.error());
+  return field;
+}
+
+bool SCIRun::ChunkedField_writer(LoggerHandle pr, FieldHandle fh, const char *filename)
+{
+  return ChunkedField_compressed_writer(pr, fh, filename, ChunkedFieldFile::DEFAULT_COMPRESSION_LEVEL);
+}
+
+bool SCIRun::ChunkedField_compressed_writer(LoggerHandle pr, FieldHandle fh, const char *filename, int level)
+{
+  std::string error;
+  if (!ChunkedFieldFile::write(fh, filename, level, error))
+  {
+    if (pr) pr->error(error);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,133 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#ifndef CORE_IEPLUGIN_CHUNKEDFIELD_PLUGIN_H__
+#define CORE_IEPLUGIN_CHUNKEDFIELD_PLUGIN_H__
+
+#include <Core/Logging/LoggerFwd.h>
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/GeometryPrimitives/GeomFwd.h>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Core/IEPlugin/share.h>
+
+namespace SCIRun
+{
+  /// Chunked field container (.cfld).
+  ///
+  /// The node positions, the element connectivity and the field values are cut into chunks of
+  /// about a megabyte that are deflated independently. A chunk index at the head of the file lets
+  /// the reader inflate all chunks of an array in parallel, and read a range of nodes, elements or
+  /// values without inflating the rest of the file. The format covers unstructured meshes with
+  /// linear geometry and scalar or vector data on the nodes or the elements.
+  class SCISHARE ChunkedFieldFile
+  {
+  public:
+    static const int DEFAULT_COMPRESSION_LEVEL = 6;
+
+    /// Writes the field with a zlib level from 0 (store only) to 9 (smallest file). Returns false
+    /// and sets error if the field is not supported or the file cannot be written.
+    static bool write(FieldHandle field, const std::string& filename, int compressionLevel, std::string& error);
+
+    /// Opens the file and reads its header and chunk index; check is_open() afterwards. The chunks
+    /// are inflated straight from a read-only mapping of the file where the platform allows it.
+    explicit ChunkedFieldFile(const std::string& filename);
+    ~ChunkedFieldFile();
+
+    bool is_open() const { return open_; }
+    const std::string& error() const { return error_; }
+
+    const std::string& mesh_type() const { return mesh_type_; }
+    const std::string& mesh_basis_type() const { return mesh_basis_type_; }
+    const std::string& data_basis_type() const { return data_basis_type_; }
+    const std::string& data_type() const { return data_type_; }
+
+    size_type num_nodes() const { return static_cast<size_type>(arrays_[NODES].count); }
+    size_type num_elems() const { return static_cast<size_type>(arrays_[ELEMS].count); }
+    size_type num_values() const { return static_cast<size_type>(arrays_[VALUES].count); }
+    size_type num_nodes_per_elem() const { return arrays_[ELEMS].components; }
+    size_type num_chunks() const;
+
+    /// Range reads only inflate the chunks that overlap [first, first+count). Elements are
+    /// returned as num_nodes_per_elem() node indices each, values in the field's data type.
+    bool read_nodes(index_type first, size_type count, Core::Geometry::Point* nodes);
+    bool read_elems(index_type first, size_type count, index_type* elems);
+    bool read_values(index_type first, size_type count, void* values);
+
+    /// Reads the whole field; returns a null handle and sets error on failure.
+    FieldHandle read_field();
+
+  private:
+    enum { NODES = 0, ELEMS = 1, VALUES = 2, NUM_ARRAYS = 3 };
+
+    struct Chunk
+    {
+      std::uint64_t offset;
+      std::uint64_t size;
+      std::uint64_t raw_size;
+    };
+
+    struct Array
+    {
+      std::uint32_t scalar_size = 0;
+      std::uint32_t components = 0;
+      std::uint64_t count = 0;
+      std::uint64_t chunk_items = 0;
+      std::vector<Chunk> chunks;
+    };
+
+    bool read_header();
+    bool read_items(const Array& array, index_type first, size_type count, void* items);
+    bool fail(const std::string& error);
+
+    struct Mapping;
+    std::unique_ptr<Mapping> mapping_;
+    std::ifstream file_;
+    std::uint64_t file_size_ = 0;
+    bool open_ = false;
+    bool swap_ = false;
+    std::string error_;
+    std::string mesh_type_;
+    std::string mesh_basis_type_;
+    std::string data_basis_type_;
+    std::string data_type_;
+    Array arrays_[NUM_ARRAYS];
+  };
+
+  SCISHARE FieldHandle ChunkedField_reader(Core::Logging::LoggerHandle pr, const char *filename);
+  SCISHARE bool ChunkedField_writer(Core::Logging::LoggerHandle pr, FieldHandle fh, const char *filename);
+  SCISHARE bool ChunkedField_compressed_writer(Core::Logging::LoggerHandle pr, FieldHandle fh, const char *filename, int level);
+}
+
+#endif
@@ -30,12 +30,14 @@
 #include <Core/Datatypes/Mesh.h>
 #include <Core/Datatypes/FieldInformation.h>
 #include <Core/ImportExport/Field/FieldIEPlugin.h>
+#include <Core/ImportExport/NumericTextFile.h>
 #include <Core/Util/StringUtil.h>
 
 #include <sci_debug.h>
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -171,201 +173,84 @@ FieldHandle TextToHexVolField_reader(ProgressReporter *pr, const char *filename)
     }
   }
 
-  int ncols = 0;
-  int nrows = 0;
-  int line_ncols = 0;
-  int nnodes = 0, nhexes = 0;
-
   // STAGE 1 - SCAN THE FILE TO DETERMINE THE NUMBER OF NODES
   // AND CHECK THE FILE'S INTEGRITY.
 
-  bool has_header_pts = false;
-  bool first_line_pts = true;
+  NumericTextFile pts_file(pts_fn);
+  if (!pts_file.is_open())
+  {
+    if (pr) pr->error("Could not open and read file: " + pts_fn);
+    return (result);
+  }
 
-  bool has_header = false;
-  bool first_line = true;
+  const bool has_header_pts = pts_file.has_count_header();
+  const index_type first_node = has_header_pts ? 1 : 0;
+  size_type nnodes = pts_file.num_rows() - first_node;
 
-  bool has_data = false;
+  const size_type pts_ncols = pts_file.columns(first_node);
+  if (pts_ncols < 0)
+  {
+    if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
+    return (result);
+  }
+  // Only rows with 2 or 3 coordinates describe nodes
+  if (pts_ncols != 2 && pts_ncols != 3) nnodes = 0;
 
   std::vector<double> values;
-  std::string line;
-
+  if (has_header_pts)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
-    {
-      inputfile.open(pts_fn.c_str());
-
-      while( getline(inputfile,line,'\n'))
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0; p < line.size(); ++p)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        line_ncols = values.size();
-
-        if (first_line_pts)
-        {
-          if (line_ncols > 0)
-          {
-            if (line_ncols == 1)
-            {
-              has_header_pts = true;
-              nnodes = static_cast<int>(values[0]) + 1;
-            }
-            else if ((line_ncols > 1))
-            {
-              has_header_pts = false;
-              first_line_pts = false;
-              ++nrows;
-              ncols = line_ncols;
-            }
-          }
-        }
-        else
-        {
-          if (line_ncols > 0)
-          {
-            ++nrows;
-            if (ncols > 0)
-            {
-              if (ncols != line_ncols)
-              {
-                if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
-                return (result);
-              }
-            }
-            else
-            {
-              ncols = line_ncols;
-            }
-          }
-        }
-      }
-    }
-    catch (...)
+    pts_file.read_row(0, values);
+    const size_type header = static_cast<size_type>(values[0]);
+    if (header != nnodes)
     {
-      if (pr) pr->error("Could not open and read file: " + pts_fn);
-      return (result);
-    }
-    inputfile.close();
-
-    if (0 == nnodes)
-    {
-      nnodes = nrows;
-    }
-    else if ( has_header_pts && (nnodes != nrows) )
-    {
-      if (pr) pr->warning("Number of nodes listed in header (" + boost::lexical_cast<std::string>(nnodes) +
-                          ") does not match number of non-header rows in file (" + boost::lexical_cast<std::string>(nrows) + ")");
+      if (pr) pr->warning("Number of nodes listed in header (" + boost::lexical_cast<std::string>(header) +
+                          ") does not match number of non-header rows in file (" + boost::lexical_cast<std::string>(nnodes) + ")");
     }
+    nnodes = std::max<size_type>(0, std::min(header, nnodes));
   }
 
-  nrows = 0;
-  ncols = 0;
-  line_ncols = 0;
-
-  bool zero_based = false;
-
+  NumericTextFile hexes_file(hexes_fn);
+  if (!hexes_file.is_open())
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
-    {
-      inputfile.open(hexes_fn.c_str());
+    if (pr) pr->error("Could not open and read file: " + hexes_fn);
+    return (result);
+  }
 
-      while( getline(inputfile,line,'\n'))
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
+  const bool has_header = hexes_file.has_count_header();
+  const index_type first_hex = has_header ? 1 : 0;
+  size_type nhexes = hexes_file.num_rows() - first_hex;
 
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0; p < line.size(); ++p)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        line_ncols = values.size();
+  if (nhexes > 0 && hexes_file.num_numbers(first_hex) < 8)
+  {
+    if (pr)  pr->error("Improper format of text file, the first line does not contain either a header or at least 8 entries");
+    return (result);
+  }
 
-        for (size_t j=0; j < values.size(); ++j) if (values[j] == 0.0) zero_based = true;
+  const size_type ncols = hexes_file.columns(first_hex);
+  if (ncols < 0)
+  {
+    if (pr)  pr->error("Improper format of text file, not every line contains the same amount of node references");
+    return (result);
+  }
+  const bool has_data = (ncols == 9);
 
-        if (first_line)
-        {
-          if (line_ncols > 0)
-          {
-            if (line_ncols == 1)
-            {
-              has_header = true;
-              nhexes = static_cast<int>(values[0]) + 1;
-            }
-            else if (line_ncols > 7)
-            {
-              has_header = false;
-              first_line = false;
-              ++nrows;
-              ncols = line_ncols;
-              if (ncols == 9) has_data = true;
-            }
-            else
-            {
-              if (pr)  pr->error("Improper format of text file, the first line does not contain either a header or at least 8 entries");
-              return (result);
-            }
-          }
-        }
-        else
-        {
-          if (line_ncols > 0)
-          {
-            ++nrows;
-            if (ncols > 0)
-            {
-              if (ncols != line_ncols)
-              {
-                if (pr)  pr->error("Improper format of text file, not every line contains the same amount of node references");
-                return (result);
-              }
-            }
-            else
-            {
-              ncols = line_ncols;
-              if (ncols == 9) has_data = true;
-            }
-          }
-        }
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open and read file: " + hexes_fn);
-      return (result);
-    }
-    inputfile.close();
-    if (nhexes == 0)
-    {
-      nhexes = nrows;
-    }
-    else if ( has_header && (nhexes != nrows) )
+  if (has_header)
+  {
+    hexes_file.read_row(0, values);
+    const size_type header = static_cast<size_type>(values[0]);
+    if (header != nhexes)
     {
-      if (pr) pr->warning("Number of elements listed in header (" + boost::lexical_cast<std::string>(nhexes) +
-                          ") does not match number of non-header rows in file (" + boost::lexical_cast<std::string>(nrows) + ")");
+      if (pr) pr->warning("Number of elements listed in header (" + boost::lexical_cast<std::string>(header) +
+                          ") does not match number of non-header rows in file (" + boost::lexical_cast<std::string>(nhexes) + ")");
     }
+    nhexes = std::max<size_type>(0, std::min(header, nhexes));
   }
 
+  // Node references are one based, unless the file references node 0 anywhere
+  const bool zero_based = hexes_file.contains_zero(0, hexes_file.num_rows());
+
+  // STAGE 2 - NOW ACTUALLY READ AND STORE THE MESH
+
   FieldInformation fi("HexVolMesh",-1,"double");
   if (has_data) fi.make_constantdata();
   result = CreateField(fi);
@@ -373,94 +258,23 @@ FieldHandle TextToHexVolField_reader(ProgressReporter *pr, const char *filename)
   VMesh *mesh = result->vmesh();
   VField *field = result->vfield();
 
-  mesh->node_reserve(nnodes);
-  mesh->elem_reserve(nhexes);
-
+  mesh->resize_nodes(nnodes);
+  Point* points = mesh->get_points_pointer();
+  pts_file.for_each_row<double>(first_node, nnodes, [&](index_type row, const std::vector<double>& coords)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
-    {
-      inputfile.open(pts_fn.c_str());
-
-      std::vector<double> vdata(3);
-
-      for (int i = 0; i < nnodes && getline(inputfile, line, '\n'); ++i)
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0; p < line.size(); ++p)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,vdata);
-
-        if (vdata.size() == 3) mesh->add_point(Point(vdata[0],vdata[1],vdata[2]));
-        if (vdata.size() == 2) mesh->add_point(Point(vdata[0],vdata[1],0.0));
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open and process file: " + pts_fn);
-      return (result);
-    }
-    inputfile.close();
-  }
-
-  std::vector<double> fvalues;
-
+    points[row - first_node] = Point(coords[0], coords[1], pts_ncols == 3 ? coords[2] : 0.0);
+  });
+
+  mesh->resize_elems(nhexes);
+  VMesh::index_type* hexes = mesh->get_elems_pointer();
+  const index_type offset = zero_based ? 0 : 1;
+  std::vector<double> fvalues(has_data ? nhexes : 0);
+  hexes_file.for_each_row<long long>(first_hex, nhexes, [&](index_type row, const std::vector<long long>& ivalues)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-
-    try
-    {
-      inputfile.open(hexes_fn.c_str());
-
-      VMesh::Node::array_type vdata;
-      vdata.resize(8);
-
-      std::vector<VMesh::index_type> ivalues;
-
-      for (int i = 0; i < nhexes && getline(inputfile, line, '\n'); ++i)
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0; p < line.size(); ++p)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,ivalues);
-
-        for (size_t j = 0; j < ivalues.size() && j < 8; ++j)
-        {
-          if (zero_based) vdata[j] = ivalues[j];
-          else vdata[j] = ivalues[j]-1;
-        }
-        if (ivalues.size() > 8) fvalues.push_back(ivalues[8]);
-
-        if (ivalues.size() > 7) mesh->add_elem(vdata);
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open and process file: " + hexes_fn);
-      return (result);
-    }
-    inputfile.close();
-  }
+    const index_type hex = row - first_hex;
+    for (size_t j = 0; j < ivalues.size() && j < 8; ++j) hexes[8*hex + j] = ivalues[j] - offset;
+    if (has_data && ivalues.size() > 8) fvalues[hex] = static_cast<double>(ivalues[8]);
+  });
 
   if (has_data)
   {
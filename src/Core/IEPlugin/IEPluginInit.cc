@@ -40,6 +40,7 @@
 #include <Core/IEPlugin/TetVolField_Plugin.h>
 #include <Core/IEPlugin/CARPMesh_Plugin.h>
 #include <Core/IEPlugin/CARPFiber_Plugin.h>
+#include <Core/IEPlugin/ChunkedField_Plugin.h>
 #include <Core/ImportExport/Field/FieldIEPlugin.h>
 #include <Core/ImportExport/Matrix/MatrixIEPlugin.h>
 #include <Core/IEPlugin/IEPluginInit.h>
@@ -49,6 +50,8 @@ using namespace SCIRun::Core::Logging;
 
 void IEPluginManager::Initialize()
 {
+  static FieldIEPluginLegacyAdapter ChunkedField_plugin("SCIRun Chunked Field", "*.cfld", "*.cfld", ChunkedField_reader, ChunkedField_writer, ChunkedField_compressed_writer);
+
   static FieldIEPluginLegacyAdapter ObjToField_plugin("ObjToField", "*.obj", "", ObjToField_reader, FieldToObj_writer);
 
   //static FieldIEPluginLegacyAdapter G3DToField_plugin("IV3D", "*.g3d", "", nullptr, FieldToG3D_writer);
@@ -43,9 +43,10 @@
 #include <Core/IEPlugin/SimpleTextFileToMatrix_Plugin.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
-#include <Core/Utils/Legacy/StringUtil.h>
+#include <Core/ImportExport/NumericTextFile.h>
 #include <Core/Logging/LoggerInterface.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -59,113 +60,39 @@ MatrixHandle SCIRun::SimpleTextFileMatrix_reader(LoggerHandle pr, const char *fi
 {
   DenseMatrixHandle result;
 
-  SCIRun::size_type ncols = 0;
-  SCIRun::size_type nrows = 0;
-  SCIRun::size_type line_ncols = 0;
-
-  std::string line;
-
   // STAGE 1 - SCAN THE FILE TO DETERMINE THE DIMENSIONS OF THE MATRIX
   // AND CHECK THE FILE'S INTEGRITY.
 
-  std::vector<double> values;
-
+  NumericTextFile inputfile(filename);
+  if (!inputfile.is_open())
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-
-    try
-    {
-      inputfile.open(filename);
+    if (pr) pr->error("Could not open file: "+std::string(filename));
+    return (result);
+  }
 
-      while( getline(inputfile,line,'\n'))
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        line_ncols = values.size();
-
-        if (line_ncols > 0)
-        {
-          nrows++;
-          if (ncols > 0)
-          {
-            if (ncols != line_ncols)
-            {
-              if (pr)  pr->error("Improper format of text file, not every line contains the same amount of numbers");
-              return (result);
-            }
-          }
-          else
-          {
-            ncols = line_ncols;
-          }
-        }
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open file: "+std::string(filename));
-      return (result);
-    }
-    inputfile.close();
+  const SCIRun::size_type nrows = inputfile.num_rows();
+  const SCIRun::size_type ncols = inputfile.columns(0);
+  if (ncols < 0)
+  {
+    if (pr)  pr->error("Improper format of text file, not every line contains the same amount of numbers");
+    return (result);
   }
 
   // STAGE 2 - NOW ACTUALLY READ AND STORE THE MATRIX
 
+  result.reset(new DenseMatrix(nrows,ncols));
+  if (!result)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-
-    result.reset(new DenseMatrix(nrows,ncols));
-    if (!result)
-    {
-      if (pr) pr->error("Could not allocate matrix");
-      return(result);
-    }
-
-    double* dataptr = result->data();
-    int k = 0;
+    if (pr) pr->error("Could not allocate matrix");
+    return(result);
+  }
 
-    try
-    {
-      inputfile.open(filename);
+  double* dataptr = result->data();
+  inputfile.for_each_row<double>(0, nrows, [&](SCIRun::index_type row, const std::vector<double>& values)
+  {
+    std::copy(values.begin(), values.end(), dataptr + row*ncols);
+  });
 
-      while( getline(inputfile,line,'\n'))
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        for (size_t j=0; j<values.size();j++) dataptr[k++] = values[j];
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open and read file: "+std::string(filename));
-      return (result);
-    }
-    inputfile.close();
-  }
   return(result);
 }
 
@@ -0,0 +1,330 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/IEPlugin/ChunkedField_Plugin.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Persistent/Pstreams.h>
+#include <Core/Logging/ScopedTimeRemarker.h>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <iostream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  class ChunkedFieldTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      dir_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("chunked-field-%%%%-%%%%");
+      boost::filesystem::create_directories(dir_);
+    }
+
+    void TearDown() override
+    {
+      boost::system::error_code ec;
+      boost::filesystem::remove_all(dir_, ec);
+    }
+
+    std::string file(const std::string& name) const
+    {
+      return (dir_ / name).string();
+    }
+
+    boost::filesystem::path dir_;
+  };
+
+  // Six tetrahedra per cell of an n x n x n grid of nodes, with one value per node.
+  FieldHandle tetGrid(int n)
+  {
+    FieldInformation fi(mesh_info_type::TETVOLMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+    auto node = [n](int i, int j, int k) { return static_cast<VMesh::index_type>((k * n + j) * n + i); };
+
+    mesh->reserve_nodes(n * n * n);
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+          mesh->add_point(Point(i, 0.5 * j, 0.25 * k));
+
+    const int cube[6][4] = { {0, 1, 3, 7}, {0, 3, 2, 7}, {0, 2, 6, 7}, {0, 6, 4, 7}, {0, 4, 5, 7}, {0, 5, 1, 7} };
+    VMesh::Node::array_type tet(4);
+    mesh->reserve_elems(6 * (n - 1) * (n - 1) * (n - 1));
+    for (int k = 0; k + 1 < n; ++k)
+      for (int j = 0; j + 1 < n; ++j)
+        for (int i = 0; i + 1 < n; ++i)
+          for (const auto& corners : cube)
+          {
+            for (int c = 0; c < 4; ++c)
+              tet[c] = node(i + (corners[c] & 1), j + ((corners[c] >> 1) & 1), k + ((corners[c] >> 2) & 1));
+            mesh->add_elem(tet);
+          }
+
+    VField* vfield = field->vfield();
+    vfield->resize_values();
+    for (VMesh::index_type v = 0; v < vfield->num_values(); ++v)
+      vfield->set_value(0.125 * v, v);
+    return field;
+  }
+
+  void expectSameField(FieldHandle expected, FieldHandle actual)
+  {
+    ASSERT_TRUE(actual != nullptr);
+    EXPECT_EQ(FieldInformation(expected).get_field_type_id(), FieldInformation(actual).get_field_type_id());
+
+    VMesh* emesh = expected->vmesh();
+    VMesh* amesh = actual->vmesh();
+    ASSERT_EQ(emesh->num_nodes(), amesh->num_nodes());
+    ASSERT_EQ(emesh->num_elems(), amesh->num_elems());
+    for (VMesh::index_type i = 0; i < emesh->num_nodes(); ++i)
+    {
+      Point e, a;
+      emesh->get_point(e, VMesh::Node::index_type(i));
+      amesh->get_point(a, VMesh::Node::index_type(i));
+      ASSERT_EQ(e, a) << i;
+    }
+    VMesh::Node::array_type enodes, anodes;
+    for (VMesh::index_type i = 0; i < emesh->num_elems(); ++i)
+    {
+      emesh->get_nodes(enodes, VMesh::Elem::index_type(i));
+      amesh->get_nodes(anodes, VMesh::Elem::index_type(i));
+      ASSERT_EQ(enodes, anodes) << i;
+    }
+
+    VField* efield = expected->vfield();
+    VField* afield = actual->vfield();
+    ASSERT_EQ(efield->num_values(), afield->num_values());
+    if (efield->is_vector())
+    {
+      std::vector<Vector> evalues, avalues;
+      efield->get_values(evalues);
+      afield->get_values(avalues);
+      EXPECT_EQ(evalues, avalues);
+    }
+    else if (efield->num_values() > 0)
+    {
+      std::vector<double> evalues, avalues;
+      efield->get_values(evalues);
+      afield->get_values(avalues);
+      EXPECT_EQ(evalues, avalues);
+    }
+  }
+}
+
+TEST_F(ChunkedFieldTest, RoundTripsTetVolWithNodeData)
+{
+  auto field = tetGrid(12);
+  std::string error;
+  ASSERT_TRUE(ChunkedFieldFile::write(field, file("tets.cfld"), 6, error)) << error;
+
+  ChunkedFieldFile in(file("tets.cfld"));
+  ASSERT_TRUE(in.is_open()) << in.error();
+  EXPECT_EQ(12 * 12 * 12, in.num_nodes());
+  EXPECT_EQ(6 * 11 * 11 * 11, in.num_elems());
+  EXPECT_EQ(4, in.num_nodes_per_elem());
+  EXPECT_EQ("double", in.data_type());
+  expectSameField(field, in.read_field());
+}
+
+TEST_F(ChunkedFieldTest, RoundTripsTriSurfWithVectorsOnElements)
+{
+  FieldInformation fi(mesh_info_type::TRISURFMESH_E, databasis_info_type::CONSTANTDATA_E, data_info_type::VECTOR_E);
+  FieldHandle field = CreateField(fi);
+  VMesh* mesh = field->vmesh();
+  VMesh::Node::array_type tri(3);
+  for (int i = 0; i < 100; ++i)
+    mesh->add_point(Point(i, i % 7, 0.5 * i));
+  for (int i = 0; i + 2 < 100; ++i)
+  {
+    tri[0] = i; tri[1] = i + 1; tri[2] = i + 2;
+    mesh->add_elem(tri);
+  }
+  VField* vfield = field->vfield();
+  vfield->resize_values();
+  for (VMesh::index_type v = 0; v < vfield->num_values(); ++v)
+    vfield->set_value(Vector(v, -v, 0.5 * v), v);
+
+  ASSERT_TRUE(ChunkedField_compressed_writer(nullptr, field, file("tris.cfld").c_str(), 9));
+  expectSameField(field, ChunkedField_reader(nullptr, file("tris.cfld").c_str()));
+}
+
+TEST_F(ChunkedFieldTest, RoundTripsPointCloudWithoutData)
+{
+  FieldInformation fi(mesh_info_type::POINTCLOUDMESH_E, databasis_info_type::NODATA_E, data_info_type::DOUBLE_E);
+  FieldHandle field = CreateField(fi);
+  for (int i = 0; i < 50; ++i)
+    field->vmesh()->add_point(Point(i, 2 * i, 3 * i));
+
+  ASSERT_TRUE(ChunkedField_writer(nullptr, field, file("cloud.cfld").c_str()));
+  expectSameField(field, ChunkedField_reader(nullptr, file("cloud.cfld").c_str()));
+}
+
+TEST_F(ChunkedFieldTest, ReadsRangesAcrossChunkBoundaries)
+{
+  auto field = tetGrid(40);
+  std::string error;
+  ASSERT_TRUE(ChunkedFieldFile::write(field, file("tets.cfld"), 1, error)) << error;
+
+  ChunkedFieldFile in(file("tets.cfld"));
+  ASSERT_TRUE(in.is_open()) << in.error();
+  ASSERT_GT(in.num_chunks(), 3);
+
+  // 43690 points fit in a chunk of points, 32768 elements in a chunk of elements.
+  const VMesh::index_type first = 43000;
+  const VMesh::size_type count = 1500;
+  std::vector<Point> points(count);
+  ASSERT_TRUE(in.read_nodes(first, count, points.data()));
+  for (VMesh::index_type i = 0; i < count; ++i)
+  {
+    Point expected;
+    field->vmesh()->get_point(expected, VMesh::Node::index_type(first + i));
+    ASSERT_EQ(expected, points[i]) << i;
+  }
+
+  std::vector<VMesh::index_type> elems(4 * count);
+  ASSERT_TRUE(in.read_elems(32000, count, elems.data()));
+  VMesh::Node::array_type nodes;
+  field->vmesh()->get_nodes(nodes, VMesh::Elem::index_type(32768));
+  for (int c = 0; c < 4; ++c)
+    EXPECT_EQ(nodes[c], elems[4 * 768 + c]) << c;
+
+  std::vector<double> values(count);
+  ASSERT_TRUE(in.read_values(in.num_values() - count, count, values.data()));
+  EXPECT_EQ(0.125 * (in.num_values() - 1), values.back());
+
+  EXPECT_FALSE(in.read_values(in.num_values() - count, count + 1, values.data()));
+  EXPECT_FALSE(in.error().empty());
+}
+
+TEST_F(ChunkedFieldTest, HigherLevelsWriteSmallerFiles)
+{
+  auto field = tetGrid(20);
+  std::string error;
+  ASSERT_TRUE(ChunkedFieldFile::write(field, file("stored.cfld"), 0, error)) << error;
+  ASSERT_TRUE(ChunkedFieldFile::write(field, file("best.cfld"), 9, error)) << error;
+  EXPECT_LT(boost::filesystem::file_size(file("best.cfld")), boost::filesystem::file_size(file("stored.cfld")) / 2);
+
+  ChunkedFieldFile stored(file("stored.cfld"));
+  expectSameField(field, stored.read_field());
+}
+
+TEST_F(ChunkedFieldTest, RejectsStructuredMeshes)
+{
+  FieldInformation fi(mesh_info_type::LATVOLMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+  MeshHandle mesh = CreateMesh(fi, 3, 3, 3, Point(0, 0, 0), Point(1, 1, 1));
+  std::string error;
+  EXPECT_FALSE(ChunkedFieldFile::write(CreateField(fi, mesh), file("lat.cfld"), 6, error));
+  EXPECT_FALSE(error.empty());
+}
+
+TEST_F(ChunkedFieldTest, ReportsTruncatedFiles)
+{
+  std::string error;
+  ASSERT_TRUE(ChunkedFieldFile::write(tetGrid(10), file("tets.cfld"), 6, error)) << error;
+  boost::filesystem::resize_file(file("tets.cfld"), boost::filesystem::file_size(file("tets.cfld")) - 100);
+
+  ChunkedFieldFile in(file("tets.cfld"));
+  EXPECT_FALSE(in.is_open());
+  EXPECT_FALSE(in.error().empty());
+  EXPECT_TRUE(in.read_field() == nullptr);
+
+  ChunkedFieldFile missing(file("missing.cfld"));
+  EXPECT_FALSE(missing.is_open());
+}
+
+TEST_F(ChunkedFieldTest, RejectsChunksThatAreNotBackToBack)
+{
+  auto field = tetGrid(40);
+  std::string error;
+  ASSERT_TRUE(ChunkedFieldFile::write(field, file("tets.cfld"), 1, error)) << error;
+
+  // Offset of the second chunk of points: magic, byte order, version, the four type names, the
+  // node array sizes and the first chunk's offset, size and raw size.
+  FieldInformation fi(field);
+  std::streamoff position = 8 + 4 + 4;
+  for (const auto& name : { fi.get_mesh_type(), fi.get_mesh_basis_type(), fi.get_basis_type(), fi.get_data_type() })
+    position += 4 + name.size();
+  position += 4 + 4 + 8 + 8 + 8 + 3 * 8;
+
+  std::fstream patch(file("tets.cfld"), std::ios::in | std::ios::out | std::ios::binary);
+  std::uint64_t offset = 0;
+  patch.seekg(position);
+  patch.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+  ++offset;
+  patch.seekp(position);
+  patch.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+  patch.close();
+
+  ChunkedFieldFile in(file("tets.cfld"));
+  EXPECT_FALSE(in.is_open());
+  EXPECT_EQ("Chunked field index is corrupt.", in.error());
+}
+
+TEST_F(ChunkedFieldTest, DISABLED_LoadTimeComparedToFld)
+{
+  using Core::Logging::SimpleScopedTimer;
+  auto field = tetGrid(100);
+  std::cout << field->vmesh()->num_nodes() << " nodes, " << field->vmesh()->num_elems() << " tets" << std::endl;
+  {
+    auto out = auto_ostream(file("tets.fld"), "Binary");
+    Pio(*out, field);
+  }
+  {
+    FieldHandle loaded;
+    SimpleScopedTimer t;
+    auto in = auto_istream(file("tets.fld"));
+    Pio(*in, loaded);
+    std::cout << "binary .fld (" << boost::filesystem::file_size(file("tets.fld")) << " bytes) loaded in " << t.elapsedSeconds() << " s" << std::endl;
+  }
+  for (int level : { 0, 1, 6 })
+  {
+    std::string error;
+    SimpleScopedTimer w;
+    ASSERT_TRUE(ChunkedFieldFile::write(field, file("tets.cfld"), level, error)) << error;
+    const auto written = w.elapsedSeconds();
+    SimpleScopedTimer t;
+    ChunkedFieldFile in(file("tets.cfld"));
+    auto loaded = in.read_field();
+    std::cout << ".cfld level " << level << " (" << boost::filesystem::file_size(file("tets.cfld")) << " bytes) written in "
+      << written << " s, loaded in " << t.elapsedSeconds() << " s" << std::endl;
+  }
+}
@@ -0,0 +1,237 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/IEPlugin/TetVolField_Plugin.h>
+#include <Core/IEPlugin/TriSurfField_Plugin.h>
+#include <Core/IEPlugin/SimpleTextFileToMatrix_Plugin.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Logging/LoggerInterface.h>
+#include <Core/Logging/ScopedTimeRemarker.h>
+#include <Core/Utils/Legacy/StringUtil.h>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <iostream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  class RecordingLogger : public LegacyLoggerInterface
+  {
+  public:
+    void error(const std::string& msg) const override { errors.push_back(msg); }
+    bool errorReported() const override { return !errors.empty(); }
+    void setErrorFlag(bool) override {}
+    void warning(const std::string& msg) const override { warnings.push_back(msg); }
+    void remark(const std::string&) const override {}
+    void status(const std::string&) const override {}
+
+    mutable std::vector<std::string> errors, warnings;
+  };
+
+  class TextMeshPluginTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      dir_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("text-mesh-%%%%-%%%%");
+      boost::filesystem::create_directories(dir_);
+      log_.reset(new RecordingLogger);
+    }
+
+    void TearDown() override
+    {
+      boost::system::error_code ec;
+      boost::filesystem::remove_all(dir_, ec);
+    }
+
+    std::string write(const std::string& name, const std::string& contents) const
+    {
+      const auto filename = (dir_ / name).string();
+      std::ofstream file(filename.c_str(), std::ios::binary);
+      file << contents;
+      return filename;
+    }
+
+    boost::filesystem::path dir_;
+    std::shared_ptr<RecordingLogger> log_;
+  };
+
+  std::vector<VMesh::index_type> elemNodes(VMesh* mesh, VMesh::index_type elem)
+  {
+    VMesh::Node::array_type nodes;
+    mesh->get_nodes(nodes, VMesh::Elem::index_type(elem));
+    return std::vector<VMesh::index_type>(nodes.begin(), nodes.end());
+  }
+}
+
+TEST_F(TextMeshPluginTest, ReadsTetVolWithHeadersAndElementData)
+{
+  const auto pts = write("mesh.pts", "# four corners\n4\n0 0 0\n1, 0, 0\n0\t1\t0\n\n0 0 1\n");
+  write("mesh.elem", "% one based\n2\n1 2 3 4 7\n4 3 2 1 -2\n");
+
+  FieldHandle field = TextToTetVolField_reader(log_, pts.c_str());
+  ASSERT_TRUE(field != nullptr);
+  EXPECT_TRUE(log_->errors.empty());
+  EXPECT_TRUE(log_->warnings.empty());
+
+  VMesh* mesh = field->vmesh();
+  ASSERT_EQ(4, mesh->num_nodes());
+  ASSERT_EQ(2, mesh->num_elems());
+  Point p;
+  mesh->get_center(p, VMesh::Node::index_type(1));
+  EXPECT_EQ(Point(1, 0, 0), p);
+  mesh->get_center(p, VMesh::Node::index_type(3));
+  EXPECT_EQ(Point(0, 0, 1), p);
+  EXPECT_EQ(std::vector<VMesh::index_type>({ 0, 1, 2, 3 }), elemNodes(mesh, 0));
+  EXPECT_EQ(std::vector<VMesh::index_type>({ 3, 2, 1, 0 }), elemNodes(mesh, 1));
+
+  VField* vfield = field->vfield();
+  EXPECT_TRUE(vfield->is_constantdata());
+  ASSERT_EQ(2, vfield->num_values());
+  double value;
+  vfield->get_value(value, 0);
+  EXPECT_EQ(7, value);
+  vfield->get_value(value, 1);
+  EXPECT_EQ(-2, value);
+}
+
+TEST_F(TextMeshPluginTest, TetVolHeaderLimitsRowsAndWarnsOnMismatch)
+{
+  const auto pts = write("mesh.pts", "3\n0 0 0\n1 0 0\n0 1 0\n0 0 1\n");
+  write("mesh.elem", "1 2 3 4\n");
+
+  FieldHandle field = TextToTetVolField_reader(log_, pts.c_str());
+  ASSERT_TRUE(field != nullptr);
+  EXPECT_EQ(3, field->vmesh()->num_nodes());
+  EXPECT_EQ(1, field->vmesh()->num_elems());
+  EXPECT_TRUE(field->vfield()->is_nodata());
+  ASSERT_EQ(1u, log_->warnings.size());
+}
+
+TEST_F(TextMeshPluginTest, TetVolRejectsInconsistentRows)
+{
+  const auto pts = write("mesh.pts", "0 0 0\n1 0 0\n0 1 0\n0 0 1\n");
+  write("mesh.elem", "1 2 3 4\n1 2 3\n");
+
+  EXPECT_TRUE(TextToTetVolField_reader(log_, pts.c_str()) == nullptr);
+  ASSERT_EQ(1u, log_->errors.size());
+  EXPECT_NE(std::string::npos, log_->errors[0].find("node references"));
+}
+
+TEST_F(TextMeshPluginTest, ReadsZeroBasedTriSurfWithPlanarPoints)
+{
+  const auto pts = write("surf.pts", "0 0\n1 0\n1 1\n0 1");
+  write("surf.fac", "0 1 2\r\n0 2 3\r\n");
+
+  FieldHandle field = TextToTriSurfField_reader(log_, pts.c_str());
+  ASSERT_TRUE(field != nullptr);
+  VMesh* mesh = field->vmesh();
+  ASSERT_EQ(4, mesh->num_nodes());
+  ASSERT_EQ(2, mesh->num_elems());
+  Point p;
+  mesh->get_center(p, VMesh::Node::index_type(2));
+  EXPECT_EQ(Point(1, 1, 0), p);
+  EXPECT_EQ(std::vector<VMesh::index_type>({ 0, 1, 2 }), elemNodes(mesh, 0));
+  EXPECT_EQ(std::vector<VMesh::index_type>({ 0, 2, 3 }), elemNodes(mesh, 1));
+}
+
+TEST_F(TextMeshPluginTest, ReadsMatrixRowByRow)
+{
+  const auto file = write("matrix.txt", "% 2 x 3\n1 2 3\n4,5,6e1\n");
+
+  auto matrix = std::dynamic_pointer_cast<DenseMatrix>(SimpleTextFileMatrix_reader(log_, file.c_str()));
+  ASSERT_TRUE(matrix != nullptr);
+  ASSERT_EQ(2, matrix->nrows());
+  ASSERT_EQ(3, matrix->ncols());
+  EXPECT_EQ(3, (*matrix)(0, 2));
+  EXPECT_EQ(4, (*matrix)(1, 0));
+  EXPECT_EQ(60, (*matrix)(1, 2));
+
+  const auto ragged = write("ragged.txt", "1 2 3\n4 5\n");
+  EXPECT_TRUE(SimpleTextFileMatrix_reader(log_, ragged.c_str()) == nullptr);
+  EXPECT_EQ(1u, log_->errors.size());
+}
+
+TEST_F(TextMeshPluginTest, DISABLED_TetVolLoadTimeComparedToLineByLineParsing)
+{
+  using Core::Logging::SimpleScopedTimer;
+
+  // Six tetrahedra per cell of an n x n x n grid of nodes
+  const int n = 56;
+  {
+    std::ofstream pts((dir_ / "grid.pts").string().c_str());
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+          pts << 0.1 * i << " " << 0.1 * j << " " << 0.1 * k << "\n";
+    std::ofstream elem((dir_ / "grid.elem").string().c_str());
+    const int cube[6][4] = { {0, 1, 3, 7}, {0, 3, 2, 7}, {0, 2, 6, 7}, {0, 6, 4, 7}, {0, 4, 5, 7}, {0, 5, 1, 7} };
+    for (int k = 0; k + 1 < n; ++k)
+      for (int j = 0; j + 1 < n; ++j)
+        for (int i = 0; i + 1 < n; ++i)
+          for (const auto& corners : cube)
+          {
+            for (int c = 0; c < 4; ++c)
+              elem << ((k + ((corners[c] >> 2) & 1)) * n + j + ((corners[c] >> 1) & 1)) * n + i + (corners[c] & 1) + 1 << " ";
+            elem << "\n";
+          }
+  }
+
+  {
+    SimpleScopedTimer t;
+    size_t count = 0;
+    std::vector<double> values;
+    for (const auto name : { "grid.pts", "grid.elem" })
+    {
+      std::ifstream file((dir_ / name).string().c_str());
+      std::string line;
+      while (getline(file, line, '\n'))
+        if (multiple_from_string(line, values)) count += values.size();
+    }
+    std::cout << "Parsing " << count << " numbers line by line took " << t.elapsedSeconds() << " seconds" << std::endl;
+  }
+
+  SimpleScopedTimer t;
+  FieldHandle field = TextToTetVolField_reader(log_, (dir_ / "grid.pts").string().c_str());
+  std::cout << "Reading " << field->vmesh()->num_elems() << " tets took " << t.elapsedSeconds() << " seconds" << std::endl;
+  EXPECT_EQ(6 * (n - 1) * (n - 1) * (n - 1), field->vmesh()->num_elems());
+}
@@ -32,8 +32,9 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/IEPlugin/TriSurfField_Plugin.h>
-#include <Core/Utils/Legacy/StringUtil.h>
+#include <Core/ImportExport/NumericTextFile.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -178,202 +179,84 @@ FieldHandle SCIRun::TextToTetVolField_reader(LoggerHandle pr, const char *filena
     }
   }
 
-  int ncols = 0;
-  int nrows = 0;
-  int line_ncols = 0;
-  int num_nodes = 0, num_elems = 0;
-
-  std::string line;
-
   // STAGE 1 - SCAN THE FILE TO DETERMINE THE NUMBER OF NODES
   // AND CHECK THE FILE'S INTEGRITY.
 
-  bool has_header_pts = false;
-  bool first_line_pts = true;
+  NumericTextFile pts_file(pts_fn);
+  if (!pts_file.is_open())
+  {
+    if (pr) pr->error("Could not open and read file: " + pts_fn);
+    return (result);
+  }
 
-  bool has_header = false;
-  bool first_line = true;
+  const bool has_header_pts = pts_file.has_count_header();
+  const index_type first_node = has_header_pts ? 1 : 0;
+  size_type num_nodes = pts_file.num_rows() - first_node;
 
-  bool has_data = false;
+  const size_type pts_ncols = pts_file.columns(first_node);
+  if (pts_ncols < 0)
+  {
+    if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
+    return (result);
+  }
+  // Only rows with 2 or 3 coordinates describe nodes
+  if (pts_ncols != 2 && pts_ncols != 3) num_nodes = 0;
 
   std::vector<double> values;
-
+  if (has_header_pts)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
+    pts_file.read_row(0, values);
+    const size_type header = static_cast<size_type>(values[0]);
+    if (header != num_nodes)
     {
-      inputfile.open(pts_fn.c_str());
-
-      while (getline(inputfile,line,'\n'))
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        line_ncols = values.size();
-
-        if (first_line_pts)
-        {
-          if (line_ncols > 0)
-          {
-            if (line_ncols == 1)
-            {
-              has_header_pts = true;
-              num_nodes = static_cast<int>(values[0]) + 1;
-            }
-            else if ((line_ncols > 1))
-            {
-              has_header_pts = false;
-              first_line_pts = false;
-              nrows++;
-              ncols = line_ncols;
-            }
-          }
-        }
-        else
-        {
-          if (line_ncols > 0)
-          {
-            nrows++;
-            if (ncols > 0)
-            {
-              if (ncols != line_ncols)
-              {
-                if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
-                return (result);
-              }
-            }
-            else
-            {
-              ncols = line_ncols;
-            }
-          }
-        }
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open and read file: " + pts_fn);
-      return (result);
+      if (pr) pr->warning("Number of nodes listed in header (" + boost::lexical_cast<std::string>(header) +
+                          ") does not match number of non-header rows in file (" + boost::lexical_cast<std::string>(num_nodes) + ")");
     }
-    inputfile.close();
+    num_nodes = std::max<size_type>(0, std::min(header, num_nodes));
   }
 
-  if (0 == num_nodes)
+  NumericTextFile elems_file(elems_fn);
+  if (!elems_file.is_open())
   {
-    num_nodes = nrows;
-  }
-  else if ( has_header_pts && (nrows != num_nodes) )
-  {
-    if (pr) pr->warning("Number of nodes listed in header (" + boost::lexical_cast<std::string>(num_nodes) +
-                        ") does not match number of non-header rows in file (" + boost::lexical_cast<std::string>(nrows) + ")");
+    if (pr) pr->error("Could not open and read file: " + elems_fn);
+    return (result);
   }
 
-  nrows = 0;
-  ncols = 0;
-  line_ncols = 0;
+  const bool has_header = elems_file.has_count_header();
+  const index_type first_elem = has_header ? 1 : 0;
+  size_type num_elems = elems_file.num_rows() - first_elem;
 
-  bool zero_based = false;
+  if (num_elems > 0 && elems_file.num_numbers(first_elem) < 4)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
-    {
-      inputfile.open(elems_fn.c_str());
-
-      while (getline(inputfile,line,'\n'))
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        line_ncols = values.size();
-
-        for (size_t j=0; j<values.size(); j++) if (values[j] == 0.0) zero_based = true;
-
-        if (first_line)
-        {
-          if (line_ncols > 0)
-          {
-            if (line_ncols == 1)
-            {
-              has_header = true;
-              num_elems = static_cast<int>(values[0]) + 1;
-            }
-            else if (line_ncols > 3)
-            {
-              has_header = false;
-              first_line = false;
-              nrows++;
-              ncols = line_ncols;
-              if (ncols == 5) has_data = true;
-            }
-            else
-            {
-              if (pr)  pr->error("Improper format of text file, some lines do not contain 4 entries");
-              return (result);
-            }
-          }
-        }
-        else
-        {
-          if (line_ncols > 0)
-          {
-            nrows++;
-            if (ncols > 0)
-            {
-              if (ncols != line_ncols)
-              {
-                if (pr)  pr->error("Improper format of text file, not every line contains the same amount of node references");
-                return (result);
-              }
-            }
-            else
-            {
-              ncols = line_ncols;
-              if (ncols == 5) has_data = true;
-            }
-          }
-        }
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open and read file: " + elems_fn);
-      return (result);
-    }
-    inputfile.close();
+    if (pr)  pr->error("Improper format of text file, some lines do not contain 4 entries");
+    return (result);
   }
 
-  if (0 == num_elems)
+  const size_type ncols = elems_file.columns(first_elem);
+  if (ncols < 0)
   {
-    num_elems = nrows;
+    if (pr)  pr->error("Improper format of text file, not every line contains the same amount of node references");
+    return (result);
   }
-  else if ( has_header && (nrows != num_elems) )
+  const bool has_data = (ncols == 5);
+
+  if (has_header)
   {
-    if (pr) pr->warning("Number of elements listed in header (" + boost::lexical_cast<std::string>(num_elems) +
-                        ") does not match number of non-header rows in file (" + boost::lexical_cast<std::string>(nrows) + ")");
+    elems_file.read_row(0, values);
+    const size_type header = static_cast<size_type>(values[0]);
+    if (header != num_elems)
+    {
+      if (pr) pr->warning("Number of elements listed in header (" + boost::lexical_cast<std::string>(header) +
+                          ") does not match number of non-header rows in file (" + boost::lexical_cast<std::string>(num_elems) + ")");
+    }
+    num_elems = std::max<size_type>(0, std::min(header, num_elems));
   }
 
+  // Node references are one based, unless the file references node 0 anywhere
+  const bool zero_based = elems_file.contains_zero(0, elems_file.num_rows());
+
+  // STAGE 2 - NOW ACTUALLY READ AND STORE THE MESH
+
   // add data to elems (constant basis)
   FieldInformation fi("TetVolMesh",-1,"double");
   if (has_data) fi.make_constantdata();
@@ -382,94 +265,23 @@ FieldHandle SCIRun::TextToTetVolField_reader(LoggerHandle pr, const char *filena
   VMesh *mesh = result->vmesh();
   VField *field = result->vfield();
 
-  mesh->node_reserve(num_nodes);
-  mesh->elem_reserve(num_elems);
-
+  mesh->resize_nodes(num_nodes);
+  Point* points = mesh->get_points_pointer();
+  pts_file.for_each_row<double>(first_node, num_nodes, [&](index_type row, const std::vector<double>& coords)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-
-    try
-    {
-      inputfile.open(pts_fn.c_str());
-
-      std::vector<double> vdata(3);
-
-      for (int i = 0; i < num_nodes && getline(inputfile,line,'\n'); ++i)
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-
-        if (values.size() == 3) mesh->add_point(Point(values[0],values[1],values[2]));
-        if (values.size() == 2) mesh->add_point(Point(values[0],values[1],0.0));
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open and process file: " + pts_fn);
-      return (result);
-    }
-    inputfile.close();
-  }
-
-  std::vector<double> fvalues;
-
+    points[row - first_node] = Point(coords[0], coords[1], pts_ncols == 3 ? coords[2] : 0.0);
+  });
+
+  mesh->resize_elems(num_elems);
+  VMesh::index_type* elems = mesh->get_elems_pointer();
+  const index_type offset = zero_based ? 0 : 1;
+  std::vector<double> fvalues(has_data ? num_elems : 0);
+  elems_file.for_each_row<long long>(first_elem, num_elems, [&](index_type row, const std::vector<long long>& ivalues)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-
-    try
-    {
-      inputfile.open(elems_fn.c_str());
-
-      VMesh::Node::array_type vdata;
-      vdata.resize(4);
-
-      std::vector<VMesh::index_type> ivalues;
-
-      for (int i = 0; i < num_elems && getline(inputfile,line,'\n'); ++i)
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,ivalues);
-        for (size_t j=0; j<ivalues.size() && j<4; j++)
-        {
-          if (zero_based) vdata[j] = ivalues[j];
-          else vdata[j] = ivalues[j]-1;
-        }
-        if (ivalues.size() > 4) fvalues.push_back(ivalues[4]);
-
-        if (ivalues.size() > 3) mesh->add_elem(vdata);
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open and process file: " + elems_fn);
-      return (result);
-    }
-    inputfile.close();
-  }
+    const index_type elem = row - first_elem;
+    for (size_t j = 0; j < ivalues.size() && j < 4; j++) elems[4*elem + j] = ivalues[j] - offset;
+    if (has_data && ivalues.size() > 4) fvalues[elem] = static_cast<double>(ivalues[4]);
+  });
 
   if (has_data)
   {
@@ -31,11 +31,12 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/IEPlugin/TriSurfField_Plugin.h>
-#include <Core/Utils/Legacy/StringUtil.h>
+#include <Core/ImportExport/NumericTextFile.h>
 #include <Core/Algorithms/Legacy/DataIO/VTKToTriSurfReader.h>
 #include <Core/Algorithms/Legacy/DataIO/TriSurfSTLASCIIConverter.h>
 #include <Core/Algorithms/Legacy/DataIO/TriSurfSTLBinaryConverter.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -197,274 +198,92 @@ FieldHandle SCIRun::TextToTriSurfField_reader(LoggerHandle pr, const char *filen
   }
 
 
-  int ncols = 0;
-  int nrows = 0;
-  int line_ncols = 0;
-  int num_elems = 0, num_nodes = 0;
-
-  std::string line;
-
   // STAGE 1 - SCAN THE FILE TO DETERMINE THE NUMBER OF NODES
   // AND CHECK THE FILE'S INTEGRITY.
 
-  bool first_line_pts = true;
-  bool first_line = true;
-
-  std::vector<double> values;
-
+  NumericTextFile pts_file(pts_fn);
+  if (!pts_file.is_open())
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
-    {
-      inputfile.open(pts_fn.c_str());
-
-      while ( getline(inputfile,line,'\n') )
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
+    if (pr) pr->error("Could not open file: " + pts_fn);
+    return (result);
+  }
 
-        multiple_from_string(line,values);
-        line_ncols = values.size();
+  const index_type first_node = pts_file.has_count_header() ? 1 : 0;
+  size_type num_nodes = pts_file.num_rows() - first_node;
 
-        if (first_line_pts)
-        {
-          if (line_ncols > 0)
-          {
-            if (line_ncols == 1)
-            {
-              num_nodes =  static_cast<int>(values[0]) + 1;
-            }
-            else if ((line_ncols == 3)||(line_ncols == 2))
-            {
-              first_line_pts = false;
-              nrows++;
-              ncols = line_ncols;
-            }
-            else
-            {
-              if (pr)  pr->error("Improper format of text file, some lines contain more than 3 entries");
-              return (result);
-            }
-          }
-        }
-        else
-        {
-          if (line_ncols > 0)
-          {
-            nrows++;
-            if (ncols > 0)
-            {
-              if (ncols != line_ncols)
-              {
-                if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
-                return (result);
-              }
-            }
-            else
-            {
-              ncols = line_ncols;
-            }
-          }
-        }
-      }
-    }
-    catch (...) {
-      if (pr) pr->error("Could not open file: " + pts_fn);
-      return (result);
-    }
-    inputfile.close();
+  if (num_nodes > 0 && pts_file.num_numbers(first_node) != 2 && pts_file.num_numbers(first_node) != 3)
+  {
+    if (pr)  pr->error("Improper format of text file, some lines contain more than 3 entries");
+    return (result);
   }
 
-  if (0 == num_nodes) {
-    num_nodes = nrows;
+  const size_type pts_ncols = pts_file.columns(first_node);
+  if (pts_ncols < 0)
+  {
+    if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
+    return (result);
   }
 
-  nrows = 0;
-  ncols = 0;
-  line_ncols = 0;
-
-  bool zero_based = false;
-
+  std::vector<double> values;
+  if (first_node > 0)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
-    {
-      inputfile.open(fac_fn.c_str());
-
-      while( getline(inputfile,line,'\n'))
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        line_ncols = values.size();
-
-        for (size_t j=0; j<values.size(); j++) if (values[j] == 0.0) zero_based = true;
-
-        if (first_line)
-        {
-          if (line_ncols > 0)
-          {
-            if (line_ncols == 1)
-            {
-              num_elems =  static_cast<int>(values[0]) + 1;
-            }
-            else if (line_ncols == 3)
-            {
-              first_line = false;
-              nrows++;
-              ncols = line_ncols;
-            }
-            else
-            {
-              if (pr)  pr->error("Improper format of text file, some lines do not contain 3 entries");
-              return (result);
-            }
-          }
-        }
-        else
-        {
-          if (line_ncols > 0)
-          {
-            nrows++;
-            if (ncols > 0)
-            {
-              if (ncols != line_ncols)
-              {
-                if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
-                return (result);
-              }
-            }
-            else
-            {
-              ncols = line_ncols;
-            }
-          }
-        }
-      }
-    }
-    catch (...) {
-      if (pr) pr->error("Could not open file: " + fac_fn);
-      return (result);
-    }
-    inputfile.close();
+    pts_file.read_row(0, values);
+    num_nodes = std::max<size_type>(0, std::min(static_cast<size_type>(values[0]), num_nodes));
   }
 
-  if (0 == num_elems)
+  NumericTextFile fac_file(fac_fn);
+  if (!fac_file.is_open())
   {
-    num_elems = nrows;
+    if (pr) pr->error("Could not open file: " + fac_fn);
+    return (result);
   }
 
-  FieldInformation fi("TriSurfMesh", 1,"double");
-  result = CreateField(fi);
-
-  VMesh *mesh = result->vmesh();
-
-  mesh->node_reserve(num_nodes);
-  mesh->elem_reserve(num_elems);
+  const index_type first_elem = fac_file.has_count_header() ? 1 : 0;
+  size_type num_elems = fac_file.num_rows() - first_elem;
 
+  if (num_elems > 0 && fac_file.num_numbers(first_elem) != 3)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-
-    try
-    {
-      inputfile.open(pts_fn.c_str());
-
-      std::vector<double> vdata(3);
-
-      for(int i = 0; i < num_nodes && getline(inputfile,line,'\n'); ++i)
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-
-        if (values.size() == 3) mesh->add_point(Point(values[0],values[1],values[2]));
-        if (values.size() == 2) mesh->add_point(Point(values[0],values[1],0.0));
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open file: "+std::string(pts_fn));
-      return (result);
-    }
-    inputfile.close();
+    if (pr)  pr->error("Improper format of text file, some lines do not contain 3 entries");
+    return (result);
   }
 
+  if (fac_file.columns(first_elem) < 0)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
+    if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
+    return (result);
+  }
 
-    try
-    {
-      inputfile.open(fac_fn.c_str());
+  if (first_elem > 0)
+  {
+    fac_file.read_row(0, values);
+    num_elems = std::max<size_type>(0, std::min(static_cast<size_type>(values[0]), num_elems));
+  }
 
-      VMesh::Node::array_type vdata;
-      vdata.resize(3);
+  // Node references are one based, unless the file references node 0 anywhere
+  const bool zero_based = fac_file.contains_zero(0, fac_file.num_rows());
 
-      std::vector<VMesh::index_type> ivalues;
+  // STAGE 2 - NOW ACTUALLY READ AND STORE THE MESH
 
-      for (int i = 0; i < num_elems && getline(inputfile,line,'\n'); ++i)
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
+  FieldInformation fi("TriSurfMesh", 1,"double");
+  result = CreateField(fi);
 
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0; p < line.size(); p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
+  VMesh *mesh = result->vmesh();
 
-        multiple_from_string(line,ivalues);
-        for (size_t j = 0; j < ivalues.size() && j < 3; j++)
-        {
-          if (zero_based) vdata[j] = ivalues[j];
-          else vdata[j] = ivalues[j]-1;
-        }
+  mesh->resize_nodes(num_nodes);
+  Point* points = mesh->get_points_pointer();
+  pts_file.for_each_row<double>(first_node, num_nodes, [&](index_type row, const std::vector<double>& coords)
+  {
+    points[row - first_node] = Point(coords[0], coords[1], pts_ncols == 3 ? coords[2] : 0.0);
+  });
 
-        if (ivalues.size() > 2) mesh->add_elem(vdata);
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open file: "+std::string(fac_fn));
-      return (result);
-    }
-    inputfile.close();
-  }
+  mesh->resize_elems(num_elems);
+  VMesh::index_type* faces = mesh->get_elems_pointer();
+  const index_type offset = zero_based ? 0 : 1;
+  fac_file.for_each_row<long long>(first_elem, num_elems, [&](index_type row, const std::vector<long long>& ivalues)
+  {
+    const index_type face = row - first_elem;
+    for (size_t j = 0; j < ivalues.size() && j < 3; j++) faces[3*face + j] = ivalues[j] - offset;
+  });
 
   return (result);
 }
@@ -52,6 +52,12 @@ public:
 
   virtual SharedPointer<Data> readFile(const std::string& filename, Core::Logging::LoggerHandle log) const = 0;
   virtual bool writeFile(SharedPointer<Data> f, const std::string& filename, Core::Logging::LoggerHandle log) const = 0;
+  /// Writers of compressed formats take a level from 0 (store only) to 9 (smallest file); all other
+  /// writers ignore it.
+  virtual bool writeFile(SharedPointer<Data> f, const std::string& filename, int compressionLevel, Core::Logging::LoggerHandle log) const
+  {
+    return writeFile(f, filename, log);
+  }
   virtual bool equals(const GenericIEPluginInterface<Data>& other) const = 0;
   virtual bool hasReader() const = 0;
   virtual bool hasWriter() const = 0;
@@ -82,13 +88,15 @@ public:
 
   SharedPointer<Data> readFile(const std::string& filename, Core::Logging::LoggerHandle log) const override;
   bool writeFile(SharedPointer<Data> f, const std::string& filename, Core::Logging::LoggerHandle log) const override;
+  bool writeFile(SharedPointer<Data> f, const std::string& filename, int compressionLevel, Core::Logging::LoggerHandle log) const override;
   bool equals(const GenericIEPluginInterface<Data>& other) const override;
 
   IEPluginLegacyAdapter(const std::string &name,
     const std::string &fileextension,
     const std::string &filemagic,
     SharedPointer<Data> (*freader)(Core::Logging::LoggerHandle pr, const char *filename) = nullptr,
-    bool (*fwriter)(Core::Logging::LoggerHandle pr, SharedPointer<Data> f, const char *filename) = nullptr);
+    bool (*fwriter)(Core::Logging::LoggerHandle pr, SharedPointer<Data> f, const char *filename) = nullptr,
+    bool (*fcompressedwriter)(Core::Logging::LoggerHandle pr, SharedPointer<Data> f, const char *filename, int level) = nullptr);
 
   ~IEPluginLegacyAdapter();
 
@@ -102,6 +110,8 @@ private:
   SharedPointer<Data> (*filereader_)(Core::Logging::LoggerHandle pr, const char *filename);
   bool (*filewriter_)(Core::Logging::LoggerHandle pr,
     SharedPointer<Data> f, const char *filename);
+  bool (*compressedfilewriter_)(Core::Logging::LoggerHandle pr,
+    SharedPointer<Data> f, const char *filename, int level);
 };
 
 template <class Data>
@@ -235,12 +245,14 @@ IEPluginLegacyAdapter<Data>::IEPluginLegacyAdapter(const std::string& pname,
   const std::string& fextension,
   const std::string& fmagic,
   SharedPointer<Data> (*freader)(Core::Logging::LoggerHandle pr, const char *filename),
-  bool (*fwriter)(Core::Logging::LoggerHandle pr, SharedPointer<Data> f, const char *filename))
+  bool (*fwriter)(Core::Logging::LoggerHandle pr, SharedPointer<Data> f, const char *filename),
+  bool (*fcompressedwriter)(Core::Logging::LoggerHandle pr, SharedPointer<Data> f, const char *filename, int level))
   : pluginname_(pname),
   fileextension_(fextension),
   filemagic_(fmagic),
   filereader_(freader),
-  filewriter_(fwriter)
+  filewriter_(fwriter),
+  compressedfilewriter_(fcompressedwriter)
 {
   Core::Thread::Guard s(GenericIEPluginManager<Data>::getMap().getLock());
 
@@ -302,6 +314,14 @@ bool IEPluginLegacyAdapter<Data>::writeFile(SharedPointer<Data> f, const std::st
   return filewriter_(log, f, filename.c_str());
 }
 
+template <class Data>
+bool IEPluginLegacyAdapter<Data>::writeFile(SharedPointer<Data> f, const std::string& filename, int compressionLevel, Core::Logging::LoggerHandle log) const
+{
+  if (compressedfilewriter_)
+    return compressedfilewriter_(log, f, filename.c_str(), compressionLevel);
+  return writeFile(f, filename, log);
+}
+
 template <class Data>
 bool IEPluginLegacyAdapter<Data>::equals(const GenericIEPluginInterface<Data>& other) const
 {
@@ -318,7 +338,8 @@ bool IEPluginLegacyAdapter<Data>::operator==(const IEPluginLegacyAdapter<Data>&
     fileextension_ == other.fileextension_ &&
     filemagic_ == other.filemagic_ &&
     filereader_ == other.filereader_ &&
-    filewriter_ == other.filewriter_);
+    filewriter_ == other.filewriter_ &&
+    compressedfilewriter_ == other.compressedfilewriter_);
 }
 
 template <class Data>
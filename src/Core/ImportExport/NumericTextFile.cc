@@ -0,0 +1,355 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Core/ImportExport/NumericTextFile.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+using namespace SCIRun;
+
+namespace
+{
+  inline bool is_separator(char c)
+  {
+    return c == ' ' || c == '\t' || c == ',' || c == '"' || c == '\r' || c == '\n';
+  }
+
+  inline bool is_digit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  inline bool is_hex_digit(char c)
+  {
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+  }
+
+  inline bool starts_with(const char* begin, const char* end, const char* prefix)
+  {
+    const size_t size = std::strlen(prefix);
+    return static_cast<size_t>(end - begin) >= size && std::memcmp(begin, prefix, size) == 0;
+  }
+
+  // Anything the fast path does not handle (hex floats, "infinity", out of range values) goes
+  // through strtod, which needs a terminated copy of the token.
+  const char* parse_with_strtod(const char* begin, const char* end, double& value)
+  {
+    char buffer[128];
+    const size_t size = std::min(static_cast<size_t>(end - begin), sizeof(buffer) - 1);
+    std::memcpy(buffer, begin, size);
+    buffer[size] = '\0';
+    char* eptr;
+    const double result = std::strtod(buffer, &eptr);
+    if (eptr == buffer) return begin;
+    value = result;
+    return begin + (eptr - buffer);
+  }
+
+  template <class T>
+  void parse_numbers_impl(const char* begin, const char* end, std::vector<T>& numbers)
+  {
+    numbers.clear();
+    const char* p = begin;
+    while (p < end)
+    {
+      while (p < end && is_separator(*p)) ++p;
+      if (p == end) break;
+      const char* token_end = p;
+      while (token_end < end && !is_separator(*token_end)) ++token_end;
+
+      T value;
+      if (parse_number(p, token_end, value) != p) numbers.push_back(value);
+      p = token_end;
+    }
+  }
+
+  // Counts the numbers parse_numbers() would return as doubles. Tokens starting with a digit
+  // always parse, so only the others need a conversion.
+  size_t count_numbers(const char* begin, const char* end)
+  {
+    size_t count = 0;
+    const char* p = begin;
+    while (p < end)
+    {
+      while (p < end && is_separator(*p)) ++p;
+      if (p == end) break;
+      const char* token_end = p;
+      while (token_end < end && !is_separator(*token_end)) ++token_end;
+
+      const char* q = p;
+      if (q < token_end && (*q == '-' || *q == '+')) ++q;
+      if (q < token_end && *q == '.') ++q;
+      double value;
+      if ((q < token_end && is_digit(*q)) || parse_number(p, token_end, value) != p) ++count;
+      p = token_end;
+    }
+    return count;
+  }
+
+  // Whether the line holds a number equal to zero. Tokens starting with a nonzero digit and
+  // without an exponent cannot be zero, so only the others need a conversion.
+  bool has_zero(const char* begin, const char* end)
+  {
+    const char* p = begin;
+    while (p < end)
+    {
+      while (p < end && is_separator(*p)) ++p;
+      if (p == end) break;
+      const char* token_end = p;
+      while (token_end < end && !is_separator(*token_end)) ++token_end;
+
+      const char* q = p;
+      if (q < token_end && (*q == '-' || *q == '+')) ++q;
+      const bool nonzero = q < token_end && *q >= '1' && *q <= '9' &&
+        std::find_if(q, token_end, [](char c) { return c == 'e' || c == 'E'; }) == token_end;
+      double value;
+      if (!nonzero && parse_number(p, token_end, value) != p && value == 0.0) return true;
+      p = token_end;
+    }
+    return false;
+  }
+
+  // Rows of the file are found in parts of about this size, one task per part.
+  const size_t index_part_size = 1 << 20;
+}
+
+const char* SCIRun::parse_number(const char* begin, const char* end, double& value)
+{
+  const char* p = begin;
+  while (p < end && (*p == '\f' || *p == '\v')) ++p;
+  if (p == end) return begin;
+
+  // Same special cases, and the same spellings, as from_string()
+  if (starts_with(p, end, "nan") || starts_with(p, end, "NaN") || starts_with(p, end, "Nan") || starts_with(p, end, "NAN"))
+  {
+    value = std::numeric_limits<double>::quiet_NaN();
+    return p + 3;
+  }
+  if (starts_with(p, end, "inf") || starts_with(p, end, "Inf") || starts_with(p, end, "INF"))
+  {
+    value = std::numeric_limits<double>::infinity();
+    return p + 3;
+  }
+  if (starts_with(p, end, "-inf") || starts_with(p, end, "-Inf") || starts_with(p, end, "-INF"))
+  {
+    value = -std::numeric_limits<double>::infinity();
+    return p + 4;
+  }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  const char* q = p;
+  const bool negative = (q < end && *q == '-');
+  if (q < end && (*q == '-' || *q == '+')) ++q;
+  const bool hex = (end - q > 1 && q[0] == '0' && (q[1] == 'x' || q[1] == 'X'));
+  if (q < end && (is_digit(*q) || *q == '.') && !hex)
+  {
+    double result;
+    auto parsed = std::from_chars(q, end, result, std::chars_format::general);
+    if (parsed.ec == std::errc())
+    {
+      value = negative ? -result : result;
+      return parsed.ptr;
+    }
+  }
+#endif
+  return parse_with_strtod(begin, end, value);
+}
+
+const char* SCIRun::parse_number(const char* begin, const char* end, long long& value)
+{
+  // strtol with base 0
+  const char* p = begin;
+  while (p < end && (*p == '\f' || *p == '\v')) ++p;
+  const bool negative = (p < end && *p == '-');
+  if (p < end && (*p == '-' || *p == '+')) ++p;
+  if (p == end || !is_digit(*p)) return begin;
+
+  int base = 10;
+  if (*p == '0')
+  {
+    if (end - p > 2 && (p[1] == 'x' || p[1] == 'X') && is_hex_digit(p[2]))
+    {
+      base = 16;
+      p += 2;
+    }
+    else
+    {
+      base = 8;
+    }
+  }
+
+  unsigned long long magnitude;
+  auto parsed = std::from_chars(p, end, magnitude, base);
+  const unsigned long long limit = negative ?
+    static_cast<unsigned long long>(LLONG_MAX) + 1 : static_cast<unsigned long long>(LLONG_MAX);
+  if (parsed.ec == std::errc::result_out_of_range || magnitude > limit)
+    value = negative ? LLONG_MIN : LLONG_MAX;
+  else if (negative)
+    value = static_cast<long long>(0 - magnitude);
+  else
+    value = static_cast<long long>(magnitude);
+  return parsed.ptr;
+}
+
+void SCIRun::parse_numbers(const char* begin, const char* end, std::vector<double>& numbers)
+{
+  parse_numbers_impl(begin, end, numbers);
+}
+
+void SCIRun::parse_numbers(const char* begin, const char* end, std::vector<long long>& numbers)
+{
+  parse_numbers_impl(begin, end, numbers);
+}
+
+struct NumericTextFile::Mapping
+{
+  boost::interprocess::file_mapping file_;
+  boost::interprocess::mapped_region region_;
+};
+
+NumericTextFile::NumericTextFile(const std::string& filename)
+{
+  std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+  if (!file) return;
+  const std::streamoff size = file.tellg();
+  open_ = true;
+  if (size <= 0) return;
+
+  try
+  {
+    using namespace boost::interprocess;
+    std::unique_ptr<Mapping> mapping(new Mapping);
+    mapping->file_ = file_mapping(filename.c_str(), read_only);
+    mapping->region_ = mapped_region(mapping->file_, read_only);
+    mapping_ = std::move(mapping);
+    begin_ = static_cast<const char*>(mapping_->region_.get_address());
+    end_ = begin_ + mapping_->region_.get_size();
+  }
+  catch (const boost::interprocess::interprocess_exception&)
+  {
+    file.seekg(0);
+    contents_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    begin_ = contents_.data();
+    end_ = begin_ + contents_.size();
+  }
+
+  index_rows();
+}
+
+NumericTextFile::~NumericTextFile()
+{
+}
+
+const char* NumericTextFile::row_end(const char* row) const
+{
+  auto next = static_cast<const char*>(std::memchr(row, '\n', end_ - row));
+  return next ? next : end_;
+}
+
+void NumericTextFile::index_rows()
+{
+  const size_t size = end_ - begin_;
+  const size_t num_parts = (size + index_part_size - 1) / index_part_size;
+  std::vector<std::vector<std::uint64_t>> part_rows(num_parts);
+  std::vector<std::vector<std::uint32_t>> part_numbers(num_parts);
+
+  Core::Thread::Parallel::For(0, static_cast<std::int64_t>(num_parts), [&](std::int64_t first, std::int64_t last)
+  {
+    for (auto part = first; part < last; ++part)
+    {
+      // A part owns the lines that start inside it.
+      const char* part_begin = begin_ + part * index_part_size;
+      const char* part_end = begin_ + std::min(size, (part + 1) * index_part_size);
+      const char* line = part_begin;
+      if (line != begin_ && line[-1] != '\n')
+        line = row_end(line) + 1;
+
+      for (; line < part_end; line = row_end(line) + 1)
+      {
+        if (*line == '#' || *line == '%') continue;
+        const size_t count = count_numbers(line, row_end(line));
+        if (count == 0) continue;
+        part_rows[part].push_back(line - begin_);
+        part_numbers[part].push_back(static_cast<std::uint32_t>(count));
+      }
+    }
+  }, 1);
+
+  for (size_t part = 0; part < num_parts; ++part)
+  {
+    rows_.insert(rows_.end(), part_rows[part].begin(), part_rows[part].end());
+    numbers_.insert(numbers_.end(), part_numbers[part].begin(), part_numbers[part].end());
+  }
+}
+
+size_type NumericTextFile::columns(size_type first_row) const
+{
+  if (first_row >= num_rows()) return 0;
+  const auto count = numbers_[first_row];
+  for (auto row = first_row + 1; row < num_rows(); ++row)
+    if (numbers_[row] != count) return -1;
+  return count;
+}
+
+bool NumericTextFile::contains_zero(size_type first, size_type count) const
+{
+  std::atomic<bool> found(false);
+  Core::Thread::Parallel::For(first, first + count, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (auto row = begin; row < end && !found; ++row)
+    {
+      const char* line = begin_ + rows_[row];
+      if (has_zero(line, row_end(line))) found = true;
+    }
+  });
+  return found;
+}
+
+void NumericTextFile::read_row(size_type row, std::vector<double>& numbers) const
+{
+  const char* line = begin_ + rows_[row];
+  parse_numbers(line, row_end(line), numbers);
+}
+
+void NumericTextFile::read_row(size_type row, std::vector<long long>& numbers) const
+{
+  const char* line = begin_ + rows_[row];
+  parse_numbers(line, row_end(line), numbers);
+}
@@ -0,0 +1,113 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#ifndef CORE_IMPORTEXPORT_NUMERICTEXTFILE_H
+#define CORE_IMPORTEXPORT_NUMERICTEXTFILE_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Core/ImportExport/share.h>
+
+namespace SCIRun
+{
+  /// Parses the number at the start of [begin, end) with the rules the legacy from_string() applies
+  /// to a token: strtod syntax, including nan and inf, for floating point, and strtol with base 0
+  /// (0x1f is hex, 017 is octal) for integers. Unlike strtod it does not depend on the C locale.
+  /// Returns the end of the number, or begin if no number starts there.
+  SCISHARE const char* parse_number(const char* begin, const char* end, double& value);
+  SCISHARE const char* parse_number(const char* begin, const char* end, long long& value);
+
+  /// Parses all numbers in a line of text; tokens are separated by spaces, tabs, commas and
+  /// quotes, and tokens that do not start with a number are skipped.
+  SCISHARE void parse_numbers(const char* begin, const char* end, std::vector<double>& numbers);
+  SCISHARE void parse_numbers(const char* begin, const char* end, std::vector<long long>& numbers);
+
+  /// Text file of numbers, as read by the text importers: one row per line, lines starting with
+  /// '#' or '%' are comments and lines without numbers are skipped. The file is memory mapped and
+  /// split at line boundaries, so that finding the rows and parsing them both run on all cores.
+  class SCISHARE NumericTextFile
+  {
+  public:
+    explicit NumericTextFile(const std::string& filename);
+    ~NumericTextFile();
+
+    bool is_open() const { return open_; }
+
+    size_type num_rows() const { return static_cast<size_type>(rows_.size()); }
+    size_type num_numbers(size_type row) const { return numbers_[row]; }
+
+    /// SCIRun writes the number of rows as a single number on the first line of some formats.
+    bool has_count_header() const { return !numbers_.empty() && numbers_[0] == 1; }
+
+    /// Number of numbers on every row from first_row on, or -1 if the rows differ.
+    size_type columns(size_type first_row) const;
+
+    /// Whether any number in the rows [first, first+count) equals zero.
+    bool contains_zero(size_type first, size_type count) const;
+
+    void read_row(size_type row, std::vector<double>& numbers) const;
+    void read_row(size_type row, std::vector<long long>& numbers) const;
+
+    /// Calls function(row, numbers) for the rows [first, first+count) in parallel, with the numbers
+    /// of the row parsed as T. Calls for different rows may run concurrently.
+    template <class T, class RowFunction>
+    void for_each_row(size_type first, size_type count, RowFunction function) const
+    {
+      Core::Thread::Parallel::For(first, first + count, [&](std::int64_t begin, std::int64_t end)
+      {
+        std::vector<T> numbers;
+        for (auto row = begin; row < end; ++row)
+        {
+          read_row(row, numbers);
+          function(static_cast<size_type>(row), numbers);
+        }
+      });
+    }
+
+  private:
+    const char* row_end(const char* row) const;
+    void index_rows();
+
+    struct Mapping;
+    std::unique_ptr<Mapping> mapping_;
+    std::string contents_;
+    const char* begin_ = nullptr;
+    const char* end_ = nullptr;
+    bool open_ = false;
+    std::vector<std::uint64_t> rows_;
+    std::vector<std::uint32_t> numbers_;
+  };
+}
+
+#endif
@@ -68,6 +68,12 @@ namespace
   {
     return false;
   }
+  int compressionLevelWritten = -1;
+  bool fcompressedwriterDummy(Core::Logging::LoggerHandle pr, FieldHandle f, const char *filename, int level)
+  {
+    compressionLevelWritten = level;
+    return true;
+  }
   ColorMapHandle creaderDummy(Core::Logging::LoggerHandle pr, const char *filename)
   {
     return ColorMapHandle();
@@ -106,6 +112,19 @@ TEST(ImportExportPluginManagerTest, PluginsAddSelfToManagerField)
   EXPECT_EQ(0, mmanager.numPlugins());
 }
 
+TEST(ImportExportPluginManagerTest, CompressionLevelReachesCompressedWriter)
+{
+  FieldIEPluginLegacyAdapter plain("plain", ".fld", "", freaderDummy, fwriterDummy);
+  FieldIEPluginLegacyAdapter compressed("compressed", ".cfld", "", freaderDummy, fwriterDummy, fcompressedwriterDummy);
+
+  FieldIEPluginManager manager;
+  EXPECT_FALSE(manager.get_plugin("plain")->writeFile(FieldHandle(), "x.fld", 3, nullptr));
+  EXPECT_EQ(-1, compressionLevelWritten);
+  EXPECT_TRUE(manager.get_plugin("compressed")->writeFile(FieldHandle(), "x.cfld", 3, nullptr));
+  EXPECT_EQ(3, compressionLevelWritten);
+  EXPECT_FALSE(manager.get_plugin("compressed")->writeFile(FieldHandle(), "x.cfld", nullptr));
+}
+
 TEST(ImportExportPluginManagerTest, PluginsAddSelfToManagerColorMap)
 {
   ColorMapIEPluginLegacyAdapter dummy("dummy", ".color", "123", creaderDummy, cwriterDummy);
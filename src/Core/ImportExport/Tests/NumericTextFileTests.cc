@@ -0,0 +1,217 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/ImportExport/NumericTextFile.h>
+#include <Core/Utils/Legacy/StringUtil.h>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace SCIRun;
+
+namespace
+{
+  class NumericTextFileTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      dir_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("numeric-text-%%%%-%%%%");
+      boost::filesystem::create_directories(dir_);
+    }
+
+    void TearDown() override
+    {
+      boost::system::error_code ec;
+      boost::filesystem::remove_all(dir_, ec);
+    }
+
+    std::string write(const std::string& contents) const
+    {
+      const auto filename = (dir_ / "numbers.txt").string();
+      std::ofstream file(filename.c_str(), std::ios::binary);
+      file << contents;
+      return filename;
+    }
+
+    boost::filesystem::path dir_;
+  };
+
+  // What the text importers did with a line before they used NumericTextFile
+  template <class T>
+  std::vector<T> legacyParse(std::string line)
+  {
+    for (auto& c : line)
+      if (c == '\t' || c == ',' || c == '"') c = ' ';
+    std::vector<T> values;
+    multiple_from_string(line, values);
+    return values;
+  }
+
+  template <class T>
+  std::vector<T> parse(const std::string& line)
+  {
+    std::vector<T> values;
+    parse_numbers(line.data(), line.data() + line.size(), values);
+    return values;
+  }
+
+  const char* lines[] =
+  {
+    "1 2 3",
+    "1.5,2.5,3.5",
+    "\t-1e3\t+4.25e-2  ",
+    "\"7\",\"8\"",
+    "1 2 3\r",
+    "nan inf -inf NaN Nan NAN Inf INF -Inf -INF",
+    "infinity +inf -nan nanx",
+    "0x1A 010 -0x10 08 0x 0xg",
+    "1abc x2 3. -0",
+    ".5 -.5 5e 1e400 1e-400 4.9e-324",
+    "0x1p3 -0X.8",
+    "9223372036854775807 9223372036854775808 -9223372036854775808 -9223372036854775809",
+    "--5 +-5 - + . e5",
+    "123456789012345678901234567890",
+    "0.1 0.2 0.30000000000000004 1.7976931348623157e308",
+    "\v12 \f13 \vx \v",
+    "",
+    "   "
+  };
+}
+
+TEST(ParseNumbersTest, MatchesLegacyDoubleConversion)
+{
+  for (const std::string line : lines)
+  {
+    auto expected = legacyParse<double>(line);
+    auto actual = parse<double>(line);
+    ASSERT_EQ(expected.size(), actual.size()) << line;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+      if (std::isnan(expected[i]))
+        EXPECT_TRUE(std::isnan(actual[i])) << line;
+      else
+        EXPECT_EQ(0, std::memcmp(&expected[i], &actual[i], sizeof(double))) << line << " [" << i << "] " << expected[i] << " != " << actual[i];
+    }
+  }
+}
+
+TEST(ParseNumbersTest, MatchesLegacyIntegerConversion)
+{
+  for (const std::string line : lines)
+    EXPECT_EQ(legacyParse<long long>(line), parse<long long>(line)) << line;
+}
+
+TEST_F(NumericTextFileTest, SkipsCommentsAndLinesWithoutNumbers)
+{
+  NumericTextFile file(write("# comment 1 2 3\n1 2 3\n\n% 4 5\n  \nno numbers\n4,5,6\r\n 7\t8\t9"));
+  ASSERT_TRUE(file.is_open());
+  ASSERT_EQ(3, file.num_rows());
+  EXPECT_FALSE(file.has_count_header());
+  EXPECT_EQ(3, file.columns(0));
+
+  std::vector<double> row;
+  file.read_row(1, row);
+  EXPECT_EQ(std::vector<double>({ 4, 5, 6 }), row);
+  file.read_row(2, row);
+  EXPECT_EQ(std::vector<double>({ 7, 8, 9 }), row);
+}
+
+TEST_F(NumericTextFileTest, ReportsHeaderAndInconsistentRows)
+{
+  NumericTextFile file(write("3\n1 2 3 4\n5 6 7 8\n9 10 11\n"));
+  ASSERT_EQ(4, file.num_rows());
+  EXPECT_TRUE(file.has_count_header());
+  EXPECT_EQ(1, file.num_numbers(0));
+  EXPECT_EQ(3, file.num_numbers(3));
+  EXPECT_EQ(-1, file.columns(1));
+  EXPECT_EQ(3, file.columns(3));
+}
+
+TEST_F(NumericTextFileTest, FindsZerosLikeTheElementReaders)
+{
+  NumericTextFile file(write("1 2 3\n10 20 30\n4 -0.0 5\n6 0x0 7\n8 1e-400 9\n0.5 08 1e5\n"));
+  ASSERT_EQ(6, file.num_rows());
+  EXPECT_FALSE(file.contains_zero(0, 2));
+  EXPECT_TRUE(file.contains_zero(2, 1));
+  EXPECT_TRUE(file.contains_zero(3, 1));
+  EXPECT_TRUE(file.contains_zero(4, 1));
+  EXPECT_FALSE(file.contains_zero(5, 1));
+  EXPECT_TRUE(file.contains_zero(0, 6));
+}
+
+TEST_F(NumericTextFileTest, EmptyAndMissingFiles)
+{
+  NumericTextFile empty(write(""));
+  EXPECT_TRUE(empty.is_open());
+  EXPECT_EQ(0, empty.num_rows());
+  EXPECT_EQ(0, empty.columns(0));
+
+  NumericTextFile missing((dir_ / "missing.txt").string());
+  EXPECT_FALSE(missing.is_open());
+  EXPECT_EQ(0, missing.num_rows());
+}
+
+TEST_F(NumericTextFileTest, RowsSpanningSeveralMegabytes)
+{
+  // Long enough to be indexed in several parts, with rows straddling the part boundaries
+  const size_type n = 150000;
+  std::ostringstream contents;
+  contents.precision(17);
+  contents << "# header comment\n" << n << "\n";
+  for (size_type i = 0; i < n; ++i)
+  {
+    contents << i << ", " << 0.5 * i << ", " << -0.25 * i << ", " << 3 * i + 1 << "\n";
+    if (i % 1000 == 999) contents << "% comment\n\n";
+  }
+  NumericTextFile file(write(contents.str()));
+  ASSERT_GT(contents.str().size(), 3u << 20);
+  ASSERT_EQ(n + 1, file.num_rows());
+  EXPECT_TRUE(file.has_count_header());
+  EXPECT_EQ(4, file.columns(1));
+
+  std::vector<int> wrong(n, 0);
+  file.for_each_row<long long>(1, n, [&](index_type row, const std::vector<long long>& values)
+  {
+    const long long i = row - 1;
+    wrong[i] = !(values.size() == 4 && values[0] == i && values[1] == i / 2 && values[2] == -(i / 4) && values[3] == 3 * i + 1);
+  });
+  EXPECT_EQ(0, std::count(wrong.begin(), wrong.end(), 1));
+
+  std::vector<double> row;
+  file.read_row(n, row);
+  EXPECT_EQ(std::vector<double>({ n - 1.0, 0.5 * (n - 1), -0.25 * (n - 1), 3.0 * (n - 1) + 1 }), row);
+}
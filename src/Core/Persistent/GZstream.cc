@@ -41,6 +41,7 @@
 ///
 
 #include <Core/Persistent/GZstream.h>
+#include <Core/Persistent/Pstreams.h>
 
 #include <Core/Util/StringUtil.h>
 
@@ -559,8 +560,9 @@ GZPiostream::block_io(void *data, size_t s, size_t nmemb)
   if (err || version() == 1) { return false; }
   if (dir == Read)
   {
-    const size_t did = gzread(fp_, data, s * nmemb);
-    if (did != nmemb)
+    // gzread and gzwrite count bytes, not items.
+    const int did = gzread(fp_, data, static_cast<unsigned int>(s * nmemb));
+    if (did < 0 || static_cast<size_t>(did) != s * nmemb)
     {
       err = true;
       reporter_->error("GZPiostream error reading block io.");
@@ -568,8 +570,8 @@ GZPiostream::block_io(void *data, size_t s, size_t nmemb)
   }
   else
   {
-    const size_t did = gzwrite(fp_, data, s * nmemb);
-    if (did != nmemb)
+    const int did = gzwrite(fp_, data, static_cast<unsigned int>(s * nmemb));
+    if (did <= 0 || static_cast<size_t>(did) != s * nmemb)
     {
       err = true;
       reporter_->error("GZPiostream error writing block io.");
@@ -611,6 +613,16 @@ GZSwapPiostream::endianness()
     return "BIG\n";
 }
 
+bool
+GZSwapPiostream::block_io(void *data, size_t s, size_t nmemb)
+{
+  if (s != 1 && s != 2 && s != 4 && s != 8) { return false; }
+  if (!GZPiostream::block_io(data, s, nmemb)) { return false; }
+  if (dir == Read && !err) { swap_bytes(data, s, nmemb); }
+  return true;
+}
+
+
 template <class T>
 inline void
 GZSwapPiostream::gen_io(T& data, const char *iotype)
@@ -115,7 +115,7 @@ public:
   virtual void io(float&);
 
   virtual bool supports_block_io() { return false; }
-  virtual bool block_io(void*, size_t, size_t) { return false; }
+  virtual bool block_io(void*, size_t, size_t);
 };
 
 
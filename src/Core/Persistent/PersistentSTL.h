@@ -171,6 +171,43 @@ void Pio(Piostream& stream, std::vector<T>& data)
   stream.end_class();
 }
 
+//////////
+// Vectors of fixed size records made of VALUES values of type V, with
+// nothing else in memory (e.g. Point, three doubles). The layout on disk
+// is the one of the generic vector Pio above, but streams that support
+// block io move the whole array with one call instead of one per value.
+template <class V, size_t VALUES, class T>
+void Pio_packed(Piostream& stream, std::vector<T>& data)
+{
+  static_assert(sizeof(T) == VALUES * sizeof(V), "Pio_packed needs records without padding");
+
+  if (stream.reading() && stream.peek_class() == "Array1")
+  {
+    stream.begin_class("Array1", STLVECTOR_VERSION);
+  }
+  else
+  {
+    stream.begin_class("STLVector", STLVECTOR_VERSION);
+  }
+
+  int size=static_cast<int>(data.size());
+  stream.io(size);
+
+  if(stream.reading()){
+    data.resize(size);
+  }
+
+  if (size > 0 && !stream.block_io(&data.front(), sizeof(V), VALUES * data.size()))
+  {
+    for (int i = 0; i < size; i++)
+    {
+      Pio(stream, data[i]);
+    }
+  }
+
+  stream.end_class();
+}
+
 template <class T>
 void Pio(Piostream& stream, std::vector<T*>& data)
 {
@@ -52,6 +52,8 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sys/types.h>
@@ -71,6 +73,65 @@ using namespace SCIRun::Core::Logging;
 
 namespace SCIRun {
 
+namespace
+{
+  // Plain shifts and masks, compilers turn the loops below into vector
+  // byte shuffles.
+  inline uint16_t swap16(uint16_t v)
+  {
+    return static_cast<uint16_t>((v >> 8) | (v << 8));
+  }
+
+  inline uint32_t swap32(uint32_t v)
+  {
+    return ((v >> 24) & 0x000000ffu) | ((v >> 8) & 0x0000ff00u) |
+           ((v << 8) & 0x00ff0000u) | ((v << 24) & 0xff000000u);
+  }
+
+  inline uint64_t swap64(uint64_t v)
+  {
+    return (static_cast<uint64_t>(swap32(static_cast<uint32_t>(v))) << 32) |
+           swap32(static_cast<uint32_t>(v >> 32));
+  }
+
+  template <class T, class SWAP>
+  void swap_array(unsigned char *data, size_t nmemb, SWAP swap)
+  {
+    for (size_t i = 0; i < nmemb; i++)
+    {
+      T v;
+      memcpy(&v, data + i*sizeof(T), sizeof(T));
+      v = swap(v);
+      memcpy(data + i*sizeof(T), &v, sizeof(T));
+    }
+  }
+}
+
+void
+swap_bytes(void *data, size_t size, size_t nmemb)
+{
+  unsigned char *cdata = static_cast<unsigned char *>(data);
+  switch (size)
+  {
+    case 1:
+      break;
+    case 2:
+      swap_array<uint16_t>(cdata, nmemb, swap16);
+      break;
+    case 4:
+      swap_array<uint32_t>(cdata, nmemb, swap32);
+      break;
+    case 8:
+      swap_array<uint64_t>(cdata, nmemb, swap64);
+      break;
+    default:
+      for (size_t i = 0; i < nmemb; i++)
+      {
+        std::reverse(cdata + i*size, cdata + (i+1)*size);
+      }
+  }
+}
+
 // BinaryPiostream -- portable
   BinaryPiostream::BinaryPiostream(const std::string& filename, Direction dir,
     const int& v, LoggerHandle pr)
@@ -609,6 +670,19 @@ BinarySwapPiostream::endianness()
   return "LIT\n";
 }
 
+bool
+BinarySwapPiostream::block_io(void *data, size_t s, size_t nmemb)
+{
+  // Only scalars can be swapped as a block; records of several values (a
+  // Vector, say) have to go through io one value at a time.
+  if (s != 1 && s != 2 && s != 4 && s != 8) { return false; }
+  // Like gen_io, only swap what is read; files are written in native order.
+  if (!BinaryPiostream::block_io(data, s, nmemb)) { return false; }
+  if (dir == Direction::Read && !err) { swap_bytes(data, s, nmemb); }
+  return true;
+}
+
+
 template <class T>
 inline void
 BinarySwapPiostream::gen_io(T& data, const char *iotype)
@@ -48,6 +48,9 @@
 
 namespace SCIRun {
 
+/// Reverse the byte order of nmemb consecutive values of size bytes each.
+SCISHARE void swap_bytes(void* data, size_t size, size_t nmemb);
+
 class SCISHARE BinaryPiostream : public Piostream {
 protected:
   FILE* fp_;
@@ -109,7 +112,7 @@ public:
   void io(float&) override;
 
   bool supports_block_io() override { return false; }
-  bool block_io(void*, size_t, size_t) override { return false; }
+  bool block_io(void*, size_t, size_t) override;
 };
 
 
@@ -36,6 +36,9 @@
 #include <Core/Datatypes/DenseMatrix.h>
 // ReSharper disable once CppUnusedIncludeDirective
 #include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/String.h>
@@ -44,6 +47,9 @@
 #include <Core/Python/PythonDatatypeConverter.h>
 #include <Core/Algorithms/Base/VariableHelper.h>
 #include <boost/variant/apply_visitor.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms;
@@ -221,6 +227,276 @@ py::dict toPythonListSparse(const SparseRowMatrixGeneric<T>& sparse)
   list["values"] = values;
   return list;
 }
+
+// Python object exposing the memory of a datatype through the buffer protocol. It keeps the
+// datatype alive, and is read-only since datatypes are shared between modules.
+struct ArrayView
+{
+  PyObject_HEAD
+  DatatypeHandle* owner;
+  void* data;
+  const char* format;
+  Py_ssize_t itemsize;
+  int ndim;
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+};
+
+void deallocArrayView(PyObject* self)
+{
+  delete reinterpret_cast<ArrayView*>(self)->owner;
+  Py_TYPE(self)->tp_free(self);
+}
+
+int getArrayViewBuffer(PyObject* self, Py_buffer* buffer, int flags)
+{
+  auto view = reinterpret_cast<ArrayView*>(self);
+  buffer->obj = nullptr;
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+  {
+    PyErr_SetString(PyExc_BufferError, "SCIRun data is read-only, copy it before changing values");
+    return -1;
+  }
+  if ((flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS && view->ndim == 2 &&
+      view->shape[0] > 1 && view->shape[1] > 1)
+  {
+    PyErr_SetString(PyExc_BufferError, "SCIRun data is stored in row-major order");
+    return -1;
+  }
+
+  static double emptyData;
+  buffer->buf = view->data ? view->data : &emptyData;
+  buffer->obj = self;
+  Py_INCREF(self);
+  buffer->len = view->itemsize * view->shape[0] * (view->ndim == 2 ? view->shape[1] : 1);
+  buffer->readonly = 1;
+  buffer->itemsize = view->itemsize;
+  buffer->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(view->format) : nullptr;
+  const bool withShape = (flags & PyBUF_ND) == PyBUF_ND;
+  buffer->ndim = withShape ? view->ndim : 1;
+  buffer->shape = withShape ? view->shape : nullptr;
+  buffer->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? view->strides : nullptr;
+  buffer->suboffsets = nullptr;
+  buffer->internal = nullptr;
+  return 0;
+}
+
+PyTypeObject* arrayViewType()
+{
+  static PyBufferProcs bufferProcs = { getArrayViewBuffer, nullptr };
+  static PyTypeObject type = { PyVarObject_HEAD_INIT(nullptr, 0) };
+  if (!type.tp_name)
+  {
+    type.tp_name = "scirun.ArrayView";
+    type.tp_doc = "Read-only view of the values of a SCIRun matrix or field";
+    type.tp_basicsize = sizeof(ArrayView);
+    type.tp_dealloc = deallocArrayView;
+    type.tp_as_buffer = &bufferProcs;
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    if (PyType_Ready(&type) < 0)
+      py::throw_error_already_set();
+  }
+  return &type;
+}
+
+template <class T> const char* bufferFormat();
+template <> const char* bufferFormat<double>() { return "d"; }
+template <> const char* bufferFormat<long long>() { return "q"; }
+
+/// View of rows x columns values of the datatype, or of a vector of values when columns is -1.
+template <class T>
+py::object makeArrayView(const DatatypeHandle& owner, const T* data, Py_ssize_t rows, Py_ssize_t columns = -1)
+{
+  auto view = PyObject_New(ArrayView, arrayViewType());
+  if (!view)
+    py::throw_error_already_set();
+  view->owner = new DatatypeHandle(owner);
+  view->data = const_cast<T*>(data);
+  view->format = bufferFormat<T>();
+  view->itemsize = sizeof(T);
+  view->ndim = columns < 0 ? 1 : 2;
+  view->shape[0] = rows;
+  view->shape[1] = std::max<Py_ssize_t>(columns, 1);
+  view->strides[0] = view->ndim == 2 ? columns * view->itemsize : view->itemsize;
+  view->strides[1] = view->itemsize;
+  return py::object(py::handle<>(reinterpret_cast<PyObject*>(view)));
+}
+
+/// Follows memoryview and numpy base references to the ArrayView an object was made from.
+const ArrayView* findArrayView(const py::object& object)
+{
+  auto current = object;
+  for (int depth = 0; depth < 8 && !current.is_none(); ++depth)
+  {
+    if (Py_TYPE(current.ptr()) == arrayViewType())
+      return reinterpret_cast<const ArrayView*>(current.ptr());
+    if (PyMemoryView_Check(current.ptr()))
+    {
+      auto base = PyMemoryView_GET_BASE(current.ptr());
+      if (!base)
+        return nullptr;
+      current = py::object(py::handle<>(py::borrowed(base)));
+    }
+    else if (PyObject_HasAttrString(current.ptr(), "base"))
+      current = current.attr("base");
+    else
+      return nullptr;
+  }
+  return nullptr;
+}
+
+/// Read-only buffer of a Python object holding a vector or matrix of numbers, such as a numpy
+/// array or a memoryview. Values are copied out in row-major order, converting their type.
+class PythonBuffer
+{
+public:
+  explicit PythonBuffer(const py::object& object)
+  {
+    const auto ptr = object.ptr();
+    if (PyBytes_Check(ptr) || PyByteArray_Check(ptr) || !PyObject_CheckBuffer(ptr))
+      return;
+    if (PyObject_GetBuffer(ptr, &buffer_, PyBUF_RECORDS_RO) != 0)
+    {
+      PyErr_Clear();
+      return;
+    }
+    valid_ = true;
+    kind_ = numberKind();
+    if (buffer_.ndim < 1 || buffer_.ndim > 2 || kind_ == Kind::None)
+    {
+      PyBuffer_Release(&buffer_);
+      valid_ = false;
+    }
+  }
+
+  ~PythonBuffer()
+  {
+    if (valid_)
+      PyBuffer_Release(&buffer_);
+  }
+
+  PythonBuffer(const PythonBuffer&) = delete;
+  PythonBuffer& operator=(const PythonBuffer&) = delete;
+
+  bool valid() const { return valid_; }
+  bool isMatrix() const { return buffer_.ndim == 2; }
+  const void* data() const { return buffer_.buf; }
+  Py_ssize_t rows() const { return buffer_.shape[0]; }
+  Py_ssize_t columns() const { return isMatrix() ? buffer_.shape[1] : 1; }
+  bool contiguous() const { return PyBuffer_IsContiguous(&buffer_, 'C') != 0; }
+
+  /// Whether the buffer is exactly the memory of the view, with the same type and shape.
+  bool sameMemory(const ArrayView& view) const
+  {
+    return buffer_.buf == view.data && buffer_.ndim == view.ndim && buffer_.itemsize == view.itemsize &&
+      kind_ == (view.format[0] == 'd' ? Kind::Float : Kind::Signed) && contiguous() &&
+      rows() == view.shape[0] && columns() == (view.ndim == 2 ? view.shape[1] : 1);
+  }
+
+  template <class T>
+  void copyTo(T* destination) const
+  {
+    switch (kind_)
+    {
+    case Kind::Float:
+      if (buffer_.itemsize == sizeof(float)) copyAs<float>(destination);
+      else copyAs<double>(destination);
+      break;
+    case Kind::Signed:
+      switch (buffer_.itemsize)
+      {
+      case 1: copyAs<std::int8_t>(destination); break;
+      case 2: copyAs<std::int16_t>(destination); break;
+      case 4: copyAs<std::int32_t>(destination); break;
+      default: copyAs<std::int64_t>(destination); break;
+      }
+      break;
+    case Kind::Unsigned:
+      switch (buffer_.itemsize)
+      {
+      case 1: copyAs<std::uint8_t>(destination); break;
+      case 2: copyAs<std::uint16_t>(destination); break;
+      case 4: copyAs<std::uint32_t>(destination); break;
+      default: copyAs<std::uint64_t>(destination); break;
+      }
+      break;
+    case Kind::None:
+      break;
+    }
+  }
+
+private:
+  enum class Kind { None, Signed, Unsigned, Float };
+
+  // Native and little-endian struct formats of single numbers.
+  Kind numberKind() const
+  {
+    std::string format = buffer_.format ? buffer_.format : "B";
+    if (!format.empty() && (format[0] == '@' || format[0] == '=' || format[0] == '<'))
+      format.erase(0, 1);
+    if (format.size() != 1)
+      return Kind::None;
+    const auto size = buffer_.itemsize;
+    const bool integerSize = size == 1 || size == 2 || size == 4 || size == 8;
+    if (std::strchr("bhilqn", format[0]))
+      return integerSize ? Kind::Signed : Kind::None;
+    if (std::strchr("BHILQN?", format[0]))
+      return integerSize ? Kind::Unsigned : Kind::None;
+    if (std::strchr("fd", format[0]))
+      return size == 4 || size == 8 ? Kind::Float : Kind::None;
+    return Kind::None;
+  }
+
+  template <class S, class T>
+  void copyAs(T* destination) const
+  {
+    const auto source = static_cast<const char*>(buffer_.buf);
+    const auto n = rows(), m = columns();
+    if (std::is_same<S, T>::value && contiguous())
+    {
+      std::memcpy(destination, source, n * m * sizeof(T));
+      return;
+    }
+    const auto rowStride = buffer_.strides[0];
+    const auto columnStride = isMatrix() ? buffer_.strides[1] : 0;
+    for (Py_ssize_t i = 0; i < n; ++i)
+    {
+      for (Py_ssize_t j = 0; j < m; ++j)
+      {
+        S value;
+        std::memcpy(&value, source + i * rowStride + j * columnStride, sizeof(S));
+        *destination++ = static_cast<T>(value);
+      }
+    }
+  }
+
+  Py_buffer buffer_{};
+  bool valid_ = false;
+  Kind kind_ = Kind::None;
+};
+
+/// The view an object was made from, if the object still shows exactly the viewed memory.
+const ArrayView* unchangedArrayView(const py::object& object)
+{
+  auto view = findArrayView(object);
+  if (!view)
+    return nullptr;
+  PythonBuffer buffer(object);
+  return buffer.valid() && buffer.sameMemory(*view) ? view : nullptr;
+}
+
+template <class T>
+std::vector<T> numbersFromPython(const py::object& object)
+{
+  PythonBuffer buffer(object);
+  if (buffer.valid())
+  {
+    std::vector<T> numbers(buffer.rows() * buffer.columns());
+    buffer.copyTo(numbers.data());
+    return numbers;
+  }
+  return to_std_vector<T>(object);
+}
 }
 
 py::dict SCIRun::Core::Python::wrapDatatypesInMap(
@@ -307,6 +583,77 @@ py::dict SCIRun::Core::Python::convertMatrixToPython(SparseRowMatrixHandle matri
   return {};
 }
 
+py::object SCIRun::Core::Python::convertMatrixToPythonArray(DenseMatrixHandle matrix)
+{
+  if (matrix)
+    return makeArrayView(matrix, matrix->data(), matrix->nrows(), matrix->ncols());
+  return {};
+}
+
+py::dict SCIRun::Core::Python::convertMatrixToPythonArrays(SparseRowMatrixHandle matrix)
+{
+  if (!matrix)
+    return {};
+  if (!matrix->isCompressed())
+    return convertMatrixToPython(matrix);
+
+  py::dict arrays;
+  arrays["nrows"] = matrix->nrows();
+  arrays["ncols"] = matrix->ncols();
+  arrays["rows"] = makeArrayView(matrix, matrix->outerIndexPtr(), matrix->outerSize() + 1);
+  arrays["columns"] = makeArrayView(matrix, matrix->innerIndexPtr(), matrix->nonZeros());
+  arrays["values"] = makeArrayView(matrix, matrix->valuePtr(), matrix->nonZeros());
+  return arrays;
+}
+
+namespace {
+bool hasFieldArrays(const FieldHandle& field)
+{
+  auto mesh = field->vmesh();
+  auto vfield = field->vfield();
+  if (!mesh->is_unstructuredmesh() || !mesh->is_linearmesh() || vfield->is_nonlineardata() ||
+      !mesh->get_points_pointer())
+    return false;
+  if (!mesh->get_elems_pointer() && !mesh->is_pointcloudmesh())
+    return false;
+  return vfield->is_nodata() || (vfield->is_scalar() && vfield->is_double()) || vfield->is_vector();
+}
+}
+
+py::dict SCIRun::Core::Python::convertFieldToPythonArrays(FieldHandle field)
+{
+  if (!field)
+    return {};
+  if (!hasFieldArrays(field))
+    return convertFieldToPython(field);
+
+  FieldInformation info(field);
+  auto mesh = field->vmesh();
+  auto vfield = field->vfield();
+  py::dict arrays;
+  arrays["meshtype"] = info.get_mesh_type();
+  arrays["meshbasis"] = info.get_mesh_basis_type();
+  arrays["databasis"] = info.get_basis_type();
+  arrays["datatype"] = info.get_data_type();
+  arrays["node"] = makeArrayView(field, reinterpret_cast<const double*>(mesh->get_points_pointer()), mesh->num_nodes(), 3);
+  if (auto elems = mesh->get_elems_pointer())
+    arrays["elem"] = makeArrayView(field, elems, mesh->num_elems(), mesh->num_nodes_per_elem());
+  if (!vfield->is_nodata())
+  {
+    auto values = static_cast<const double*>(vfield->fdata_pointer());
+    if (vfield->is_vector())
+      arrays["data"] = makeArrayView(field, values, vfield->num_values(), 3);
+    else
+      arrays["data"] = makeArrayView(field, values, vfield->num_values());
+  }
+  return arrays;
+}
+
+bool SCIRun::Core::Python::isPythonBuffer(const py::object& object)
+{
+  return PythonBuffer(object).valid();
+}
+
 py::object SCIRun::Core::Python::convertStringToPython(StringHandle str)
 {
   if (str)
@@ -319,6 +666,9 @@ py::object SCIRun::Core::Python::convertStringToPython(StringHandle str)
 
 bool DenseMatrixExtractor::check() const
 {
+  if (isPythonBuffer(object_))
+    return true;
+
   py::extract<py::list> e(object_);
   if (!e.check()) return false;
 
@@ -332,8 +682,31 @@ bool DenseMatrixExtractor::check() const
   return false;
 }
 
+namespace {
+DenseMatrixHandle denseMatrixFromBuffer(const py::object& object)
+{
+  if (auto view = unchangedArrayView(object))
+  {
+    if (auto dense = std::dynamic_pointer_cast<DenseMatrix>(*view->owner))
+      if (dense->data() == view->data && static_cast<Py_ssize_t>(dense->nrows()) == view->shape[0] &&
+          static_cast<Py_ssize_t>(dense->ncols()) == view->shape[1])
+        return dense;
+  }
+
+  PythonBuffer buffer(object);
+  if (!buffer.valid())
+    throw std::invalid_argument("Attempted to convert into dense matrix but the array does not hold numbers.");
+  auto dense = makeShared<DenseMatrix>(buffer.rows(), buffer.columns());
+  buffer.copyTo(dense->data());
+  return dense;
+}
+}
+
 DatatypeHandle DenseMatrixExtractor::operator()() const
 {
+  if (isPythonBuffer(object_))
+    return denseMatrixFromBuffer(object_);
+
   DenseMatrixHandle dense;
   py::extract<py::list> e(object_);
   if (e.check())
@@ -401,12 +774,33 @@ bool SparseRowMatrixExtractor::check() const
 
     py::extract<py::list> value_i_list(values[i]);
     py::extract<size_t> value_i_int(values[i]);
-    if (!value_i_int.check() && !value_i_list.check()) return false;
+    if (!value_i_int.check() && !value_i_list.check() && !isPythonBuffer(values[i])) return false;
   }
 
   return true;
 }
 
+namespace {
+// The matrix a dictionary from convertMatrixToPythonArrays was made from, if its arrays are unchanged.
+SparseRowMatrixHandle unchangedSparseRowMatrix(const py::dict& arrays)
+{
+  auto rows = unchangedArrayView(arrays.get("rows"));
+  auto columns = unchangedArrayView(arrays.get("columns"));
+  auto values = unchangedArrayView(arrays.get("values"));
+  if (!rows || !columns || !values || *rows->owner != *columns->owner || *rows->owner != *values->owner)
+    return nullptr;
+
+  auto sparse = std::dynamic_pointer_cast<SparseRowMatrix>(*rows->owner);
+  py::extract<size_t> nrows(arrays.get("nrows")), ncols(arrays.get("ncols"));
+  if (!sparse || !nrows.check() || !ncols.check() ||
+      nrows() != static_cast<size_t>(sparse->nrows()) || ncols() != static_cast<size_t>(sparse->ncols()))
+    return nullptr;
+  if (rows->data != sparse->outerIndexPtr() || columns->data != sparse->innerIndexPtr() || values->data != sparse->valuePtr())
+    return nullptr;
+  return sparse;
+}
+}
+
 DatatypeHandle SparseRowMatrixExtractor::operator()() const
 {
   SparseRowMatrixHandle sparse;
@@ -416,6 +810,9 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
   py::extract<py::dict> e(object_);
   auto pyMatlabDict = e();
 
+  if (auto shared = unchangedSparseRowMatrix(pyMatlabDict))
+    return shared;
+
   auto length = len(pyMatlabDict);
 
   auto keys = pyMatlabDict.keys();
@@ -426,12 +823,11 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
   {
     py::extract<std::string> key_i(keys[i]);
 
-    py::extract<py::list> value_i_list(values[i]);
     auto fieldName = key_i();
-    if (fieldName == "rows") { rows = to_std_vector<index_type>(value_i_list()); }
+    if (fieldName == "rows") { rows = numbersFromPython<index_type>(values[i]); }
     else if (fieldName == "columns")
     {
-      columns = to_std_vector<index_type>(value_i_list());
+      columns = numbersFromPython<index_type>(values[i]);
     }
     else if (fieldName == "nrows")
     {
@@ -445,7 +841,7 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
     }
     else if (fieldName == "values")
     {
-      matrixValues = to_std_vector<double>(value_i_list());
+      matrixValues = numbersFromPython<double>(values[i]);
     }
   }
 
@@ -478,7 +874,7 @@ bool FieldExtractor::check() const
 
     py::extract<std::string> value_i_string(values[i]);
     py::extract<py::list> value_i_list(values[i]);
-    if (!value_i_string.check() && !value_i_list.check()) return false;
+    if (!value_i_string.check() && !value_i_list.check() && !isPythonBuffer(values[i])) return false;
   }
 
   return true;
@@ -532,8 +928,105 @@ matlabarray getPythonFieldDictionaryValue(
 }
 }
 
+namespace {
+std::string fieldArraysString(const py::dict& arrays, const char* key)
+{
+  py::extract<std::string> e(arrays.get(key));
+  if (!e.check())
+    throw std::invalid_argument(std::string("Field dictionary is missing the string \"") + key + "\".");
+  return e();
+}
+
+// The field a dictionary from convertFieldToPythonArrays was made from, if its arrays are unchanged.
+FieldHandle unchangedField(const py::dict& arrays, const FieldInformation& info)
+{
+  auto node = unchangedArrayView(arrays.get("node"));
+  if (!node)
+    return nullptr;
+  auto field = std::dynamic_pointer_cast<Field>(*node->owner);
+  if (!field || !hasFieldArrays(field) || node->data != field->vmesh()->get_points_pointer())
+    return nullptr;
+
+  FieldInformation fieldInfo(field);
+  if (fieldInfo.get_field_type_id() != info.get_field_type_id())
+    return nullptr;
+
+  auto sameArray = [&field](const py::object& object, const void* data)
+  {
+    if (!data)
+      return object.is_none();
+    auto view = unchangedArrayView(object);
+    return view && *view->owner == field && view->data == data;
+  };
+  auto vfield = field->vfield();
+  if (!sameArray(arrays.get("elem"), field->vmesh()->get_elems_pointer()) ||
+      !sameArray(arrays.get("data"), vfield->is_nodata() ? nullptr : vfield->fdata_pointer()))
+    return nullptr;
+  return field;
+}
+
+template <class T>
+void copyFieldArray(const py::dict& arrays, const char* key, Py_ssize_t columns, std::function<T*(size_type)> resize)
+{
+  PythonBuffer buffer(arrays.get(key));
+  if (!buffer.valid() || buffer.columns() != columns || (columns > 1 && !buffer.isMatrix()))
+    throw std::invalid_argument(std::string("Field array \"") + key + "\" must be an array of numbers with " +
+      std::to_string(columns) + " columns.");
+  buffer.copyTo(resize(buffer.rows()));
+}
+
+// Builds a field from the arrays of convertFieldToPythonArrays, copying them only if they changed.
+FieldHandle fieldFromArrays(const py::dict& arrays)
+{
+  FieldInformation info(fieldArraysString(arrays, "meshtype"), fieldArraysString(arrays, "meshbasis"),
+    fieldArraysString(arrays, "databasis"), fieldArraysString(arrays, "datatype"));
+  if (auto shared = unchangedField(arrays, info))
+    return shared;
+
+  auto field = CreateField(info);
+  if (!field)
+    throw std::invalid_argument("Could not create a field of type " + info.get_field_type_id());
+  auto mesh = field->vmesh();
+  auto vfield = field->vfield();
+  if (!mesh->is_unstructuredmesh() || !mesh->is_linearmesh() || vfield->is_nonlineardata() ||
+      !(vfield->is_nodata() || (vfield->is_scalar() && vfield->is_double()) || vfield->is_vector()))
+    throw std::invalid_argument("Field arrays only describe linear unstructured meshes with double or Vector data.");
+
+  copyFieldArray<double>(arrays, "node", 3, [mesh](size_type n)
+  {
+    mesh->resize_nodes(n);
+    return reinterpret_cast<double*>(mesh->get_points_pointer());
+  });
+  if (!mesh->is_pointcloudmesh())
+  {
+    copyFieldArray<index_type>(arrays, "elem", mesh->num_nodes_per_elem(), [mesh](size_type n)
+    {
+      mesh->resize_elems(n);
+      return mesh->get_elems_pointer();
+    });
+  }
+  if (!vfield->is_nodata())
+  {
+    vfield->resize_values();
+    copyFieldArray<double>(arrays, "data", vfield->is_vector() ? 3 : 1, [vfield](size_type n)
+    {
+      if (n != vfield->num_values())
+        throw std::invalid_argument("Field array \"data\" needs " + std::to_string(vfield->num_values()) + " values.");
+      return static_cast<double*>(vfield->fdata_pointer());
+    });
+  }
+  return field;
+}
+}
+
 DatatypeHandle FieldExtractor::operator()() const
 {
+  {
+    py::extract<py::dict> e(object_);
+    if (e().has_key("datatype"))
+      return fieldFromArrays(e());
+  }
+
   matlabarray ma;
   matlabconverter mc(nullptr);
   mc.converttostructmatrix();
@@ -609,6 +1102,11 @@ Variable SCIRun::Core::Python::convertPythonObjectToVariable(const py::object& o
       return makeVariable("list", newList);
     }
   }
+  {
+    DenseMatrixExtractor e(object);
+    if (isPythonBuffer(object) && e.check())
+      return makeDatatypeVariable(e);
+  }
   {
     SparseRowMatrixExtractor e(object);
     if (e.check())
@@ -91,6 +91,18 @@ namespace SCIRun
       SCISHARE boost::python::list convertMatrixToPython(Datatypes::DenseMatrixHandle matrix);
       SCISHARE boost::python::dict convertMatrixToPython(Datatypes::SparseRowMatrixHandle matrix);
       SCISHARE boost::python::object convertStringToPython(Datatypes::StringHandle str);
+
+      /// Read-only views of the values of matrices and fields through the Python buffer protocol,
+      /// so numpy.asarray() and memoryview() use SCIRun's memory instead of copying it. Scripts
+      /// copy an array (e.g. numpy.array()) before changing it; the extractors below take back
+      /// unchanged views without a copy. Sparse matrices give a dictionary like the list version
+      /// with arrays for rows, columns and values. Fields with linear unstructured meshes and
+      /// double or Vector data give "node", "elem" and "data" arrays plus their type names;
+      /// other fields use the list-based dictionary of convertFieldToPython.
+      SCISHARE boost::python::object convertMatrixToPythonArray(Datatypes::DenseMatrixHandle matrix);
+      SCISHARE boost::python::dict convertMatrixToPythonArrays(Datatypes::SparseRowMatrixHandle matrix);
+      SCISHARE boost::python::dict convertFieldToPythonArrays(FieldHandle field);
+      SCISHARE bool isPythonBuffer(const boost::python::object& object);
       SCISHARE boost::python::dict wrapDatatypesInMap(
         const std::vector<Datatypes::MatrixHandle>& matrices,
         const std::vector<FieldHandle>& fields,
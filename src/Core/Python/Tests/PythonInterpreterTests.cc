@@ -35,6 +35,9 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Matlab/matlabconverter.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Testing/Utils/SCIRunFieldSamples.h>
@@ -430,3 +433,186 @@ TEST_F(FieldConversionTests, RejectsIncompatibleDictionary)
 
   ASSERT_FALSE(converter.check());
 }
+
+namespace
+{
+  boost::python::object runPython(const std::string& code, boost::python::dict& variables)
+  {
+    boost::python::dict globals(boost::python::import("__main__").attr("__dict__"));
+    boost::python::exec(code.c_str(), globals, variables);
+    return variables.get("result");
+  }
+
+  SCIRun::Core::Datatypes::DenseMatrixHandle exampleDenseMatrix()
+  {
+    auto m = makeShared<SCIRun::Core::Datatypes::DenseMatrix>(3, 2);
+    *m << 1, 2,
+          3, 4,
+          5, 6.5;
+    return m;
+  }
+}
+
+TEST_F(FieldConversionTests, DenseMatrixArrayViewSharesMemory)
+{
+  auto m = exampleDenseMatrix();
+  boost::python::dict vars;
+  vars["view"] = convertMatrixToPythonArray(m);
+
+  auto result = runPython(
+    "mv = memoryview(view)\n"
+    "result = (mv.shape, mv.format, mv.readonly, mv.tolist())\n", vars);
+
+  EXPECT_EQ("((3, 2), 'd', True, [[1.0, 2.0], [3.0, 4.0], [5.0, 6.5]])",
+    boost::python::extract<std::string>(boost::python::str(result))());
+
+  DenseMatrixExtractor fromView(vars["view"]);
+  ASSERT_TRUE(fromView.check());
+  EXPECT_EQ(m, fromView());
+  DenseMatrixExtractor fromMemoryview(vars["mv"]);
+  EXPECT_EQ(m, fromMemoryview());
+}
+
+TEST_F(FieldConversionTests, ArrayViewsAreReadOnly)
+{
+  auto view = convertMatrixToPythonArray(exampleDenseMatrix());
+  Py_buffer buffer;
+  EXPECT_NE(0, PyObject_GetBuffer(view.ptr(), &buffer, PyBUF_WRITABLE));
+  EXPECT_TRUE(PyErr_ExceptionMatches(PyExc_BufferError));
+  PyErr_Clear();
+}
+
+TEST_F(FieldConversionTests, DenseMatrixFromChangedArrayIsCopied)
+{
+  auto m = exampleDenseMatrix();
+  boost::python::dict vars;
+  vars["view"] = convertMatrixToPythonArray(m);
+  runPython(
+    "import array\n"
+    "changed = memoryview(bytearray(memoryview(view).cast('B'))).cast('d', (3, 2))\n"
+    "ints = memoryview(array.array('i', [1, -2, 3, -4])).cast('B').cast('i', (2, 2))\n"
+    "column = memoryview(array.array('d', [1, 2, 3, 4, 5]))[::2]\n", vars);
+
+  auto copy = std::dynamic_pointer_cast<SCIRun::Core::Datatypes::DenseMatrix>(DenseMatrixExtractor(vars["changed"])());
+  ASSERT_TRUE(copy != nullptr);
+  EXPECT_NE(m, copy);
+  EXPECT_NE(m->data(), copy->data());
+  EXPECT_MATRIX_EQ(*copy, *m);
+
+  auto ints = std::dynamic_pointer_cast<SCIRun::Core::Datatypes::DenseMatrix>(DenseMatrixExtractor(vars["ints"])());
+  ASSERT_TRUE(ints != nullptr);
+  EXPECT_EQ(-2, (*ints)(0, 1));
+  EXPECT_EQ(-4, (*ints)(1, 1));
+
+  auto variable = convertPythonObjectToVariable(vars["column"]);
+  EXPECT_EQ(pyDenseMatrixLabel(), variable.name().name());
+  auto column = std::dynamic_pointer_cast<SCIRun::Core::Datatypes::DenseMatrix>(variable.getDatatype());
+  ASSERT_TRUE(column != nullptr);
+  ASSERT_EQ(3, column->nrows());
+  ASSERT_EQ(1, column->ncols());
+  EXPECT_EQ(5, (*column)(2, 0));
+}
+
+TEST_F(FieldConversionTests, SparseMatrixArrays)
+{
+  auto sparse = makeShared<SCIRun::Core::Datatypes::SparseRowMatrix>(3, 3);
+  sparse->insert(0, 0) = 1;
+  sparse->insert(1, 2) = 2;
+  sparse->insert(2, 1) = 3;
+  sparse->makeCompressed();
+
+  boost::python::dict vars;
+  vars["m"] = convertMatrixToPythonArrays(sparse);
+  auto result = runPython(
+    "result = (memoryview(m['rows']).tolist(), memoryview(m['columns']).tolist(), memoryview(m['values']).tolist())\n", vars);
+  EXPECT_EQ("([0, 1, 2, 3], [0, 2, 1], [1.0, 2.0, 3.0])",
+    boost::python::extract<std::string>(boost::python::str(result))());
+
+  SparseRowMatrixExtractor unchanged(vars["m"]);
+  ASSERT_TRUE(unchanged.check());
+  EXPECT_EQ(sparse, unchanged());
+
+  runPython(
+    "import array\n"
+    "m['values'] = memoryview(array.array('d', [4, 5, 6]))\n", vars);
+  SparseRowMatrixExtractor changed(vars["m"]);
+  ASSERT_TRUE(changed.check());
+  auto copy = std::dynamic_pointer_cast<SCIRun::Core::Datatypes::SparseRowMatrix>(changed());
+  ASSERT_TRUE(copy != nullptr);
+  EXPECT_EQ(5, copy->coeff(1, 2));
+  EXPECT_EQ(3, sparse->coeff(2, 1));
+}
+
+TEST_F(FieldConversionTests, TetVolFieldArrays)
+{
+  auto field = CubeTetVolLinearBasis(data_info_type::DOUBLE_E);
+  auto mesh = field->vmesh();
+  boost::python::dict vars;
+  vars["f"] = convertFieldToPythonArrays(field);
+  auto result = runPython(
+    "result = (f['meshtype'], f['datatype'], memoryview(f['node']).shape, memoryview(f['elem']).shape, memoryview(f['data']).shape)\n", vars);
+  std::ostringstream expected;
+  expected << "('TetVolMesh', 'double', (" << mesh->num_nodes() << ", 3), (" << mesh->num_elems() << ", 4), ("
+    << mesh->num_nodes() << ",))";
+  EXPECT_EQ(expected.str(), boost::python::extract<std::string>(boost::python::str(result))());
+
+  FieldExtractor unchanged(vars["f"]);
+  ASSERT_TRUE(unchanged.check());
+  EXPECT_EQ(field, unchanged());
+
+  runPython(
+    "import array\n"
+    "f['data'] = memoryview(array.array('d', range(len(memoryview(f['data'])))))\n", vars);
+  auto copy = std::dynamic_pointer_cast<Field>(FieldExtractor(vars["f"])());
+  ASSERT_TRUE(copy != nullptr);
+  ASSERT_NE(field, copy);
+  FieldInformation info(copy);
+  EXPECT_EQ(FieldInformation(field).get_field_type_id(), info.get_field_type_id());
+  ASSERT_EQ(mesh->num_nodes(), copy->vmesh()->num_nodes());
+  ASSERT_EQ(mesh->num_elems(), copy->vmesh()->num_elems());
+  for (VMesh::Node::index_type i = 0; i < mesh->num_nodes(); ++i)
+  {
+    Geometry::Point p, q;
+    mesh->get_center(p, i);
+    copy->vmesh()->get_center(q, i);
+    EXPECT_EQ(p, q);
+    double value;
+    copy->vfield()->get_value(value, i);
+    EXPECT_EQ(i, value);
+  }
+  VMesh::Node::array_type expectedNodes, actualNodes;
+  mesh->get_nodes(expectedNodes, VMesh::Elem::index_type(3));
+  copy->vmesh()->get_nodes(actualNodes, VMesh::Elem::index_type(3));
+  EXPECT_EQ(expectedNodes, actualNodes);
+}
+
+TEST_F(FieldConversionTests, VectorFieldArraysRoundTrip)
+{
+  auto field = CubeTriSurfConstantBasis(data_info_type::VECTOR_E);
+  for (VMesh::Elem::index_type i = 0; i < field->vmesh()->num_elems(); ++i)
+    field->vfield()->set_value(Geometry::Vector(i, 2 * i, 3 * i), i);
+
+  boost::python::dict vars;
+  vars["f"] = convertFieldToPythonArrays(field);
+  runPython(
+    "import array\n"
+    "f['node'] = memoryview(bytearray(memoryview(f['node']).cast('B'))).cast('d', memoryview(f['node']).shape)\n"
+    "result = memoryview(f['data']).tolist()[2]\n", vars);
+  EXPECT_EQ("[2.0, 4.0, 6.0]", boost::python::extract<std::string>(boost::python::str(vars["result"]))());
+
+  auto copy = std::dynamic_pointer_cast<Field>(FieldExtractor(vars["f"])());
+  ASSERT_TRUE(copy != nullptr);
+  ASSERT_NE(field, copy);
+  EXPECT_TRUE(copy->vfield()->is_vector());
+  EXPECT_TRUE(copy->vfield()->is_constantdata());
+  Geometry::Vector v;
+  copy->vfield()->get_value(v, VMesh::Elem::index_type(5));
+  EXPECT_EQ(Geometry::Vector(5, 10, 15), v);
+}
+
+TEST_F(FieldConversionTests, StructuredFieldArraysUseMatlabDictionary)
+{
+  auto pyField = convertFieldToPythonArrays(CreateEmptyLatVol());
+  EXPECT_EQ(9, len(pyField.items()));
+  EXPECT_FALSE(pyField.has_key("datatype"));
+}
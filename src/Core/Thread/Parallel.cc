@@ -27,36 +27,207 @@
 
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/ThreadPool.h>
 #include <Core/Logging/Log.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <iostream>
 
 using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Logging;
 
+namespace
+{
+  class CompletionLatch : boost::noncopyable
+  {
+  public:
+    explicit CompletionLatch(std::int64_t count) : remaining_(count) {}
+
+    void countDown(std::exception_ptr error = nullptr)
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      if (error && !error_)
+        error_ = error;
+      if (0 == --remaining_)
+        done_.notify_all();
+    }
+
+    void wait()
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      done_.wait(lock, [this]() { return remaining_ <= 0; });
+    }
+
+    bool failed() const
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      return static_cast<bool>(error_);
+    }
+
+    void rethrowIfFailed() const
+    {
+      if (error_)
+        std::rethrow_exception(error_);
+    }
+
+  private:
+    mutable std::mutex lock_;
+    std::condition_variable done_;
+    std::int64_t remaining_;
+    std::exception_ptr error_;
+  };
+
+  // Shared between the caller and its helpers, so a helper that only starts after the loop is
+  // finished finds no chunks left and never touches the caller's (by then destroyed) task.
+  struct ChunkedLoop
+  {
+    ChunkedLoop(std::int64_t numChunks, const std::function<void(std::int64_t)>& task) :
+      next(0), numChunks(numChunks), task(task), latch(numChunks) {}
+
+    void work()
+    {
+      for (auto chunk = next++; chunk < numChunks; chunk = next++)
+      {
+        if (latch.failed())
+        {
+          latch.countDown();
+          continue;
+        }
+        try
+        {
+          task(chunk);
+          latch.countDown();
+        }
+        catch (...)
+        {
+          latch.countDown(std::current_exception());
+        }
+      }
+    }
+
+    std::atomic<std::int64_t> next;
+    const std::int64_t numChunks;
+    std::function<void(std::int64_t)> task;
+    CompletionLatch latch;
+  };
+
+  thread_local unsigned int threadCoreBudget_ = std::numeric_limits<unsigned int>::max();
+}
+
 void Parallel::RunTasks(IndexedTask task, int numProcs)
 {
-  ThreadGroup threads;
+  const int n = static_cast<int>(capByUserCoreCount(std::max(numProcs, 0)));
+  if (n <= 0)
+    return;
+
+  const auto budgetPerTask = std::max(1u, NumCores() / n);
+  CompletionLatch latch(n - 1);
+  std::vector<ThreadPool::Job> jobs;
+  for (int i = 1; i < n; ++i)
+  {
+    jobs.emplace_back([&task, &latch, i, budgetPerTask]()
+    {
+      try
+      {
+        ScopedCoreBudget budget(budgetPerTask);
+        task(i);
+        latch.countDown();
+      }
+      catch (...)
+      {
+        latch.countDown(std::current_exception());
+      }
+    });
+  }
+  ThreadPool::global().submit(std::move(jobs), true, 0);
+
+  std::exception_ptr error;
+  try
+  {
+    ScopedCoreBudget budget(budgetPerTask);
+    task(0);
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+  latch.wait();
+
+  if (error)
+    std::rethrow_exception(error);
+  latch.rethrowIfFailed();
+}
+
+void Parallel::For(std::int64_t begin, std::int64_t end, RangeTask task, std::int64_t grainSize)
+{
+  const auto grain = chunkSize(begin, end, grainSize);
+  const auto numChunks = end > begin ? (end - begin + grain - 1) / grain : 0;
+  RunChunks(numChunks, [&](std::int64_t chunk)
+  {
+    const auto chunkBegin = begin + chunk * grain;
+    task(chunkBegin, std::min(end, chunkBegin + grain));
+  });
+}
 
-  for (unsigned int i = 0; i < capByUserCoreCount(numProcs); ++i)
+std::int64_t Parallel::chunkSize(std::int64_t begin, std::int64_t end, std::int64_t grainSize)
+{
+  if (grainSize > 0)
+    return grainSize;
+  // fixed chunk count, so default-grain reductions give the same answer on every machine.
+  const std::int64_t defaultChunks = 256;
+  return std::max<std::int64_t>(1, (end - begin + defaultChunks - 1) / defaultChunks);
+}
+
+void Parallel::RunChunks(std::int64_t numChunks, const std::function<void(std::int64_t)>& chunkTask)
+{
+  if (numChunks <= 0)
+    return;
+
+  const auto numThreads = std::min<std::int64_t>(NumCores(), numChunks);
+  if (numThreads <= 1)
   {
-    threads.create_thread(task, i);
+    for (std::int64_t chunk = 0; chunk < numChunks; ++chunk)
+      chunkTask(chunk);
+    return;
   }
 
-  //try
-  //{
-    threads.join_all();
-  //}
-  //catch (std::thread_interrupted&)
-  //{
-  //  threads.interrupt_all();
-  //  throw;
-  //}
+  // every thread of the loop already occupies a core, so parallel regions nested in a chunk run serially.
+  // The calling thread claims chunks too, so the loop finishes even if no helper ever gets a worker;
+  // once it runs out of chunks, helpers still queued are withdrawn and it only waits for chunks in progress.
+  auto loop = std::make_shared<ChunkedLoop>(numChunks, chunkTask);
+  std::vector<ThreadPool::Job> helpers;
+  for (std::int64_t i = 1; i < numThreads; ++i)
+    helpers.emplace_back([loop]() { ScopedCoreBudget budget(1); loop->work(); });
+  auto& pool = ThreadPool::global();
+  pool.submitHelpers(loop.get(), std::move(helpers), NumCores() - 1);
+
+  {
+    ScopedCoreBudget budget(1);
+    loop->work();
+  }
+  pool.withdraw(loop.get());
+  loop->latch.wait();
+  loop->latch.rethrowIfFailed();
 }
 
 unsigned int Parallel::NumCores()
 {
-  return capByUserCoreCount(std::thread::hardware_concurrency());
+  return std::max(1u, std::min(capByUserCoreCount(std::thread::hardware_concurrency()), threadCoreBudget_));
+}
+
+Parallel::ScopedCoreBudget::ScopedCoreBudget(unsigned int cores) : previous_(threadCoreBudget_)
+{
+  threadCoreBudget_ = std::max(1u, std::min(cores, previous_));
+}
+
+Parallel::ScopedCoreBudget::~ScopedCoreBudget()
+{
+  threadCoreBudget_ = previous_;
 }
 
 void Parallel::SetMaximumCores(unsigned int max)
@@ -30,6 +30,8 @@
 #define CORE_THREAD_PARLLEL_H
 
 #include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <thread>
 #include <vector>
 #include <functional>
@@ -45,12 +47,58 @@ namespace Thread
   {
   public:
     typedef std::function<void(int)> IndexedTask;
+    typedef std::function<void(std::int64_t, std::int64_t)> RangeTask;
+
+    /// Runs task(0)..task(numProcs-1) concurrently on the persistent thread pool, with the calling
+    /// thread taking index 0. numProcs is capped by SetMaximumCores. Tasks may wait on each other,
+    /// e.g. through a Barrier.
     static void RunTasks(IndexedTask task, int numProcs);
+
+    /// Splits [begin, end) into chunks of grainSize indices (0 picks a default) and hands them out
+    /// dynamically to at most NumCores() threads, including the calling thread. Chunks must be
+    /// independent of each other.
+    static void For(std::int64_t begin, std::int64_t end, RangeTask task, std::int64_t grainSize = 0);
+
+    /// Like For, but each chunk returns reduceChunk(chunkBegin, chunkEnd, identity), and the partial
+    /// results are combined in chunk order. The result depends only on the grain size, never on the
+    /// number of threads or on timing.
+    template <typename T, class ChunkReduce, class Combine>
+    static T Reduce(std::int64_t begin, std::int64_t end, const T& identity, ChunkReduce reduceChunk, Combine combine, std::int64_t grainSize = 0)
+    {
+      const auto grain = chunkSize(begin, end, grainSize);
+      const auto numChunks = end > begin ? (end - begin + grain - 1) / grain : 0;
+      std::vector<T> partials(numChunks, identity);
+      RunChunks(numChunks, [&](std::int64_t chunk)
+      {
+        const auto chunkBegin = begin + chunk * grain;
+        partials[chunk] = reduceChunk(chunkBegin, std::min(end, chunkBegin + grain), identity);
+      });
+      T result = identity;
+      for (const auto& partial : partials)
+        result = combine(result, partial);
+      return result;
+    }
+
+    /// Cores the calling thread may use: the hardware count, capped by SetMaximumCores and by the
+    /// thread's core budget. Work started through RunTasks or For inherits a share of the caller's
+    /// budget, so nested parallel regions split the cores instead of multiplying threads.
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
+
+    /// Limits NumCores() on the current thread for the lifetime of the object; budgets only shrink.
+    class SCISHARE ScopedCoreBudget : public boost::noncopyable
+    {
+    public:
+      explicit ScopedCoreBudget(unsigned int cores);
+      ~ScopedCoreBudget();
+    private:
+      unsigned int previous_;
+    };
   private:
     static unsigned int maximumCoresSetByUser_;
     static unsigned int capByUserCoreCount(unsigned int numProcs);
+    static std::int64_t chunkSize(std::int64_t begin, std::int64_t end, std::int64_t grainSize);
+    static void RunChunks(std::int64_t numChunks, const std::function<void(std::int64_t)>& chunkTask);
   };
 
   class SCISHARE ThreadGroup : public boost::noncopyable
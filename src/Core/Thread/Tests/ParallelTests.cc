@@ -28,9 +28,15 @@
 
 #include <gtest/gtest.h>
 #include <numeric>
+#include <set>
 #include <fstream>
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/ThreadPool.h>
+#include <Core/Thread/Barrier.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <boost/filesystem/path.hpp>
 #include <Testing/Utils/SCIRunUnitTests.h>
 
@@ -52,6 +58,202 @@ TEST(ParallelTests, CanDoubleNumberInParallel)
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 }
 
+TEST(ParallelTests, RunTasksReusesPoolThreads)
+{
+  std::atomic<int> count(0);
+  Parallel::RunTasks([&](int) { ++count; }, 4);
+  const auto workers = ThreadPool::global().numWorkers();
+  for (int i = 0; i < 100; ++i)
+    Parallel::RunTasks([&](int) { ++count; }, 4);
+  EXPECT_EQ(404, count);
+  EXPECT_EQ(workers, ThreadPool::global().numWorkers());
+}
+
+TEST(ParallelTests, RunTasksRunsAllTasksConcurrently)
+{
+  // more tasks than cores, all meeting at a barrier: deadlocks unless every task gets its own thread.
+  const int numTasks = Parallel::NumCores() + 3;
+  Barrier barrier("RunTasksRunsAllTasksConcurrently", numTasks);
+  std::vector<int> visited(numTasks, 0);
+  Parallel::RunTasks([&](int i) { barrier.wait(); visited[i] = 1; barrier.wait(); }, numTasks);
+  EXPECT_EQ(numTasks, std::accumulate(visited.begin(), visited.end(), 0));
+}
+
+TEST(ParallelTests, RunTasksPropagatesExceptions)
+{
+  EXPECT_THROW(Parallel::RunTasks([](int i) { if (i == 1) throw std::runtime_error("task failed"); }, 2), std::runtime_error);
+  EXPECT_THROW(Parallel::RunTasks([](int i) { if (i == 0) throw std::runtime_error("task failed"); }, 2), std::runtime_error);
+}
+
+TEST(ParallelTests, ForVisitsEveryIndexOnce)
+{
+  const int size = 100003;
+  std::vector<int> visits(size, 0);
+  Parallel::For(0, size, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (auto i = begin; i < end; ++i)
+      visits[i]++;
+  });
+  EXPECT_EQ(size, std::count(visits.begin(), visits.end(), 1));
+
+  std::fill(visits.begin(), visits.end(), 0);
+  Parallel::For(10, 20, [&](std::int64_t begin, std::int64_t end)
+  {
+    for (auto i = begin; i < end; ++i)
+      visits[i]++;
+  }, 3);
+  EXPECT_EQ(10, std::accumulate(visits.begin(), visits.end(), 0));
+  EXPECT_EQ(1, visits[10]);
+  EXPECT_EQ(1, visits[19]);
+  EXPECT_EQ(0, visits[20]);
+}
+
+TEST(ParallelTests, ForHandlesEmptyRange)
+{
+  bool called = false;
+  Parallel::For(5, 5, [&](std::int64_t, std::int64_t) { called = true; });
+  Parallel::For(5, 2, [&](std::int64_t, std::int64_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST(ParallelTests, ForCanNestInsideRunTasks)
+{
+  std::atomic<std::int64_t> total(0);
+  Parallel::RunTasks([&](int)
+  {
+    Parallel::For(0, 1000, [&](std::int64_t begin, std::int64_t end) { total += end - begin; }, 7);
+  }, 3);
+  EXPECT_EQ(3000, total);
+}
+
+TEST(ParallelTests, ForPropagatesExceptions)
+{
+  EXPECT_THROW(Parallel::For(0, 1000, [](std::int64_t begin, std::int64_t) { if (begin == 500) throw std::runtime_error("chunk failed"); }, 10),
+    std::runtime_error);
+}
+
+TEST(ParallelTests, ReduceIsDeterministic)
+{
+  const int size = 1000000;
+  std::vector<double> values(size);
+  for (int i = 0; i < size; ++i)
+    values[i] = 1.0 / (i + 1);
+
+  auto sumChunk = [&](std::int64_t begin, std::int64_t end, double init)
+  {
+    for (auto i = begin; i < end; ++i)
+      init += values[i];
+    return init;
+  };
+  const auto first = Parallel::Reduce(0, size, 0.0, sumChunk, std::plus<double>());
+
+  // same grouping evaluated serially
+  const std::int64_t grain = (size + 255) / 256;
+  double serial = 0;
+  for (std::int64_t begin = 0; begin < size; begin += grain)
+    serial += sumChunk(begin, std::min<std::int64_t>(size, begin + grain), 0.0);
+  EXPECT_EQ(serial, first);
+
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(first, Parallel::Reduce(0, size, 0.0, sumChunk, std::plus<double>()));
+
+  EXPECT_EQ(size, Parallel::Reduce(0, size, 0, [](std::int64_t b, std::int64_t e, int init) { return init + static_cast<int>(e - b); }, std::plus<int>(), 13));
+}
+
+TEST(ParallelTests, ForRespectsMaximumCores)
+{
+  Parallel::SetMaximumCores(1);
+  std::set<std::thread::id> threads;
+  Parallel::For(0, 1000, [&](std::int64_t, std::int64_t) { threads.insert(std::this_thread::get_id()); }, 1);
+  Parallel::SetMaximumCores(0);
+  EXPECT_EQ(1, threads.size());
+  EXPECT_EQ(1, threads.count(std::this_thread::get_id()));
+}
+
+TEST(ParallelTests, CoreBudgetLimitsNumCoresOnCurrentThread)
+{
+  const auto cores = Parallel::NumCores();
+  {
+    Parallel::ScopedCoreBudget budget(1);
+    EXPECT_EQ(1, Parallel::NumCores());
+    {
+      // budgets only shrink
+      Parallel::ScopedCoreBudget wider(cores + 4);
+      EXPECT_EQ(1, Parallel::NumCores());
+    }
+    std::set<std::thread::id> threads;
+    Parallel::For(0, 1000, [&](std::int64_t, std::int64_t) { threads.insert(std::this_thread::get_id()); }, 1);
+    EXPECT_EQ(1, threads.size());
+  }
+  EXPECT_EQ(cores, Parallel::NumCores());
+
+  std::thread other([&]() { EXPECT_EQ(cores, Parallel::NumCores()); });
+  Parallel::ScopedCoreBudget budget(1);
+  other.join();
+}
+
+TEST(ParallelTests, NestedRegionsShareTheCallersBudget)
+{
+  const unsigned int outerBudget = 8;
+  const int numTasks = 3;
+  Parallel::ScopedCoreBudget budget(outerBudget);
+  const auto expectedPerTask = std::max(1u, Parallel::NumCores() / numTasks);
+
+  std::vector<unsigned int> taskCores(numTasks, 0);
+  Parallel::RunTasks([&](int i) { taskCores[i] = Parallel::NumCores(); }, numTasks);
+  EXPECT_EQ(std::vector<unsigned int>(numTasks, expectedPerTask), taskCores);
+
+  std::atomic<unsigned int> maxChunkCores(0);
+  Parallel::For(0, 100, [&](std::int64_t, std::int64_t)
+  {
+    auto cores = Parallel::NumCores();
+    auto seen = maxChunkCores.load();
+    while (cores > seen && !maxChunkCores.compare_exchange_weak(seen, cores)) {}
+  }, 1);
+  EXPECT_EQ(1, maxChunkCores);
+  EXPECT_LE(Parallel::NumCores(), outerBudget);
+}
+
+TEST(ParallelTests, HelpersNeverOutgrowTheirWorkerCap)
+{
+  ThreadPool pool;
+  std::mutex lock;
+  std::condition_variable released;
+  bool release = false;
+  std::atomic<bool> started(false);
+  std::vector<ThreadPool::Job> blocking;
+  blocking.emplace_back([&]()
+  {
+    started = true;
+    std::unique_lock<std::mutex> l(lock);
+    released.wait(l, [&]() { return release; });
+  });
+  pool.submit(std::move(blocking), true, 0);
+  while (!started)
+    std::this_thread::yield();
+
+  std::atomic<int> helpersRun(0);
+  int owner;
+  std::vector<ThreadPool::Job> helpers(10, [&]() { ++helpersRun; });
+  pool.submitHelpers(&owner, std::move(helpers), 1);
+  EXPECT_EQ(1, pool.numWorkers());
+
+  pool.withdraw(&owner);
+  {
+    std::lock_guard<std::mutex> l(lock);
+    release = true;
+  }
+  released.notify_all();
+  while (pool.numIdleWorkers() < 1)
+    std::this_thread::yield();
+  std::vector<ThreadPool::Job> last(1, [&]() { ++helpersRun; });
+  pool.submit(std::move(last), true, 0);
+  while (helpersRun == 0)
+    std::this_thread::yield();
+  EXPECT_EQ(1, helpersRun);
+  EXPECT_EQ(1, pool.numWorkers());
+}
+
 /// @todo
 #if 0
 TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
@@ -0,0 +1,144 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Thread/ThreadPool.h>
+#include <algorithm>
+
+using namespace SCIRun::Core::Thread;
+
+ThreadPool& ThreadPool::global()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::ThreadPool() : idleWorkers_(0), stopping_(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    stopping_ = true;
+  }
+  jobAvailable_.notify_all();
+  for (auto& worker : workers_)
+  {
+    if (worker.joinable())
+      worker.join();
+  }
+}
+
+void ThreadPool::submit(std::vector<Job>&& jobs, bool requireConcurrency, size_t maxWorkers)
+{
+  if (jobs.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    for (auto& job : jobs)
+      jobs_.push_back(std::move(job));
+
+    while (idleWorkers_ < jobs_.size() && (requireConcurrency || workers_.size() < maxWorkers))
+      startWorker();
+  }
+  jobAvailable_.notify_all();
+}
+
+void ThreadPool::submitHelpers(const void* owner, std::vector<Job>&& jobs, size_t maxWorkers)
+{
+  if (jobs.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    for (auto& job : jobs)
+      helpers_.emplace_back(owner, std::move(job));
+
+    while (idleWorkers_ < jobs_.size() + helpers_.size() && workers_.size() < maxWorkers)
+      startWorker();
+  }
+  jobAvailable_.notify_all();
+}
+
+void ThreadPool::withdraw(const void* owner)
+{
+  std::lock_guard<std::mutex> g(lock_);
+  helpers_.erase(std::remove_if(helpers_.begin(), helpers_.end(),
+    [owner](const std::pair<const void*, Job>& helper) { return helper.first == owner; }), helpers_.end());
+}
+
+size_t ThreadPool::numWorkers() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return workers_.size();
+}
+
+size_t ThreadPool::numIdleWorkers() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return idleWorkers_;
+}
+
+void ThreadPool::startWorker()
+{
+  // counted as idle from the start, so a burst of submissions does not over-spawn.
+  ++idleWorkers_;
+  workers_.emplace_back([this]() { workerLoop(); });
+}
+
+void ThreadPool::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true)
+  {
+    jobAvailable_.wait(lock, [this]() { return stopping_ || !jobs_.empty() || !helpers_.empty(); });
+    if (jobs_.empty() && helpers_.empty())
+      break;
+
+    // submitted jobs first: each of them was promised a thread, helpers are optional.
+    Job job;
+    if (!jobs_.empty())
+    {
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    else
+    {
+      job = std::move(helpers_.front().second);
+      helpers_.pop_front();
+    }
+    --idleWorkers_;
+    lock.unlock();
+
+    job();
+
+    lock.lock();
+    ++idleWorkers_;
+  }
+}
@@ -0,0 +1,91 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_THREAD_THREADPOOL_H
+#define CORE_THREAD_THREADPOOL_H
+
+#include <boost/noncopyable.hpp>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <Core/Thread/share.h>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  // Process-wide set of persistent worker threads behind Parallel::RunTasks and Parallel::For.
+  // Workers are started lazily and reused, so short parallel regions do not pay for thread creation.
+  class SCISHARE ThreadPool : public boost::noncopyable
+  {
+  public:
+    using Job = std::function<void()>;
+
+    static ThreadPool& global();
+
+    ThreadPool();
+    ~ThreadPool();
+
+    // Queues jobs. With requireConcurrency, enough workers are started that every queued job
+    // has an idle thread to run on--needed when jobs synchronize with each other (e.g. on a Barrier).
+    // Otherwise at most maxWorkers threads are started and jobs may wait in the queue.
+    void submit(std::vector<Job>&& jobs, bool requireConcurrency, size_t maxWorkers);
+
+    // Queues optional jobs that help with work the submitting thread also does itself (the chunks
+    // of Parallel::For). Workers only take them when no submitted job is waiting, and they never
+    // start workers beyond maxWorkers. withdraw(owner) drops the ones that have not started, so
+    // helpers left behind long-running jobs neither pile up nor grow the pool.
+    void submitHelpers(const void* owner, std::vector<Job>&& jobs, size_t maxWorkers);
+    void withdraw(const void* owner);
+
+    size_t numWorkers() const;
+    size_t numIdleWorkers() const;
+
+  private:
+    void startWorker();
+    void workerLoop();
+
+    mutable std::mutex lock_;
+    std::condition_variable jobAvailable_;
+    std::deque<Job> jobs_;
+    std::deque<std::pair<const void*, Job>> helpers_;
+    std::vector<std::thread> workers_;
+    size_t idleWorkers_;
+    bool stopping_;
+  };
+
+}}}
+
+#endif
@@ -84,15 +84,23 @@ namespace
       return str_;
     }
 
+    py::object array() const override
+    {
+      return str_;
+    }
+
   private:
     StringHandle underlying_;
     py::object str_;
   };
 
+  // Matrices and fields are converted when first asked for, so taking the array views of a large
+  // matrix never pays for building its lists. The converted value is kept, like a string's, so
+  // edits to the returned list or dict are seen by the next read.
   class PyDatatypeDenseMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -103,18 +111,25 @@ namespace
 
     py::object value() const override
     {
-      return pyMat_;
+      if (value_.is_none())
+        value_ = convertMatrixToPython(underlying_);
+      return value_;
+    }
+
+    py::object array() const override
+    {
+      return convertMatrixToPythonArray(underlying_);
     }
 
   private:
     DenseMatrixHandle underlying_;
-    py::list pyMat_;
+    mutable py::object value_;
   };
 
   class PyDatatypeSparseRowMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -125,18 +140,25 @@ namespace
 
     py::object value() const override
     {
-      return pyMat_;
+      if (value_.is_none())
+        value_ = convertMatrixToPython(underlying_);
+      return value_;
+    }
+
+    py::object array() const override
+    {
+      return convertMatrixToPythonArrays(underlying_);
     }
 
   private:
     SparseRowMatrixHandle underlying_;
-    py::dict pyMat_;
+    mutable py::object value_;
   };
 
   class PyDatatypeField : public PyDatatype
   {
   public:
-    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying), matlabStructure_(convertFieldToPython(underlying))
+    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -147,12 +169,19 @@ namespace
 
     py::object value() const override
     {
-      return matlabStructure_;
+      if (value_.is_none())
+        value_ = convertFieldToPython(underlying_);
+      return value_;
+    }
+
+    py::object array() const override
+    {
+      return convertFieldToPythonArrays(underlying_);
     }
 
   private:
     FieldHandle underlying_;
-    py::dict matlabStructure_;
+    mutable py::object value_;
   };
 
   class PyDatatypeFactory
@@ -495,6 +495,24 @@ boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_value(cons
   return {};
 }
 
+boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_array_index(const std::string& moduleId, int portIndex)
+{
+  auto pyData = scirun_get_module_input_object_index(moduleId, portIndex);
+  Guard g(pythonLock_);
+  if (pyData)
+    return pyData->array();
+  return {};
+}
+
+boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_array(const std::string& moduleId, const std::string& portName)
+{
+  auto pyData = scirun_get_module_input_object(moduleId, portName);
+  Guard g(pythonLock_);
+  if (pyData)
+    return pyData->array();
+  return {};
+}
+
 std::string NetworkEditorPythonAPI::scirun_enable_connection(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex)
 {
   return impl_->setConnectionStatus(moduleIdFrom, fromIndex, moduleIdTo, toIndex, true);
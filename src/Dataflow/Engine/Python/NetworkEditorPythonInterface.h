@@ -77,6 +77,8 @@ namespace SCIRun
     virtual ~PyDatatype() {}
     virtual std::string type() const = 0;
     virtual boost::python::object value() const = 0;
+    /// Read-only buffer views of the data, for numpy.asarray() without a copy.
+    virtual boost::python::object array() const = 0;
   };
 
   class SCISHARE PyPort : public std::enable_shared_from_this<PyPort>
@@ -68,6 +68,7 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::class_<PyDatatype, SharedPointer<PyDatatype>, boost::noncopyable>("SCIRun::PyDatatype", boost::python::no_init)
     .add_property("type", &PyDatatype::type)
     .add_property("value", &PyDatatype::value)
+    .add_property("array", &PyDatatype::array)
   ;
 
   //////////////////////////////////////////////////////////////////////////////////////
@@ -96,6 +97,8 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::def("scirun_get_module_input_value", &NetworkEditorPythonAPI::scirun_get_module_input_value);
   boost::python::def("scirun_get_module_input_object_by_index", &NetworkEditorPythonAPI::scirun_get_module_input_object_index);
   boost::python::def("scirun_get_module_input_value_by_index", &NetworkEditorPythonAPI::scirun_get_module_input_value_index);
+  boost::python::def("scirun_get_module_input_array", &NetworkEditorPythonAPI::scirun_get_module_input_array);
+  boost::python::def("scirun_get_module_input_array_by_index", &NetworkEditorPythonAPI::scirun_get_module_input_array_index);
 
   boost::python::def("get_input_data", &NetworkEditorPythonAPI::get_input_data);
   boost::python::def("get_output_data", &NetworkEditorPythonAPI::get_output_data);
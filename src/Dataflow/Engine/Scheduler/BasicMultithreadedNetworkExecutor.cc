@@ -27,9 +27,13 @@
 
 
 #include <Dataflow/Engine/Scheduler/BasicMultithreadedNetworkExecutor.h>
+#include <Dataflow/Engine/Scheduler/ModuleConcurrency.h>
 #include <Dataflow/Network/ModuleInterface.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/ThreadPool.h>
+#include <atomic>
+#include <future>
 
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
@@ -54,14 +58,42 @@ namespace
         const auto groupIter = order_.getGroup(group);
 
         std::vector<boost::function<void()>> tasks;
+        std::vector<ThreadPool::Job> blockingJobs;
+        std::vector<std::future<void>> blocking;
 
-        std::transform(groupIter.first, groupIter.second, std::back_inserter(tasks),
-          [&](const ParallelModuleExecutionOrder::ModulesByGroup::value_type& mod) -> boost::function<void()>
+        for (auto mod = groupIter.first; mod != groupIter.second; ++mod)
         {
-          return [=]() { lookup_->lookupExecutable(mod.second)->executeWithSignals(); };
-        });
-
-        Parallel::RunTasks([&](int i) { tasks[i](); }, tasks.size());
+          auto executable = lookup_->lookupExecutable(mod->second);
+          auto module = dynamic_cast<const ModuleInterface*>(executable);
+          if (module && module->executionMayBlock())
+          {
+            auto job = std::make_shared<std::packaged_task<void()>>([executable]() { executable->executeWithSignals(); });
+            blocking.push_back(job->get_future());
+            blockingJobs.emplace_back([job]() { (*job)(); });
+          }
+          else
+            tasks.push_back([executable]() { executable->executeWithSignals(); });
+        }
+
+        // Modules that may block could be waiting on one queued behind the cap, so each gets a
+        // thread of its own and does not count against it.
+        if (!blockingJobs.empty())
+          ThreadPool::global().submit(std::move(blockingJobs), true, 0);
+
+        // A group wider than the module cap is run by fewer workers pulling modules in turn;
+        // RunTasks gives each worker its share of the cores for the module's own parallel code.
+        if (!tasks.empty())
+        {
+          std::atomic<size_t> next(0);
+          Parallel::RunTasks([&](int)
+          {
+            for (auto i = next++; i < tasks.size(); i = next++)
+              tasks[i]();
+          }, static_cast<int>(ModuleConcurrency::Width(tasks.size())));
+        }
+
+        for (auto& done : blocking)
+          done.get();
       }
       bounds_.executeFinishes_(lookup_->errorCode());
     }
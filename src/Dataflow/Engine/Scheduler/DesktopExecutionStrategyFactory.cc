@@ -30,6 +30,7 @@
 #include <Dataflow/Engine/Scheduler/SerialExecutionStrategy.h>
 #include <Dataflow/Engine/Scheduler/BasicParallelExecutionStrategy.h>
 #include <Dataflow/Engine/Scheduler/DynamicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/WorkStealingExecutionStrategy.h>
 #include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Logging/Log.h>
@@ -42,7 +43,8 @@ DesktopExecutionStrategyFactory::DesktopExecutionStrategyFactory(const std::opti
   threadMode_(threadMode),
   serial_(new SerialExecutionStrategy),
   parallel_(new BasicParallelExecutionStrategy),
-  dynamic_(new DynamicParallelExecutionStrategy)
+  dynamic_(new DynamicParallelExecutionStrategy),
+  workStealing_(new WorkStealingExecutionStrategy)
 {
 }
 
@@ -56,6 +58,8 @@ ExecutionStrategyHandle DesktopExecutionStrategyFactory::create(ExecutionStrateg
     return parallel_;
   case ExecutionStrategy::Type::DYNAMIC_PARALLEL:
     return dynamic_;
+  case ExecutionStrategy::Type::WORK_STEALING_PARALLEL:
+    return workStealing_;
   default:
     THROW_INVALID_ARGUMENT("Unknown execution strategy type.");
   }
@@ -73,8 +77,10 @@ ExecutionStrategyHandle DesktopExecutionStrategyFactory::createDefault() const
       return create(ExecutionStrategy::Type::BASIC_PARALLEL);
     if (*threadMode_ == "dynamicParallel")
       return create(ExecutionStrategy::Type::DYNAMIC_PARALLEL);
-    else
-      return create(latestWorkingVersion);
+    if (*threadMode_ == "workStealingParallel")
+      return create(ExecutionStrategy::Type::WORK_STEALING_PARALLEL);
+    logWarning("Unknown thread mode {}, using dynamicParallel", *threadMode_);
+    return create(latestWorkingVersion);
   }
   else
   {
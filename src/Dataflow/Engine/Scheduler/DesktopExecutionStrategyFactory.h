@@ -44,7 +44,7 @@ namespace Engine {
     ExecutionStrategyHandle createDefault() const override;
   private:
     std::optional<std::string> threadMode_;
-    ExecutionStrategyHandle serial_, parallel_, dynamic_;
+    ExecutionStrategyHandle serial_, parallel_, dynamic_, workStealing_;
   };
 }
 }}
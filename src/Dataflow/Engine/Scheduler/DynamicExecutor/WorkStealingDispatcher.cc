@@ -0,0 +1,128 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkStealingDispatcher.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitExecutor.h>
+#include <Dataflow/Engine/Scheduler/ModuleConcurrency.h>
+#include <Core/Logging/Log.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Thread/ThreadPool.h>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Thread;
+
+WorkStealingDispatcher::WorkStealingDispatcher(const ModuleFilter& filter, const NetworkStateInterface* network,
+  const ExecutableLookup* lookup, WorkStealingPool& pool, size_t numModules) :
+  filter_(filter), network_(network), lookup_(lookup), pool_(pool), numModules_(numModules),
+  running_(0), completed_(0), stalled_(false)
+{
+}
+
+void WorkStealingDispatcher::enqueueReadyModules() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  if (readySet_)
+    return;
+
+  readySet_.reset(new IncrementalReadySetTracker(*network_, filter_));
+  dispatch(readySet_->initiallyReady());
+
+  if (0 == running_ && !finished())
+  {
+    stalled_ = true;
+    allFinished_.notify_all();
+  }
+}
+
+void WorkStealingDispatcher::moduleExecuted(const ModuleId& id) const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  if (readySet_)
+    dispatch(readySet_->moduleCompleted(id));
+}
+
+void WorkStealingDispatcher::dispatch(const std::vector<ModuleId>& ready) const
+{
+  auto self = std::const_pointer_cast<WorkStealingDispatcher>(shared_from_this());
+  for (const auto& id : ready)
+  {
+    if (dispatchedIds_.size() >= numModules_ || !dispatchedIds_.insert(id).second)
+      continue;
+
+    auto module = network_->lookupModule(id);
+    ++running_;
+    auto job = [self, module]()
+    {
+      Parallel::ScopedCoreBudget budget(ModuleConcurrency::CoresPerModule(self->pool_.size()));
+      ModuleExecutor(module, self->lookup_, self).run();
+      self->moduleFinished();
+    };
+    // A module that may block could be waiting on one queued behind it in the pool, so it gets a
+    // thread of its own and leaves the pool's workers free.
+    if (module->executionMayBlock())
+      ThreadPool::global().submit({ job }, true, 0);
+    else
+      pool_.submit(job);
+  }
+}
+
+bool WorkStealingDispatcher::isDone() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return dispatchedIds_.size() >= numModules_;
+}
+
+void WorkStealingDispatcher::moduleFinished() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  --running_;
+  ++completed_;
+  // Downstream modules were already dispatched by the executeEnds signal, so if nothing is
+  // running now and modules remain, none of them can ever become ready.
+  if (0 == running_ && !finished())
+    stalled_ = true;
+  if (finished() || stalled_)
+    allFinished_.notify_all();
+}
+
+bool WorkStealingDispatcher::finished() const
+{
+  return completed_ >= numModules_;
+}
+
+void WorkStealingDispatcher::waitForCompletion() const
+{
+  std::unique_lock<std::mutex> lock(lock_);
+  allFinished_.wait(lock, [this]() { return finished() || (stalled_ && 0 == running_); });
+  if (stalled_ && !finished())
+    logCritical("Work-stealing executor could not schedule {} of {} modules; network execution stopped early.",
+      numModules_ - completed_, numModules_);
+}
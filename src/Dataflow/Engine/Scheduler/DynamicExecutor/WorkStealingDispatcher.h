@@ -0,0 +1,86 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKSTEALINGDISPATCHER_H
+#define ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKSTEALINGDISPATCHER_H
+
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Engine/Scheduler/IncrementalReadySetTracker.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkStealingPool.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducerInterface.h>
+#include <set>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+namespace DynamicExecutor {
+
+  // Event-driven replacement for the ModuleProducer/ModuleConsumer pair: ready modules are
+  // submitted straight to a WorkStealingPool from the executeEnds signal of their upstream
+  // modules, and the executing thread blocks on a condition variable instead of polling.
+  class SCISHARE WorkStealingDispatcher : public ProducerInterface,
+    public std::enable_shared_from_this<WorkStealingDispatcher>, boost::noncopyable
+  {
+  public:
+    WorkStealingDispatcher(const Networks::ModuleFilter& filter, const Networks::NetworkStateInterface* network,
+      const Networks::ExecutableLookup* lookup, WorkStealingPool& pool, size_t numModules);
+
+    void enqueueReadyModules() const override;
+    void moduleExecuted(const Networks::ModuleId& id) const override;
+    bool isDone() const override;
+
+    // Blocks until every scheduled module has finished executing, or no further progress is possible.
+    void waitForCompletion() const;
+
+  private:
+    void dispatch(const std::vector<Networks::ModuleId>& ready) const;
+    void moduleFinished() const;
+    bool finished() const;
+
+    Networks::ModuleFilter filter_;
+    const Networks::NetworkStateInterface* network_;
+    const Networks::ExecutableLookup* lookup_;
+    WorkStealingPool& pool_;
+    const size_t numModules_;
+
+    mutable std::mutex lock_;
+    mutable std::condition_variable allFinished_;
+    mutable std::unique_ptr<IncrementalReadySetTracker> readySet_;
+    mutable std::set<Networks::ModuleId> dispatchedIds_;
+    mutable size_t running_;
+    mutable size_t completed_;
+    mutable bool stalled_;
+  };
+
+  typedef SharedPointer<WorkStealingDispatcher> WorkStealingDispatcherPtr;
+
+}}}}
+
+#endif
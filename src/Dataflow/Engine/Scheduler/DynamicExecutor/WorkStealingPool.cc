@@ -0,0 +1,117 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkStealingPool.h>
+
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+
+namespace
+{
+  struct WorkerIdentity
+  {
+    const WorkStealingPool* pool;
+    size_t index;
+  };
+
+  thread_local WorkerIdentity currentWorker_ { nullptr, 0 };
+}
+
+WorkStealingPool::WorkStealingPool(size_t numWorkers) : queued_(0), nextQueue_(0), stopping_(false)
+{
+  numWorkers = std::max<size_t>(1, numWorkers);
+  for (size_t i = 0; i < numWorkers; ++i)
+    queues_.emplace_back(new WorkStealingDeque<Task>);
+  for (size_t i = 0; i < numWorkers; ++i)
+    workers_.emplace_back([this, i]() { workerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+  shutdown();
+}
+
+void WorkStealingPool::submit(Task task)
+{
+  const auto index = currentWorker_.pool == this ? currentWorker_.index : nextQueue_.fetch_add(1) % queues_.size();
+  {
+    // queued_ is bumped under the sleep lock so a worker cannot miss the wakeup between its
+    // predicate check and going to sleep.
+    std::lock_guard<std::mutex> g(sleepLock_);
+    queues_[index]->push(std::move(task));
+    ++queued_;
+  }
+  workAvailable_.notify_one();
+}
+
+void WorkStealingPool::shutdown()
+{
+  {
+    std::lock_guard<std::mutex> g(sleepLock_);
+    stopping_ = true;
+  }
+  workAvailable_.notify_all();
+  for (auto& worker : workers_)
+  {
+    if (worker.joinable())
+      worker.join();
+  }
+}
+
+bool WorkStealingPool::acquire(size_t index, Task& task)
+{
+  if (queues_[index]->pop(task))
+    return true;
+  for (size_t offset = 1; offset < queues_.size(); ++offset)
+  {
+    if (queues_[(index + offset) % queues_.size()]->steal(task))
+      return true;
+  }
+  return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index)
+{
+  currentWorker_ = { this, index };
+  while (true)
+  {
+    Task task;
+    if (acquire(index, task))
+    {
+      --queued_;
+      task();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepLock_);
+    workAvailable_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+    if (stopping_ && 0 == queued_)
+      break;
+  }
+  currentWorker_ = { nullptr, 0 };
+}
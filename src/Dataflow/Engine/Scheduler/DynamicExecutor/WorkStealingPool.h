@@ -0,0 +1,119 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKSTEALINGPOOL_H
+#define ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKSTEALINGPOOL_H
+
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+namespace DynamicExecutor {
+
+  // Per-worker double-ended queue. The owning worker pushes and pops at the back (LIFO, so a
+  // module's downstream work runs on the thread that just produced its inputs); idle workers
+  // steal from the front.
+  template <class Unit>
+  class WorkStealingDeque : boost::noncopyable
+  {
+  public:
+    void push(Unit unit)
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      units_.push_back(std::move(unit));
+    }
+
+    bool pop(Unit& unit)
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      if (units_.empty())
+        return false;
+      unit = std::move(units_.back());
+      units_.pop_back();
+      return true;
+    }
+
+    bool steal(Unit& unit)
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      if (units_.empty())
+        return false;
+      unit = std::move(units_.front());
+      units_.pop_front();
+      return true;
+    }
+
+  private:
+    std::mutex lock_;
+    std::deque<Unit> units_;
+  };
+
+  // Bounded set of worker threads that sleep on a condition variable until work is submitted.
+  // Tasks submitted from a worker thread go onto that worker's own deque; tasks submitted from
+  // outside the pool are distributed round-robin.
+  class SCISHARE WorkStealingPool : boost::noncopyable
+  {
+  public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(size_t numWorkers);
+    ~WorkStealingPool();
+
+    void submit(Task task);
+    size_t size() const { return workers_.size(); }
+
+    // Runs all queued tasks to completion, then stops and joins the workers.
+    void shutdown();
+
+  private:
+    void workerLoop(size_t index);
+    bool acquire(size_t index, Task& task);
+
+    std::vector<std::unique_ptr<WorkStealingDeque<Task>>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleepLock_;
+    std::condition_variable workAvailable_;
+    std::atomic<size_t> queued_;
+    std::atomic<size_t> nextQueue_;
+    bool stopping_;
+  };
+
+}}}}
+
+#endif
@@ -36,6 +36,10 @@
 #include <Core/Logging/Log.h>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/ThreadPool.h>
+#include <Dataflow/Engine/Scheduler/ModuleConcurrency.h>
+#include <condition_variable>
+#include <mutex>
 
 #include <Dataflow/Engine/Scheduler/share.h>
 
@@ -44,47 +48,72 @@ namespace Dataflow {
 namespace Engine {
 namespace DynamicExecutor {
 
+  /// Runs modules on the shared Core::Thread::ThreadPool, at most ModuleConcurrency::MaximumConcurrentModules()
+  /// at a time; startExecution blocks while the cap is reached. Modules whose execution may block
+  /// (ModuleInterface::executionMayBlock) could be waiting on a module held back by the cap, so they
+  /// start right away and do not count against it.
   class SCISHARE ExecutionThreadGroup : boost::noncopyable
   {
   public:
+    ExecutionThreadGroup() : running_(0), uncapped_(0) {}
+
     void startExecution(const ModuleExecutor& executor)
     {
-      //auto thread = 
-      executeThreads_.create_thread([=]() { executor.run(); });
-      //Core::Thread::Guard g(mapLock_->get());
-      //threadsByModuleId_[executor.module_->id().id_] = thread;
+      const auto width = ModuleConcurrency::MaximumConcurrentModules();
+      const bool capped = !executor.module_->executionMayBlock();
+      {
+        std::unique_lock<std::mutex> lock(lock_);
+        if (capped)
+        {
+          changed_.wait(lock, [this, width]() { return running_ < width; });
+          ++running_;
+        }
+        else
+          ++uncapped_;
+      }
+      const auto cores = ModuleConcurrency::CoresPerModule(width);
+      std::vector<Core::Thread::ThreadPool::Job> job;
+      job.emplace_back([this, executor, cores, capped]()
+      {
+        try
+        {
+          Core::Thread::Parallel::ScopedCoreBudget budget(cores);
+          executor.run();
+        }
+        catch (std::exception& e)
+        {
+          logCritical("Module {} threw during execution: {}", executor.module_->id().id_, e.what());
+        }
+        catch (...)
+        {
+          logCritical("Module {} threw during execution", executor.module_->id().id_);
+        }
+        finished(capped);
+      });
+      // modules may block on each other (e.g. interactive ones), so each needs a thread of its own.
+      Core::Thread::ThreadPool::global().submit(std::move(job), true, 0);
     }
     void joinAll()
     {
-      executeThreads_.join_all();
+      std::unique_lock<std::mutex> lock(lock_);
+      changed_.wait(lock, [this]() { return 0 == running_ && 0 == uncapped_; });
     }
     void clear()
     {
-      executeThreads_.clear();
-     // threadsByModuleId_.clear();
-      //std::ostringstream lockName;
-      //lockName << "threadMap " << this;
-      //mapLock_.reset(new Core::Thread::Mutex(lockName.str()));
     }
-    //std::thread* getThreadForModule(const std::string& moduleId) const
-    //{
-    //  if (!mapLock_)
-    //  {
-    //    return nullptr;
-    //  }
-    //  Core::Thread::Guard g(mapLock_->get());
-
-    //  auto it = threadsByModuleId_.find(moduleId);
-    //  if (it == threadsByModuleId_.end())
-    //    return nullptr;
-    //  if (!executeThreads_->is_thread_in(it->second))
-    //    return nullptr;
-    //  return it->second;
-    //}
   private:
-    mutable Core::Thread::ThreadGroup executeThreads_;
-    //std::map<std::string, std::thread*> threadsByModuleId_;
-    //mutable SharedPointer<Core::Thread::Mutex> mapLock_;
+    void finished(bool capped)
+    {
+      {
+        std::lock_guard<std::mutex> g(lock_);
+        --(capped ? running_ : uncapped_);
+      }
+      changed_.notify_all();
+    }
+
+    std::mutex lock_;
+    std::condition_variable changed_;
+    size_t running_, uncapped_;
   };
 
   typedef SharedPointer<ExecutionThreadGroup> ExecutionThreadGroupPtr;
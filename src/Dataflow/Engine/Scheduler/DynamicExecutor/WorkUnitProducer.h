@@ -31,10 +31,10 @@
 
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkQueue.h>
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducerInterface.h>
-#include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
+#include <Dataflow/Engine/Scheduler/IncrementalReadySetTracker.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Thread/Mutex.h>
-#include <boost/foreach.hpp>
+#include <boost/atomic.hpp>
 
 #include <Dataflow/Engine/Scheduler/share.h>
 
@@ -50,7 +50,7 @@ namespace SCIRun {
         public:
           ModuleProducer(const Networks::ModuleFilter& filter,
             const Networks::NetworkStateInterface* network, Core::Thread::Mutex* lock, ModuleWorkQueuePtr work, size_t numModules) :
-            scheduler_(filter), network_(network), enqueueLock_(lock),
+            filter_(filter), network_(network), enqueueLock_(lock),
             work_(work), doneCount_(0), badGroup_(false),
             //shouldLog_(SCIRun::Core::Logging::Log::get().verbose()),
             numModules_(numModules)
@@ -58,47 +58,24 @@ namespace SCIRun {
             //log_.setVerbose(shouldLog_);
           }
 
+          // Analyzes the network once and enqueues the modules without upstream dependencies.
           void enqueueReadyModules() const override
           {
             Core::Thread::Guard g(enqueueLock_->get());
-            if (!isDone())
-            {
-              auto order = scheduler_.schedule(*network_);
-              //if (shouldLog_)
-              //{
-              //  log_->trace("Producer received this ordering: \n{}\nProducer processing min group {}", order, order.minGroup());
-              //}
-              if (order.minGroup() < 0)
-              {
-                badGroup_ = true;
-              }
-              auto groupIter = order.getGroup(order.minGroup());
-              BOOST_FOREACH(const ParallelModuleExecutionOrder::ModulesByGroup::value_type& mod, groupIter)
-              {
-                auto module = network_->lookupModule(mod.second);
-
-                if (module->executionState().currentState() == Networks::ModuleExecutionState::Value::Waiting)
-                {
-                  //if (shouldLog_)
-                  //  log_->trace("Producer pushing module {}", mod.second);
-
-                  if (doneIds_.find(mod.second) != doneIds_.end())
-                  {
-                    //if (shouldLog_)
-                    //  log_->info("Module producer: wants to enqueue module {} a second time. {}", mod.second, id_);
-                  }
-                  else
-                  {
-                    work_->push(module);
-                    doneIds_.insert(mod.second);
-                    doneCount_.fetch_add(1);
-
-                    //if (shouldLog_)
-                    //  log_->trace("Producer status: {} {} out of {}", id_, doneCount_, numModules_);
-                  }
-                }
-              }
-            }
+            if (readySet_)
+              return;
+
+            readySet_.reset(new IncrementalReadySetTracker(*network_, filter_));
+            enqueue(readySet_->initiallyReady());
+            if (0 == doneCount_ && numModules_ > 0)
+              badGroup_ = true;
+          }
+
+          void moduleExecuted(const Networks::ModuleId& id) const override
+          {
+            Core::Thread::Guard g(enqueueLock_->get());
+            if (readySet_ && !isDone())
+              enqueue(readySet_->moduleCompleted(id));
           }
 
           void operator()() const
@@ -126,13 +103,30 @@ namespace SCIRun {
             return doneCount_ >= numModules_;
           }
         private:
-          BoostGraphParallelScheduler scheduler_;
+          void enqueue(const std::vector<Networks::ModuleId>& ready) const
+          {
+            for (const auto& id : ready)
+            {
+              if (doneIds_.find(id) != doneIds_.end())
+                continue;
+
+              work_->push(network_->lookupModule(id));
+              doneIds_.insert(id);
+              doneCount_.fetch_add(1);
+
+              //if (shouldLog_)
+              //  log_->trace("Producer status: {} {} out of {}", id_, doneCount_, numModules_);
+            }
+          }
+
+          Networks::ModuleFilter filter_;
           const Networks::NetworkStateInterface* network_;
           Core::Thread::Mutex* enqueueLock_;
           ModuleWorkQueuePtr work_;
           mutable boost::atomic<int> doneCount_;
           mutable bool badGroup_;
           mutable std::set<Networks::ModuleId> doneIds_;
+          mutable std::unique_ptr<IncrementalReadySetTracker> readySet_;
           //static Core::Logging::Logger2 log_;
           //bool shouldLog_;
           size_t numModules_;
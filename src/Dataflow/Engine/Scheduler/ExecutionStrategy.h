@@ -51,7 +51,8 @@ namespace Engine {
     {
       SERIAL,
       BASIC_PARALLEL,
-      DYNAMIC_PARALLEL
+      DYNAMIC_PARALLEL,
+      WORK_STEALING_PARALLEL
       // next: pausable, then with loops
     };
 
@@ -0,0 +1,110 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/IncrementalReadySetTracker.h>
+#include <Dataflow/Engine/Scheduler/GraphNetworkAnalyzer.h>
+#include <Dataflow/Network/NetworkInterface.h>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+
+IncrementalReadySetTracker::IncrementalReadySetTracker(const NetworkStateInterface& network, const ModuleFilter& filter)
+  : completedCount_(0)
+{
+  NetworkGraphAnalyzer analyzer(network, filter, false);
+  const auto edges = analyzer.constructEdgeListFromNetwork();
+  const auto numModules = analyzer.moduleCount();
+
+  moduleIds_.reserve(numModules);
+  for (int v = 0; v < numModules; ++v)
+  {
+    moduleIds_.push_back(analyzer.moduleAt(v));
+    vertexLookup_[moduleIds_.back()] = v;
+  }
+
+  successorOffsets_.assign(numModules + 1, 0);
+  remainingUpstream_.assign(numModules, 0);
+  for (const auto& edge : edges)
+  {
+    ++successorOffsets_[edge.first + 1];
+    ++remainingUpstream_[edge.second];
+  }
+  for (int v = 0; v < numModules; ++v)
+    successorOffsets_[v + 1] += successorOffsets_[v];
+
+  successors_.resize(edges.size());
+  auto fill = successorOffsets_;
+  for (const auto& edge : edges)
+    successors_[fill[edge.first]++] = edge.second;
+
+  completed_.assign(numModules, false);
+}
+
+std::vector<ModuleId> IncrementalReadySetTracker::initiallyReady() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  std::vector<ModuleId> ready;
+  for (size_t v = 0; v < moduleIds_.size(); ++v)
+  {
+    if (0 == remainingUpstream_[v] && !completed_[v])
+      ready.push_back(moduleIds_[v]);
+  }
+  return ready;
+}
+
+std::vector<ModuleId> IncrementalReadySetTracker::moduleCompleted(const ModuleId& id)
+{
+  std::lock_guard<std::mutex> g(lock_);
+  std::vector<ModuleId> ready;
+  auto vIter = vertexLookup_.find(id);
+  if (vIter == vertexLookup_.end() || completed_[vIter->second])
+    return ready;
+
+  const auto v = vIter->second;
+  completed_[v] = true;
+  ++completedCount_;
+  for (int e = successorOffsets_[v]; e < successorOffsets_[v + 1]; ++e)
+  {
+    const auto down = successors_[e];
+    if (0 == --remainingUpstream_[down])
+      ready.push_back(moduleIds_[down]);
+  }
+  return ready;
+}
+
+size_t IncrementalReadySetTracker::completedCount() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return completedCount_;
+}
+
+bool IncrementalReadySetTracker::allCompleted() const
+{
+  return completedCount() >= size();
+}
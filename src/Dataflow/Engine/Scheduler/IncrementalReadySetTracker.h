@@ -0,0 +1,76 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_INCREMENTAL_READY_SET_TRACKER_H
+#define ENGINE_SCHEDULER_INCREMENTAL_READY_SET_TRACKER_H
+
+#include <Dataflow/Network/ModuleDescription.h>
+#include <Dataflow/Engine/Scheduler/SchedulerInterfaces.h>
+#include <boost/noncopyable.hpp>
+#include <mutex>
+#include <vector>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Dependency-counter scheduler for the dynamic executors. The network graph is analyzed once;
+  /// afterwards each module completion costs O(out-degree) instead of a full re-schedule of the
+  /// remaining network. Modules rejected by the filter are not dependencies.
+  class SCISHARE IncrementalReadySetTracker : boost::noncopyable
+  {
+  public:
+    IncrementalReadySetTracker(const Networks::NetworkStateInterface& network, const Networks::ModuleFilter& filter);
+
+    /// Modules with no upstream dependencies among the filtered set.
+    std::vector<Networks::ModuleId> initiallyReady() const;
+    /// Decrements the dependency counts of the downstream modules of a finished module, returning those that reached zero.
+    /// Unknown or already completed ids are ignored.
+    std::vector<Networks::ModuleId> moduleCompleted(const Networks::ModuleId& id);
+
+    size_t size() const { return moduleIds_.size(); }
+    size_t completedCount() const;
+    bool allCompleted() const;
+
+  private:
+    std::vector<Networks::ModuleId> moduleIds_;
+    std::map<Networks::ModuleId, int> vertexLookup_;
+    // CSR adjacency of successors, duplicate edges kept so counts stay consistent.
+    std::vector<int> successorOffsets_;
+    std::vector<int> successors_;
+    std::vector<int> remainingUpstream_;
+    std::vector<bool> completed_;
+    size_t completedCount_;
+    mutable std::mutex lock_;
+  };
+
+}}}
+
+#endif
@@ -0,0 +1,63 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/ModuleConcurrency.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Logging/Log.h>
+#include <algorithm>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Logging;
+
+size_t ModuleConcurrency::maximumSetByUser_(0);
+
+size_t ModuleConcurrency::MaximumConcurrentModules()
+{
+  return maximumSetByUser_ != 0 ? maximumSetByUser_ : Parallel::NumCores();
+}
+
+void ModuleConcurrency::SetMaximumConcurrentModules(size_t max)
+{
+  if (max == 0)
+    logWarning("Maximum concurrently executing modules set to the core count");
+  else
+    logWarning("Maximum concurrently executing modules set to {}", max);
+  maximumSetByUser_ = max;
+}
+
+size_t ModuleConcurrency::Width(size_t numReady)
+{
+  return std::max<size_t>(1, std::min(numReady, MaximumConcurrentModules()));
+}
+
+unsigned int ModuleConcurrency::CoresPerModule(size_t width)
+{
+  return std::max(1u, static_cast<unsigned int>(Parallel::NumCores() / std::max<size_t>(1, width)));
+}
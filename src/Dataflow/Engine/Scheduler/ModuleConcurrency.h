@@ -0,0 +1,59 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_MODULECONCURRENCY_H
+#define ENGINE_SCHEDULER_MODULECONCURRENCY_H
+
+#include <cstddef>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Shared limit on how many modules the multithreaded executors run at once. The cores left over
+  /// are split between the running modules, so their internal Parallel regions stay within one budget.
+  class SCISHARE ModuleConcurrency
+  {
+  public:
+    /// Defaults to Parallel::NumCores(); 0 restores the default.
+    static size_t MaximumConcurrentModules();
+    static void SetMaximumConcurrentModules(size_t max);
+
+    /// Number of modules to run side by side when numReady are ready; at least 1.
+    static size_t Width(size_t numReady);
+    /// Core budget for each module when width modules run side by side; at least 1.
+    static unsigned int CoresPerModule(size_t width);
+  private:
+    static size_t maximumSetByUser_;
+  };
+
+}}}
+
+#endif
@@ -28,10 +28,34 @@
 
 #include <Dataflow/Engine/Scheduler/SchedulerInterfaces.h>
 #include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ModuleResultStore.h>
+#include <Dataflow/Network/ExecutionProfiler.h>
+#include <Core/Datatypes/Datatype.h>
 #include <Core/Logging/Log.h>
 
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+ExecutionBounds::ExecutionBounds()
+{
+  // clone, memoization and profiling totals are reported per network execution
+  executeStarts_.connect([]()
+  {
+    CloneStatistics::reset();
+    ModuleResultStore::instance().resetStatistics();
+    ExecutionProfiler::instance().networkExecutionStarting();
+  });
+  executeFinishes_.connect([](int)
+  {
+    if (CloneStatistics::numClones() > 0)
+      logInfo("Network execution cloned {} datatypes totaling {} bytes", CloneStatistics::numClones(), CloneStatistics::bytesCloned());
+    auto& store = ModuleResultStore::instance();
+    if (store.enabled())
+      logInfo("Memoized module results: {} hits, {} misses, {} stored", store.numHits(), store.numMisses(), store.numStores());
+    ExecutionProfiler::instance().networkExecutionFinished();
+  });
+}
 
 ScopedExecutionBoundsSignaller::ScopedExecutionBoundsSignaller(const ExecutionBounds* bounds, std::function<int()> errorCodeRetriever) : bounds_(bounds), errorCodeRetriever_(errorCodeRetriever)
 {
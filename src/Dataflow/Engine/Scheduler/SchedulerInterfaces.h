@@ -57,6 +57,7 @@ namespace Engine {
 
   struct SCISHARE ExecutionBounds : boost::noncopyable
   {
+    ExecutionBounds();
     ExecuteAllStartsSignalType executeStarts_;
     ExecuteAllFinishesSignalType executeFinishes_;
   };
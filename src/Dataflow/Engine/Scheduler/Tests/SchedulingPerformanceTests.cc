@@ -0,0 +1,154 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Dataflow/Network/Network.h>
+#include <Dataflow/Network/Tests/MockNetwork.h>
+#include <Dataflow/State/SimpleMapModuleState.h>
+#include <Modules/Factory/HardCodedModuleFactory.h>
+#include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
+#include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
+#include <Dataflow/Engine/Scheduler/IncrementalReadySetTracker.h>
+#include <Core/Logging/Log.h>
+#include <Core/Logging/ScopedTimeRemarker.h>
+#include <deque>
+
+using namespace SCIRun;
+using namespace SCIRun::Modules::Factory;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::Networks::Mocks;
+using namespace SCIRun::Dataflow::State;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Logging;
+
+class SchedulingOverheadPerformanceTest : public ::testing::TestWithParam<int>
+{
+protected:
+  SchedulingOverheadPerformanceTest() :
+    network_(ModuleFactoryHandle(new HardCodedModuleFactory),
+      ModuleStateFactoryHandle(new SimpleMapModuleStateFactory),
+      AlgorithmFactoryHandle(new HardCodedAlgorithmFactory),
+      ReexecuteStrategyFactoryHandle())
+  {
+    LogSettings::Instance().setVerbose(false);
+  }
+
+  // Synthetic network: 10 source modules feeding 10 chains, with every third module
+  // also pulling from the neighboring chain.
+  void buildLayeredNetwork(int numModules)
+  {
+    const int width = 10;
+    std::vector<ModuleHandle> modules;
+    modules.reserve(numModules);
+    for (int i = 0; i < numModules; ++i)
+    {
+      if (i < width)
+        modules.push_back(addModuleToNetwork(network_, "CreateMatrix"));
+      else if (i % 3 == 0 && i % width != width - 1)
+      {
+        modules.push_back(addModuleToNetwork(network_, "EvaluateLinearAlgebraBinary"));
+        network_.connect(ConnectionOutputPort(modules[i - width], 0), ConnectionInputPort(modules[i], 0));
+        network_.connect(ConnectionOutputPort(modules[i - width + 1], 0), ConnectionInputPort(modules[i], 1));
+      }
+      else
+      {
+        modules.push_back(addModuleToNetwork(network_, "EvaluateLinearAlgebraUnary"));
+        network_.connect(ConnectionOutputPort(modules[i - width], 0), ConnectionInputPort(modules[i], 0));
+      }
+    }
+    network_.setModuleExecutionState(ModuleExecutionState::Value::Waiting, ExecuteAllModules::Instance());
+  }
+
+  Network network_;
+};
+
+// Prints the per-completion scheduling cost of re-running BoostGraphParallelScheduler (what the
+// dynamic executor used to do on every executeEnds) against the incremental ready set.
+TEST_P(SchedulingOverheadPerformanceTest, ScheduleOnEveryCompletionVersusIncrementalReadySet)
+{
+  const int numModules = GetParam();
+  buildLayeredNetwork(numModules);
+  ASSERT_EQ(numModules, network_.nmodules());
+
+  // The full-reschedule baseline is quadratic overall, so only a prefix of completions is timed.
+  const int maxRescheduledCompletions = 200;
+  int rescheduledCompletions = 0;
+  double rescheduleSeconds;
+  {
+    BoostGraphParallelScheduler scheduler(ModuleWaitingFilter::Instance());
+    SimpleScopedTimer timer;
+    while (rescheduledCompletions < maxRescheduledCompletions)
+    {
+      auto order = scheduler.schedule(network_);
+      if (order.minGroup() < 0)
+        break;
+      auto next = order.getGroup(order.minGroup()).first->second;
+      network_.lookupModule(next)->executionState().transitionTo(ModuleExecutionState::Value::Completed);
+      ++rescheduledCompletions;
+    }
+    rescheduleSeconds = timer.elapsedSeconds();
+  }
+
+  network_.setModuleExecutionState(ModuleExecutionState::Value::Waiting, ExecuteAllModules::Instance());
+
+  int incrementalCompletions = 0;
+  double incrementalSeconds;
+  {
+    SimpleScopedTimer timer;
+    IncrementalReadySetTracker tracker(network_, ModuleWaitingFilter::Instance());
+    auto initial = tracker.initiallyReady();
+    std::deque<ModuleId> ready(initial.begin(), initial.end());
+    while (!ready.empty())
+    {
+      auto next = ready.front();
+      ready.pop_front();
+      for (const auto& id : tracker.moduleCompleted(next))
+        ready.push_back(id);
+      ++incrementalCompletions;
+    }
+    incrementalSeconds = timer.elapsedSeconds();
+    EXPECT_TRUE(tracker.allCompleted());
+  }
+  EXPECT_EQ(numModules, incrementalCompletions);
+
+  const auto reschedulePerCompletion = rescheduleSeconds / rescheduledCompletions;
+  const auto incrementalPerCompletion = incrementalSeconds / incrementalCompletions;
+  std::cout << numModules << " modules:\n"
+    << "  full reschedule:     " << 1e3 * reschedulePerCompletion << " ms/completion ("
+    << rescheduledCompletions << " timed), projected total " << reschedulePerCompletion * numModules << " s\n"
+    << "  incremental (incl. setup): " << 1e3 * incrementalPerCompletion << " ms/completion, total "
+    << incrementalSeconds << " s" << std::endl;
+}
+
+INSTANTIATE_TEST_CASE_P(
+  SchedulingOverheadPerformanceTestParameters,
+  SchedulingOverheadPerformanceTest,
+  ::testing::Values(100, 1000, 10000)
+);
@@ -38,16 +38,24 @@
 #include <Core/Algorithms/Math/EvaluateLinearAlgebraBinaryAlgo.h>
 #include <Core/Algorithms/Math/ReportMatrixInfo.h>
 #include <Dataflow/Network/Tests/MockNetwork.h>
+#include <Dataflow/Network/Tests/MockModule.h>
 #include <Dataflow/State/SimpleMapModuleState.h>
 #include <Dataflow/Engine/Scheduler/BoostGraphSerialScheduler.h>
 #include <Dataflow/Engine/Scheduler/LinearSerialNetworkExecutor.h>
 #include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
 #include <Dataflow/Engine/Scheduler/BasicMultithreadedNetworkExecutor.h>
 #include <Dataflow/Engine/Scheduler/BasicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/IncrementalReadySetTracker.h>
+#include <Dataflow/Engine/Scheduler/ModuleConcurrency.h>
+#include <Dataflow/Engine/Scheduler/WorkStealingExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/DynamicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Logging/Log.h>
+#include <Core/Thread/Parallel.h>
 
+#include <future>
 #include <queue>
 
 #include <boost/graph/adjacency_list.hpp>
@@ -71,6 +79,7 @@ using ::testing::_;
 using ::testing::NiceMock;
 using ::testing::DefaultValue;
 using ::testing::Return;
+using ::testing::Invoke;
 
 namespace
 {
@@ -281,6 +290,150 @@ TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorMultiThreaded)
   EXPECT_EQ(186, reportOutput.get<5>());
 }
 
+TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorWorkStealing)
+{
+  setupBasicNetwork();
+
+  WorkStealingExecutionStrategy strategy;
+  ExecutionContext context(matrixMathNetwork, &matrixMathNetwork);
+  context.preexecute();
+  Mutex m("exec");
+  auto result = strategy.execute(context, m);
+
+  ASSERT_TRUE(result.valid());
+  EXPECT_EQ(0, result.get());
+
+  for (const auto& state : matrixMathNetwork.moduleExecutionStates())
+    EXPECT_EQ(ModuleExecutionState::Value::Completed, state);
+
+  auto reportOutput = transient_value_cast<ReportMatrixInfoAlgorithm::Outputs>(report->get_state()->getTransientValue("ReportedInfo"));
+  EXPECT_EQ(3, reportOutput.get<1>());
+  EXPECT_EQ(3, reportOutput.get<2>());
+  EXPECT_EQ(9, reportOutput.get<3>());
+  EXPECT_EQ(22, reportOutput.get<4>());
+  EXPECT_EQ(186, reportOutput.get<5>());
+}
+
+TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorWorkStealingByThreadMode)
+{
+  setupBasicNetwork();
+
+  DesktopExecutionStrategyFactory factory(std::string("workStealingParallel"));
+  auto strategy = factory.createDefault();
+  ASSERT_TRUE(std::dynamic_pointer_cast<WorkStealingExecutionStrategy>(strategy) != nullptr);
+
+  ExecutionContext context(matrixMathNetwork, &matrixMathNetwork);
+  context.preexecute();
+  Mutex m("exec");
+  auto result = strategy->execute(context, m);
+
+  ASSERT_TRUE(result.valid());
+  EXPECT_EQ(0, result.get());
+
+  for (const auto& state : matrixMathNetwork.moduleExecutionStates())
+    EXPECT_EQ(ModuleExecutionState::Value::Completed, state);
+
+  auto reportOutput = transient_value_cast<ReportMatrixInfoAlgorithm::Outputs>(report->get_state()->getTransientValue("ReportedInfo"));
+  EXPECT_EQ(3, reportOutput.get<1>());
+  EXPECT_EQ(3, reportOutput.get<2>());
+  EXPECT_EQ(9, reportOutput.get<3>());
+  EXPECT_EQ(22, reportOutput.get<4>());
+  EXPECT_EQ(186, reportOutput.get<5>());
+}
+
+TEST(DesktopExecutionStrategyFactoryTests, UnknownThreadModeFallsBackToDynamicParallel)
+{
+  DesktopExecutionStrategyFactory factory(std::string("noSuchMode"));
+  EXPECT_TRUE(std::dynamic_pointer_cast<DynamicParallelExecutionStrategy>(factory.createDefault()) != nullptr);
+}
+
+TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorMultiThreadedOneModuleAtATime)
+{
+  setupBasicNetwork();
+
+  // groups wider than the cap must still run every module
+  ModuleConcurrency::SetMaximumConcurrentModules(1);
+  BasicParallelExecutionStrategy strategy;
+  ExecutionContext context(matrixMathNetwork, &matrixMathNetwork);
+  Mutex m("exec");
+  strategy.execute(context, m);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(800));
+  ModuleConcurrency::SetMaximumConcurrentModules(0);
+
+  for (const auto& state : matrixMathNetwork.moduleExecutionStates())
+    EXPECT_EQ(ModuleExecutionState::Value::Completed, state);
+
+  auto reportOutput = transient_value_cast<ReportMatrixInfoAlgorithm::Outputs>(report->get_state()->getTransientValue("ReportedInfo"));
+  EXPECT_EQ(186, reportOutput.get<5>());
+}
+
+namespace
+{
+  class FixedExecutableLookup : public ExecutableLookup
+  {
+  public:
+    explicit FixedExecutableLookup(const std::map<ModuleId, ExecutableObject*>& modules) : modules_(modules) {}
+    ExecutableObject* lookupExecutable(const ModuleId& id) const override { return modules_.at(id); }
+    bool containsViewScene() const override { return false; }
+    int errorCode() const override { return 0; }
+  private:
+    std::map<ModuleId, ExecutableObject*> modules_;
+  };
+}
+
+TEST(BasicMultithreadedNetworkExecutorTests, ModulesThatMayBlockDoNotWaitForTheCap)
+{
+  std::promise<void> producerRan, waiterRan;
+  auto produced = producerRan.get_future().share();
+  std::atomic<bool> sawProducer(false);
+
+  NiceMock<MockModule> waiter, producer;
+  ON_CALL(waiter, executionMayBlock()).WillByDefault(Return(true));
+  ON_CALL(waiter, executeWithSignals()).WillByDefault(Invoke([&]()
+  {
+    sawProducer = std::future_status::ready == produced.wait_for(std::chrono::seconds(5));
+    waiterRan.set_value();
+    return true;
+  }));
+  ON_CALL(producer, executeWithSignals()).WillByDefault(Invoke([&]() { producerRan.set_value(); return true; }));
+
+  // the waiter comes first in the group, so a single capped worker would start it and never reach the producer
+  const ModuleId waiterId("Waiter", 0), producerId("Producer", 1);
+  FixedExecutableLookup lookup({ { waiterId, &waiter }, { producerId, &producer } });
+  ParallelModuleExecutionOrder order({ { 0, waiterId }, { 0, producerId } });
+  NiceMock<MockNetwork> network;
+  ExecutionContext context(network, &lookup);
+  Mutex lock("exec");
+
+  ModuleConcurrency::SetMaximumConcurrentModules(1);
+  BasicMultithreadedNetworkExecutor executor;
+  executor.execute(context, order, lock);
+  EXPECT_EQ(std::future_status::ready, waiterRan.get_future().wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(std::future_status::ready, produced.wait_for(std::chrono::seconds(10)));
+  // the executor holds the lock until it has signalled the end of the execution
+  Guard g(lock.get());
+  ModuleConcurrency::SetMaximumConcurrentModules(0);
+
+  EXPECT_TRUE(sawProducer);
+}
+
+TEST(ModuleConcurrencyTests, WidthAndCoresStayWithinTheCoreBudget)
+{
+  const auto cores = Parallel::NumCores();
+  EXPECT_EQ(cores, ModuleConcurrency::MaximumConcurrentModules());
+  EXPECT_EQ(1, ModuleConcurrency::Width(0));
+  EXPECT_EQ(std::min<size_t>(cores, 64), ModuleConcurrency::Width(64));
+  EXPECT_EQ(cores, ModuleConcurrency::CoresPerModule(1));
+  EXPECT_EQ(1, ModuleConcurrency::CoresPerModule(cores + 1));
+
+  ModuleConcurrency::SetMaximumConcurrentModules(2);
+  EXPECT_EQ(2, ModuleConcurrency::Width(64));
+  EXPECT_EQ(std::max(1u, cores / 2), ModuleConcurrency::CoresPerModule(ModuleConcurrency::Width(64)));
+  ModuleConcurrency::SetMaximumConcurrentModules(0);
+  EXPECT_EQ(cores, ModuleConcurrency::MaximumConcurrentModules());
+}
+
 TEST_F(SchedulingWithBoostGraph, SerialNetworkOrder)
 {
   setupBasicNetwork();
@@ -414,6 +567,63 @@ TEST_F(SchedulingWithBoostGraph, ParallelNetworkOrderExecutedFromAModuleInADisjo
   }
 }
 
+namespace
+{
+  std::vector<ModuleId> sorted(std::vector<ModuleId> ids)
+  {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+}
+
+TEST_F(SchedulingWithBoostGraph, IncrementalReadySetFollowsDependencies)
+{
+  setupBasicNetwork();
+
+  IncrementalReadySetTracker tracker(matrixMathNetwork, ExecuteAllModules::Instance());
+  EXPECT_EQ(9, tracker.size());
+
+  using Ids = std::vector<ModuleId>;
+  EXPECT_EQ((Ids{ ModuleId("CreateMatrix:0"), ModuleId("CreateMatrix:1") }), sorted(tracker.initiallyReady()));
+
+  EXPECT_EQ((Ids{ ModuleId("EvaluateLinearAlgebraUnary:4") }), tracker.moduleCompleted(ModuleId("CreateMatrix:1")));
+  EXPECT_EQ((Ids{ ModuleId("EvaluateLinearAlgebraUnary:2"), ModuleId("EvaluateLinearAlgebraUnary:3") }),
+    sorted(tracker.moduleCompleted(ModuleId("CreateMatrix:0"))));
+  // multiply still waits on negate
+  EXPECT_TRUE(tracker.moduleCompleted(ModuleId("EvaluateLinearAlgebraUnary:4")).empty());
+  EXPECT_EQ((Ids{ ModuleId("EvaluateLinearAlgebraBinary:5") }), tracker.moduleCompleted(ModuleId("EvaluateLinearAlgebraUnary:3")));
+  // add still waits on multiply
+  EXPECT_TRUE(tracker.moduleCompleted(ModuleId("EvaluateLinearAlgebraUnary:2")).empty());
+  EXPECT_EQ((Ids{ ModuleId("EvaluateLinearAlgebraBinary:6") }), tracker.moduleCompleted(ModuleId("EvaluateLinearAlgebraBinary:5")));
+  EXPECT_EQ((Ids{ ModuleId("ReportMatrixInfo:7"), ModuleId("ReportMatrixInfo:8") }),
+    sorted(tracker.moduleCompleted(ModuleId("EvaluateLinearAlgebraBinary:6"))));
+
+  EXPECT_FALSE(tracker.allCompleted());
+  EXPECT_TRUE(tracker.moduleCompleted(ModuleId("ReportMatrixInfo:7")).empty());
+  EXPECT_TRUE(tracker.moduleCompleted(ModuleId("ReportMatrixInfo:8")).empty());
+  EXPECT_TRUE(tracker.allCompleted());
+
+  // completing twice, or completing an unknown module, is a no-op
+  EXPECT_TRUE(tracker.moduleCompleted(ModuleId("EvaluateLinearAlgebraBinary:6")).empty());
+  EXPECT_TRUE(tracker.moduleCompleted(ModuleId("CreateMatrix:99")).empty());
+  EXPECT_EQ(9, tracker.completedCount());
+}
+
+TEST_F(SchedulingWithBoostGraph, IncrementalReadySetIgnoresFilteredModules)
+{
+  setupBasicNetwork();
+
+  ModuleFilter filter = [](ModuleHandle mh) { return mh->name().find("Unary") == std::string::npos; };
+  IncrementalReadySetTracker tracker(matrixMathNetwork, filter);
+  EXPECT_EQ(6, tracker.size());
+
+  using Ids = std::vector<ModuleId>;
+  EXPECT_EQ((Ids{ ModuleId("CreateMatrix:0"), ModuleId("CreateMatrix:1"), ModuleId("EvaluateLinearAlgebraBinary:5") }),
+    sorted(tracker.initiallyReady()));
+  EXPECT_TRUE(tracker.moduleCompleted(ModuleId("CreateMatrix:0")).empty());
+  EXPECT_EQ((Ids{ ModuleId("EvaluateLinearAlgebraBinary:6") }), tracker.moduleCompleted(ModuleId("EvaluateLinearAlgebraBinary:5")));
+}
+
 #if 0
 namespace ThreadingPrototype
 {
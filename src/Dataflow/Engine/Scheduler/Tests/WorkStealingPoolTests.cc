@@ -0,0 +1,101 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkStealingPool.h>
+#include <set>
+
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+
+TEST(WorkStealingPoolTests, RunsAllSubmittedTasks)
+{
+  std::atomic<int> count(0);
+  {
+    WorkStealingPool pool(4);
+    for (int i = 0; i < 1000; ++i)
+      pool.submit([&count]() { ++count; });
+    pool.shutdown();
+  }
+  EXPECT_EQ(1000, count);
+}
+
+TEST(WorkStealingPoolTests, TasksSubmittedFromWorkersAreRun)
+{
+  std::atomic<int> count(0);
+  WorkStealingPool pool(3);
+  std::function<void(int)> spawn = [&](int depth)
+  {
+    ++count;
+    if (depth > 0)
+    {
+      pool.submit([&spawn, depth]() { spawn(depth - 1); });
+      pool.submit([&spawn, depth]() { spawn(depth - 1); });
+    }
+  };
+  pool.submit([&spawn]() { spawn(9); });
+
+  while (count < 1023)
+    std::this_thread::yield();
+  pool.shutdown();
+  EXPECT_EQ(1023, count);
+}
+
+TEST(WorkStealingPoolTests, IdleWorkersStealFromBusyWorker)
+{
+  const int numTasks = 64;
+  std::atomic<int> count(0);
+  std::mutex idsLock;
+  std::set<std::thread::id> ids;
+  WorkStealingPool pool(4);
+  pool.submit([&]()
+  {
+    // all of these land on this worker's own deque; other workers can only get them by stealing.
+    for (int i = 0; i < numTasks; ++i)
+    {
+      pool.submit([&]()
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> g(idsLock);
+        ids.insert(std::this_thread::get_id());
+        ++count;
+      });
+    }
+  });
+
+  while (count < numTasks)
+    std::this_thread::yield();
+  pool.shutdown();
+  EXPECT_GT(ids.size(), 1u);
+}
+
+TEST(WorkStealingPoolTests, ZeroWorkersMeansOne)
+{
+  WorkStealingPool pool(0);
+  EXPECT_EQ(1u, pool.size());
+}
@@ -0,0 +1,99 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/WorkStealingNetworkExecutor.h>
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkStealingDispatcher.h>
+#include <Dataflow/Engine/Scheduler/ModuleConcurrency.h>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  class WorkStealingNetworkExecutorImpl : public WaitsForStartupInitialization
+  {
+  public:
+    WorkStealingNetworkExecutorImpl(const ExecutionContext& context, const NetworkStateInterface* network,
+      size_t numModules, Mutex* executionLock) :
+      lookup_(context.lookup()),
+      bounds_(&context.bounds()),
+      filter_(context.addAdditionalFilter(ModuleWaitingFilter::Instance())),
+      network_(network),
+      numModules_(numModules),
+      executionLock_(executionLock)
+    {
+    }
+
+    int run() const
+    {
+      Guard g(executionLock_->get());
+
+      ScopedExecutionBoundsSignaller signaller(bounds_, [=]() { return lookup_->errorCode(); });
+
+      waitForStartupInit(*network_);
+
+      WorkStealingPool pool(WorkStealingNetworkExecutor::workerCount(numModules_));
+      auto dispatcher = makeShared<WorkStealingDispatcher>(filter_, network_, lookup_, pool, numModules_);
+      dispatcher->enqueueReadyModules();
+      dispatcher->waitForCompletion();
+      pool.shutdown();
+
+      return lookup_->errorCode();
+    }
+
+  private:
+    const ExecutableLookup* lookup_;
+    const ExecutionBounds* bounds_;
+    ModuleFilter filter_;
+    const NetworkStateInterface* network_;
+    size_t numModules_;
+    Mutex* executionLock_;
+  };
+}
+
+WorkStealingNetworkExecutor::WorkStealingNetworkExecutor(const NetworkStateInterface& network) : network_(network)
+{
+}
+
+size_t WorkStealingNetworkExecutor::workerCount(size_t numModules)
+{
+  return ModuleConcurrency::Width(numModules);
+}
+
+std::future<int> WorkStealingNetworkExecutor::execute(const ExecutionContext& context, ParallelModuleExecutionOrder order, Mutex& executionLock)
+{
+  auto runner = makeShared<WorkStealingNetworkExecutorImpl>(context, &network_, order.size(), &executionLock);
+  std::packaged_task<int()> task([runner] { return runner->run(); });
+  auto value = task.get_future();
+  std::thread t(std::move(task));
+  t.detach();
+  return value;
+}
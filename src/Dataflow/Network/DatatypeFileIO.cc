@@ -0,0 +1,100 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Dataflow/Network/DatatypeFileIO.h>
+#include <Core/Persistent/Persistent.h>
+#include <Core/Logging/Log.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  // Files hold any type registered below "Datatype". The id is only used for that lookup,
+  // so it is built by hand rather than added to the Persistent type table.
+  const PersistentTypeID& anyDatatypeId()
+  {
+    static const PersistentTypeID id = []()
+    {
+      PersistentTypeID pid;
+      pid.type = "Datatype";
+      return pid;
+    }();
+    return id;
+  }
+}
+
+bool SCIRun::Dataflow::Networks::isPersistentDatatype(const Datatype& data)
+{
+  return Persistent::find_derived(data.dynamic_type_name(), anyDatatypeId().type) != nullptr;
+}
+
+bool SCIRun::Dataflow::Networks::writeDatatypeFile(const DatatypeHandle& data, const std::string& filename)
+{
+  try
+  {
+    auto stream = auto_ostream(filename, "Binary");
+    if (!stream || stream->error())
+      return false;
+    PersistentHandle handle = data;
+    stream->begin_cheap_delim();
+    stream->io(handle, anyDatatypeId());
+    stream->end_cheap_delim();
+    return !stream->error();
+  }
+  catch (std::exception& e)
+  {
+    logWarning("Could not write port data to {}: {}", filename, e.what());
+    return false;
+  }
+}
+
+DatatypeHandle SCIRun::Dataflow::Networks::readDatatypeFile(const std::string& filename)
+{
+  try
+  {
+    auto stream = auto_istream(filename);
+    if (!stream || stream->error())
+      return nullptr;
+    PersistentHandle handle;
+    stream->begin_cheap_delim();
+    stream->io(handle, anyDatatypeId());
+    stream->end_cheap_delim();
+    if (stream->error())
+      return nullptr;
+    return std::dynamic_pointer_cast<Datatype>(handle);
+  }
+  catch (std::exception& e)
+  {
+    logError("Could not read port data from {}: {}", filename, e.what());
+    return nullptr;
+  }
+}
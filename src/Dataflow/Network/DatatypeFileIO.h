@@ -0,0 +1,55 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#ifndef DATAFLOW_NETWORK_DATATYPEFILEIO_H
+#define DATAFLOW_NETWORK_DATATYPEFILEIO_H
+
+#include <Core/Datatypes/Datatype.h>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun
+{
+  namespace Dataflow
+  {
+    namespace Networks
+    {
+      /// Scratch files for port data kept on local disk, written with the binary Piostream.
+
+      /// True when data's type is registered below "Datatype", so it can be written and read back.
+      SCISHARE bool isPersistentDatatype(const Core::Datatypes::Datatype& data);
+      /// Logs a warning and returns false on failure.
+      SCISHARE bool writeDatatypeFile(const Core::Datatypes::DatatypeHandle& data, const std::string& filename);
+      /// Logs an error and returns null on failure.
+      SCISHARE Core::Datatypes::DatatypeHandle readDatatypeFile(const std::string& filename);
+    }
+  }
+}
+
+#endif
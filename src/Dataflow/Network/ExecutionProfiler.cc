@@ -0,0 +1,243 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Dataflow/Network/ExecutionProfiler.h>
+#include <Core/Logging/Log.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <set>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace SCIRun::Dataflow::Networks;
+
+namespace
+{
+  size_t peakResidentMemory()
+  {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+      return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (0 != getrusage(RUSAGE_SELF, &usage))
+      return 0;
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+  }
+
+  // small stable numbers read better than native thread ids in a trace viewer
+  int currentThreadIndex()
+  {
+    static std::atomic<int> nextIndex(1);
+    thread_local int index = nextIndex++;
+    return index;
+  }
+}
+
+std::string SCIRun::Dataflow::Networks::jsonEscaped(const std::string& str)
+{
+  std::string escaped;
+  for (auto c : str)
+  {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20)
+      escaped += c;
+  }
+  return escaped;
+}
+
+ExecutionProfiler& ExecutionProfiler::instance()
+{
+  static ExecutionProfiler profiler;
+  return profiler;
+}
+
+ExecutionProfiler::ExecutionProfiler()
+{
+}
+
+void ExecutionProfiler::setTraceFile(const std::string& filename)
+{
+  std::lock_guard<std::mutex> g(lock_);
+  traceFile_ = filename;
+}
+
+std::string ExecutionProfiler::traceFile() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return traceFile_;
+}
+
+bool ExecutionProfiler::enabled() const
+{
+  return !traceFile().empty();
+}
+
+ExecutionProfiler::Start ExecutionProfiler::moduleStarting() const
+{
+  return { std::chrono::steady_clock::now(), boost::chrono::thread_clock::now(), peakResidentMemory() };
+}
+
+std::int64_t ExecutionProfiler::sinceEpoch(std::chrono::steady_clock::time_point t) const
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(t - *epoch_).count();
+}
+
+void ExecutionProfiler::moduleFinished(const Start& start, const std::string& moduleId, const std::string& moduleName,
+  const std::vector<std::string>& upstreamModuleIds, size_t inputBytes, size_t outputBytes, bool succeeded)
+{
+  const auto wallEnd = std::chrono::steady_clock::now();
+  const auto cpuEnd = boost::chrono::thread_clock::now();
+  const auto peakMemory = peakResidentMemory();
+
+  ModuleRun run;
+  run.moduleId = moduleId;
+  run.moduleName = moduleName;
+  run.thread = currentThreadIndex();
+  run.wallTime = std::chrono::duration_cast<std::chrono::microseconds>(wallEnd - start.wall).count();
+  run.cpuTime = boost::chrono::duration_cast<boost::chrono::microseconds>(cpuEnd - start.cpu).count();
+  run.inputBytes = inputBytes;
+  run.outputBytes = outputBytes;
+  run.peakMemoryGrowth = peakMemory > start.peakMemory ? peakMemory - start.peakMemory : 0;
+  run.succeeded = succeeded;
+
+  std::lock_guard<std::mutex> g(lock_);
+  // a module executed on its own still gets a timeline
+  if (!epoch_)
+    epoch_ = start.wall;
+  run.start = sinceEpoch(start.wall);
+
+  std::int64_t ready = 0;
+  for (const auto& upstream : upstreamModuleIds)
+  {
+    auto finished = finishTimes_.find(upstream);
+    if (finished != finishTimes_.end())
+      ready = std::max(ready, finished->second);
+  }
+  run.queueWait = std::max<std::int64_t>(0, run.start - ready);
+
+  finishTimes_[moduleId] = run.start + run.wallTime;
+  runs_.push_back(run);
+}
+
+void ExecutionProfiler::networkExecutionStarting()
+{
+  std::lock_guard<std::mutex> g(lock_);
+  epoch_ = std::chrono::steady_clock::now();
+  runs_.clear();
+  finishTimes_.clear();
+}
+
+void ExecutionProfiler::networkExecutionFinished()
+{
+  const auto file = traceFile();
+  auto finished = runs();
+  if (file.empty() || finished.empty())
+    return;
+
+  {
+    std::ofstream out(file);
+    if (boost::algorithm::ends_with(file, ".folded"))
+      writeFoldedStacks(out);
+    else
+      writeChromeTrace(out);
+    if (!out)
+      logWarning("Could not write execution profile to {}", file);
+    else
+      logInfo("Execution profile of {} module runs written to {}", finished.size(), file);
+  }
+
+  std::sort(finished.begin(), finished.end(), [](const ModuleRun& a, const ModuleRun& b) { return a.wallTime > b.wallTime; });
+  const size_t slowest = std::min<size_t>(5, finished.size());
+  for (size_t i = 0; i < slowest; ++i)
+  {
+    const auto& run = finished[i];
+    logInfo("Profile: {} took {:.1f} ms wall, {:.1f} ms CPU, after waiting {:.1f} ms", run.moduleId,
+      run.wallTime / 1000.0, run.cpuTime / 1000.0, run.queueWait / 1000.0);
+  }
+}
+
+std::vector<ExecutionProfiler::ModuleRun> ExecutionProfiler::runs() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return runs_;
+}
+
+void ExecutionProfiler::writeChromeTrace(std::ostream& out) const
+{
+  const auto all = runs();
+  std::set<int> threads;
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (const auto& run : all)
+  {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "{\"name\":\"" << jsonEscaped(run.moduleId) << "\",\"cat\":\"module\",\"ph\":\"X\""
+      << ",\"ts\":" << run.start << ",\"dur\":" << run.wallTime
+      << ",\"pid\":1,\"tid\":" << run.thread
+      << ",\"args\":{\"module\":\"" << jsonEscaped(run.moduleName) << "\""
+      << ",\"cpu_us\":" << run.cpuTime
+      << ",\"queue_wait_us\":" << run.queueWait
+      << ",\"input_bytes\":" << run.inputBytes
+      << ",\"output_bytes\":" << run.outputBytes
+      << ",\"peak_memory_growth_bytes\":" << run.peakMemoryGrowth
+      << ",\"succeeded\":" << (run.succeeded ? "true" : "false") << "}}";
+    threads.insert(run.thread);
+  }
+  for (auto thread : threads)
+  {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+      << ",\"args\":{\"name\":\"Module thread " << thread << "\"}}";
+  }
+  out << "\n]}\n";
+}
+
+void ExecutionProfiler::writeFoldedStacks(std::ostream& out) const
+{
+  for (const auto& run : runs())
+    out << "network;" << run.moduleName << ";" << run.moduleId << " " << run.wallTime << "\n";
+}
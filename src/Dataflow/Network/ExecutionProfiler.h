@@ -0,0 +1,118 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#ifndef DATAFLOW_NETWORK_EXECUTIONPROFILER_H
+#define DATAFLOW_NETWORK_EXECUTIONPROFILER_H
+
+#include <boost/chrono/thread_clock.hpp>
+#include <boost/noncopyable.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun
+{
+  namespace Dataflow
+  {
+    namespace Networks
+    {
+      /// Escapes quotes and backslashes and drops control characters, for names written into JSON.
+      SCISHARE std::string jsonEscaped(const std::string& str);
+
+      /// Records every module execution while enabled, and writes each network execution to a trace
+      /// file that chrome://tracing, Perfetto or speedscope can open.
+      class SCISHARE ExecutionProfiler : boost::noncopyable
+      {
+      public:
+        static ExecutionProfiler& instance();
+
+        /// Empty disables profiling, the default. A ".folded" extension writes folded stacks for
+        /// flamegraph.pl instead of Chrome trace-event JSON.
+        void setTraceFile(const std::string& filename);
+        std::string traceFile() const;
+        bool enabled() const;
+
+        /// All times in microseconds; start is relative to the beginning of the network execution.
+        struct ModuleRun
+        {
+          std::string moduleId, moduleName;
+          int thread;
+          std::int64_t start, wallTime, cpuTime;
+          /// Time between the last upstream module finishing (or the execution starting) and this one starting.
+          std::int64_t queueWait;
+          size_t inputBytes, outputBytes;
+          /// Growth of the process's peak resident memory, so it includes anything running concurrently.
+          size_t peakMemoryGrowth;
+          bool succeeded;
+        };
+
+        /// Taken on the executing thread as a module starts.
+        struct Start
+        {
+          std::chrono::steady_clock::time_point wall;
+          boost::chrono::thread_clock::time_point cpu;
+          size_t peakMemory;
+        };
+
+        Start moduleStarting() const;
+        /// Must be called on the thread that called moduleStarting.
+        void moduleFinished(const Start& start, const std::string& moduleId, const std::string& moduleName,
+          const std::vector<std::string>& upstreamModuleIds, size_t inputBytes, size_t outputBytes, bool succeeded);
+
+        void networkExecutionStarting();
+        /// Writes the trace file and logs the modules that took longest.
+        void networkExecutionFinished();
+
+        /// Runs of the current (or last) network execution, in the order they finished.
+        std::vector<ModuleRun> runs() const;
+        void writeChromeTrace(std::ostream& out) const;
+        void writeFoldedStacks(std::ostream& out) const;
+
+      private:
+        ExecutionProfiler();
+        std::int64_t sinceEpoch(std::chrono::steady_clock::time_point t) const;
+
+        mutable std::mutex lock_;
+        std::string traceFile_;
+        std::optional<std::chrono::steady_clock::time_point> epoch_;
+        std::vector<ModuleRun> runs_;
+        std::map<std::string, std::int64_t> finishTimes_;
+      };
+    }
+  }
+}
+
+#endif
@@ -28,6 +28,7 @@
 
 #include <memory>
 #include <numeric>
+#include <algorithm>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <chrono>
 #include <atomic>
@@ -41,6 +42,8 @@
 #include <Dataflow/Network/Module.h>
 #include <Dataflow/Network/NullModuleState.h>
 #include <Dataflow/Network/ModuleReexecutionStrategies.h>
+#include <Dataflow/Network/ModuleResultStore.h>
+#include <Dataflow/Network/ExecutionProfiler.h>
 #include <Dataflow/Network/ModuleWithAsyncDynamicPorts.h>
 #include <Dataflow/Network/GeometryGeneratingModule.h>
 // ReSharper disable once CppUnusedIncludeDirective
@@ -173,6 +176,8 @@ namespace SCIRun
         }
 
         boost::atomic<bool> inputsChanged_ { false };
+        bool executionMayBlock_ { false };
+        bool memoizable_ { true };
 
         const ModuleLookupInfo info_;
         ModuleId id_;
@@ -191,6 +196,10 @@ namespace SCIRun
         ModuleInterface::ExecutionSelfRequestSignalType executionSelfRequested_;
 
         ModuleReexecutionStrategyHandle reexecute_;
+        // outputs sent during an execution whose result will be memoized
+        std::optional<ModuleResultStore::Outputs> sentOutputs_;
+        // bytes read and sent per port, while the execution is being profiled
+        std::optional<std::map<std::string, size_t>> inputBytes_, outputBytes_;
         std::atomic<bool> threadStopped_ { false };
 
         ModuleExecutionStateHandle executionState_;
@@ -394,6 +403,15 @@ bool Module::executeWithSignals() NOEXCEPT
     std::cout << starting << std::endl;
   }
 #endif
+  auto& profiler = ExecutionProfiler::instance();
+  std::optional<ExecutionProfiler::Start> profileStart;
+  if (profiler.enabled())
+  {
+    profileStart = profiler.moduleStarting();
+    impl_->inputBytes_.emplace();
+    impl_->outputBytes_.emplace();
+  }
+
   impl_->executeBegins_(id());
   auto start = std::chrono::steady_clock::now();
   {
@@ -412,7 +430,7 @@ bool Module::executeWithSignals() NOEXCEPT
   try
   {
     if (!executionDisabled())
-      execute();
+      executeOrReuseMemoizedResult();
 
     impl_->returnCode_ = true;
     getLogger()->setErrorFlag(false);
@@ -489,10 +507,96 @@ bool Module::executeWithSignals() NOEXCEPT
     impl_->inputsChanged_ = false;
   }
 
+  if (profileStart)
+  {
+    std::vector<std::string> upstream;
+    for (const auto& input : inputPorts())
+    {
+      if (auto connected = input->connectedModuleId())
+        upstream.push_back(*connected);
+    }
+    auto total = [](const std::map<std::string, size_t>& bytes)
+    {
+      return std::accumulate(bytes.begin(), bytes.end(), size_t(0), [](size_t sum, const std::pair<const std::string, size_t>& port) { return sum + port.second; });
+    };
+    profiler.moduleFinished(*profileStart, id().id_, name(), upstream, total(*impl_->inputBytes_), total(*impl_->outputBytes_), impl_->returnCode_);
+    impl_->inputBytes_.reset();
+    impl_->outputBytes_.reset();
+  }
+
   impl_->executeEnds_(elapsed_seconds.count(), id());
   return impl_->returnCode_;
 }
 
+void Module::executeOrReuseMemoizedResult()
+{
+  impl_->sentOutputs_.reset();
+  auto& store = ModuleResultStore::instance();
+  auto key = memoizationKey();
+  if (key)
+  {
+    if (auto outputs = store.lookup(*key))
+    {
+      for (const auto& output : outputPorts())
+      {
+        auto data = outputs->find(output->internalId().toString());
+        if (data != outputs->end())
+        {
+          if (impl_->outputBytes_)
+            (*impl_->outputBytes_)[data->first] = data->second->sizeInBytes();
+          output->sendData(data->second);
+        }
+      }
+      // consume the new-data flags, as reading the inputs in execute() would have
+      for (const auto& input : inputPorts())
+        input->hasChanged();
+      status("Reusing memoized result for module " + id().id_);
+      return;
+    }
+    impl_->sentOutputs_.emplace();
+  }
+
+  execute();
+
+  if (key && !getLogger()->errorReported())
+    store.store(*key, *impl_->sentOutputs_);
+  impl_->sentOutputs_.reset();
+}
+
+// Only modules that compute their outputs from connected inputs and state are memoized: sources such
+// as file readers depend on more than their state, asynchronous modules send outputs at any time, and
+// a reused result skips execute(), so modules with other effects (GUI updates) opt out.
+std::optional<std::string> Module::memoizationKey() const
+{
+  if (!impl_->memoizable_ || !ModuleResultStore::instance().enabled() || 0 == numOutputPorts()
+    || dynamic_cast<const ModuleWithAsyncDynamicPorts*>(this))
+    return {};
+
+  auto inputs = inputPorts();
+  if (std::none_of(inputs.begin(), inputs.end(), [](const InputPortHandle& input) { return input->nconnections() > 0; }))
+    return {};
+
+  ModuleResultStore::Inputs data;
+  for (const auto& input : inputs)
+  {
+    // peeked at the upstream source, so the sink still holds the data for execute() to receive
+    DatatypeHandleOption peeked;
+    if (input->nconnections() > 0)
+    {
+      if (auto upstream = input->connection(0)->oport_->peekData())
+        peeked = upstream;
+    }
+    data.emplace_back(input->internalId().toString(), peeked);
+  }
+  Variable::List state;
+  if (cstate())
+  {
+    for (const auto& key : cstate()->getKeys())
+      state.push_back(cstate()->getValue(key));
+  }
+  return ModuleResultStore::instance().makeKey(name(), ModuleResultStore::stateKey(state), data);
+}
+
 void Module::runProgrammablePortInput()
 {
   auto prog = getOptionalInputAtIndex<MetadataObject>(ProgrammablePortId());
@@ -594,6 +698,8 @@ DatatypeHandleOption Module::get_input_handle(const PortId& id)
 
   auto data = port->getData();
   impl_->metadata_.setMetadata("Input " + id.toString(), metaInfo(data));
+  if (impl_->inputBytes_ && data && *data)
+    (*impl_->inputBytes_)[id.toString()] = (*data)->sizeInBytes();
   return data;
 }
 
@@ -617,6 +723,14 @@ std::vector<DatatypeHandleOption> Module::get_dynamic_input_handles(const PortId
   std::vector<DatatypeHandleOption> options;
   auto getData = [](InputPortHandle input) { return input->getData(); };
   std::transform(portsWithName.begin(), portsWithName.end(), std::back_inserter(options), getData);
+  if (impl_->inputBytes_)
+  {
+    for (size_t i = 0; i < options.size(); ++i)
+    {
+      if (options[i] && *options[i])
+        (*impl_->inputBytes_)[portsWithName[i]->internalId().toString()] = (*options[i])->sizeInBytes();
+    }
+  }
 
   impl_->metadata_.setMetadata("Input " + pid.toString(), metaInfo(options.empty() ? DatatypeHandleOption() : options[0]));
 
@@ -631,7 +745,12 @@ void Module::send_output_handle(const PortId& id, DatatypeHandle data)
     THROW_OUT_OF_RANGE("Output port does not exist: " + id.toString());
   }
 
-  impl_->oports_[id]->sendData(data);
+  auto port = impl_->oports_[id];
+  if (impl_->sentOutputs_ && data)
+    (*impl_->sentOutputs_)[port->internalId().toString()] = data;
+  if (impl_->outputBytes_ && data)
+    (*impl_->outputBytes_)[port->internalId().toString()] = data->sizeInBytes();
+  port->sendData(data);
 }
 
 std::vector<InputPortHandle> Module::findInputPortsWithName(const std::string& name) const
@@ -1160,6 +1279,21 @@ bool Module::isStoppable() const
   return dynamic_cast<const Stoppable*>(this) != nullptr;
 }
 
+bool Module::executionMayBlock() const
+{
+  return impl_->executionMayBlock_ || isStoppable();
+}
+
+void Module::setExecutionMayBlock()
+{
+  impl_->executionMayBlock_ = true;
+}
+
+void Module::disableMemoization()
+{
+  impl_->memoizable_ = false;
+}
+
 void Module::sendFeedbackUpstreamAlongIncomingConnections(const ModuleFeedback& feedback) const
 {
   std::set<OutputPortHandle> outputPortsNotifed;
@@ -107,6 +107,7 @@ namespace Networks {
     std::vector<InputPortHandle> inputPorts() const override final;
     std::vector<OutputPortHandle> outputPorts() const override final;
     bool isStoppable() const override final;
+    bool executionMayBlock() const override final;
     bool oport_connected(const PortId& id) const;
     bool inputsChanged() const;
     std::string name() const override final;
@@ -191,6 +192,11 @@ namespace Networks {
     void send_output_handle(const PortId& id, Core::Datatypes::DatatypeHandle data) override final;
 
     void sendFeedbackUpstreamAlongIncomingConnections(const Core::Datatypes::ModuleFeedback& feedback) const;
+    // Stoppable modules may always block; others whose execute() waits (e.g. in a loop) call this in their constructor.
+    void setExecutionMayBlock();
+    // Modules whose execute() does more than send outputs (e.g. updates its UI through transient state)
+    // call this in their constructor, since a memoized result is sent without calling execute().
+    void disableMemoization();
     std::string stateMetaInfo() const;
     void copyStateToMetadata();
 
@@ -200,6 +206,8 @@ namespace Networks {
     Core::Datatypes::DatatypeHandleOption get_input_handle(const PortId& id) override final;
     std::vector<Core::Datatypes::DatatypeHandleOption> get_dynamic_input_handles(const PortId& id) override final;
     void runProgrammablePortInput();
+    void executeOrReuseMemoizedResult();
+    std::optional<std::string> memoizationKey() const;
     template <class T>
     SharedPointer<T> getRequiredInputAtIndex(const PortId& id);
     template <class T>
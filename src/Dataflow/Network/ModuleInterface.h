@@ -85,6 +85,9 @@ namespace Networks {
     virtual void enqueueExecuteAgain(bool upstream) = 0;
     virtual const MetadataMap& metadata() const = 0;
     virtual bool isStoppable() const = 0;
+    /// True for modules whose execute() may wait on other modules or on the user (playback loops,
+    /// scripts driving the network); the executors never hold them back behind a concurrency cap.
+    virtual bool executionMayBlock() const = 0;
     virtual bool executionDisabled() const = 0;
     virtual void setExecutionDisabled(bool disable) = 0;
     virtual bool isImplementationDisabled() const = 0;
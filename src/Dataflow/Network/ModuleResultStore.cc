@@ -0,0 +1,404 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Dataflow/Network/ModuleResultStore.h>
+#include <Dataflow/Network/DatatypeFileIO.h>
+#include <Core/Logging/Log.h>
+#include <boost/filesystem/operations.hpp>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  // 64-bit FNV-1a; the total length is kept alongside to make collisions between files even less likely.
+  class ContentHasher
+  {
+  public:
+    void add(const char* bytes, size_t size)
+    {
+      for (size_t i = 0; i < size; ++i)
+      {
+        hash_ ^= static_cast<unsigned char>(bytes[i]);
+        hash_ *= 1099511628211ULL;
+      }
+      length_ += size;
+    }
+
+    // length-prefixed, so consecutive strings cannot run together
+    void add(const std::string& str)
+    {
+      const auto size = static_cast<std::uint64_t>(str.size());
+      add(reinterpret_cast<const char*>(&size), sizeof(size));
+      add(str.data(), str.size());
+    }
+
+    std::string str() const
+    {
+      std::ostringstream ostr;
+      ostr << std::hex << std::setfill('0') << std::setw(16) << hash_ << '-' << length_;
+      return ostr.str();
+    }
+
+  private:
+    std::uint64_t hash_ = 14695981039346656037ULL;
+    std::uint64_t length_ = 0;
+  };
+
+  // Hashes the raw bits of each state value, tagged with its type, so values that print alike
+  // (doubles differing past the stream precision, 1 and true and "1") never share a key.
+  class StateHasher : public boost::static_visitor<>
+  {
+  public:
+    explicit StateHasher(ContentHasher& hasher) : hasher_(hasher) {}
+
+    void operator()(int i) const { addRaw('i', i); }
+    void operator()(double d) const { addRaw('d', d); }
+    void operator()(bool b) const { addRaw('b', b); }
+    void operator()(const std::string& str) const
+    {
+      hasher_.add("s");
+      hasher_.add(str);
+    }
+    void operator()(const Core::Algorithms::AlgoOption& option) const
+    {
+      hasher_.add("o");
+      hasher_.add(option.option_);
+    }
+    void operator()(const Core::Algorithms::Variable::List& list) const
+    {
+      addRaw('l', static_cast<std::uint64_t>(list.size()));
+      for (const auto& var : list)
+        add(var);
+    }
+
+    void add(const Core::Algorithms::Variable& var) const
+    {
+      hasher_.add(var.name().name());
+      boost::apply_visitor(*this, var.value());
+    }
+
+  private:
+    template <typename T>
+    void addRaw(char tag, const T& value) const
+    {
+      hasher_.add(&tag, 1);
+      hasher_.add(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    ContentHasher& hasher_;
+  };
+
+  std::optional<std::string> hashFile(const boost::filesystem::path& file)
+  {
+    std::ifstream in(file.string(), std::ios::binary);
+    if (!in)
+      return {};
+    ContentHasher hasher;
+    std::vector<char> buffer(1 << 20);
+    while (in)
+    {
+      in.read(buffer.data(), buffer.size());
+      hasher.add(buffer.data(), static_cast<size_t>(in.gcount()));
+    }
+    if (in.bad())
+      return {};
+    return hasher.str();
+  }
+
+  void removeQuietly(const boost::filesystem::path& file)
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove(file, ec);
+  }
+
+  // written next to the destination and renamed, so a crash never leaves a partial file behind
+  boost::filesystem::path temporaryFile(const boost::filesystem::path& dir)
+  {
+    return dir / boost::filesystem::unique_path("tmp-%%%%-%%%%-%%%%-%%%%");
+  }
+
+  const size_t MIN_PRUNED_SIZE = 64;
+}
+
+ModuleResultStore& ModuleResultStore::instance()
+{
+  static ModuleResultStore store;
+  return store;
+}
+
+ModuleResultStore::ModuleResultStore() : prunedSize_(MIN_PRUNED_SIZE), hits_(0), misses_(0), stores_(0)
+{
+}
+
+void ModuleResultStore::setDirectory(const boost::filesystem::path& dir)
+{
+  auto usable = dir;
+  if (!dir.empty())
+  {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(dir / "objects", ec);
+    if (!ec)
+      boost::filesystem::create_directories(dir / "results", ec);
+    if (ec)
+    {
+      logWarning("Could not create module result store {}, memoization is disabled: {}", dir.string(), ec.message());
+      usable.clear();
+    }
+  }
+  std::lock_guard<std::mutex> g(lock_);
+  directory_ = usable;
+  hashes_.clear();
+  prunedSize_ = MIN_PRUNED_SIZE;
+}
+
+boost::filesystem::path ModuleResultStore::directory() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return directory_;
+}
+
+bool ModuleResultStore::enabled() const
+{
+  return !directory().empty();
+}
+
+boost::filesystem::path ModuleResultStore::objectFile(const std::string& hash) const
+{
+  return directory() / "objects" / (hash + ".pio");
+}
+
+boost::filesystem::path ModuleResultStore::resultFile(const std::string& key) const
+{
+  return directory() / "results" / key;
+}
+
+std::optional<std::string> ModuleResultStore::contentHash(const DatatypeHandle& data)
+{
+  if (!data || !enabled() || !isPersistentDatatype(*data))
+    return {};
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    auto known = hashes_.find(data->id());
+    if (known != hashes_.end())
+      return known->second.second;
+  }
+
+  // hashing the serialized form also leaves the object in the store, ready for any result that sends it
+  const auto tmp = temporaryFile(directory() / "objects");
+  if (!writeDatatypeFile(data, tmp.string()))
+  {
+    removeQuietly(tmp);
+    return {};
+  }
+  auto hash = hashFile(tmp);
+  if (!hash)
+  {
+    removeQuietly(tmp);
+    return {};
+  }
+
+  const auto object = objectFile(*hash);
+  boost::system::error_code ec;
+  if (boost::filesystem::exists(object, ec))
+    removeQuietly(tmp);
+  else
+  {
+    boost::filesystem::rename(tmp, object, ec);
+    if (ec)
+    {
+      removeQuietly(tmp);
+      return {};
+    }
+  }
+
+  std::lock_guard<std::mutex> g(lock_);
+  remember(data, *hash);
+  return hash;
+}
+
+void ModuleResultStore::remember(const DatatypeHandle& data, const std::string& hash)
+{
+  hashes_[data->id()] = { data, hash };
+  // pruning whenever the map doubles keeps it proportional to the live datatypes
+  if (hashes_.size() >= 2 * prunedSize_)
+  {
+    for (auto i = hashes_.begin(); i != hashes_.end();)
+    {
+      if (i->second.first.expired())
+        i = hashes_.erase(i);
+      else
+        ++i;
+    }
+    prunedSize_ = std::max<size_t>(hashes_.size(), MIN_PRUNED_SIZE);
+  }
+}
+
+size_t ModuleResultStore::numKnownHashes() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return hashes_.size();
+}
+
+std::string ModuleResultStore::stateKey(const Core::Algorithms::Variable::List& state)
+{
+  ContentHasher hasher;
+  StateHasher values(hasher);
+  for (const auto& var : state)
+    values.add(var);
+  return hasher.str();
+}
+
+std::optional<std::string> ModuleResultStore::makeKey(const std::string& moduleName, const std::string& state, const Inputs& inputs)
+{
+  if (!enabled())
+    return {};
+
+  ContentHasher hasher;
+  hasher.add(moduleName);
+  hasher.add(state);
+  for (const auto& input : inputs)
+  {
+    hasher.add(input.first);
+    if (!input.second || !*input.second)
+    {
+      hasher.add("none");
+      continue;
+    }
+    auto hash = contentHash(*input.second);
+    if (!hash)
+      return {};
+    hasher.add(*hash);
+  }
+  return hasher.str();
+}
+
+std::optional<ModuleResultStore::Outputs> ModuleResultStore::lookup(const std::string& key)
+{
+  Outputs outputs;
+  bool found = false;
+  if (enabled())
+  {
+    std::ifstream in(resultFile(key).string());
+    found = in.good();
+    std::string port, hash;
+    while (found && in >> port >> hash)
+    {
+      const auto object = objectFile(hash);
+      boost::system::error_code ec;
+      auto data = boost::filesystem::exists(object, ec) ? readDatatypeFile(object.string()) : nullptr;
+      if (!data)
+      {
+        found = false;
+        break;
+      }
+      {
+        std::lock_guard<std::mutex> g(lock_);
+        remember(data, hash);
+      }
+      outputs[port] = data;
+    }
+    found = found && !outputs.empty();
+  }
+
+  std::lock_guard<std::mutex> g(lock_);
+  if (found)
+  {
+    ++hits_;
+    return outputs;
+  }
+  ++misses_;
+  return {};
+}
+
+void ModuleResultStore::store(const std::string& key, const Outputs& outputs)
+{
+  if (!enabled() || outputs.empty())
+    return;
+
+  std::ostringstream listing;
+  for (const auto& output : outputs)
+  {
+    auto hash = contentHash(output.second);
+    if (!hash)
+      return;
+    listing << output.first << ' ' << *hash << '\n';
+  }
+
+  const auto tmp = temporaryFile(directory() / "results");
+  {
+    std::ofstream out(tmp.string());
+    out << listing.str();
+    if (!out)
+    {
+      removeQuietly(tmp);
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp, resultFile(key), ec);
+  if (ec)
+  {
+    removeQuietly(tmp);
+    return;
+  }
+
+  std::lock_guard<std::mutex> g(lock_);
+  ++stores_;
+}
+
+size_t ModuleResultStore::numHits() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return hits_;
+}
+
+size_t ModuleResultStore::numMisses() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return misses_;
+}
+
+size_t ModuleResultStore::numStores() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return stores_;
+}
+
+void ModuleResultStore::resetStatistics()
+{
+  std::lock_guard<std::mutex> g(lock_);
+  hits_ = misses_ = stores_ = 0;
+}
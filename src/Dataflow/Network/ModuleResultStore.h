@@ -0,0 +1,107 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#ifndef DATAFLOW_NETWORK_MODULERESULTSTORE_H
+#define DATAFLOW_NETWORK_MODULERESULTSTORE_H
+
+#include <Core/Datatypes/Datatype.h>
+#include <Core/Algorithms/Base/Variable.h>
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun
+{
+  namespace Dataflow
+  {
+    namespace Networks
+    {
+      /// On-disk, content-addressed store of module outputs. A result is keyed on a hash of the
+      /// module name, its state and the serialized contents of its inputs, so it is found again when
+      /// equal data arrives with a new datatype id, after a network is reloaded, or in a later
+      /// session. Disabled until a directory is set.
+      ///
+      /// Layout: objects/<content hash>.pio holds one datatype, results/<key> lists the output
+      /// port ids of one module execution with the content hash sent on each.
+      class SCISHARE ModuleResultStore : boost::noncopyable
+      {
+      public:
+        static ModuleResultStore& instance();
+
+        /// Empty disables memoization, the default.
+        void setDirectory(const boost::filesystem::path& dir);
+        boost::filesystem::path directory() const;
+        bool enabled() const;
+
+        /// Output data sent by one execution, by output port id.
+        using Outputs = std::map<std::string, Core::Datatypes::DatatypeHandle>;
+        using Inputs = std::vector<std::pair<std::string, Core::Datatypes::DatatypeHandleOption>>;
+
+        /// Hash of the exact state values, for makeKey; printing them would round doubles.
+        static std::string stateKey(const Core::Algorithms::Variable::List& state);
+        /// None when an input cannot be serialized, so the module must just execute.
+        std::optional<std::string> makeKey(const std::string& moduleName, const std::string& state, const Inputs& inputs);
+        /// Counts a hit or a miss.
+        std::optional<Outputs> lookup(const std::string& key);
+        /// Nothing is stored if any output cannot be serialized.
+        void store(const std::string& key, const Outputs& outputs);
+        /// Hash of the serialized data, computed once per datatype id; none if it cannot be serialized.
+        std::optional<std::string> contentHash(const Core::Datatypes::DatatypeHandle& data);
+        /// Hashes kept for datatypes that may still be hashed again.
+        size_t numKnownHashes() const;
+
+        size_t numHits() const;
+        size_t numMisses() const;
+        size_t numStores() const;
+        void resetStatistics();
+
+      private:
+        ModuleResultStore();
+        boost::filesystem::path objectFile(const std::string& hash) const;
+        boost::filesystem::path resultFile(const std::string& key) const;
+        void remember(const Core::Datatypes::DatatypeHandle& data, const std::string& hash);
+
+        mutable std::mutex lock_;
+        boost::filesystem::path directory_;
+        // only the hashes of live datatypes are worth keeping: ids are never reused
+        std::map<Core::Datatypes::Datatype::id_type, std::pair<std::weak_ptr<Core::Datatypes::Datatype>, std::string>> hashes_;
+        size_t prunedSize_;
+        size_t hits_, misses_, stores_;
+      };
+    }
+  }
+}
+
+#endif
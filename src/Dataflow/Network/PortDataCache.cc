@@ -0,0 +1,349 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/PortDataCache.h>
+#include <Core/Datatypes/Datatype.h>
+#include <Dataflow/Network/DatatypeFileIO.h>
+#include <Core/Logging/Log.h>
+#include <boost/filesystem/operations.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+CachedPortData::CachedPortData() : dataId_(0), size_(0), lastUse_(0), generation_(0), spilledGeneration_(0),
+  pins_(0), evicting_(false), spillable_(false)
+{
+  PortDataCache::instance().add(this);
+}
+
+CachedPortData::~CachedPortData()
+{
+  PortDataCache::instance().remove(this);
+}
+
+void CachedPortData::set(DatatypeHandle data)
+{
+  PortDataCache::instance().set(this, data);
+}
+
+DatatypeHandle CachedPortData::get()
+{
+  return PortDataCache::instance().get(this);
+}
+
+void CachedPortData::clear()
+{
+  PortDataCache::instance().clear(this);
+}
+
+Datatype::id_type CachedPortData::dataId() const
+{
+  std::lock_guard<std::mutex> g(PortDataCache::instance().lock_);
+  return dataId_;
+}
+
+bool CachedPortData::hasData() const
+{
+  std::lock_guard<std::mutex> g(PortDataCache::instance().lock_);
+  return data_ || (!spillFile_.empty() && spilledGeneration_ == generation_);
+}
+
+bool CachedPortData::isResident() const
+{
+  std::lock_guard<std::mutex> g(PortDataCache::instance().lock_);
+  return data_ != nullptr;
+}
+
+bool CachedPortData::isSpilled() const
+{
+  std::lock_guard<std::mutex> g(PortDataCache::instance().lock_);
+  return !spillFile_.empty() && spilledGeneration_ == generation_;
+}
+
+void CachedPortData::pin()
+{
+  std::lock_guard<std::mutex> g(PortDataCache::instance().lock_);
+  ++pins_;
+}
+
+void CachedPortData::unpin()
+{
+  {
+    std::lock_guard<std::mutex> g(PortDataCache::instance().lock_);
+    if (pins_ > 0)
+      --pins_;
+  }
+  // the entry may have been kept over budget only because of this pin
+  PortDataCache::instance().enforceBudget(nullptr);
+}
+
+PortDataCache& PortDataCache::instance()
+{
+  static PortDataCache cache;
+  return cache;
+}
+
+PortDataCache::PortDataCache() : budget_(0), resident_(0), evictions_(0), spills_(0), reloads_(0),
+  clock_(0), fileCounter_(0)
+{
+}
+
+void PortDataCache::setMemoryBudget(size_t bytes)
+{
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    budget_ = bytes;
+  }
+  enforceBudget(nullptr);
+}
+
+size_t PortDataCache::memoryBudget() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return budget_;
+}
+
+void PortDataCache::setSpillDirectory(const boost::filesystem::path& dir)
+{
+  if (!dir.empty())
+  {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(dir, ec);
+    if (ec)
+      logWarning("Could not create port cache spill directory {}: {}", dir.string(), ec.message());
+  }
+  std::lock_guard<std::mutex> g(lock_);
+  spillDirectory_ = dir;
+}
+
+boost::filesystem::path PortDataCache::spillDirectory() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return spillDirectory_;
+}
+
+size_t PortDataCache::residentBytes() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return resident_;
+}
+
+size_t PortDataCache::numEvictions() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return evictions_;
+}
+
+size_t PortDataCache::numSpills() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return spills_;
+}
+
+size_t PortDataCache::numReloads() const
+{
+  std::lock_guard<std::mutex> g(lock_);
+  return reloads_;
+}
+
+void PortDataCache::add(CachedPortData* entry)
+{
+  std::lock_guard<std::mutex> g(lock_);
+  entries_.insert(entry);
+}
+
+void PortDataCache::remove(CachedPortData* entry)
+{
+  std::unique_lock<std::mutex> lock(lock_);
+  evicted_.wait(lock, [entry]() { return !entry->evicting_; });
+  dropResident(entry);
+  removeFile(entry->spillFile_);
+  entries_.erase(entry);
+}
+
+void PortDataCache::set(CachedPortData* entry, DatatypeHandle data)
+{
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    ++entry->generation_;
+    dropResident(entry);
+    removeFile(entry->spillFile_);
+    entry->spillable_ = data && isPersistentDatatype(*data);
+    entry->dataId_ = data ? data->id() : 0;
+    if (data)
+      makeResident(entry, data);
+  }
+  enforceBudget(entry);
+}
+
+DatatypeHandle PortDataCache::get(CachedPortData* entry)
+{
+  boost::filesystem::path file;
+  std::uint64_t generation;
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    entry->lastUse_ = ++clock_;
+    if (entry->data_ || entry->spillFile_.empty() || entry->spilledGeneration_ != entry->generation_)
+      return entry->data_;
+    file = entry->spillFile_;
+    generation = entry->generation_;
+  }
+
+  auto data = readDatatypeFile(file.string());
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    // new data arrived, or another reader reloaded it first
+    if (entry->generation_ != generation || entry->data_ || !data)
+      return entry->data_;
+    ++reloads_;
+    makeResident(entry, data);
+  }
+  enforceBudget(entry);
+  return data;
+}
+
+void PortDataCache::clear(CachedPortData* entry)
+{
+  std::lock_guard<std::mutex> g(lock_);
+  ++entry->generation_;
+  dropResident(entry);
+  removeFile(entry->spillFile_);
+}
+
+void PortDataCache::makeResident(CachedPortData* entry, DatatypeHandle data)
+{
+  entry->data_ = data;
+  entry->size_ = data->sizeInBytes();
+  entry->lastUse_ = ++clock_;
+  resident_ += entry->size_;
+}
+
+void PortDataCache::dropResident(CachedPortData* entry)
+{
+  if (entry->data_)
+  {
+    resident_ -= entry->size_;
+    entry->data_.reset();
+    entry->size_ = 0;
+  }
+}
+
+CachedPortData* PortDataCache::leastRecentlyUsed(const CachedPortData* keep) const
+{
+  CachedPortData* oldest = nullptr;
+  for (auto entry : entries_)
+  {
+    if (entry == keep || !entry->data_ || entry->evicting_ || 0 == entry->size_)
+      continue;
+    // data a sink has yet to receive may only leave memory for the disk
+    if (entry->pins_ > 0 && !isOnDisk(entry) && (spillDirectory_.empty() || !entry->spillable_))
+      continue;
+    if (!oldest || entry->lastUse_ < oldest->lastUse_)
+      oldest = entry;
+  }
+  return oldest;
+}
+
+bool PortDataCache::isOnDisk(const CachedPortData* entry)
+{
+  return !entry->spillFile_.empty() && entry->spilledGeneration_ == entry->generation_;
+}
+
+void PortDataCache::enforceBudget(const CachedPortData* keep)
+{
+  for (;;)
+  {
+    CachedPortData* victim;
+    DatatypeHandle data;
+    boost::filesystem::path file;
+    std::uint64_t generation;
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      if (0 == budget_ || resident_ <= budget_)
+        return;
+      victim = leastRecentlyUsed(keep);
+      if (!victim)
+        return;
+      ++evictions_;
+
+      if (isOnDisk(victim) || spillDirectory_.empty() || !victim->spillable_)
+      {
+        // without a copy on disk, the producing module will execute again
+        dropResident(victim);
+        continue;
+      }
+
+      victim->evicting_ = true;
+      data = victim->data_;
+      generation = victim->generation_;
+      file = spillDirectory_ / ("port-data-" + std::to_string(++fileCounter_) + ".pio");
+    }
+
+    // serialization can take a while, so other ports stay usable meanwhile
+    const bool written = writeDatatypeFile(data, file.string());
+    data.reset();
+
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      victim->evicting_ = false;
+      if (victim->generation_ != generation)
+      {
+        removeFile(file);
+      }
+      else
+      {
+        if (written)
+        {
+          victim->spillFile_ = file;
+          victim->spilledGeneration_ = generation;
+          ++spills_;
+        }
+        else
+        {
+          removeFile(file);
+          victim->spillable_ = false;
+        }
+        if (written || 0 == victim->pins_)
+          dropResident(victim);
+      }
+    }
+    evicted_.notify_all();
+  }
+}
+
+void PortDataCache::removeFile(boost::filesystem::path& file)
+{
+  if (!file.empty())
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove(file, ec);
+    file.clear();
+  }
+}
@@ -0,0 +1,137 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef DATAFLOW_NETWORK_PORTDATACACHE_H
+#define DATAFLOW_NETWORK_PORTDATACACHE_H
+
+#include <Core/Datatypes/Datatype.h>
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun
+{
+  namespace Dataflow
+  {
+    namespace Networks
+    {
+      class PortDataCache;
+
+      /// The datatype last sent by one output port. It stays resident until the global memory
+      /// budget forces it out; it is then written to the spill directory (if one is set) and read
+      /// back on the next access, or else dropped so the producing module executes again.
+      class SCISHARE CachedPortData : boost::noncopyable
+      {
+      public:
+        CachedPortData();
+        ~CachedPortData();
+
+        void set(Core::Datatypes::DatatypeHandle data);
+        /// Id of the data as originally set; a reloaded copy gets a new Datatype id.
+        Core::Datatypes::Datatype::id_type dataId() const;
+        /// Reloads spilled data; null if there is none.
+        Core::Datatypes::DatatypeHandle get();
+        /// True when get() will return data: resident or spilled.
+        bool hasData() const;
+        void clear();
+        bool isResident() const;
+        bool isSpilled() const;
+        /// Held by each sink the data was sent to until it receives it. A pinned entry is only
+        /// evicted by spilling, so until then it stays resident and counts against the budget.
+        void pin();
+        void unpin();
+
+      private:
+        friend class PortDataCache;
+        // all guarded by the PortDataCache lock
+        Core::Datatypes::DatatypeHandle data_;
+        Core::Datatypes::Datatype::id_type dataId_;
+        size_t size_;
+        std::uint64_t lastUse_;
+        std::uint64_t generation_;
+        std::uint64_t spilledGeneration_;
+        size_t pins_;
+        boost::filesystem::path spillFile_;
+        bool evicting_;
+        bool spillable_;
+      };
+
+      using CachedPortDataHandle = SharedPointer<CachedPortData>;
+
+      /// Global memory budget shared by all output port caches, with least-recently-used eviction.
+      class SCISHARE PortDataCache : boost::noncopyable
+      {
+      public:
+        static PortDataCache& instance();
+
+        /// 0 means unlimited, the default.
+        void setMemoryBudget(size_t bytes);
+        size_t memoryBudget() const;
+        /// Evicted data is serialized here with the binary Piostream; empty disables spilling.
+        void setSpillDirectory(const boost::filesystem::path& dir);
+        boost::filesystem::path spillDirectory() const;
+
+        size_t residentBytes() const;
+        size_t numEvictions() const;
+        size_t numSpills() const;
+        size_t numReloads() const;
+
+      private:
+        friend class CachedPortData;
+        PortDataCache();
+
+        void add(CachedPortData* entry);
+        void remove(CachedPortData* entry);
+        void set(CachedPortData* entry, Core::Datatypes::DatatypeHandle data);
+        Core::Datatypes::DatatypeHandle get(CachedPortData* entry);
+        void clear(CachedPortData* entry);
+        void makeResident(CachedPortData* entry, Core::Datatypes::DatatypeHandle data);
+        void dropResident(CachedPortData* entry);
+        void enforceBudget(const CachedPortData* keep);
+        CachedPortData* leastRecentlyUsed(const CachedPortData* keep) const;
+        static bool isOnDisk(const CachedPortData* entry);
+        static void removeFile(boost::filesystem::path& file);
+
+        mutable std::mutex lock_;
+        std::condition_variable evicted_;
+        std::set<CachedPortData*> entries_;
+        size_t budget_, resident_;
+        size_t evictions_, spills_, reloads_;
+        std::uint64_t clock_, fileCounter_;
+        boost::filesystem::path spillDirectory_;
+      };
+    }
+  }
+}
+
+#endif
@@ -39,6 +39,7 @@ using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Algorithms::General;
 
 SimpleSink::SimpleSink() :
+  pinned_(false),
   hasChanged_(false),
   checkForNewDataOnSetting_(false)
 {
@@ -47,6 +48,7 @@ SimpleSink::SimpleSink() :
 
 SimpleSink::~SimpleSink()
 {
+  releasePin();
   instances_.erase(this);
 }
 
@@ -78,12 +80,40 @@ void SimpleSink::invalidateAll()
 }
 
 DatatypeHandleOption SimpleSink::receive()
+{
+  auto data = currentData();
+  releasePin();
+  if (data)
+    return data;
+  return DatatypeHandleOption();
+}
+
+DatatypeHandle SimpleSink::currentData()
 {
   if (auto strong = weakData_.lock())
   {
     return strong;
   }
-  return DatatypeHandleOption();
+  // evicted from the source's cache since it was sent
+  if (auto provider = provider_.lock())
+  {
+    if (auto data = provider->get())
+    {
+      weakData_ = data;
+      return data;
+    }
+  }
+  return nullptr;
+}
+
+void SimpleSink::releasePin()
+{
+  if (pinned_)
+  {
+    pinned_ = false;
+    if (auto provider = provider_.lock())
+      provider->unpin();
+  }
 }
 
 void SimpleSink::setData(DatatypeHandle data)
@@ -100,15 +130,43 @@ void SimpleSink::setData(DatatypeHandle data)
     hasChanged_ = true;
   }
 
+  releasePin();
+  provider_.reset();
+  dataId_.reset();
   weakData_ = data;
   if (data && hasChanged_ && checkForNewDataOnSetting_)
     dataHasChanged_(data);
 }
 
+void SimpleSink::setCachedData(DatatypeHandle data, CachedPortDataHandle provider)
+{
+  if (data)
+  {
+    const auto id = provider->dataId();
+    hasChanged_ = !dataId_ || *dataId_ != id;
+    dataId_ = id;
+  }
+
+  // pinned before the old pin is released, in case both are the same entry
+  if (data)
+    provider->pin();
+  releasePin();
+  provider_ = provider;
+  weakData_ = data;
+  pinned_ = data != nullptr;
+  if (data && hasChanged_ && checkForNewDataOnSetting_)
+    dataHasChanged_(data);
+}
+
+void SimpleSink::invalidateProvider()
+{
+  releasePin();
+  provider_.reset();
+}
+
 void SimpleSink::forceFireDataHasChanged()
 {
-  auto data = weakData_.lock();
-  dataHasChanged_(data);
+  dataHasChanged_(currentData());
 }
 
 DatatypeSinkInterface* SimpleSink::clone() const
@@ -131,12 +189,12 @@ boost::signals2::connection SimpleSink::connectDataHasChanged(const DataHasChang
 
 void SimpleSource::cacheData(DatatypeHandle data)
 {
-  data_ = data;
+  data_->set(data);
 }
 
 DatatypeHandle SimpleSource::peekData() const
 {
-  return data_;
+  return data_->get();
 }
 
 void SimpleSource::send(DatatypeSinkInterfaceHandle receiver) const
@@ -145,15 +203,15 @@ void SimpleSource::send(DatatypeSinkInterfaceHandle receiver) const
   if (!sink)
     THROW_INVALID_ARGUMENT("SimpleSource can only send to SimpleSinks");
 
-  sink->setData(data_);
+  sink->setCachedData(data_->get(), data_);
 }
 
 bool SimpleSource::hasData() const
 {
-  return data_ != nullptr;
+  return data_->hasData();
 }
 
-SimpleSource::SimpleSource()
+SimpleSource::SimpleSource() : data_(makeShared<CachedPortData>())
 {
   instances_.insert(this);
 }
@@ -168,11 +226,11 @@ std::set<SimpleSource*> SimpleSource::instances_;
 void SimpleSource::clearAllSources()
 {
   for (auto source : instances_)
-    source->data_.reset();
+    source->data_->clear();
 }
 
 std::string SimpleSource::describeData() const
 {
   DescribeDatatype dd;
-  return dd.describe(data_);
+  return dd.describe(data_->get());
 }
@@ -32,6 +32,7 @@
 #define DATAFLOW_NETWORK_SIMPLESOURCESINK_H
 
 #include <Dataflow/Network/DataflowInterfaces.h>
+#include <Dataflow/Network/PortDataCache.h>
 #include <set>
 #include <Dataflow/Network/share.h>
 
@@ -53,7 +54,10 @@ namespace SCIRun
         DatatypeSinkInterface* clone() const override;
         bool hasChanged() const override;
         void setData(Core::Datatypes::DatatypeHandle data);
-        void invalidateProvider() override { /*TODO*/ }
+        /// Like setData, but the data can be fetched again from provider after the source's cache
+        /// evicts it, and is identified by the id it had when cached, so a reload is not a change.
+        void setCachedData(Core::Datatypes::DatatypeHandle data, CachedPortDataHandle provider);
+        void invalidateProvider() override;
         boost::signals2::connection connectDataHasChanged(const DataHasChangedSignalType::slot_type& subscriber) override;
         void forceFireDataHasChanged() override;
 
@@ -61,7 +65,14 @@ namespace SCIRun
         static void setGlobalPortCachingFlag(bool value);
 
       private:
+        Core::Datatypes::DatatypeHandle currentData();
+        void releasePin();
+
         WeakDatatypeHandle weakData_;
+        std::weak_ptr<CachedPortData> provider_;
+        // the provider is pinned from send to the first receive, so in-flight data stays within the budget
+        bool pinned_;
+        std::optional<Core::Datatypes::Datatype::id_type> dataId_;
         mutable bool hasChanged_;
         DataHasChangedSignalType dataHasChanged_;
         bool checkForNewDataOnSetting_;
@@ -97,7 +108,7 @@ namespace SCIRun
 
         static void clearAllSources();
       protected:
-        SCIRun::Core::Datatypes::DatatypeHandle data_;
+        CachedPortDataHandle data_;
         static std::set<SimpleSource*> instances_;
       };
     }
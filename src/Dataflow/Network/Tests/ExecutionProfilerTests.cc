@@ -0,0 +1,109 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Dataflow/Network/ExecutionProfiler.h>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+using namespace SCIRun::Dataflow::Networks;
+
+class ExecutionProfilerTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ExecutionProfiler::instance().networkExecutionStarting();
+  }
+
+  static void run(const std::string& id, const std::vector<std::string>& upstream, std::chrono::milliseconds duration)
+  {
+    auto& profiler = ExecutionProfiler::instance();
+    auto start = profiler.moduleStarting();
+    std::this_thread::sleep_for(duration);
+    profiler.moduleFinished(start, id, id.substr(0, id.find(':')), upstream, 100, 200, true);
+  }
+};
+
+TEST_F(ExecutionProfilerTests, DisabledWithoutTraceFile)
+{
+  EXPECT_FALSE(ExecutionProfiler::instance().enabled());
+}
+
+TEST_F(ExecutionProfilerTests, RecordsEachModuleRun)
+{
+  run("ReadMatrix:0", {}, std::chrono::milliseconds(20));
+  run("TransposeMatrix:0", { "ReadMatrix:0" }, std::chrono::milliseconds(5));
+
+  auto runs = ExecutionProfiler::instance().runs();
+  ASSERT_EQ(2, runs.size());
+  EXPECT_EQ("ReadMatrix:0", runs[0].moduleId);
+  EXPECT_EQ("ReadMatrix", runs[0].moduleName);
+  EXPECT_GE(runs[0].wallTime, 20000);
+  EXPECT_EQ(100, runs[1].inputBytes);
+  EXPECT_EQ(200, runs[1].outputBytes);
+  EXPECT_TRUE(runs[1].succeeded);
+  EXPECT_GE(runs[1].start, runs[0].start + runs[0].wallTime);
+}
+
+TEST_F(ExecutionProfilerTests, QueueWaitStartsWhenUpstreamFinishes)
+{
+  run("ReadMatrix:0", {}, std::chrono::milliseconds(20));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  run("TransposeMatrix:0", { "ReadMatrix:0" }, std::chrono::milliseconds(1));
+
+  auto runs = ExecutionProfiler::instance().runs();
+  ASSERT_EQ(2, runs.size());
+  // the first module waited only for the execution to start, the second for its upstream module
+  EXPECT_LT(runs[0].queueWait, 10000);
+  EXPECT_GE(runs[1].queueWait, 10000);
+  EXPECT_LT(runs[1].queueWait, runs[1].start);
+}
+
+TEST_F(ExecutionProfilerTests, WritesChromeTraceEvents)
+{
+  run("ReadMatrix:0", {}, std::chrono::milliseconds(1));
+  std::ostringstream trace;
+  ExecutionProfiler::instance().writeChromeTrace(trace);
+
+  const auto json = trace.str();
+  EXPECT_EQ(0, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"ReadMatrix:0\",\"cat\":\"module\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, json.find("\"input_bytes\":100,\"output_bytes\":200"));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"thread_name\",\"ph\":\"M\""));
+}
+
+TEST_F(ExecutionProfilerTests, WritesFoldedStacks)
+{
+  run("ReadMatrix:0", {}, std::chrono::milliseconds(1));
+  std::ostringstream folded;
+  ExecutionProfiler::instance().writeFoldedStacks(folded);
+  EXPECT_EQ(0, folded.str().find("network;ReadMatrix;ReadMatrix:0 "));
+}
@@ -0,0 +1,151 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Dataflow/Network/ModuleResultStore.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+class ModuleResultStoreTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("result-store-%%%%-%%%%");
+    ModuleResultStore::instance().setDirectory(dir_);
+    ModuleResultStore::instance().resetStatistics();
+  }
+
+  void TearDown() override
+  {
+    ModuleResultStore::instance().setDirectory({});
+    boost::filesystem::remove_all(dir_);
+  }
+
+  static ModuleResultStore::Inputs input(DatatypeHandle data)
+  {
+    return { { "InputMatrix:0", DatatypeHandleOption(data) } };
+  }
+
+  boost::filesystem::path dir_;
+};
+
+TEST_F(ModuleResultStoreTests, DisabledWithoutDirectory)
+{
+  auto& store = ModuleResultStore::instance();
+  store.setDirectory({});
+  EXPECT_FALSE(store.enabled());
+  EXPECT_FALSE(store.makeKey("TransposeMatrix", "{}", input(makeShared<DenseMatrix>(2, 2, 1.0))));
+}
+
+TEST_F(ModuleResultStoreTests, KeyDependsOnContentsNotDatatypeId)
+{
+  auto& store = ModuleResultStore::instance();
+  auto key1 = store.makeKey("TransposeMatrix", "{}", input(makeShared<DenseMatrix>(3, 3, 1.0)));
+  auto key2 = store.makeKey("TransposeMatrix", "{}", input(makeShared<DenseMatrix>(3, 3, 1.0)));
+  auto otherData = store.makeKey("TransposeMatrix", "{}", input(makeShared<DenseMatrix>(3, 3, 2.0)));
+  auto otherState = store.makeKey("TransposeMatrix", "{[Option, 1]}", input(makeShared<DenseMatrix>(3, 3, 1.0)));
+  auto otherModule = store.makeKey("ReportMatrixInfo", "{}", input(makeShared<DenseMatrix>(3, 3, 1.0)));
+
+  ASSERT_TRUE(key1 && key2 && otherData && otherState && otherModule);
+  EXPECT_EQ(*key1, *key2);
+  EXPECT_NE(*key1, *otherData);
+  EXPECT_NE(*key1, *otherState);
+  EXPECT_NE(*key1, *otherModule);
+}
+
+TEST_F(ModuleResultStoreTests, StoredResultIsFoundAgain)
+{
+  auto& store = ModuleResultStore::instance();
+  auto key = store.makeKey("TransposeMatrix", "{}", input(makeShared<DenseMatrix>(4, 4, 1.0)));
+  ASSERT_TRUE(key);
+  EXPECT_FALSE(store.lookup(*key));
+
+  auto output = makeShared<DenseMatrix>(4, 4, 7.0);
+  store.store(*key, { { "OutputMatrix:0", output } });
+  EXPECT_EQ(1, store.numStores());
+
+  auto found = store.lookup(*key);
+  ASSERT_TRUE(found);
+  ASSERT_EQ(1, found->count("OutputMatrix:0"));
+  auto matrix = std::dynamic_pointer_cast<DenseMatrix>(found->at("OutputMatrix:0"));
+  ASSERT_TRUE(matrix != nullptr);
+  EXPECT_EQ(7.0, (*matrix)(3, 3));
+  EXPECT_EQ(1, store.numHits());
+  EXPECT_EQ(1, store.numMisses());
+
+  // the reloaded copy has a new id but the same content hash as what was stored
+  EXPECT_NE(output->id(), matrix->id());
+  EXPECT_EQ(store.contentHash(output), store.contentHash(matrix));
+}
+
+TEST_F(ModuleResultStoreTests, ResultsSurviveANewSession)
+{
+  auto& store = ModuleResultStore::instance();
+  auto key = store.makeKey("TransposeMatrix", "{}", input(makeShared<DenseMatrix>(2, 5, 3.0)));
+  ASSERT_TRUE(key);
+  store.store(*key, { { "OutputMatrix:0", makeShared<DenseMatrix>(5, 2, 3.0) } });
+
+  // reopening the directory forgets every in-memory hash
+  store.setDirectory(dir_);
+  auto sameKey = store.makeKey("TransposeMatrix", "{}", input(makeShared<DenseMatrix>(2, 5, 3.0)));
+  ASSERT_TRUE(sameKey);
+  EXPECT_EQ(*key, *sameKey);
+  EXPECT_TRUE(store.lookup(*sameKey));
+}
+
+TEST_F(ModuleResultStoreTests, StateKeyDistinguishesValuesThatPrintAlike)
+{
+  using SCIRun::Core::Algorithms::Name;
+  using SCIRun::Core::Algorithms::Variable;
+  auto key = [](const Variable::Value& value) { return ModuleResultStore::stateKey({ Variable(Name("Value"), value) }); };
+
+  EXPECT_EQ(key(0.1), key(0.1));
+  EXPECT_NE(key(1.0), key(1.0 + 1e-9));
+  EXPECT_NE(key(1), key(true));
+  EXPECT_NE(key(1), key(std::string("1")));
+  EXPECT_NE(ModuleResultStore::stateKey({ Variable(Name("A"), 1) }), ModuleResultStore::stateKey({ Variable(Name("B"), 1) }));
+}
+
+TEST_F(ModuleResultStoreTests, HashesOfReleasedDataAreForgotten)
+{
+  auto& store = ModuleResultStore::instance();
+  auto kept = makeShared<DenseMatrix>(2, 2, 1.0);
+  ASSERT_TRUE(store.contentHash(kept));
+
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_TRUE(store.contentHash(makeShared<DenseMatrix>(2, 2, static_cast<double>(i))));
+
+  EXPECT_LT(store.numKnownHashes(), 200u);
+  EXPECT_EQ(store.contentHash(kept), store.contentHash(makeShared<DenseMatrix>(2, 2, 1.0)));
+}
@@ -0,0 +1,173 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/PortDataCache.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+class PortDataCacheTests : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    PortDataCache::instance().setMemoryBudget(0);
+    PortDataCache::instance().setSpillDirectory({});
+    if (!spillDir_.empty())
+      boost::filesystem::remove_all(spillDir_);
+  }
+
+  boost::filesystem::path makeSpillDirectory()
+  {
+    spillDir_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("port-cache-%%%%-%%%%");
+    PortDataCache::instance().setSpillDirectory(spillDir_);
+    return spillDir_;
+  }
+
+  static DenseMatrixHandle matrix(double value)
+  {
+    return makeShared<DenseMatrix>(10, 10, value);
+  }
+
+  static constexpr size_t matrixBytes = 100 * sizeof(double);
+  boost::filesystem::path spillDir_;
+};
+
+TEST_F(PortDataCacheTests, UnlimitedBudgetKeepsEverything)
+{
+  SimpleSource a, b;
+  a.cacheData(matrix(1));
+  b.cacheData(matrix(2));
+  EXPECT_TRUE(a.hasData());
+  EXPECT_TRUE(b.hasData());
+  EXPECT_EQ(2 * matrixBytes, PortDataCache::instance().residentBytes());
+}
+
+TEST_F(PortDataCacheTests, EvictsLeastRecentlyUsedWhenOverBudget)
+{
+  PortDataCache::instance().setMemoryBudget(2 * matrixBytes + 10);
+  SimpleSource a, b, c;
+  a.cacheData(matrix(1));
+  b.cacheData(matrix(2));
+  a.peekData();
+  c.cacheData(matrix(3));
+
+  // b was used least recently; without a spill directory it is dropped and must be recomputed
+  EXPECT_TRUE(a.hasData());
+  EXPECT_FALSE(b.hasData());
+  EXPECT_TRUE(c.hasData());
+  EXPECT_EQ(2 * matrixBytes, PortDataCache::instance().residentBytes());
+}
+
+TEST_F(PortDataCacheTests, SinkKeepsDataInFlightUntilReceived)
+{
+  PortDataCache::instance().setMemoryBudget(matrixBytes + 10);
+  SimpleSource a, b;
+  auto sink = makeShared<SimpleSink>();
+  a.cacheData(matrix(1));
+  a.send(sink);
+  b.cacheData(matrix(2));
+
+  // without a spill directory the sent data cannot be evicted, and is still charged to the budget
+  EXPECT_TRUE(a.hasData());
+  EXPECT_EQ(2 * matrixBytes, PortDataCache::instance().residentBytes());
+  auto received = sink->receive();
+  ASSERT_TRUE(received && *received);
+  EXPECT_EQ(1.0, (*std::dynamic_pointer_cast<DenseMatrix>(*received))(0, 0));
+
+  received.reset();
+  EXPECT_FALSE(a.hasData());
+  EXPECT_EQ(matrixBytes, PortDataCache::instance().residentBytes());
+}
+
+TEST_F(PortDataCacheTests, DataInFlightCanSpill)
+{
+  makeSpillDirectory();
+  PortDataCache::instance().setMemoryBudget(matrixBytes + 10);
+  SimpleSource a, b;
+  auto sink = makeShared<SimpleSink>();
+  a.cacheData(matrix(1));
+  a.send(sink);
+  b.cacheData(matrix(2));
+
+  EXPECT_TRUE(a.hasData());
+  EXPECT_EQ(matrixBytes, PortDataCache::instance().residentBytes());
+  auto received = sink->receive();
+  ASSERT_TRUE(received && *received);
+  EXPECT_EQ(1.0, (*std::dynamic_pointer_cast<DenseMatrix>(*received))(0, 0));
+}
+
+TEST_F(PortDataCacheTests, EvictedDataIsReloadedFromSpillDirectory)
+{
+  auto dir = makeSpillDirectory();
+  PortDataCache::instance().setMemoryBudget(matrixBytes + 10);
+  const auto reloadsBefore = PortDataCache::instance().numReloads();
+
+  SimpleSource a, b;
+  auto sink = makeShared<SimpleSink>();
+  a.cacheData(matrix(1));
+  a.send(sink);
+  ASSERT_TRUE(sink->receive());
+  EXPECT_TRUE(sink->hasChanged());
+
+  b.cacheData(matrix(2));
+  EXPECT_TRUE(a.hasData());
+  EXPECT_EQ(1, std::distance(boost::filesystem::directory_iterator(dir), boost::filesystem::directory_iterator()));
+
+  // re-execution downstream: the sink asks the cache again instead of the upstream module running
+  auto reloaded = sink->receive();
+  ASSERT_TRUE(reloaded && *reloaded);
+  auto reloadedMatrix = std::dynamic_pointer_cast<DenseMatrix>(*reloaded);
+  ASSERT_TRUE(reloadedMatrix != nullptr);
+  EXPECT_EQ(10, reloadedMatrix->nrows());
+  EXPECT_EQ(1.0, (*reloadedMatrix)(9, 9));
+  EXPECT_EQ(reloadsBefore + 1, PortDataCache::instance().numReloads());
+
+  // sending the reloaded copy again is not a change
+  a.send(sink);
+  EXPECT_FALSE(sink->hasChanged());
+}
+
+TEST_F(PortDataCacheTests, NewDataDiscardsSpillFile)
+{
+  auto dir = makeSpillDirectory();
+  PortDataCache::instance().setMemoryBudget(matrixBytes + 10);
+  SimpleSource a, b;
+  a.cacheData(matrix(1));
+  b.cacheData(matrix(2));
+  ASSERT_EQ(1, std::distance(boost::filesystem::directory_iterator(dir), boost::filesystem::directory_iterator()));
+
+  a.cacheData(matrix(3));
+  EXPECT_EQ(1, std::distance(boost::filesystem::directory_iterator(dir), boost::filesystem::directory_iterator()));
+  EXPECT_EQ(3.0, (*std::dynamic_pointer_cast<DenseMatrix>(a.peekData()))(0, 0));
+}
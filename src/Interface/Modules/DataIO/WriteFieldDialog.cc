@@ -38,6 +38,7 @@ using namespace SCIRun::Gui;
 using namespace SCIRun::Modules::DataIO;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::DataIO;
 
 WriteFieldDialog::WriteFieldDialog(const std::string& name, ModuleStateHandle state,
   QWidget* parent /* = 0 */)
@@ -47,6 +48,8 @@ WriteFieldDialog::WriteFieldDialog(const std::string& name, ModuleStateHandle st
   setWindowTitle(QString::fromStdString(name));
   fixSize();
 
+  addSpinBoxManager(compressionLevelSpinBox_, Parameters::CompressionLevel);
+
   connect(saveFileButton_, &QPushButton::clicked, this, &WriteFieldDialog::saveFile);
   connect(fileNameLineEdit_, &QLineEdit::editingFinished, this, &WriteFieldDialog::pushFileNameToState);
   connect(fileNameLineEdit_, &QLineEdit::returnPressed, this, &WriteFieldDialog::pushFileNameToState);
@@ -57,6 +57,8 @@ BuildBEMatrixDialog::BuildBEMatrixDialog(const std::string& name, ModuleStateHan
   fixSize();
   WidgetStyleMixin::tableHeaderStyle(this->tableWidget);
   tableWidget->resizeColumnsToContents();
+  addCheckBoxManager(compressPointOperatorsCheckBox_, Parameters::CompressPointOperators);
+  addDoubleLineEditManager(compressionToleranceLineEdit_, Parameters::CompressionTolerance);
 
   connect(tableWidget, &QTableWidget::cellChanged, this, &BuildBEMatrixDialog::pushTable);
 }
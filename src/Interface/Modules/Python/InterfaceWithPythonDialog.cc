@@ -55,6 +55,7 @@ InterfaceWithPythonDialog::InterfaceWithPythonDialog(const std::string& name, Mo
 
   addSpinBoxManager(retryAttemptsSpinBox_, Parameters::NumberOfRetries);
   addSpinBoxManager(pollingIntervalSpinBox_, Parameters::PollingIntervalMilliseconds);
+  addCheckBoxManager(inputArraysCheckBox_, Parameters::PythonInputArrays);
 
   connect(clearObjectPushButton_, &QPushButton::clicked, this, &InterfaceWithPythonDialog::resetObjects);
 
@@ -132,6 +132,7 @@ AsyncStreamingTest::AsyncStreamingTest()
 {
   INITIALIZE_PORT(InputMatrix);
   INITIALIZE_PORT(OutputSlice);
+  setExecutionMayBlock();
 }
 
 AsyncStreamingTest::~AsyncStreamingTest() = default;
@@ -41,6 +41,7 @@ ALGORITHM_PARAMETER_DEF(FlowControl, PortMax);
 ChooseInput::ChooseInput()
   : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(Input);
   INITIALIZE_PORT(Output);
 }
@@ -61,6 +61,7 @@ class SCIRun::Modules::Basic::CompositeModuleImpl
 CompositeModuleWithStaticPorts::CompositeModuleWithStaticPorts()
     : Module(staticInfo_), impl_(new CompositeModuleImpl(this))
 {
+  disableMemoization();
   INITIALIZE_PORT(Input0) INITIALIZE_PORT(Input1) INITIALIZE_PORT(Input2)
   INITIALIZE_PORT(Input3) INITIALIZE_PORT(Input4) INITIALIZE_PORT(Input5) INITIALIZE_PORT(Input6)  // INITIALIZE_PORT(Input7)
   INITIALIZE_PORT(Output0) INITIALIZE_PORT(Output1) INITIALIZE_PORT(Output2)
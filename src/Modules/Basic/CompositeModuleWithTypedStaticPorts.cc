@@ -57,6 +57,7 @@ class SCIRun::Modules::Basic::CompositeModuleTypedImpl
 CompositeModuleWithTypedStaticPorts::CompositeModuleWithTypedStaticPorts()
     : Module(staticInfo_), impl_(new CompositeModuleTypedImpl(this))
 {
+  disableMemoization();
   INITIALIZE_PORT(Input0) INITIALIZE_PORT(Input1) INITIALIZE_PORT(Input2)
   INITIALIZE_PORT(Input3) INITIALIZE_PORT(Input4) INITIALIZE_PORT(Input5) INITIALIZE_PORT(Input6)  // INITIALIZE_PORT(Input7)
   INITIALIZE_PORT(Output0) INITIALIZE_PORT(Output1) INITIALIZE_PORT(Output2)
@@ -42,6 +42,7 @@ using namespace SCIRun::Dataflow::Networks;
 
 GenerateROIStatistics::GenerateROIStatistics() : Module(ModuleLookupInfo("GenerateROIStatistics", "BrainStimulator", "SCIRun"))
 {
+ disableMemoization();
  INITIALIZE_PORT(MeshDataOnElements);
  INITIALIZE_PORT(PhysicalUnit);
  INITIALIZE_PORT(AtlasMesh);
@@ -53,6 +53,9 @@ SimulateForwardMagneticField::SimulateForwardMagneticField() : Module(staticInfo
 
 void SimulateForwardMagneticField::setStateDefaults()
 {
+  setStateBoolFromAlgo(Parameters::UseTreecode);
+  setStateDoubleFromAlgo(Parameters::TreecodeOpeningAngle);
+  setStateIntFromAlgo(Parameters::TreecodeOrder);
 }
 
 void SimulateForwardMagneticField::execute()
@@ -64,6 +67,9 @@ void SimulateForwardMagneticField::execute()
 
   if (needToExecute())
   {
+    setAlgoBoolFromState(Parameters::UseTreecode);
+    setAlgoDoubleFromState(Parameters::TreecodeOpeningAngle);
+    setAlgoIntFromState(Parameters::TreecodeOrder);
      auto output = algo().run(make_input((ElectricField, EField)(ConductivityTensor, CondTensor)(DipoleSources, Dipoles)(DetectorLocations, Detectors)));
     sendOutputFromAlgorithm(MagneticField, output);
     sendOutputFromAlgorithm(MagneticFieldMagnitudes, output);
@@ -51,6 +51,9 @@ void SolveBiotSavart::setStateDefaults()
 {
   auto state = get_state();
   setStateIntFromAlgo(Parameters::OutType);
+  setStateBoolFromAlgo(Parameters::UseTreecode);
+  setStateDoubleFromAlgo(Parameters::TreecodeOpeningAngle);
+  setStateIntFromAlgo(Parameters::TreecodeOrder);
 }
 
 void SolveBiotSavart::execute()
@@ -78,6 +81,10 @@ void SolveBiotSavart::execute()
 
   if (needToExecute())
   {
+    setAlgoBoolFromState(Parameters::UseTreecode);
+    setAlgoDoubleFromState(Parameters::TreecodeOpeningAngle);
+    setAlgoIntFromState(Parameters::TreecodeOrder);
+
     AlgorithmOutput output;
 
     if ((oport_connected(VectorBField) || oport_connected(VectorAField)))
@@ -54,8 +54,11 @@
 
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Algorithms::DataIO;
 using namespace SCIRun::Modules::DataIO;
 
+ALGORITHM_PARAMETER_DEF(DataIO, CompressionLevel);
+
 WriteField::WriteField()
   : my_base("WriteField", "DataIO", "SCIRun", "Filename")
     //gui_increment_(get_ctx()->subVar("increment"), 0),
@@ -70,6 +73,12 @@ WriteField::WriteField()
   get_state()->setTransientValue(Variables::FileTypeList, types);
 }
 
+void WriteField::setStateDefaults()
+{
+  my_base::setStateDefaults();
+  get_state()->setValue(Parameters::CompressionLevel, 6);
+}
+
 bool WriteField::call_exporter(const std::string& filename)
 {
   ///@todo: how will this work via python? need more code to set the filetype based on the extension...
@@ -77,7 +86,7 @@ bool WriteField::call_exporter(const std::string& filename)
   auto pl = mgr.get_plugin(get_state()->getValue(Variables::FileTypeName).toString());
   if (pl)
   {
-    return pl->writeFile(handle_, filename, getLogger());
+    return pl->writeFile(handle_, filename, get_state()->getValue(Parameters::CompressionLevel).toInt(), getLogger());
   }
   return false;
 }
@@ -36,6 +36,14 @@
 #include <Modules/DataIO/share.h>
 
 namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace DataIO {
+        ALGORITHM_PARAMETER_DECL(CompressionLevel);
+      }
+    }
+  }
+
   namespace Modules {
     namespace DataIO {
 
@@ -44,6 +52,7 @@ namespace SCIRun {
       public:
         typedef GenericWriter<FieldHandle, FieldPortTag> my_base;
         WriteField();
+        void setStateDefaults() override;
         void execute() override;
         bool useCustomExporter(const std::string& filename) const override;
         bool call_exporter(const std::string& filename) override;
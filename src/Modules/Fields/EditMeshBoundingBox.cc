@@ -54,6 +54,7 @@ MODULE_INFO_DEF(EditMeshBoundingBox, ChangeMesh, SCIRun)
 EditMeshBoundingBox::EditMeshBoundingBox()
 : GeometryGeneratingModule(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputField);
   INITIALIZE_PORT(OutputField);
   INITIALIZE_PORT(Transformation_Widget);
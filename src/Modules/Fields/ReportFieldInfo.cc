@@ -43,6 +43,7 @@ MODULE_INFO_DEF(ReportFieldInfo, MiscField, SCIRun)
 
 ReportFieldInfo::ReportFieldInfo() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputField);
   INITIALIZE_PORT(NumNodes);
   INITIALIZE_PORT(NumElements);
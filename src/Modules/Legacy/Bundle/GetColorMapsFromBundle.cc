@@ -50,6 +50,7 @@ const AlgorithmParameterName GetColorMapsFromBundle::ColorMapNames[] = {
 
 GetColorMapsFromBundle::GetColorMapsFromBundle() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputBundle);
   INITIALIZE_PORT(OutputBundle);
   INITIALIZE_PORT(colorMap1);
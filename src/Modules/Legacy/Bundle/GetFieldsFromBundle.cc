@@ -51,6 +51,7 @@ const AlgorithmParameterName GetFieldsFromBundle::FieldNames[] = {
 
 GetFieldsFromBundle::GetFieldsFromBundle() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputBundle);
   INITIALIZE_PORT(OutputBundle);
   INITIALIZE_PORT(field1);
@@ -50,6 +50,7 @@ const AlgorithmParameterName GetMatricesFromBundle::MatrixNames[] = {
 
 GetMatricesFromBundle::GetMatricesFromBundle() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputBundle);
   INITIALIZE_PORT(OutputBundle);
   INITIALIZE_PORT(matrix1);
@@ -54,6 +54,7 @@ const AlgorithmParameterName GetStringsFromBundle::StringNames[] = {
 
 GetStringsFromBundle::GetStringsFromBundle() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputBundle);
   INITIALIZE_PORT(OutputBundle);
   INITIALIZE_PORT(string1);
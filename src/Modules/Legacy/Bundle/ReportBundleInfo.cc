@@ -43,6 +43,7 @@ MODULE_INFO_DEF(ReportBundleInfo, Bundle, SCIRun)
 
 ReportBundleInfo::ReportBundleInfo() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputBundle);
 }
 
@@ -50,6 +50,7 @@ MODULE_INFO_DEF(ExtractIsosurface, NewField, SCIRun)
 ExtractIsosurface::ExtractIsosurface()
   : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputField);
   INITIALIZE_PORT(Isovalue);
   INITIALIZE_PORT(OutputField);
@@ -57,6 +57,7 @@ MODULE_INFO_DEF(BuildBEMatrix, Forward, SCIRun)
 
 BuildBEMatrix::BuildBEMatrix() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(Surface);
   INITIALIZE_PORT(BEM_Forward_Matrix);
 }
@@ -67,6 +68,8 @@ void BuildBEMatrix::setStateDefaults()
   get_state()->setValue(Parameters::BoundaryConditionList, VariableList());
   get_state()->setValue(Parameters::OutsideConductivityList, VariableList());
   get_state()->setValue(Parameters::InsideConductivityList, VariableList());
+  get_state()->setValue(Parameters::CompressPointOperators, false);
+  get_state()->setValue(Parameters::CompressionTolerance, HierarchicalMatrix::Options().tolerance);
 }
 
 void BuildBEMatrix::execute()
@@ -81,7 +84,11 @@ void BuildBEMatrix::execute()
     auto outsideConds = state->getValue(Parameters::OutsideConductivityList).toVector();
     auto insideConds = state->getValue(Parameters::InsideConductivityList).toVector();
 
-    BuildBEMatrixImpl impl(fieldNames, boundaryConditions, outsideConds, insideConds, this);
+    HierarchicalMatrix::Options compression;
+    compression.tolerance = state->getValue(Parameters::CompressionTolerance).toDouble();
+
+    BuildBEMatrixImpl impl(fieldNames, boundaryConditions, outsideConds, insideConds, this,
+      state->getValue(Parameters::CompressPointOperators).toBool(), compression);
     MatrixHandle transferMatrix = impl.executeImpl(inputs);
     auto fieldTypes = impl.getInputTypes();
     state->setTransientValue(Parameters::FieldTypeList, fieldTypes);
@@ -57,12 +57,16 @@ BuildBEMatrixImpl::BuildBEMatrixImpl(const VariableList& names,
   const VariableList& bdyConds,
   const VariableList& outside,
   const VariableList& inside,
-  LegacyLoggerInterface* log) :
+  LegacyLoggerInterface* log,
+  bool compressPointOperators,
+  const HierarchicalMatrix::Options& compression) :
   names_(names),
   bdyConds_(bdyConds),
   outside_(outside),
   inside_(inside),
-  log_(log)
+  log_(log),
+  compressPointOperators_(compressPointOperators),
+  compression_(compression)
 {
 
 }
@@ -128,7 +132,7 @@ MatrixHandle BuildBEMatrixImpl::executeImpl(const FieldList& inputs)
 
   // The specific BEM routine (2 so far) to be called is dependent on the inputs in the fields vector,
   // so we check for the conditions and call the appropriate routine:
-  auto BEMalgo = BEMAlgoImplFactory::create(fields);
+  auto BEMalgo = BEMAlgoImplFactory::create(fields, compressPointOperators_, compression_);
 
   if (!BEMalgo)
   {
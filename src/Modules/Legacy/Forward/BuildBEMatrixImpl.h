@@ -32,6 +32,7 @@
 #include <Core/Logging/LoggerFwd.h>
 #include <Core/Datatypes/DatatypeFwd.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/Legacy/Forward/HierarchicalMatrix.h>
 #include <Modules/Legacy/Forward/share.h>
 
 namespace SCIRun {
@@ -46,7 +47,9 @@ namespace SCIRun {
           const Core::Algorithms::VariableList& bdyConds,
           const Core::Algorithms::VariableList& outside,
           const Core::Algorithms::VariableList& inside,
-          Core::Logging::LegacyLoggerInterface* log);
+          Core::Logging::LegacyLoggerInterface* log,
+          bool compressPointOperators = false,
+          const Core::Algorithms::Forward::HierarchicalMatrix::Options& compression = Core::Algorithms::Forward::HierarchicalMatrix::Options());
 
         Core::Datatypes::MatrixHandle executeImpl(const FieldList& inputs);
         const std::vector<std::string>& getInputTypes() const { return inputTypes_; }
@@ -56,6 +59,8 @@ namespace SCIRun {
         const Core::Algorithms::VariableList& outside_;
         const Core::Algorithms::VariableList& inside_;
         const Core::Logging::LegacyLoggerInterface* log_;
+        bool compressPointOperators_;
+        Core::Algorithms::Forward::HierarchicalMatrix::Options compression_;
         std::vector<std::string> inputTypes_;
       };
 
@@ -55,6 +55,7 @@ MODULE_INFO_DEF(SolveInverseProblemWithTSVD, Inverse, SCIRun)
 // Constructor needs to initialize all input/output ports
 SolveInverseProblemWithTSVD::SolveInverseProblemWithTSVD() : Module(staticInfo_)
 {
+	disableMemoization();
 	//inputs
 	INITIALIZE_PORT(ForwardMatrix);
 	INITIALIZE_PORT(WeightingInSourceSpace);
@@ -55,6 +55,7 @@ MODULE_INFO_DEF(SolveInverseProblemWithTikhonov, Inverse, SCIRun)
 // Constructor needs to initialize all input/output ports
 SolveInverseProblemWithTikhonov::SolveInverseProblemWithTikhonov() : Module(staticInfo_)
 {
+	disableMemoization();
 	INITIALIZE_PORT(ForwardMatrix);
 	INITIALIZE_PORT(WeightingInSourceSpace);
 	INITIALIZE_PORT(MeasuredPotentials);
@@ -69,6 +69,7 @@ public:
 
 CollectMatrices::CollectMatrices() : Module(staticInfo_), impl_(new CollectMatricesImpl)
 {
+  disableMemoization();
   INITIALIZE_PORT(Optional_BaseMatrix);
   INITIALIZE_PORT(SubMatrix);
   INITIALIZE_PORT(CompositeMatrix);
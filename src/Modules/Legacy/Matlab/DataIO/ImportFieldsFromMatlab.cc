@@ -60,6 +60,7 @@ MODULE_INFO_DEF(ImportFieldsFromMatlab, Matlab, SCIRun)
 
 ImportFieldsFromMatlab::ImportFieldsFromMatlab() : MatlabFileIndexModule(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(Field1);
   INITIALIZE_PORT(Field2);
   INITIALIZE_PORT(Field3);
@@ -41,6 +41,7 @@ const std::string ReportStringInfo::infoKey_("StringContents");
 ReportStringInfo::ReportStringInfo()
   : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(Input);
 }
 
@@ -44,6 +44,7 @@ MODULE_INFO_DEF(ReportNrrdInfo, Misc, Teem)
 
 ReportNrrdInfo::ReportNrrdInfo() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(Query_Nrrd);
 }
 
@@ -47,6 +47,7 @@ ALGORITHM_PARAMETER_DEF(Math, DependentVariablesVector);
 
 LinePlotter::LinePlotter() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(IndependentVariable);
   INITIALIZE_PORT(DependentVariables);
 }
@@ -57,6 +57,7 @@ ALGORITHM_PARAMETER_DEF(Math, TransposeData);
 
 BasicPlotter::BasicPlotter() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputMatrix);
 }
 
@@ -40,6 +40,7 @@ MODULE_INFO_DEF(DisplayHistogram, Math, SCIRun)
 
 DisplayHistogram::DisplayHistogram() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputMatrix);
 }
 
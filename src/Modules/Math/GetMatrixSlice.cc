@@ -45,6 +45,8 @@ GetMatrixSlice::GetMatrixSlice() : Module(staticInfo_), playing_(false)
   INITIALIZE_PORT(OutputMatrix);
   INITIALIZE_PORT(Current_Index);
   INITIALIZE_PORT(Selected_Index);
+  setExecutionMayBlock();
+  disableMemoization();
 }
 
 void GetMatrixSlice::setStateDefaults()
@@ -41,6 +41,7 @@ MODULE_INFO_DEF(ReportMatrixInfo, Math, SCIRun)
 
 ReportMatrixInfo::ReportMatrixInfo() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(InputMatrix);
   INITIALIZE_PORT(NumRows);
   INITIALIZE_PORT(NumCols);
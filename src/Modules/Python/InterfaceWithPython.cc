@@ -51,6 +51,7 @@ ALGORITHM_PARAMETER_DEF(Python, PythonTopLevelCode);
 ALGORITHM_PARAMETER_DEF(Python, PythonInputStringNames);
 ALGORITHM_PARAMETER_DEF(Python, PythonInputMatrixNames);
 ALGORITHM_PARAMETER_DEF(Python, PythonInputFieldNames);
+ALGORITHM_PARAMETER_DEF(Python, PythonInputArrays);
 ALGORITHM_PARAMETER_DEF(Python, PythonOutputString1Name);
 ALGORITHM_PARAMETER_DEF(Python, PythonOutputString2Name);
 ALGORITHM_PARAMETER_DEF(Python, PythonOutputString3Name);
@@ -68,6 +69,8 @@ bool InterfaceWithPython::matlabInitialized_{ false };
 
 InterfaceWithPython::InterfaceWithPython() : Module(staticInfo_)
 {
+  setExecutionMayBlock();
+  disableMemoization();
   INITIALIZE_PORT(InputMatrix);
   INITIALIZE_PORT(InputField);
   INITIALIZE_PORT(InputString);
@@ -96,6 +99,7 @@ void InterfaceWithPython::setStateDefaults()
     "# This code will be executed before the 'Code' tab, and no input/output variables are available."));
   state->setValue(Parameters::PollingIntervalMilliseconds, 200);
   state->setValue(Parameters::NumberOfRetries, 50);
+  state->setValue(Parameters::PythonInputArrays, false);
 
   state->setValue(Parameters::PythonOutputField1Name, std::string("fieldOutput1"));
   state->setValue(Parameters::PythonOutputField2Name, std::string("fieldOutput2"));
@@ -46,6 +46,7 @@ namespace SCIRun
         ALGORITHM_PARAMETER_DECL(PythonInputStringNames);
         ALGORITHM_PARAMETER_DECL(PythonInputMatrixNames);
         ALGORITHM_PARAMETER_DECL(PythonInputFieldNames);
+        ALGORITHM_PARAMETER_DECL(PythonInputArrays);
         ALGORITHM_PARAMETER_DECL(PythonOutputString1Name);
         ALGORITHM_PARAMETER_DECL(PythonOutputString2Name);
         ALGORITHM_PARAMETER_DECL(PythonOutputString3Name);
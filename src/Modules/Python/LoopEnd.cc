@@ -54,6 +54,8 @@ MODULE_INFO_DEF(LoopEnd, Python, SCIRun)
 
 LoopEnd::LoopEnd() : Module(staticInfo_)
 {
+  setExecutionMayBlock();
+  disableMemoization();
   INITIALIZE_PORT(LoopEndCodeObject);
   INITIALIZE_PORT(InputMatrix);
   INITIALIZE_PORT(InputField);
@@ -56,6 +56,7 @@ MODULE_INFO_DEF(LoopStart, Python, SCIRun)
 
 LoopStart::LoopStart() : Module(staticInfo_)
 {
+  setExecutionMayBlock();
   INITIALIZE_PORT(LoopStartCodeObject);
   INITIALIZE_PORT(LoopEndCodeObject);
   INITIALIZE_PORT(PythonMatrix1);
@@ -93,9 +93,12 @@ std::string InterfaceWithPythonCodeTranslatorImpl::translateInputSyntax(const st
       auto index = line.find(inputName);
       if (index != std::string::npos)
       {
+        const auto asArrays = state_->containsKey(Parameters::PythonInputArrays) &&
+          state_->getValue(Parameters::PythonInputArrays).toBool();
         auto codeCopy = line;
         return codeCopy.replace(index, inputName.length(),
-          "scirun_get_module_input_value(\"" + moduleId_() + "\", \"" + portId + "\")");
+          std::string(asArrays ? "scirun_get_module_input_array" : "scirun_get_module_input_value") +
+          "(\"" + moduleId_() + "\", \"" + portId + "\")");
       }
     }
   }
@@ -40,7 +40,7 @@ using namespace SCIRun::Core;
 using namespace SCIRun::Core::Algorithms;
 
 
-std::unique_ptr<InterfaceWithPythonCodeTranslatorImpl> makeParser()
+std::unique_ptr<InterfaceWithPythonCodeTranslatorImpl> makeParser(bool inputArrays = false)
 {
   std::string moduleId = "InterfaceWithPython:0";
   std::vector<std::string> portIds = {"InputString:0"};
@@ -51,6 +51,7 @@ std::unique_ptr<InterfaceWithPythonCodeTranslatorImpl> makeParser()
   }
   state->setValue(Name(portIds[0]), std::string("str1"));
   state->setValue(Name("PythonOutputString1Name"), std::string("out1"));
+  state->setValue(Parameters::PythonInputArrays, inputArrays);
 
   std::unique_ptr<InterfaceWithPythonCodeTranslatorImpl> parser(new InterfaceWithPythonCodeTranslatorImpl(
     [=]() { return moduleId; }, state, InterfaceWithPython::outputNameParameters()));
@@ -108,6 +109,23 @@ TEST(PythonInterfaceParserTests, BasicActual)
   ASSERT_EQ(convertedCode2.code, expectedCode + "\n");
 }
 
+TEST(PythonInterfaceParserTests, InputsAsArrays)
+{
+  auto parser = makeParser(true);
+
+  std::string code =
+    "s = str1\n"
+    "out1 = s + \"!12!\"\n";
+
+  auto convertedCode = parser->translateIOSyntax({code, false});
+
+  std::string expectedCode =
+    "s = scirun_get_module_input_array(\"InterfaceWithPython:0\", \"InputString:0\")\n"
+    "scirun_set_module_transient_state(\"InterfaceWithPython:0\",\"out1\",s + \"!12!\")\n\n";
+
+  ASSERT_EQ(convertedCode.code, expectedCode);
+}
+
 TEST(PythonInterfaceParserTests, CanExtractSingleMatlabBlock)
 {
   auto parser = makeParser();
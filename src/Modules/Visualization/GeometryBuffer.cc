@@ -99,6 +99,8 @@ GeometryBuffer::GeometryBuffer() : ModuleWithAsyncDynamicPorts(staticInfo_, true
   INITIALIZE_PORT(GeometryOutputSeries5);
   INITIALIZE_PORT(GeometryOutputSeries6);
   INITIALIZE_PORT(GeometryOutputSeries7);
+  setExecutionMayBlock();
+  disableMemoization();
 }
 
 GeometryBuffer::~GeometryBuffer() = default;
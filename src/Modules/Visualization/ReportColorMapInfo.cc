@@ -39,6 +39,7 @@ MODULE_INFO_DEF(ReportColorMapInfo, Visualization, SCIRun)
 
 ReportColorMapInfo::ReportColorMapInfo() : Module(staticInfo_)
 {
+  disableMemoization();
   INITIALIZE_PORT(ColorMapObject);
   INITIALIZE_PORT(Description);
 }
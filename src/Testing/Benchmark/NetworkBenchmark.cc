@@ -0,0 +1,341 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Testing/Benchmark/NetworkBenchmark.h>
+#include <Dataflow/Engine/Controller/NetworkEditorController.h>
+#include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ExecutionProfiler.h>
+#include <Dataflow/Network/ModuleReexecutionStrategies.h>
+#include <Dataflow/Network/ConnectionId.h>
+#include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <Dataflow/State/SimpleMapModuleState.h>
+#include <Modules/Factory/HardCodedModuleFactory.h>
+#include <Modules/Math/CreateMatrix.h>
+#include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/EvaluateLinearAlgebraUnaryAlgo.h>
+#include <Core/Logging/Log.h>
+#include <boost/filesystem/operations.hpp>
+#include <boost/signals2/connection.hpp>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Testing;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::State;
+using namespace SCIRun::Modules::Factory;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  // Renderers need an OpenGL context owned by the GUI, and Python modules need an
+  // embedded interpreter; neither exists in a headless benchmark process.
+  bool requiresGui(const ModuleLookupInfo& info)
+  {
+    return info.category_name_ == "Render"
+      || info.category_name_ == "Python"
+      || info.module_name_.find("Ospray") != std::string::npos;
+  }
+
+  double median(std::vector<double> values)
+  {
+    if (values.empty())
+      return 0;
+    std::sort(values.begin(), values.end());
+    const auto mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+  }
+
+  void writeSummary(std::ostream& out, const std::vector<double>& seconds)
+  {
+    out << "\"runs\":" << seconds.size();
+    if (seconds.empty())
+      return;
+    out << ",\"median\":" << median(seconds)
+      << ",\"min\":" << *std::min_element(seconds.begin(), seconds.end())
+      << ",\"max\":" << *std::max_element(seconds.begin(), seconds.end());
+  }
+
+  std::string syntheticMatrixText(int size)
+  {
+    std::ostringstream text;
+    for (int row = 0; row < size; ++row)
+    {
+      for (int col = 0; col < size; ++col)
+        text << (row * size + col) % 17 << ' ';
+      text << '\n';
+    }
+    return text.str();
+  }
+}
+
+NetworkBenchmark::NetworkBenchmark(int repetitions, const std::vector<std::string>& strategies, double timeoutSeconds) :
+  repetitions_(std::max(1, repetitions)), strategies_(strategies), timeoutSeconds_(timeoutSeconds)
+{
+}
+
+std::vector<boost::filesystem::path> NetworkBenchmark::findNetworks(const boost::filesystem::path& fileOrDirectory)
+{
+  std::vector<boost::filesystem::path> networks;
+  if (boost::filesystem::is_directory(fileOrDirectory))
+  {
+    for (const auto& entry : boost::filesystem::recursive_directory_iterator(fileOrDirectory))
+    {
+      if (boost::filesystem::is_regular_file(entry.path()) && entry.path().extension() == ".srn5")
+        networks.push_back(entry.path());
+    }
+    std::sort(networks.begin(), networks.end());
+  }
+  else if (boost::filesystem::exists(fileOrDirectory))
+  {
+    networks.push_back(fileOrDirectory);
+  }
+  return networks;
+}
+
+std::string NetworkBenchmark::unsupportedModuleIn(const NetworkFile& file, const ModuleFactory& factory)
+{
+  for (const auto& module : file.network.modules)
+  {
+    const auto& info = module.second.module;
+    if (requiresGui(info))
+      return "module " + module.first + " requires the GUI";
+    if (!factory.moduleImplementationExists(info.module_name_))
+      return "module " + module.first + " is not available in this build";
+  }
+  return {};
+}
+
+NetworkTiming NetworkBenchmark::runFile(const boost::filesystem::path& file) const
+{
+  NetworkFileHandle xml;
+  try
+  {
+    xml = XMLSerializer::load_xml<NetworkFile>(file.string());
+  }
+  catch (std::exception& e)
+  {
+    logWarning("Could not read network {}: {}", file.string(), e.what());
+  }
+
+  return run(file.string(), [xml](NetworkEditorController& controller) -> std::string
+  {
+    if (!xml)
+      return "network file could not be read";
+    HardCodedModuleFactory factory;
+    auto unsupported = unsupportedModuleIn(*xml, factory);
+    if (!unsupported.empty())
+      return unsupported;
+    controller.loadNetwork(xml);
+    return {};
+  });
+}
+
+NetworkTiming NetworkBenchmark::runSynthetic(int width, int depth, int matrixSize) const
+{
+  std::ostringstream name;
+  name << "synthetic:" << width << "x" << depth << ":" << matrixSize;
+  const auto matrixText = syntheticMatrixText(matrixSize);
+
+  return run(name.str(), [width, depth, matrixText](NetworkEditorController& controller) -> std::string
+  {
+    auto network = controller.getNetwork();
+    for (int chain = 0; chain < width; ++chain)
+    {
+      auto upstream = controller.addModule("CreateMatrix");
+      upstream->get_state()->setValue(Math::Parameters::TextEntry, matrixText);
+      for (int step = 0; step < depth; ++step)
+      {
+        auto next = controller.addModule("EvaluateLinearAlgebraUnary");
+        next->get_state()->setValue(Variables::Operator,
+          static_cast<int>(Math::EvaluateLinearAlgebraUnaryAlgorithm::Operator::TRANSPOSE));
+        network->connect(ConnectionOutputPort(upstream, 0), ConnectionInputPort(next, 0));
+        upstream = next;
+      }
+    }
+    return {};
+  });
+}
+
+NetworkTiming NetworkBenchmark::run(const std::string& name, const NetworkBuilder& build) const
+{
+  NetworkTiming timing;
+  timing.name = name;
+  for (const auto& strategy : strategies_)
+  {
+    timing.strategies.push_back(runStrategy(strategy, build, timing.moduleCount));
+    const auto& last = timing.strategies.back();
+    if (last.skipped)
+      logInfo("Benchmark {} [{}]: skipped, {}", name, strategy, last.reason);
+    else
+      logInfo("Benchmark {} [{}]: median {:.4f} s over {} runs", name, strategy, median(last.networkSeconds), last.networkSeconds.size());
+  }
+  return timing;
+}
+
+StrategyTiming NetworkBenchmark::runStrategy(const std::string& strategy, const NetworkBuilder& build, size_t& moduleCount) const
+{
+  StrategyTiming timing;
+  timing.strategy = strategy;
+
+  // Re-executing every module on every run is what makes repeated timings comparable;
+  // the default strategy would skip modules whose inputs and state are unchanged.
+  auto controller = std::make_shared<NetworkEditorController>(
+    std::make_shared<HardCodedModuleFactory>(),
+    std::make_shared<SimpleMapModuleStateFactory>(),
+    std::make_shared<DesktopExecutionStrategyFactory>(strategy),
+    std::make_shared<HardCodedAlgorithmFactory>(),
+    std::make_shared<DynamicReexecutionStrategyFactory>(std::string("always")),
+    nullptr, nullptr);
+
+  try
+  {
+    timing.reason = build(*controller);
+  }
+  catch (std::exception& e)
+  {
+    timing.reason = std::string("network could not be loaded: ") + e.what();
+  }
+  if (!timing.reason.empty())
+  {
+    timing.skipped = true;
+    return timing;
+  }
+
+  auto network = controller->getNetwork();
+  moduleCount = network->nmodules();
+
+  std::mutex timingLock;
+  bool recording = false;
+  std::vector<boost::signals2::scoped_connection> moduleConnections;
+  for (size_t i = 0; i < network->nmodules(); ++i)
+  {
+    moduleConnections.emplace_back(network->module(i)->connectExecuteEnds(
+      [&timing, &timingLock, &recording](double seconds, const ModuleId& id)
+      {
+        std::lock_guard<std::mutex> g(timingLock);
+        if (recording)
+          timing.moduleSeconds[id.id_].push_back(seconds);
+      }));
+  }
+
+  // Run 0 is a warm-up: it populates caches and reveals modules that cannot run here.
+  for (int run = 0; run <= repetitions_; ++run)
+  {
+    {
+      std::lock_guard<std::mutex> g(timingLock);
+      recording = run > 0;
+    }
+
+    auto finished = std::make_shared<std::promise<int>>();
+    auto done = finished->get_future();
+    auto once = std::make_shared<std::once_flag>();
+    boost::signals2::scoped_connection finishConnection(controller->connectStaticNetworkExecutionFinished(
+      [finished, once](int code) { std::call_once(*once, [&] { finished->set_value(code); }); }));
+
+    const auto start = std::chrono::steady_clock::now();
+    controller->executeAll();
+    if (done.wait_for(std::chrono::duration<double>(timeoutSeconds_)) != std::future_status::ready)
+    {
+      timing.skipped = true;
+      timing.reason = "execution did not finish within the timeout";
+      // The executor thread may still be running modules; let it finish on its own
+      // rather than blocking in the controller's destructor.
+      static std::vector<SharedPointer<NetworkEditorController>> abandoned;
+      abandoned.push_back(controller);
+      return timing;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (run == 0)
+    {
+      for (size_t i = 0; i < network->nmodules(); ++i)
+      {
+        auto module = network->module(i);
+        if (module->executionState().currentState() == ModuleExecutionState::Value::Errored)
+        {
+          timing.skipped = true;
+          timing.reason = "module " + module->id().id_ + " failed on the warm-up run (missing data?)";
+          return timing;
+        }
+      }
+    }
+    else
+    {
+      timing.networkSeconds.push_back(elapsed.count());
+    }
+  }
+  return timing;
+}
+
+void NetworkBenchmark::writeJson(std::ostream& out, const std::vector<NetworkTiming>& results)
+{
+  out << "{\"networks\":[";
+  bool firstNetwork = true;
+  for (const auto& network : results)
+  {
+    out << (firstNetwork ? "\n" : ",\n");
+    firstNetwork = false;
+    out << "{\"name\":\"" << jsonEscaped(network.name) << "\",\"modules\":" << network.moduleCount << ",\"strategies\":[";
+    bool firstStrategy = true;
+    for (const auto& strategy : network.strategies)
+    {
+      out << (firstStrategy ? "\n" : ",\n");
+      firstStrategy = false;
+      out << " {\"strategy\":\"" << strategy.strategy << "\"";
+      if (strategy.skipped)
+      {
+        out << ",\"skipped\":true,\"reason\":\"" << jsonEscaped(strategy.reason) << "\"}";
+        continue;
+      }
+      out << ",\"network\":{";
+      writeSummary(out, strategy.networkSeconds);
+      out << "},\"moduleTimes\":{";
+      bool firstModule = true;
+      for (const auto& module : strategy.moduleSeconds)
+      {
+        out << (firstModule ? "" : ",") << "\"" << jsonEscaped(module.first) << "\":{";
+        firstModule = false;
+        writeSummary(out, module.second);
+        out << "}";
+      }
+      out << "}}";
+    }
+    out << "]}";
+  }
+  out << "\n]}\n";
+}
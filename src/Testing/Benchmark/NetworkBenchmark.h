@@ -0,0 +1,97 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef TESTING_BENCHMARK_NETWORKBENCHMARK_H
+#define TESTING_BENCHMARK_NETWORKBENCHMARK_H
+
+#include <Dataflow/Network/NetworkFwd.h>
+#include <boost/filesystem/path.hpp>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace SCIRun
+{
+  namespace Dataflow { namespace Engine { class NetworkEditorController; } }
+
+  namespace Testing
+  {
+    /// Timings of one network under one execution strategy. Times are in seconds;
+    /// the first (warm-up) execution is not included.
+    struct StrategyTiming
+    {
+      std::string strategy;
+      bool skipped {false};
+      std::string reason;
+      std::vector<double> networkSeconds;
+      std::map<std::string, std::vector<double>> moduleSeconds;
+    };
+
+    struct NetworkTiming
+    {
+      std::string name;
+      size_t moduleCount {0};
+      std::vector<StrategyTiming> strategies;
+    };
+
+    /// Headless benchmark driver: builds a NetworkEditorController without any GUI,
+    /// executes a network repeatedly under each requested thread mode ("serial",
+    /// "basicParallel", "dynamicParallel", "workStealingParallel") and collects
+    /// per-module and whole-network wall times. Networks that contain GUI-only modules, unknown modules, or whose
+    /// modules error out on the warm-up run (usually missing test data) are skipped.
+    class NetworkBenchmark
+    {
+    public:
+      NetworkBenchmark(int repetitions, const std::vector<std::string>& strategies, double timeoutSeconds);
+
+      NetworkTiming runFile(const boost::filesystem::path& file) const;
+      /// Generates @p width independent chains of one CreateMatrix followed by @p depth
+      /// EvaluateLinearAlgebraUnary modules, each moving a @p matrixSize square matrix.
+      NetworkTiming runSynthetic(int width, int depth, int matrixSize) const;
+
+      static void writeJson(std::ostream& out, const std::vector<NetworkTiming>& results);
+      static std::vector<boost::filesystem::path> findNetworks(const boost::filesystem::path& fileOrDirectory);
+      static std::string unsupportedModuleIn(const Dataflow::Networks::NetworkFile& file,
+        const Dataflow::Networks::ModuleFactory& factory);
+
+    private:
+      using NetworkBuilder = std::function<std::string(Dataflow::Engine::NetworkEditorController&)>;
+      NetworkTiming run(const std::string& name, const NetworkBuilder& build) const;
+      StrategyTiming runStrategy(const std::string& strategy, const NetworkBuilder& build, size_t& moduleCount) const;
+
+      int repetitions_;
+      std::vector<std::string> strategies_;
+      double timeoutSeconds_;
+    };
+  }
+}
+
+#endif
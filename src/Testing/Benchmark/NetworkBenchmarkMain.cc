@@ -0,0 +1,131 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Testing/Benchmark/NetworkBenchmark.h>
+#include <Core/Application/Preferences/Preferences.h>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Testing;
+namespace po = boost::program_options;
+
+int main(int argc, char* argv[])
+{
+  po::options_description desc("Usage: SCIRunNetworkBenchmark [options] [network files or directories]\nOptions");
+  desc.add_options()
+    ("help,h", "prints usage information")
+    ("repeat,n", po::value<int>()->default_value(5), "timed executions per network and strategy")
+    ("strategy,s", po::value<std::vector<std::string>>()->composing(), "thread mode to benchmark: serial, basicParallel, dynamicParallel or workStealingParallel (default: all four)")
+    ("synthetic", po::value<std::vector<std::string>>()->composing(), "generated network WIDTHxDEPTH[:MATRIXSIZE], e.g. 8x4:200")
+    ("datadir,d", po::value<std::string>(), "SCIRun data directory used by the networks")
+    ("timeout", po::value<double>()->default_value(300), "seconds to wait for one network execution")
+    ("output,o", po::value<std::string>(), "write timing JSON to this file instead of stdout")
+    ("input-file", po::value<std::vector<std::string>>(), "network files or directories of .srn5 files");
+
+  po::positional_options_description positional;
+  positional.add("input-file", -1);
+
+  po::variables_map vm;
+  try
+  {
+    po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+    po::notify(vm);
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << e.what() << "\n" << desc << std::endl;
+    return 1;
+  }
+
+  if (vm.count("help") || (!vm.count("input-file") && !vm.count("synthetic")))
+  {
+    std::cout << desc << std::endl;
+    return vm.count("help") ? 0 : 1;
+  }
+
+  if (vm.count("datadir"))
+    (void)Core::Preferences::Instance().setDataDirectory(vm["datadir"].as<std::string>());
+
+  std::vector<std::string> strategies { "serial", "basicParallel", "dynamicParallel", "workStealingParallel" };
+  if (vm.count("strategy"))
+    strategies = vm["strategy"].as<std::vector<std::string>>();
+
+  NetworkBenchmark benchmark(vm["repeat"].as<int>(), strategies, vm["timeout"].as<double>());
+  std::vector<NetworkTiming> results;
+
+  if (vm.count("input-file"))
+  {
+    for (const auto& input : vm["input-file"].as<std::vector<std::string>>())
+    {
+      const auto networks = NetworkBenchmark::findNetworks(input);
+      if (networks.empty())
+        std::cerr << "No networks found at " << input << std::endl;
+      for (const auto& file : networks)
+        results.push_back(benchmark.runFile(file));
+    }
+  }
+
+  if (vm.count("synthetic"))
+  {
+    for (const auto& spec : vm["synthetic"].as<std::vector<std::string>>())
+    {
+      int width = 0, depth = 0, size = 100;
+      char x = 0, colon = 0;
+      std::istringstream in(spec);
+      in >> width >> x >> depth;
+      if (in >> colon)
+        in >> size;
+      if (x != 'x' || width <= 0 || depth <= 0 || size <= 0 || (colon && colon != ':'))
+      {
+        std::cerr << "Invalid synthetic network specification: " << spec << std::endl;
+        return 1;
+      }
+      results.push_back(benchmark.runSynthetic(width, depth, size));
+    }
+  }
+
+  if (vm.count("output"))
+  {
+    std::ofstream out(vm["output"].as<std::string>());
+    NetworkBenchmark::writeJson(out, results);
+    if (!out)
+    {
+      std::cerr << "Could not write " << vm["output"].as<std::string>() << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    NetworkBenchmark::writeJson(std::cout, results);
+  }
+  return 0;
+}